@@ -1,10 +1,42 @@
-#include <buffer.hpp>
+#include <arena.hpp>
+#include <callable.hpp>
+#include <concurrent_hashmap.hpp>
+#include <deque.hpp>
+#include <filesystem.hpp>
+#include <format.hpp>
+#include <handle_pool.hpp>
+#include <hash.hpp>
 #include <hashmap.hpp>
+#include <intrusive_list.hpp>
+#include <list.hpp>
 #include <random.hpp>
-
+#include <scheduler.hpp>
+#include <simd_math.hpp>
+#include <sort.hpp>
+#include <string.hpp>
+#include <string_view.hpp>
+#include <tlsf.hpp>
+
+#include <algorithm>
 #include <chrono>
+#include <deque>
+#include <list>
+#include <string_view>
 #include <unordered_map>
 
+#if EDGE_PLATFORM_POSIX
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if EDGE_BENCHMARK_GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#endif
+
 namespace edge {
 	struct string {
 		char* data;
@@ -21,16 +53,7 @@ namespace edge {
 	template<>
 	struct Hash<string> {
 		usize operator()(const string& str) const noexcept {
-			u64 hash = 0xcbf29ce484222325;
-			u64 prime = 0x100000001b3;
-
-			for (usize i = 0; i < str.len; ++i) {
-				u8 value = str.data[i];
-				hash = hash ^ value;
-				hash *= prime;
-			}
-
-			return hash;
+			return static_cast<usize>(hash_xxh3_64(str.data, str.len));
 		}
 	};
 }
@@ -39,18 +62,18 @@ using HashMap = edge::HashMap<edge::string, i32>;
 
 constexpr usize DATASET_SIZE = 2000;
 
-using DatasetStorage = edge::StackStorage<edge::string, DATASET_SIZE>;
+using DatasetStorage = edge::string[DATASET_SIZE];
 
-static void generate_dataset1(edge::NotNull<const edge::Allocator*> alloc, DatasetStorage& output, usize count, edge::RngPCGGen& rng) {
+static void generate_dataset1(edge::NotNull<const edge::Allocator*> alloc, DatasetStorage& output, usize count, edge::RngPCG& rng) {
 	static const char* prefixes[] = { "pre", "post", "un", "re", "anti", "de", "dis", "en", "in", "inter", "over", "sub", "trans", "under", "co", "mis", "non", "out" };
 	static const char* roots[] = { "act", "form", "port", "dict", "scribe", "ject", "tract", "mit", "fer", "duc", "pose", "pone", "sta", "vert", "cede", "cess", "struct", "spect", "gress", "press" };
 	static const char* suffixes[] = { "tion", "ness", "ment", "able", "ible", "ful", "less", "ive", "ous", "al", "er", "or", "ing", "ed", "ly", "ity", "ism", "ist", "ence", "ance" };
 	
 	char buffer[64] = {};
 	for (usize i = 0; i < count; ++i) {
-		usize prefix_idx = rng.gen_u32_bounded(edge::array_size(prefixes));
-		usize root_idx = rng.gen_u32_bounded(edge::array_size(roots));
-		usize suffix_idx = rng.gen_u32_bounded(edge::array_size(suffixes));
+		usize prefix_idx = edge::rng_gen_u32_bounded(rng, edge::array_size(prefixes));
+		usize root_idx = edge::rng_gen_u32_bounded(rng, edge::array_size(roots));
+		usize suffix_idx = edge::rng_gen_u32_bounded(rng, edge::array_size(suffixes));
 
 		i32 word_size = 0;
 		if (i % 4 == 0) {
@@ -91,13 +114,13 @@ static void run_bench(edge::NotNull<const edge::Allocator*> alloc, DatasetStorag
 
 	printf("Total entries: %zu\n", map.size());
 	printf("Load factor: %.2f\n", map.load_factor());
-	printf("Bucket count: %zu\n", map.m_bucket_count);
+	printf("Capacity: %zu\n", map.m_capacity);
 
 	printf("\nWarming up (100,000 lookups)...\n");
 	for (usize warmup = 0; warmup < 100000; ++warmup) {
 		usize idx = warmup % word_count;
-		volatile i32* value = map.get(dataset[idx]);
-		(void)value;
+		volatile bool found = map.contains(dataset[idx]);
+		(void)found;
 	}
 
 	printf("Running sequential lookup benchmark...\n");
@@ -108,8 +131,7 @@ static void run_bench(edge::NotNull<const edge::Allocator*> alloc, DatasetStorag
 
 	for (usize i = 0; i < NUM_ITERATIONS; ++i) {
 		usize idx = i % word_count;
-		i32* value = map.get(dataset[idx]);
-		if (value) {
+		if (map.find(dataset[idx]) != map.end()) {
 			successful++;
 		}
 	}
@@ -129,16 +151,15 @@ static void run_bench(edge::NotNull<const edge::Allocator*> alloc, DatasetStorag
 	printf("Successful lookups:    %zu (%.1f%%)\n", successful, (successful * 100.0) / NUM_ITERATIONS);
 
 	printf("\n------ Random Access Pattern ------\n");
-	edge::RngPCGGen rng;
-	rng.set_seed(0x12345678);
+	edge::RngPCG rng = {};
+	rng.seed(0x12345678);
 	successful = 0;
 
 	start = std::chrono::high_resolution_clock::now();
 
 	for (usize i = 0; i < NUM_ITERATIONS; ++i) {
-		usize idx = rng.gen_u32_bounded(word_count);
-		i32* value = map.get(dataset[idx]);
-		if (value) successful++;
+		usize idx = edge::rng_gen_u32_bounded(rng, word_count);
+		if (map.find(dataset[idx]) != map.end()) successful++;
 	}
 
 	end = std::chrono::high_resolution_clock::now();
@@ -154,23 +175,22 @@ static void run_bench(edge::NotNull<const edge::Allocator*> alloc, DatasetStorag
 	printf("Successful lookups:    %zu (%.1f%%)\n", successful, (successful * 100.0) / NUM_ITERATIONS);
 
 	printf("\n------ 50%% Hit Rate (with misses) ------\n");
-	rng.set_seed(0xDEADBEEF);
+	rng.seed(0xDEADBEEF);
 	usize hits = 0;
 
 	start = std::chrono::high_resolution_clock::now();
 
 	for (usize i = 0; i < NUM_ITERATIONS; ++i) {
 		char temp_key[64];
-		if (rng.gen_bool(0.5f)) {
-			usize idx = rng.gen_u32_bounded(word_count);
-			i32* value = map.get(dataset[idx]);
-			if (value) hits++;
+		if (edge::rng_gen_bool(rng, 0.5f)) {
+			usize idx = edge::rng_gen_u32_bounded(rng, word_count);
+			if (map.find(dataset[idx]) != map.end()) hits++;
 		}
 		else {
-			usize len = snprintf(temp_key, 64, "nonexistent_%zu_%x", i, rng.gen_u32());
+			usize len = snprintf(temp_key, 64, "nonexistent_%zu_%x", i, rng.next32());
 			edge::string tmp_str = { .data = temp_key, .len = len };
-			i32* value = map.get(tmp_str);
-			(void)value;
+			volatile bool found = map.contains(tmp_str);
+			(void)found;
 		}
 	}
 
@@ -243,14 +263,14 @@ static void run_bench_std(DatasetStorage& dataset, usize word_count) {
 	printf("Successful lookups:    %zu (%.1f%%)\n", successful, (successful * 100.0) / NUM_ITERATIONS);
 
 	printf("\n------ Random Access Pattern ------\n");
-	edge::RngPCGGen rng;
-	rng.set_seed(0x12345678);
+	edge::RngPCG rng = {};
+	rng.seed(0x12345678);
 	successful = 0;
 
 	start = std::chrono::high_resolution_clock::now();
 
 	for (usize i = 0; i < NUM_ITERATIONS; ++i) {
-		usize idx = rng.gen_u32_bounded(word_count);
+		usize idx = edge::rng_gen_u32_bounded(rng, word_count);
 		auto value = map.find(dataset[idx]);
 		if (value != map.end()) {
 			successful++;
@@ -270,22 +290,22 @@ static void run_bench_std(DatasetStorage& dataset, usize word_count) {
 	printf("Successful lookups:    %zu (%.1f%%)\n", successful, (successful * 100.0) / NUM_ITERATIONS);
 
 	printf("\n------ 50%% Hit Rate (with misses) ------\n");
-	rng.set_seed(0xDEADBEEF);
+	rng.seed(0xDEADBEEF);
 	usize hits = 0;
 
 	start = std::chrono::high_resolution_clock::now();
 
 	for (usize i = 0; i < NUM_ITERATIONS; ++i) {
 		char temp_key[64];
-		if (rng.gen_bool(0.5f)) {
-			usize idx = rng.gen_u32_bounded(word_count);
+		if (edge::rng_gen_bool(rng, 0.5f)) {
+			usize idx = edge::rng_gen_u32_bounded(rng, word_count);
 			auto value = map.find(dataset[idx]);
 			if (value != map.end()) {
 				hits++;
 			}
 		}
 		else {
-			usize len = snprintf(temp_key, 64, "nonexistent_%zu_%x", i, rng.gen_u32());
+			usize len = snprintf(temp_key, 64, "nonexistent_%zu_%x", i, rng.next32());
 			edge::string tmp_str = { .data = temp_key, .len = len };
 			volatile auto value = map.find(tmp_str);
 			(void)value;
@@ -305,17 +325,1721 @@ static void run_bench_std(DatasetStorage& dataset, usize word_count) {
 	printf("Hit rate:              %.1f%%\n", (hits * 100.0) / NUM_ITERATIONS);
 }
 
+template<typename F>
+static f64 measure_ns_per_op(usize op_count, F&& fn) {
+	auto start = std::chrono::high_resolution_clock::now();
+	fn();
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / static_cast<f64>(op_count);
+}
+
+static void run_bench_hashmap_ops(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize NUM_KEYS = 1000000;
+
+	u64* keys = alloc->allocate_array<u64>(NUM_KEYS);
+	u64* lookup_keys = alloc->allocate_array<u64>(NUM_KEYS);
+	u64* missing_keys = alloc->allocate_array<u64>(NUM_KEYS);
+
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0xABCDEF);
+	for (usize i = 0; i < NUM_KEYS; ++i) {
+		keys[i] = rng.next64() | 1;
+		missing_keys[i] = rng.next64() & ~1ull;
+	}
+
+	// Lookup in a different order than insertion, otherwise node based maps
+	// get sequential node access from the allocator for free
+	memcpy(lookup_keys, keys, NUM_KEYS * sizeof(u64));
+	edge::rng_shuffle(rng, lookup_keys, NUM_KEYS);
+
+	printf("\n==============================================================");
+	printf("\n============= HashMap vs std::unordered_map (1M u64) =========");
+	printf("\n==============================================================\n");
+	printf("%-24s %14s %14s\n", "operation (ns/op)", "edge", "std");
+
+	edge::HashMap<u64, u64> map = {};
+	map.create(alloc);
+	std::unordered_map<u64, u64> std_map = {};
+
+	usize sink = 0;
+	auto report = [](const char* name, f64 edge_ns, f64 std_ns) {
+		printf("%-24s %14.2f %14.2f\n", name, edge_ns, std_ns);
+	};
+
+	report("insert",
+		measure_ns_per_op(NUM_KEYS, [&]() { for (usize i = 0; i < NUM_KEYS; ++i) map.insert(alloc, keys[i], i); }),
+		measure_ns_per_op(NUM_KEYS, [&]() { for (usize i = 0; i < NUM_KEYS; ++i) std_map[keys[i]] = i; }));
+
+	report("lookup hit",
+		measure_ns_per_op(NUM_KEYS, [&]() { for (usize i = 0; i < NUM_KEYS; ++i) sink += map.find(lookup_keys[i])->value; }),
+		measure_ns_per_op(NUM_KEYS, [&]() { for (usize i = 0; i < NUM_KEYS; ++i) sink += std_map.find(lookup_keys[i])->second; }));
+
+	report("lookup miss",
+		measure_ns_per_op(NUM_KEYS, [&]() { for (usize i = 0; i < NUM_KEYS; ++i) sink += map.contains(missing_keys[i]); }),
+		measure_ns_per_op(NUM_KEYS, [&]() { for (usize i = 0; i < NUM_KEYS; ++i) sink += std_map.contains(missing_keys[i]); }));
+
+	report("iterate",
+		measure_ns_per_op(NUM_KEYS, [&]() { for (auto& entry : map) sink += entry.value; }),
+		measure_ns_per_op(NUM_KEYS, [&]() { for (auto& entry : std_map) sink += entry.second; }));
+
+	report("remove half",
+		measure_ns_per_op(NUM_KEYS / 2, [&]() { for (usize i = 0; i < NUM_KEYS; i += 2) map.remove(alloc, keys[i]); }),
+		measure_ns_per_op(NUM_KEYS / 2, [&]() { for (usize i = 0; i < NUM_KEYS; i += 2) std_map.erase(keys[i]); }));
+
+	// Lookups after heavy removal, a tombstone based table would degrade here
+	report("lookup after remove",
+		measure_ns_per_op(NUM_KEYS, [&]() { for (usize i = 0; i < NUM_KEYS; ++i) sink += map.contains(lookup_keys[i]); }),
+		measure_ns_per_op(NUM_KEYS, [&]() { for (usize i = 0; i < NUM_KEYS; ++i) sink += std_map.contains(lookup_keys[i]); }));
+
+	report("reinsert half",
+		measure_ns_per_op(NUM_KEYS / 2, [&]() { for (usize i = 0; i < NUM_KEYS; i += 2) map.try_emplace(alloc, keys[i], i); }),
+		measure_ns_per_op(NUM_KEYS / 2, [&]() { for (usize i = 0; i < NUM_KEYS; i += 2) std_map.try_emplace(keys[i], i); }));
+
+	printf("sink: %zu\n", sink);
+
+	map.destroy(alloc);
+	alloc->deallocate_array(keys, NUM_KEYS);
+	alloc->deallocate_array(lookup_keys, NUM_KEYS);
+	alloc->deallocate_array(missing_keys, NUM_KEYS);
+}
+
+static void run_bench_hash_size(const u8* data, usize size) {
+	constexpr usize TOTAL_BYTES = 64ull * 1024 * 1024;
+	const usize iterations = TOTAL_BYTES / size;
+	u64 sink = 0;
+
+	// Offsets walk the buffer so short inputs are not hashed from one hot line
+	auto gbps = [&](auto&& hash_fn) {
+		const f64 ns = measure_ns_per_op(iterations, [&]() {
+			for (usize i = 0; i < iterations; ++i) {
+				sink += hash_fn(data + (i * 64) % 4096, size);
+			}
+		});
+		return static_cast<f64>(size) / ns;
+	};
+
+	const f64 xxh3_64 = gbps([](const u8* p, usize n) { return edge::hash_xxh3_64(p, n); });
+	const f64 xxh3_128 = gbps([](const u8* p, usize n) { return edge::hash_xxh3_128(p, n).low; });
+	const f64 stream = gbps([](const u8* p, usize n) {
+		edge::HashStream state;
+		state.reset();
+		for (usize offset = 0; offset < n; offset += 4096) {
+			state.update(p + offset, std::min<usize>(4096, n - offset));
+		}
+		return state.digest64();
+	});
+	const f64 fnv = gbps([](const u8* p, usize n) { return edge::hash_fnv1a64(p, n); });
+	const f64 crc = gbps([](const u8* p, usize n) { return static_cast<u64>(edge::hash_crc32(p, n)); });
+	const f64 crc_c = gbps([](const u8* p, usize n) { return static_cast<u64>(edge::hash_crc32c(p, n)); });
+
+	printf("%-10zu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", size, xxh3_64, xxh3_128, stream, fnv, crc, crc_c);
+	printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+}
+
+static void run_bench_hash(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize MAX_SIZE = 1024 * 1024;
+
+	u8* data = alloc->allocate_array<u8>(MAX_SIZE + 4096);
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x4A54);
+	for (usize i = 0; i < MAX_SIZE + 4096; ++i) {
+		data[i] = static_cast<u8>(rng.next64());
+	}
+
+	printf("\n==============================================================");
+	printf("\n==================== Hash throughput (GB/s) ==================");
+	printf("\n==============================================================\n");
+	printf("%-10s %10s %10s %10s %10s %10s %10s\n", "bytes", "xxh3_64", "xxh3_128", "stream", "fnv1a64", "crc32", "crc32c");
+
+	const usize sizes[] = { 8, 16, 32, 64, 128, 256, 1024, 4096, 65536, MAX_SIZE };
+	for (usize size : sizes) {
+		run_bench_hash_size(data, size);
+	}
+
+	alloc->deallocate_array(data, MAX_SIZE + 4096);
+}
+
+static void run_bench_utf8_text(edge::NotNull<const edge::Allocator*> alloc, const char* name, const char8_t* text, usize size) {
+	constexpr usize TOTAL_BYTES = 256ull * 1024 * 1024;
+	const usize iterations = TOTAL_BYTES / size;
+	u64 sink = 0;
+
+	const usize units16 = edge::detail::utf8::utf16_length(text, size);
+	const usize units32 = edge::detail::utf8::utf32_length(text, size);
+	char16_t* utf16 = alloc->allocate_array<char16_t>(units16);
+	char32_t* utf32 = alloc->allocate_array<char32_t>(units32);
+	char8_t* utf8 = alloc->allocate_array<char8_t>(size);
+
+	auto gbps = [&](auto&& fn) {
+		const f64 ns = measure_ns_per_op(iterations, [&]() {
+			for (usize i = 0; i < iterations; ++i) {
+				sink += fn();
+			}
+		});
+		return static_cast<f64>(size) / ns;
+	};
+
+	const f64 decode = gbps([&]() {
+		usize pos = 0;
+		u64 sum = 0;
+		while (pos < size) {
+			char32_t cp = 0;
+			usize count = 0;
+			if (!edge::detail::utf8::decode_char(text + pos, size - pos, cp, count)) {
+				break;
+			}
+			sum += cp;
+			pos += count;
+		}
+		return sum;
+	});
+	const f64 validate = gbps([&]() { return static_cast<u64>(edge::detail::utf8::validate_utf8(text, size)); });
+	const f64 to16 = gbps([&]() {
+		return static_cast<u64>(edge::detail::utf8::convert_to_utf16(text, size, utf16));
+	});
+	const f64 to32 = gbps([&]() {
+		return static_cast<u64>(edge::detail::utf8::convert_to_utf32(text, size, utf32));
+	});
+	const f64 from16 = gbps([&]() {
+		usize written = 0;
+		edge::detail::utf8::convert_from_utf16(utf16, units16, utf8, written);
+		return static_cast<u64>(written);
+	});
+
+	printf("%-10s %10.2f %10.2f %10.2f %10.2f %10.2f\n", name, decode, validate, to16, to32, from16);
+	printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+
+	alloc->deallocate_array(utf8, size);
+	alloc->deallocate_array(utf32, units32);
+	alloc->deallocate_array(utf16, units16);
+}
+
+static void run_bench_utf8(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize SIZE = 1024 * 1024;
+	constexpr usize CAPACITY = SIZE + 8;
+
+	const char* words[] = { "edge", "\xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82", "\xE6\x97\xA5\xE6\x9C\xAC", "\xF0\x9F\x98\x80", "caf\xC3\xA9" };
+
+	char8_t* ascii = alloc->allocate_array<char8_t>(CAPACITY);
+	char8_t* mixed = alloc->allocate_array<char8_t>(CAPACITY);
+
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x0717);
+	for (usize i = 0; i < SIZE; ++i) {
+		ascii[i] = static_cast<char8_t>(0x20 + rng.next64() % 0x5F);
+	}
+
+	// Mostly ASCII with a multi byte word roughly every 40 bytes
+	usize mixed_size = 0;
+	while (mixed_size < SIZE) {
+		const u64 roll = rng.next64();
+		const char* word = roll % 8 == 0 ? words[1 + (roll >> 8) % 4] : words[0];
+		const usize length = strlen(word);
+		if (mixed_size + length + 1 > SIZE) {
+			break;
+		}
+		memcpy(mixed + mixed_size, word, length);
+		mixed[mixed_size + length] = u8' ';
+		mixed_size += length + 1;
+	}
+
+	printf("\n==============================================================");
+	printf("\n==================== UTF-8 throughput (GB/s) =================");
+	printf("\n==============================================================\n");
+	printf("%-10s %10s %10s %10s %10s %10s\n", "text", "decode", "validate", "to_utf16", "to_utf32", "from_utf16");
+
+	run_bench_utf8_text(alloc, "ascii", ascii, SIZE);
+	run_bench_utf8_text(alloc, "mixed", mixed, mixed_size);
+
+	alloc->deallocate_array(mixed, CAPACITY);
+	alloc->deallocate_array(ascii, CAPACITY);
+}
+
+static void run_bench_string_search_case(const char* name, usize iterations, auto&& edge_fn, auto&& std_fn) {
+	usize sink = 0;
+	const f64 edge_ns = measure_ns_per_op(iterations, [&]() {
+		for (usize i = 0; i < iterations; ++i) {
+			sink += edge_fn(i);
+		}
+	});
+	const f64 std_ns = measure_ns_per_op(iterations, [&]() {
+		for (usize i = 0; i < iterations; ++i) {
+			sink += std_fn(i);
+		}
+	});
+
+	printf("%-28s %12.2f %12.2f\n", name, edge_ns, std_ns);
+	printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+}
+
+static void run_bench_string_search(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize TEXT_SIZE = 16 * 1024;
+	constexpr usize ITERATIONS = 200000;
+
+	// Typical deep asset path, separators mixed the way tools write them
+	const char8_t path_text[] = u8"C:\\work\\edge\\assets/textures/environment/forest/ground/moss/variants/"
+		u8"high_resolution/compressed/bc7/mips/level_00/moss_ground_albedo_roughness_metal_packed_v3.texture";
+	const edge::StringView<char8_t> path = path_text;
+	const std::basic_string_view<char8_t> std_path = { path_text, path.length() };
+
+	// Word soup with the needle only at the very end
+	char8_t* text = alloc->allocate_array<char8_t>(TEXT_SIZE);
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x5EA7C4);
+	for (usize i = 0; i < TEXT_SIZE; ++i) {
+		const u64 roll = rng.next64() % 8;
+		text[i] = roll == 0 ? u8' ' : roll == 1 ? u8'\n' : static_cast<char8_t>(u8'a' + rng.next64() % 26);
+	}
+	memcpy(text + TEXT_SIZE - 16, u8"needle_in_stack", 15);
+	const edge::StringView<char8_t> view = { text, TEXT_SIZE };
+	const std::basic_string_view<char8_t> std_view = { text, TEXT_SIZE };
+
+	printf("\n==============================================================");
+	printf("\n===================== String search (ns/op) ==================");
+	printf("\n==============================================================\n");
+	printf("%-28s %12s %12s\n", "case", "edge", "std");
+
+	run_bench_string_search_case("path last separator", ITERATIONS,
+		[&](usize) { return edge::filesystem::find_last_separator(path); },
+		[&](usize) { return std_path.find_last_of(u8"\\/"); });
+	run_bench_string_search_case("path first separator", ITERATIONS,
+		[&](usize i) { return edge::filesystem::find_first_separator(path.substr(i & 7)); },
+		[&](usize i) { return std_path.substr(i & 7).find_first_of(u8"\\/"); });
+	run_bench_string_search_case("path components", ITERATIONS,
+		[&](usize) {
+			usize count = 0;
+			for (edge::StringView<char8_t> part : path.split_any_of(u8"\\/")) {
+				count += part.length();
+			}
+			return count;
+		},
+		[&](usize) {
+			usize count = 0;
+			usize start = 0;
+			for (usize found = std_path.find_first_of(u8"\\/"); found != std_path.npos; found = std_path.find_first_of(u8"\\/", start)) {
+				count += found - start;
+				start = found + 1;
+			}
+			return count + std_path.length() - start;
+		});
+
+	// Offsets keep the compiler from hoisting the std calls out of the loop
+	const usize text_iterations = ITERATIONS / 100;
+	run_bench_string_search_case("16K find char", text_iterations,
+		[&](usize i) { return view.substr(i & 7).find(u8'_'); },
+		[&](usize i) { return std_view.substr(i & 7).find(u8'_'); });
+	run_bench_string_search_case("16K rfind char", text_iterations,
+		[&](usize i) { return view.substr(i & 7).rfind(u8'!'); },
+		[&](usize i) { return std_view.substr(i & 7).rfind(u8'!'); });
+	run_bench_string_search_case("16K find substring", text_iterations,
+		[&](usize i) { return view.substr(i & 7).find(u8"needle_in_stack"); },
+		[&](usize i) { return std_view.substr(i & 7).find(u8"needle_in_stack"); });
+	run_bench_string_search_case("16K rfind substring", text_iterations,
+		[&](usize i) { return view.substr(i & 7).rfind(u8"haystack"); },
+		[&](usize i) { return std_view.substr(i & 7).rfind(u8"haystack"); });
+	run_bench_string_search_case("16K lines", text_iterations,
+		[&](usize) {
+			usize count = 0;
+			for (edge::StringView<char8_t> line : view.split(u8'\n')) {
+				count += !line.empty();
+			}
+			return count;
+		},
+		[&](usize) {
+			usize count = 0;
+			usize start = 0;
+			for (usize found = std_view.find(u8'\n'); found != std_view.npos; found = std_view.find(u8'\n', start)) {
+				count += found != start;
+				start = found + 1;
+			}
+			return count + (start != std_view.length());
+		});
+
+	alloc->deallocate_array(text, TEXT_SIZE);
+}
+
+static void run_bench_format_case(const char* name, usize iterations, auto&& edge_fn, auto&& printf_fn) {
+	usize sink = 0;
+	const f64 edge_ns = measure_ns_per_op(iterations, [&]() {
+		for (usize i = 0; i < iterations; ++i) {
+			sink += edge_fn(i);
+		}
+	});
+	const f64 printf_ns = measure_ns_per_op(iterations, [&]() {
+		for (usize i = 0; i < iterations; ++i) {
+			sink += printf_fn(i);
+		}
+	});
+
+	printf("%-28s %12.2f %12.2f %10.2fx\n", name, edge_ns, printf_ns, printf_ns / edge_ns);
+	printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+}
+
+static void run_bench_format() {
+	constexpr usize ITERATIONS = 500000;
+
+	char buffer[256];
+	const char* levels[] = { "TRACE", "DEBUG", "INFO", "WARN", "ERROR" };
+	const char* files[] = { "scheduler.cpp", "filesystem.cpp", "renderer_vulkan.cpp", "hashmap.hpp" };
+
+	printf("\n==============================================================");
+	printf("\n==================== Formatting (ns/op) ======================");
+	printf("\n==============================================================\n");
+	printf("%-28s %12s %12s %11s\n", "case", "edge", "snprintf", "speedup");
+
+	run_bench_format_case("log line", ITERATIONS,
+		[&](usize i) {
+			edge::FormatBuffer out = { buffer, sizeof(buffer) - 1, 0 };
+			edge::format_append(out, "[{:04}-{:02}-{:02} {:02}:{:02}:{:02}] ", 2024, 1 + i % 12, 1 + i % 28, i % 24, i % 60, (i >> 6) % 60);
+			edge::format_append(out, "[{}] [{}:{}] ", levels[i % 5], files[i & 3], static_cast<i32>(i % 2000));
+			edge::format_append(out, "frame {} took {:.3f} ms", i, static_cast<f64>(i % 1000) * 0.0167);
+			return out.m_length;
+		},
+		[&](usize i) {
+			i32 length = snprintf(buffer, sizeof(buffer), "[%04d-%02d-%02d %02d:%02d:%02d] ", 2024, static_cast<i32>(1 + i % 12), static_cast<i32>(1 + i % 28),
+				static_cast<i32>(i % 24), static_cast<i32>(i % 60), static_cast<i32>((i >> 6) % 60));
+			length += snprintf(buffer + length, sizeof(buffer) - length, "[%s] [%s:%d] ", levels[i % 5], files[i & 3], static_cast<i32>(i % 2000));
+			length += snprintf(buffer + length, sizeof(buffer) - length, "frame %zu took %.3f ms", i, static_cast<f64>(i % 1000) * 0.0167);
+			return static_cast<usize>(length);
+		});
+	run_bench_format_case("integers", ITERATIONS,
+		[&](usize i) { return edge::format_to(buffer, "{} {} {}", i * 2654435761ull, -static_cast<i64>(i), static_cast<u32>(i)); },
+		[&](usize i) {
+			return static_cast<usize>(snprintf(buffer, sizeof(buffer), "%llu %lld %u", static_cast<unsigned long long>(i * 2654435761ull),
+				-static_cast<long long>(i), static_cast<u32>(i)));
+		});
+	run_bench_format_case("hex padded", ITERATIONS,
+		[&](usize i) { return edge::format_to(buffer, "0x{:016x} {:08X}", i * 0x9E3779B97F4A7C15ull, static_cast<u32>(i)); },
+		[&](usize i) {
+			return static_cast<usize>(snprintf(buffer, sizeof(buffer), "0x%016llx %08X", static_cast<unsigned long long>(i * 0x9E3779B97F4A7C15ull),
+				static_cast<u32>(i)));
+		});
+	run_bench_format_case("floats", ITERATIONS,
+		[&](usize i) { return edge::format_to(buffer, "{:.2f} {:.6f}", static_cast<f64>(i) * 0.25, 1.0 / static_cast<f64>(i + 1)); },
+		[&](usize i) { return static_cast<usize>(snprintf(buffer, sizeof(buffer), "%.2f %.6f", static_cast<f64>(i) * 0.25, 1.0 / static_cast<f64>(i + 1))); });
+	run_bench_format_case("thread name", ITERATIONS,
+		[&](usize i) { return edge::format_to(buffer, "background-{}", i & 31); },
+		[&](usize i) { return static_cast<usize>(snprintf(buffer, sizeof(buffer), "background-%zu", i & 31)); });
+}
+
+static void run_bench_random_case(const char* name, usize count, auto&& scalar_fn, auto&& batch_fn) {
+	// NOTE: Repeated fills of a cache sized block, the timing is generation and not memory bandwidth
+	constexpr usize ROUNDS = 64;
+	const f64 scalar_ns = measure_ns_per_op(count * ROUNDS, [&]() {
+		for (usize round = 0; round < ROUNDS; ++round) {
+			scalar_fn();
+		}
+	});
+	const f64 batch_ns = measure_ns_per_op(count * ROUNDS, [&]() {
+		for (usize round = 0; round < ROUNDS; ++round) {
+			batch_fn();
+		}
+	});
+
+	printf("%-16s %12.3f %12.3f %10.2fx\n", name, scalar_ns, batch_ns, scalar_ns / batch_ns);
+}
+
+static void run_bench_random(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize COUNT = 16 * 1024;
+
+	u32* u32_values = alloc->allocate_array<u32>(COUNT);
+	f32* f32_values = alloc->allocate_array<f32>(COUNT);
+
+	edge::RngXoshiro256 scalar = {};
+	scalar.seed(0x043);
+	edge::RngXoshiro256Batch batch = {};
+	batch.seed(0x043);
+
+	printf("\n==============================================================");
+	printf("\n================= Random generation (ns/value) ===============");
+	printf("\n==============================================================\n");
+	printf("%-16s %12s %12s %11s\n", "case", "scalar", "batch", "speedup");
+
+	run_bench_random_case("u32", COUNT,
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				u32_values[i] = scalar.next32();
+			}
+		},
+		[&]() { batch.fill_u32(u32_values, COUNT); });
+	run_bench_random_case("f32 [0, 1)", COUNT,
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				f32_values[i] = edge::rng_gen_f32(scalar);
+			}
+		},
+		[&]() { batch.fill_f32(f32_values, COUNT); });
+	run_bench_random_case("normal f32", COUNT,
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				f32_values[i] = edge::rng_gen_normal_f32(scalar);
+			}
+		},
+		[&]() { batch.fill_normal_f32(f32_values, COUNT); });
+
+	printf("sink: %u %f\n", u32_values[COUNT / 2], f32_values[COUNT / 2]);
+
+	alloc->deallocate_array(f32_values, COUNT);
+	alloc->deallocate_array(u32_values, COUNT);
+}
+
+static void run_bench_math_case(const char* name, usize count, auto&& scalar_fn, auto&& batch_fn, auto&& glm_fn) {
+	constexpr usize ROUNDS = 8;
+	const f64 scalar_ns = measure_ns_per_op(count * ROUNDS, [&]() {
+		for (usize round = 0; round < ROUNDS; ++round) {
+			scalar_fn();
+		}
+	});
+	const f64 batch_ns = measure_ns_per_op(count * ROUNDS, [&]() {
+		for (usize round = 0; round < ROUNDS; ++round) {
+			batch_fn();
+		}
+	});
+
+	if constexpr (std::is_null_pointer_v<std::decay_t<decltype(glm_fn)>>) {
+		printf("%-16s %12.3f %12.3f %12s %10.2fx\n", name, scalar_ns, batch_ns, "-", scalar_ns / batch_ns);
+	} else {
+		const f64 glm_ns = measure_ns_per_op(count * ROUNDS, [&]() {
+			for (usize round = 0; round < ROUNDS; ++round) {
+				glm_fn();
+			}
+		});
+		printf("%-16s %12.3f %12.3f %12.3f %10.2fx\n", name, scalar_ns, batch_ns, glm_ns, scalar_ns / batch_ns);
+	}
+}
+
+static void run_bench_math(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize COUNT = 100000;
+
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x044);
+
+	// NOTE: Translation, rotation, scale and a point per element, all SoA
+	f32* soa = alloc->allocate_array<f32>(COUNT * 16);
+	for (usize i = 0; i < COUNT * 16; ++i) {
+		soa[i] = edge::rng_gen_f32_range(rng, 0.5f, 2.0f);
+	}
+	const edge::Vec3Soa translations = { soa, soa + COUNT, soa + COUNT * 2 };
+	const edge::QuatSoa rotations = { soa + COUNT * 3, soa + COUNT * 4, soa + COUNT * 5, soa + COUNT * 6 };
+	const edge::Vec3Soa scales = { soa + COUNT * 7, soa + COUNT * 8, soa + COUNT * 9 };
+	const edge::Vec3Soa points = { soa + COUNT * 10, soa + COUNT * 11, soa + COUNT * 12 };
+	const edge::Vec3Soa out_points = { soa + COUNT * 13, soa + COUNT * 14, soa + COUNT * 15 };
+	for (usize i = 0; i < COUNT; ++i) {
+		const edge::Quat q = edge::quat_normalize({ rotations.m_x[i], rotations.m_y[i], rotations.m_z[i], rotations.m_w[i] });
+		rotations.m_x[i] = q.x;
+		rotations.m_y[i] = q.y;
+		rotations.m_z[i] = q.z;
+		rotations.m_w[i] = q.w;
+	}
+
+	edge::Mat4* a = alloc->allocate_array<edge::Mat4>(COUNT);
+	edge::Mat4* b = alloc->allocate_array<edge::Mat4>(COUNT);
+	edge::Mat4* out = alloc->allocate_array<edge::Mat4>(COUNT);
+	edge::Aabb* boxes = alloc->allocate_array<edge::Aabb>(COUNT);
+	edge::Aabb* world = alloc->allocate_array<edge::Aabb>(COUNT);
+	edge::mat4_from_trs_batch(translations, rotations, scales, a, COUNT);
+	edge::mat4_from_trs_batch(points, rotations, translations, b, COUNT);
+	for (usize i = 0; i < COUNT; ++i) {
+		boxes[i].m_min = { -scales.m_x[i], -scales.m_y[i], -scales.m_z[i] };
+		boxes[i].m_max = { points.m_x[i], points.m_y[i], points.m_z[i] };
+	}
+
+	// NOTE: Plain float code, one element at a time, what gameplay code writes by hand
+	f32 (*scalar_a)[16] = reinterpret_cast<f32 (*)[16]>(a);
+	f32 (*scalar_b)[16] = reinterpret_cast<f32 (*)[16]>(b);
+	f32 (*scalar_out)[16] = reinterpret_cast<f32 (*)[16]>(out);
+
+#if EDGE_BENCHMARK_GLM
+	glm::mat4* glm_a = alloc->allocate_array<glm::mat4>(COUNT);
+	glm::mat4* glm_b = alloc->allocate_array<glm::mat4>(COUNT);
+	glm::mat4* glm_out = alloc->allocate_array<glm::mat4>(COUNT);
+	glm::vec3* glm_points = alloc->allocate_array<glm::vec3>(COUNT);
+	memcpy(static_cast<void*>(glm_a), a, COUNT * sizeof(glm::mat4));
+	memcpy(static_cast<void*>(glm_b), b, COUNT * sizeof(glm::mat4));
+	for (usize i = 0; i < COUNT; ++i) {
+		glm_points[i] = glm::vec3(points.m_x[i], points.m_y[i], points.m_z[i]);
+	}
+#endif
+
+	printf("\n==============================================================");
+	printf("\n================= SIMD math, 100k elements (ns/op) ===========");
+	printf("\n==============================================================\n");
+	printf("%-16s %12s %12s %12s %11s\n", "case", "scalar", "edge", "glm", "speedup");
+
+	run_bench_math_case("transform point", COUNT,
+		[&]() {
+			const f32* m = scalar_a[0];
+			for (usize i = 0; i < COUNT; ++i) {
+				const f32 x = points.m_x[i], y = points.m_y[i], z = points.m_z[i];
+				out_points.m_x[i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+				out_points.m_y[i] = m[1] * x + m[5] * y + m[9] * z + m[13];
+				out_points.m_z[i] = m[2] * x + m[6] * y + m[10] * z + m[14];
+			}
+		},
+		[&]() { edge::transform_points(a[0], points, out_points, COUNT); },
+#if EDGE_BENCHMARK_GLM
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				const glm::vec4 p = glm_a[0] * glm::vec4(glm_points[i], 1.0f);
+				out_points.m_x[i] = p.x;
+				out_points.m_y[i] = p.y;
+				out_points.m_z[i] = p.z;
+			}
+		});
+#else
+		nullptr);
+#endif
+
+	run_bench_math_case("mat4 mul", COUNT,
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				for (usize c = 0; c < 4; ++c) {
+					for (usize r = 0; r < 4; ++r) {
+						scalar_out[i][c * 4 + r] = scalar_a[i][r] * scalar_b[i][c * 4] + scalar_a[i][4 + r] * scalar_b[i][c * 4 + 1] +
+							scalar_a[i][8 + r] * scalar_b[i][c * 4 + 2] + scalar_a[i][12 + r] * scalar_b[i][c * 4 + 3];
+					}
+				}
+			}
+		},
+		[&]() { edge::mat4_mul_batch(a, b, out, COUNT); },
+#if EDGE_BENCHMARK_GLM
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				glm_out[i] = glm_a[i] * glm_b[i];
+			}
+		});
+#else
+		nullptr);
+#endif
+
+	run_bench_math_case("mat4 inverse", COUNT,
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				edge::mat4_inverse(a[i], out[i]);
+			}
+		},
+		[&]() { edge::mat4_inverse_batch(a, out, COUNT); },
+#if EDGE_BENCHMARK_GLM
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				glm_out[i] = glm::inverse(glm_a[i]);
+			}
+		});
+#else
+		nullptr);
+#endif
+
+	run_bench_math_case("compose trs", COUNT,
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				out[i] = edge::mat4_from_trs({ translations.m_x[i], translations.m_y[i], translations.m_z[i] },
+					{ rotations.m_x[i], rotations.m_y[i], rotations.m_z[i], rotations.m_w[i] },
+					{ scales.m_x[i], scales.m_y[i], scales.m_z[i] });
+			}
+		},
+		[&]() { edge::mat4_from_trs_batch(translations, rotations, scales, out, COUNT); },
+#if EDGE_BENCHMARK_GLM
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				const glm::quat q(rotations.m_w[i], rotations.m_x[i], rotations.m_y[i], rotations.m_z[i]);
+				glm_out[i] = glm::translate(glm::mat4(1.0f), glm::vec3(translations.m_x[i], translations.m_y[i], translations.m_z[i])) *
+					glm::mat4_cast(q) * glm::scale(glm::mat4(1.0f), glm::vec3(scales.m_x[i], scales.m_y[i], scales.m_z[i]));
+			}
+		});
+#else
+		nullptr);
+#endif
+
+	run_bench_math_case("aabb transform", COUNT,
+		[&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				const f32* m = scalar_a[i];
+				const f32 local_min[3] = { boxes[i].m_min.x, boxes[i].m_min.y, boxes[i].m_min.z };
+				const f32 local_max[3] = { boxes[i].m_max.x, boxes[i].m_max.y, boxes[i].m_max.z };
+				f32 world_min[3] = { m[12], m[13], m[14] };
+				f32 world_max[3] = { m[12], m[13], m[14] };
+				for (usize r = 0; r < 3; ++r) {
+					for (usize c = 0; c < 3; ++c) {
+						const f32 e = m[c * 4 + r] * local_min[c];
+						const f32 f = m[c * 4 + r] * local_max[c];
+						world_min[r] += e < f ? e : f;
+						world_max[r] += e < f ? f : e;
+					}
+				}
+				world[i] = { { world_min[0], world_min[1], world_min[2] }, { world_max[0], world_max[1], world_max[2] } };
+			}
+		},
+		[&]() { edge::aabb_transform_batch(boxes, a, world, COUNT); },
+		nullptr);
+
+	run_bench_math_case("aabb of points", COUNT,
+		[&]() {
+			edge::Aabb bounds = { { points.m_x[0], points.m_y[0], points.m_z[0] }, { points.m_x[0], points.m_y[0], points.m_z[0] } };
+			for (usize i = 1; i < COUNT; ++i) {
+				bounds.m_min = { edge::min(bounds.m_min.x, points.m_x[i]), edge::min(bounds.m_min.y, points.m_y[i]), edge::min(bounds.m_min.z, points.m_z[i]) };
+				bounds.m_max = { edge::max(bounds.m_max.x, points.m_x[i]), edge::max(bounds.m_max.y, points.m_y[i]), edge::max(bounds.m_max.z, points.m_z[i]) };
+			}
+			world[0] = bounds;
+		},
+		[&]() { world[1] = edge::aabb_from_points(points, COUNT); },
+		nullptr);
+
+	printf("sink: %f %f %f\n", out_points.m_x[COUNT / 2], out[COUNT / 2].m_columns[3].x, world[COUNT / 2].m_max.y + world[1].m_min.z);
+
+#if EDGE_BENCHMARK_GLM
+	alloc->deallocate_array(glm_points, COUNT);
+	alloc->deallocate_array(glm_out, COUNT);
+	alloc->deallocate_array(glm_b, COUNT);
+	alloc->deallocate_array(glm_a, COUNT);
+#endif
+	alloc->deallocate_array(world, COUNT);
+	alloc->deallocate_array(boxes, COUNT);
+	alloc->deallocate_array(out, COUNT);
+	alloc->deallocate_array(b, COUNT);
+	alloc->deallocate_array(a, COUNT);
+	alloc->deallocate_array(soa, COUNT * 16);
+}
+
+// NOTE: Drops clean pages of the file so the next read goes to the device.
+// Only Linux exposes this without privileges, elsewhere every pass is warm.
+static void read_batch_evict(const char8_t* path) {
+#if EDGE_PLATFORM_POSIX
+	const int fd = open(reinterpret_cast<const char*>(path), O_RDONLY);
+	if (fd >= 0) {
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+#else
+	(void)path;
+#endif
+}
+
+static void run_bench_read_batch(edge::NotNull<const edge::Allocator*> alloc) {
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+	using edge::filesystem::ReadRequest;
+
+	// NOTE: The assets tree is tiny, a generated set with the startup mix of
+	// small shaders, technique files and a few larger blobs pads it out.
+	constexpr usize GENERATED_COUNT = 512;
+	constexpr usize MAX_FILES = GENERATED_COUNT + 16;
+	constexpr usize PATH_CAPACITY = 128;
+	const char* asset_files[] = {
+		"shaders/fullscreen.slang", "shaders/fullscreen.h", "shaders/fullscreen.technique.yaml",
+		"shaders/imgui.technique.yaml", "shaders/example.technique.yaml", "fonts/materialdesignicons-webfont.ttf",
+		"fonts/IconsMaterialDesignIcons.h", "images/Poliigon_BrickWallReclaimed_8320_BaseColor.jpg"
+	};
+	const char* asset_roots[] = { "assets", "../assets", "../../assets", "../../../assets" };
+
+	char8_t* paths = static_cast<char8_t*>(alloc->malloc(MAX_FILES * PATH_CAPACITY, 1));
+	ReadRequest* requests = alloc->allocate_array<ReadRequest>(MAX_FILES);
+	usize file_count = 0;
+	usize asset_count = 0;
+
+	for (const char* root : asset_roots) {
+		if (!edge::filesystem::directory_exists(reinterpret_cast<const char8_t*>(root))) {
+			continue;
+		}
+		for (const char* file : asset_files) {
+			char8_t* path = paths + file_count * PATH_CAPACITY;
+			snprintf(reinterpret_cast<char*>(path), PATH_CAPACITY, "%s/%s", root, file);
+			if (edge::filesystem::file_exists(path)) {
+				++file_count;
+				++asset_count;
+			}
+		}
+		break;
+	}
+
+	edge::filesystem::create_directory(u8"edge_read_batch_bench");
+	edge::RngPCG rng = {};
+	u8* contents = static_cast<u8*>(alloc->malloc(256 * 1024, 16));
+	for (usize i = 0; i < 256 * 1024; ++i) {
+		contents[i] = static_cast<u8>(rng.next32());
+	}
+	usize total_bytes = 0;
+	for (usize i = 0; i < GENERATED_COUNT; ++i) {
+		char8_t* path = paths + file_count * PATH_CAPACITY;
+		snprintf(reinterpret_cast<char*>(path), PATH_CAPACITY, "edge_read_batch_bench/file_%03zu.bin", i);
+		const usize size = i % 64 == 0 ? 64 * 1024 + rng.next32() % (192 * 1024) : 256 + rng.next32() % (24 * 1024);
+		edge::filesystem::IFile* file = edge::filesystem::open_native_file(alloc, path, AccessModeFlags{ AccessMode::Write } | AccessMode::Create | AccessMode::Truncate);
+		if (!file) {
+			continue;
+		}
+		file->write_at(0, contents, size);
+		alloc->deallocate(file);
+		++file_count;
+	}
+	for (usize i = 0; i < file_count; ++i) {
+		total_bytes += static_cast<usize>(edge::filesystem::file_size(paths + i * PATH_CAPACITY));
+	}
+
+	edge::Arena arena = {};
+	arena.create(64 * 1024 * 1024);
+
+	auto sequential = [&]() {
+		arena.reset();
+		usize loaded = 0;
+		for (usize i = 0; i < file_count; ++i) {
+			edge::filesystem::IFile* file = edge::filesystem::open_native_file(alloc, paths + i * PATH_CAPACITY, AccessModeFlags{ AccessMode::Read });
+			if (!file) {
+				continue;
+			}
+			const usize size = static_cast<usize>(file->size());
+			void* buffer = arena.alloc(size);
+			loaded += file->read_at(0, buffer, size) == size;
+			alloc->deallocate(file);
+		}
+		return loaded;
+	};
+	auto batched = [&]() {
+		arena.reset();
+		for (usize i = 0; i < file_count; ++i) {
+			requests[i] = { .path = paths + i * PATH_CAPACITY };
+		}
+		return edge::filesystem::read_batch(alloc, edge::Span<ReadRequest>{ requests, file_count }, &arena);
+	};
+	auto evict = [&]() {
+		for (usize i = 0; i < file_count; ++i) {
+			read_batch_evict(paths + i * PATH_CAPACITY);
+		}
+	};
+
+	printf("\n==============================================================");
+	printf("\n================ Batched file reads (us/load) ================");
+	printf("\n==============================================================\n");
+	printf("files: %zu (%zu from assets), %.2f MiB\n", file_count, asset_count, total_bytes / (1024.0 * 1024.0));
+	printf("%-16s %12s %12s %11s\n", "case", "sequential", "batch", "speedup");
+
+	constexpr usize ROUNDS = 8;
+	usize sink = 0;
+	f64 cold_sequential_ns = 0.0;
+	f64 cold_batch_ns = 0.0;
+	for (usize round = 0; round < ROUNDS; ++round) {
+		evict();
+		cold_sequential_ns += measure_ns_per_op(ROUNDS, [&]() { sink += sequential(); });
+		evict();
+		cold_batch_ns += measure_ns_per_op(ROUNDS, [&]() { sink += batched(); });
+	}
+	printf("%-16s %12.1f %12.1f %10.2fx\n", "cold", cold_sequential_ns / 1e3, cold_batch_ns / 1e3, cold_sequential_ns / cold_batch_ns);
+
+	const f64 warm_sequential_ns = measure_ns_per_op(ROUNDS, [&]() {
+		for (usize round = 0; round < ROUNDS; ++round) {
+			sink += sequential();
+		}
+	});
+	const f64 warm_batch_ns = measure_ns_per_op(ROUNDS, [&]() {
+		for (usize round = 0; round < ROUNDS; ++round) {
+			sink += batched();
+		}
+	});
+	printf("%-16s %12.1f %12.1f %10.2fx\n", "warm", warm_sequential_ns / 1e3, warm_batch_ns / 1e3, warm_sequential_ns / warm_batch_ns);
+	printf("sink: %zu\n", sink);
+
+	for (usize i = asset_count; i < file_count; ++i) {
+		edge::filesystem::remove_file(paths + i * PATH_CAPACITY);
+	}
+	edge::filesystem::remove_directory(u8"edge_read_batch_bench");
+
+	arena.destroy();
+	alloc->free(contents);
+	alloc->deallocate_array(requests, MAX_FILES);
+	alloc->free(paths);
+}
+
+static void run_bench_archive_mount(edge::NotNull<const edge::Allocator*> alloc) {
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+
+	constexpr usize FILE_COUNT = 10000;
+	constexpr usize PATH_CAPACITY = 64;
+	constexpr usize MAX_FILE_SIZE = 4096;
+
+	char8_t* paths = static_cast<char8_t*>(alloc->malloc(FILE_COUNT * PATH_CAPACITY, 1));
+	u8* contents = static_cast<u8*>(alloc->malloc(MAX_FILE_SIZE, 16));
+	edge::RngPCG rng = {};
+	for (usize i = 0; i < MAX_FILE_SIZE; ++i) {
+		contents[i] = static_cast<u8>(rng.next32());
+	}
+
+	// NOTE: The same tree is written loose and as a ustar pack next to it
+	edge::filesystem::create_directories(u8"edge_archive_bench/loose/assets");
+	edge::filesystem::IFile* pack = edge::filesystem::open_native_file(alloc, u8"edge_archive_bench/assets.tar", AccessModeFlags{ AccessMode::Write } | AccessMode::Create | AccessMode::Truncate);
+	u64 pack_offset = 0;
+	usize total_bytes = 0;
+	for (usize i = 0; i < FILE_COUNT; ++i) {
+		char8_t* path = paths + i * PATH_CAPACITY;
+		snprintf(reinterpret_cast<char*>(path), PATH_CAPACITY, "assets/dir_%02zu/asset_%05zu.bin", i % 64, i);
+		const usize size = 64 + rng.next32() % (MAX_FILE_SIZE - 64);
+		total_bytes += size;
+
+		char loose_path[PATH_CAPACITY * 2];
+		snprintf(loose_path, sizeof(loose_path), "edge_archive_bench/loose/assets/dir_%02zu", i % 64);
+		edge::filesystem::create_directory(reinterpret_cast<const char8_t*>(loose_path));
+		snprintf(loose_path, sizeof(loose_path), "edge_archive_bench/loose/%s", reinterpret_cast<const char*>(path));
+		edge::filesystem::IFile* file = edge::filesystem::open_native_file(alloc, reinterpret_cast<const char8_t*>(loose_path), AccessModeFlags{ AccessMode::Write } | AccessMode::Create | AccessMode::Truncate);
+		if (file) {
+			file->write_at(0, contents, size);
+			alloc->deallocate(file);
+		}
+
+		u8 header[512] = {};
+		memcpy(header, path, strlen(reinterpret_cast<const char*>(path)));
+		memcpy(header + 100, "0000644", 7);
+		snprintf(reinterpret_cast<char*>(header + 124), 12, "%011o", static_cast<u32>(size));
+		header[156] = '0';
+		memcpy(header + 257, "ustar", 6);
+		memcpy(header + 263, "00", 2);
+		memset(header + 148, ' ', 8);
+		u32 checksum = 0;
+		for (u8 byte : header) {
+			checksum += byte;
+		}
+		snprintf(reinterpret_cast<char*>(header + 148), 8, "%06o", checksum);
+		pack->write_at(pack_offset, header, sizeof(header));
+		pack->write_at(pack_offset + sizeof(header), contents, size);
+		pack_offset += sizeof(header) + ((size + 511) & ~usize{ 511 });
+	}
+	const u8 end_blocks[1024] = {};
+	pack->write_at(pack_offset, end_blocks, sizeof(end_blocks));
+	alloc->deallocate(pack);
+
+	edge::filesystem::Filesystem loose = {};
+	loose.create(alloc);
+	loose.mount(alloc, u8"assets", edge::filesystem::create_native_filesystem(alloc, u8"edge_archive_bench/loose/assets"));
+
+	edge::filesystem::Filesystem packed = {};
+	packed.create(alloc);
+	const f64 mount_ns = measure_ns_per_op(FILE_COUNT, [&]() {
+		packed.mount(alloc, u8"", edge::filesystem::create_tar_filesystem(alloc, u8"edge_archive_bench/assets.tar"));
+	});
+
+	u8* buffer = static_cast<u8*>(alloc->malloc(MAX_FILE_SIZE, 16));
+	usize sink = 0;
+	auto load_all = [&](const edge::filesystem::Filesystem& fs) {
+		for (usize i = 0; i < FILE_COUNT; ++i) {
+			edge::filesystem::IFile* file = fs.open_file(alloc, paths + i * PATH_CAPACITY, AccessModeFlags{ AccessMode::Read });
+			if (!file) {
+				continue;
+			}
+			sink += file->read_at(0, buffer, static_cast<usize>(file->size()));
+			alloc->deallocate(file);
+		}
+	};
+
+	load_all(loose);
+	load_all(packed);
+	const f64 loose_ns = measure_ns_per_op(FILE_COUNT, [&]() { load_all(loose); });
+	const f64 packed_ns = measure_ns_per_op(FILE_COUNT, [&]() { load_all(packed); });
+
+	printf("\n==============================================================");
+	printf("\n============ Loose vs packed open+read (ns/file) =============");
+	printf("\n==============================================================\n");
+	printf("files: %zu, %.2f MiB, pack index build %.1f ns/entry\n", FILE_COUNT, total_bytes / (1024.0 * 1024.0), mount_ns);
+	printf("%-16s %12s %12s %11s\n", "case", "loose", "tar mount", "speedup");
+	printf("%-16s %12.1f %12.1f %10.2fx\n", "open+read", loose_ns, packed_ns, loose_ns / packed_ns);
+	printf("sink: %zu\n", sink);
+
+	packed.destroy(alloc);
+	loose.destroy(alloc);
+	for (usize i = 0; i < FILE_COUNT; ++i) {
+		char loose_path[PATH_CAPACITY * 2];
+		snprintf(loose_path, sizeof(loose_path), "edge_archive_bench/loose/%s", reinterpret_cast<const char*>(paths + i * PATH_CAPACITY));
+		edge::filesystem::remove_file(reinterpret_cast<const char8_t*>(loose_path));
+	}
+	for (usize i = 0; i < 64; ++i) {
+		char loose_path[PATH_CAPACITY * 2];
+		snprintf(loose_path, sizeof(loose_path), "edge_archive_bench/loose/assets/dir_%02zu", i);
+		edge::filesystem::remove_directory(reinterpret_cast<const char8_t*>(loose_path));
+	}
+	edge::filesystem::remove_directory(u8"edge_archive_bench/loose/assets");
+	edge::filesystem::remove_directory(u8"edge_archive_bench/loose");
+	edge::filesystem::remove_file(u8"edge_archive_bench/assets.tar");
+	edge::filesystem::remove_directory(u8"edge_archive_bench");
+
+	alloc->free(buffer);
+	alloc->free(contents);
+	alloc->free(paths);
+}
+
+#if EDGE_PLATFORM_POSIX
+// NOTE: What a plain recursive glob does, readdir plus one stat per entry on
+// the joined path.
+static void walk_bench_readdir_stat(const char* path, usize& entries) {
+	DIR* dir = opendir(path);
+	if (!dir) {
+		return;
+	}
+	while (const dirent* record = readdir(dir)) {
+		if (strcmp(record->d_name, ".") == 0 || strcmp(record->d_name, "..") == 0) {
+			continue;
+		}
+		char child[512];
+		snprintf(child, sizeof(child), "%s/%s", path, record->d_name);
+		struct stat st;
+		if (stat(child, &st) != 0) {
+			continue;
+		}
+		++entries;
+		if (S_ISDIR(st.st_mode)) {
+			walk_bench_readdir_stat(child, entries);
+		}
+	}
+	closedir(dir);
+}
+#endif
+
+static void run_bench_walk(edge::NotNull<const edge::Allocator*> alloc) {
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+	using edge::filesystem::WalkFlag;
+	using edge::filesystem::WalkFlags;
+
+	constexpr usize DIRECTORY_COUNT = 32;
+	constexpr usize SUBDIRECTORY_COUNT = 8;
+	constexpr usize FILES_PER_DIRECTORY = 64;
+	constexpr usize ENTRY_COUNT = DIRECTORY_COUNT * (1 + SUBDIRECTORY_COUNT * (1 + FILES_PER_DIRECTORY));
+
+	edge::Scheduler* sched = edge::Scheduler::create(alloc);
+	if (!sched) {
+		return;
+	}
+
+	char path[256];
+	for (usize d = 0; d < DIRECTORY_COUNT; ++d) {
+		for (usize s = 0; s < SUBDIRECTORY_COUNT; ++s) {
+			snprintf(path, sizeof(path), "edge_walk_bench/dir_%02zu/sub_%02zu", d, s);
+			edge::filesystem::create_directories(reinterpret_cast<const char8_t*>(path));
+			for (usize f = 0; f < FILES_PER_DIRECTORY; ++f) {
+				snprintf(path, sizeof(path), "edge_walk_bench/dir_%02zu/sub_%02zu/asset_%03zu.bin", d, s, f);
+				edge::filesystem::IFile* file = edge::filesystem::open_native_file(alloc, reinterpret_cast<const char8_t*>(path), AccessModeFlags{ AccessMode::Write } | AccessMode::Create);
+				if (file) {
+					file->write_at(0, path, f);
+					alloc->deallocate(file);
+				}
+			}
+		}
+	}
+
+	std::atomic<usize> visited = 0;
+	auto count = edge::filesystem::WalkCallback::create(alloc, [&visited](const edge::filesystem::WalkEntry&) {
+		visited.fetch_add(1, std::memory_order_relaxed);
+	});
+	auto walk = [&](const WalkFlags flags, edge::Scheduler* walk_sched) {
+		edge::filesystem::walk(alloc, u8"edge_walk_bench", {}, count, flags, walk_sched);
+	};
+	const WalkFlags metadata = WalkFlags{ WalkFlag::Recursive } | WalkFlag::Metadata;
+
+	edge::filesystem::WalkSnapshot snapshot = {};
+	snapshot.capture(alloc, u8"edge_walk_bench", {}, sched);
+	usize changes = 0;
+	auto on_change = edge::filesystem::WalkChangeCallback::create(alloc, [&changes](edge::filesystem::WalkChange, const edge::filesystem::WalkEntry&) {
+		++changes;
+	});
+
+	printf("\n==============================================================");
+	printf("\n=================== Directory walk (ns/entry) ================");
+	printf("\n==============================================================\n");
+	printf("entries: %zu, background workers: %zu\n", ENTRY_COUNT, sched->background_threads.size());
+	printf("%-28s %12s\n", "case", "ns/entry");
+
+#if EDGE_PLATFORM_POSIX
+	usize readdir_entries = 0;
+	walk_bench_readdir_stat("edge_walk_bench", readdir_entries);
+	readdir_entries = 0;
+	printf("%-28s %12.1f\n", "readdir + stat", measure_ns_per_op(ENTRY_COUNT, [&]() { walk_bench_readdir_stat("edge_walk_bench", readdir_entries); }));
+#endif
+	printf("%-28s %12.1f\n", "walk, listing types", measure_ns_per_op(ENTRY_COUNT, [&]() { walk(WalkFlags{ WalkFlag::Recursive }, nullptr); }));
+	printf("%-28s %12.1f\n", "walk, metadata", measure_ns_per_op(ENTRY_COUNT, [&]() { walk(metadata, nullptr); }));
+	printf("%-28s %12.1f\n", "walk, listing types, jobs", measure_ns_per_op(ENTRY_COUNT, [&]() { walk(WalkFlags{ WalkFlag::Recursive }, sched); }));
+	printf("%-28s %12.1f\n", "walk, metadata, jobs", measure_ns_per_op(ENTRY_COUNT, [&]() { walk(metadata, sched); }));
+	printf("%-28s %12.1f\n", "snapshot rescan, jobs", measure_ns_per_op(ENTRY_COUNT, [&]() { snapshot.rescan(alloc, u8"edge_walk_bench", on_change, {}, sched); }));
+	printf("visited: %zu, changes: %zu\n", visited.load(), changes);
+
+	on_change.destroy(alloc);
+	snapshot.destroy(alloc);
+	count.destroy(alloc);
+
+	for (usize d = 0; d < DIRECTORY_COUNT; ++d) {
+		for (usize s = 0; s < SUBDIRECTORY_COUNT; ++s) {
+			for (usize f = 0; f < FILES_PER_DIRECTORY; ++f) {
+				snprintf(path, sizeof(path), "edge_walk_bench/dir_%02zu/sub_%02zu/asset_%03zu.bin", d, s, f);
+				edge::filesystem::remove_file(reinterpret_cast<const char8_t*>(path));
+			}
+			snprintf(path, sizeof(path), "edge_walk_bench/dir_%02zu/sub_%02zu", d, s);
+			edge::filesystem::remove_directory(reinterpret_cast<const char8_t*>(path));
+		}
+		snprintf(path, sizeof(path), "edge_walk_bench/dir_%02zu", d);
+		edge::filesystem::remove_directory(reinterpret_cast<const char8_t*>(path));
+	}
+	edge::filesystem::remove_directory(u8"edge_walk_bench");
+
+	edge::Scheduler::destroy(alloc, sched);
+}
+
+static void run_bench_watch(edge::NotNull<const edge::Allocator*> alloc) {
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+
+	constexpr usize FILE_COUNT = 2000;
+	constexpr usize FRAME_COUNT = 200;
+	constexpr usize PATH_CAPACITY = 64;
+
+	edge::filesystem::Watcher watcher = {};
+	if (!watcher.create(alloc, 0)) {
+		return;
+	}
+
+	char8_t* paths = static_cast<char8_t*>(alloc->malloc(FILE_COUNT * PATH_CAPACITY, 1));
+	i64* sizes = alloc->allocate_array<i64>(FILE_COUNT);
+	edge::filesystem::create_directory(u8"edge_watch_bench");
+	for (usize i = 0; i < FILE_COUNT; ++i) {
+		char8_t* path = paths + i * PATH_CAPACITY;
+		snprintf(reinterpret_cast<char*>(path), PATH_CAPACITY, "edge_watch_bench/asset_%04zu.bin", i);
+		edge::filesystem::IFile* file = edge::filesystem::open_native_file(alloc, path, AccessModeFlags{ AccessMode::Write } | AccessMode::Create);
+		if (file) {
+			file->write_at(0, path, 16);
+			alloc->deallocate(file);
+		}
+	}
+	watcher.add(alloc, u8"edge_watch_bench");
+
+	// NOTE: The polling baseline is what hot reload does today, one size query
+	// per tracked file every frame.
+	usize changed = 0;
+	const f64 polling_ns = measure_ns_per_op(FRAME_COUNT, [&]() {
+		for (usize frame = 0; frame < FRAME_COUNT; ++frame) {
+			for (usize i = 0; i < FILE_COUNT; ++i) {
+				const i64 size = edge::filesystem::file_size(paths + i * PATH_CAPACITY);
+				changed += size != sizes[i] ? 1 : 0;
+				sizes[i] = size;
+			}
+		}
+	});
+	const f64 idle_ns = measure_ns_per_op(FRAME_COUNT, [&]() {
+		for (usize frame = 0; frame < FRAME_COUNT; ++frame) {
+			changed += watcher.poll(alloc).size();
+		}
+	});
+	const f64 touched_ns = measure_ns_per_op(FRAME_COUNT, [&]() {
+		for (usize frame = 0; frame < FRAME_COUNT; ++frame) {
+			const char8_t* path = paths + (frame % FILE_COUNT) * PATH_CAPACITY;
+			edge::filesystem::IFile* file = edge::filesystem::open_native_file(alloc, path, AccessModeFlags{ AccessMode::Write });
+			if (file) {
+				file->write_at(0, &frame, sizeof(frame));
+				alloc->deallocate(file);
+			}
+			changed += watcher.poll(alloc).size();
+		}
+	});
+
+	printf("\n==============================================================");
+	printf("\n================= Change detection (us/frame) ================");
+	printf("\n==============================================================\n");
+	printf("tracked files: %zu\n", FILE_COUNT);
+	printf("%-28s %12s\n", "case", "us/frame");
+	printf("%-28s %12.2f\n", "file_size polling", polling_ns / 1000.0);
+	printf("%-28s %12.2f\n", "watcher poll, idle", idle_ns / 1000.0);
+	printf("%-28s %12.2f\n", "write + watcher poll", touched_ns / 1000.0);
+	printf("changes: %zu\n", changed);
+
+	watcher.destroy(alloc);
+	for (usize i = 0; i < FILE_COUNT; ++i) {
+		edge::filesystem::remove_file(paths + i * PATH_CAPACITY);
+	}
+	edge::filesystem::remove_directory(u8"edge_watch_bench");
+	alloc->deallocate_array(sizes, FILE_COUNT);
+	alloc->free(paths);
+}
+
+static void run_bench_handle_pool_occupancy(edge::NotNull<const edge::Allocator*> alloc, u32 slot_count, u32 occupancy_percent) {
+	const u32 live_count = static_cast<u32>(static_cast<u64>(slot_count) * occupancy_percent / 100);
+
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x5EED);
+
+	edge::HandlePool<u64> pool = {};
+	pool.create(alloc, slot_count);
+
+	edge::Handle* handles = alloc->allocate_array<edge::Handle>(slot_count);
+	for (u32 i = 0; i < slot_count; ++i) {
+		handles[i] = pool.allocate_with_data(alloc, i);
+	}
+
+	// Free a random subset so the survivors are scattered over the slots
+	edge::rng_shuffle(rng, handles, slot_count);
+	for (u32 i = live_count; i < slot_count; ++i) {
+		pool.free(handles[i]);
+	}
+
+	// Fixed capacity layout scanned slot by slot, what iteration used to cost
+	u64* flat_values = alloc->allocate_array<u64>(slot_count);
+	u8* flat_alive = alloc->allocate_array<u8>(slot_count);
+	memset(flat_alive, 0, slot_count);
+	for (u32 i = 0; i < live_count; ++i) {
+		flat_alive[handles[i].index] = 1;
+		flat_values[handles[i].index] = *pool.get(handles[i]);
+	}
+
+	u64 sink = 0;
+	const f64 iterate_ns = measure_ns_per_op(live_count, [&]() { for (auto entry : pool) sink += *entry.element; });
+	const f64 scan_ns = measure_ns_per_op(live_count, [&]() {
+		for (u32 i = 0; i < slot_count; ++i) {
+			if (flat_alive[i]) sink += flat_values[i];
+		}
+	});
+	const f64 get_ns = measure_ns_per_op(live_count, [&]() { for (u32 i = 0; i < live_count; ++i) sink += *pool.get(handles[i]); });
+	const f64 churn_ns = measure_ns_per_op(live_count, [&]() {
+		for (u32 i = 0; i < live_count; ++i) {
+			pool.free(handles[i]);
+			handles[i] = pool.allocate_with_data(alloc, i);
+		}
+	});
+
+	printf("%3u%% %12.2f %12.2f %12.2f %12.2f\n", occupancy_percent, iterate_ns, scan_ns, get_ns, churn_ns);
+	printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+
+	alloc->deallocate_array(flat_alive, slot_count);
+	alloc->deallocate_array(flat_values, slot_count);
+	alloc->deallocate_array(handles, slot_count);
+	pool.destroy(alloc);
+}
+
+static void run_bench_handle_pool(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr u32 SLOT_COUNT = 1u << 19;
+
+	printf("\n==============================================================");
+	printf("\n================ HandlePool (512K slots, ns/op) ==============");
+	printf("\n==============================================================\n");
+	printf("%4s %12s %12s %12s %12s\n", "occ", "iterate", "slot scan", "get", "churn");
+
+	run_bench_handle_pool_occupancy(alloc, SLOT_COUNT, 10);
+	run_bench_handle_pool_occupancy(alloc, SLOT_COUNT, 90);
+}
+
+template<bool Pooled>
+static void run_bench_list_ops(edge::NotNull<const edge::Allocator*> alloc, const u64* values, usize count, f64* out_ns) {
+	edge::List<u64, Pooled> list;
+	u64 sink = 0;
+
+	out_ns[0] = measure_ns_per_op(count, [&]() { for (usize i = 0; i < count; ++i) list.push_back(alloc, values[i]); });
+	out_ns[1] = measure_ns_per_op(count, [&]() { for (u64 value : list) sink += value; });
+	out_ns[2] = measure_ns_per_op(count, [&]() { list.sort([](const u64& a, const u64& b) -> i32 { return a < b ? -1 : a > b; }); });
+	out_ns[3] = measure_ns_per_op(count, [&]() { for (u64 value : list) sink += value; });
+	out_ns[4] = measure_ns_per_op(count / 2, [&]() {
+		edge::ListNode<u64>* node = list.m_head;
+		while (node && node->next) {
+			edge::ListNode<u64>* next = node->next->next;
+			list.erase(alloc, node->next);
+			node = next;
+		}
+	});
+
+	printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+	list.destroy(alloc);
+}
+
+struct BenchListItem {
+	u64 value;
+	edge::IntrusiveListNode node;
+};
+
+static void run_bench_list(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize COUNT = 1000000;
+
+	u64* values = alloc->allocate_array<u64>(COUNT);
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x1157);
+	for (usize i = 0; i < COUNT; ++i) {
+		values[i] = rng.next64();
+	}
+
+	f64 list_ns[5] = {}, pooled_ns[5] = {}, std_ns[5] = {}, intrusive_ns[5] = {};
+	// Pooled first, large chunk allocations get slow on a heap left holding a
+	// million freshly freed nodes
+	run_bench_list_ops<true>(alloc, values, COUNT, pooled_ns);
+	run_bench_list_ops<false>(alloc, values, COUNT, list_ns);
+
+	{
+		std::list<u64> list;
+		u64 sink = 0;
+		std_ns[0] = measure_ns_per_op(COUNT, [&]() { for (usize i = 0; i < COUNT; ++i) list.push_back(values[i]); });
+		std_ns[1] = measure_ns_per_op(COUNT, [&]() { for (u64 value : list) sink += value; });
+		std_ns[2] = measure_ns_per_op(COUNT, [&]() { list.sort(); });
+		std_ns[3] = measure_ns_per_op(COUNT, [&]() { for (u64 value : list) sink += value; });
+		std_ns[4] = measure_ns_per_op(COUNT / 2, [&]() {
+			auto it = list.begin();
+			while (it != list.end() && std::next(it) != list.end()) {
+				it = list.erase(std::next(it));
+			}
+		});
+		printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+	}
+
+	// Owners live in one array, linking them costs no allocation at all
+	{
+		BenchListItem* items = alloc->allocate_array<BenchListItem>(COUNT);
+		edge::IntrusiveList<BenchListItem, &BenchListItem::node> list;
+		u64 sink = 0;
+		intrusive_ns[0] = measure_ns_per_op(COUNT, [&]() {
+			for (usize i = 0; i < COUNT; ++i) {
+				items[i].value = values[i];
+				list.push_back(&items[i]);
+			}
+		});
+		intrusive_ns[1] = measure_ns_per_op(COUNT, [&]() { for (BenchListItem& item : list) sink += item.value; });
+		intrusive_ns[4] = measure_ns_per_op(COUNT / 2, [&]() { for (usize i = 1; i < COUNT; i += 2) list.remove(&items[i]); });
+		printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+		list.clear();
+		alloc->deallocate_array(items, COUNT);
+	}
+
+	printf("\n==============================================================");
+	printf("\n=================== List (1M u64, ns/op) =====================");
+	printf("\n==============================================================\n");
+	printf("%-20s %12s %12s %12s %12s\n", "operation", "List", "PooledList", "std::list", "Intrusive");
+
+	const char* names[5] = { "push_back", "iterate", "sort", "iterate sorted", "erase half" };
+	for (usize i = 0; i < 5; ++i) {
+		printf("%-20s %12.2f %12.2f %12.2f", names[i], list_ns[i], pooled_ns[i], std_ns[i]);
+		// Intrusive lists are not sorted in place, those rows stay empty
+		intrusive_ns[i] > 0.0 ? printf(" %12.2f\n", intrusive_ns[i]) : printf(" %12s\n", "-");
+	}
+
+	alloc->deallocate_array(values, COUNT);
+}
+
+// FIFO with a fixed number of queued items, the way event and pending destroy
+// queues are used
+static void run_bench_deque_fifo(edge::NotNull<const edge::Allocator*> alloc, usize queued, usize op_count) {
+	u64 sink = 0;
+
+	edge::Deque<u64> deque;
+	edge::Array<u64> array;
+	std::deque<u64> std_deque;
+	for (usize i = 0; i < queued; ++i) {
+		deque.push_back(alloc, i);
+		array.push_back(alloc, i);
+		std_deque.push_back(i);
+	}
+
+	const f64 deque_ns = measure_ns_per_op(op_count, [&]() {
+		for (usize i = 0; i < op_count; ++i) {
+			u64 value;
+			deque.pop_front(&value);
+			deque.push_back(alloc, value + i);
+			sink += value;
+		}
+	});
+	const f64 array_ns = measure_ns_per_op(op_count, [&]() {
+		for (usize i = 0; i < op_count; ++i) {
+			u64 value;
+			array.remove(0, &value);
+			array.push_back(alloc, value + i);
+			sink += value;
+		}
+	});
+	const f64 std_ns = measure_ns_per_op(op_count, [&]() {
+		for (usize i = 0; i < op_count; ++i) {
+			const u64 value = std_deque.front();
+			std_deque.pop_front();
+			std_deque.push_back(value + i);
+			sink += value;
+		}
+	});
+
+	printf("%-20zu %12.2f %12.2f %12.2f\n", queued, deque_ns, array_ns, std_ns);
+	printf("sink: %llu\n", static_cast<unsigned long long>(sink));
+
+	deque.destroy(alloc);
+	array.destroy(alloc);
+}
+
+static void run_bench_deque(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize OP_COUNT = 1000000;
+
+	printf("\n==============================================================");
+	printf("\n=============== Deque FIFO pop/push (1M, ns/op) ==============");
+	printf("\n==============================================================\n");
+	printf("%-20s %12s %12s %12s\n", "queued", "Deque", "Array", "std::deque");
+
+	run_bench_deque_fifo(alloc, 64, OP_COUNT);
+	run_bench_deque_fifo(alloc, 1024, OP_COUNT);
+	run_bench_deque_fifo(alloc, 16384, OP_COUNT / 16);
+
+	// Bulk transfer through the two contiguous runs
+	edge::Deque<u64> deque;
+	u64* batch = alloc->allocate_array<u64>(256);
+	for (usize i = 0; i < 256; ++i) {
+		batch[i] = i;
+	}
+	deque.push_back_range(alloc, batch, 100);
+
+	const f64 batch_ns = measure_ns_per_op(OP_COUNT / 256 * 256, [&]() {
+		for (usize i = 0; i < OP_COUNT / 256; ++i) {
+			deque.push_back_range(alloc, batch, 256);
+			deque.pop_front_range(batch, 256);
+		}
+	});
+	printf("%-20s %12.2f\n", "batch of 256", batch_ns);
+
+	alloc->deallocate_array(batch, 256);
+	deque.destroy(alloc);
+}
+
+struct SortBenchItem {
+	u32 key;
+	u32 value;
+};
+
+static void run_bench_sort_size(edge::NotNull<const edge::Allocator*> alloc, edge::NotNull<edge::Scheduler*> sched, usize count) {
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x50D7);
+
+	u32* source = alloc->allocate_array<u32>(count);
+	u32* keys = alloc->allocate_array<u32>(count);
+	SortBenchItem* items = alloc->allocate_array<SortBenchItem>(count);
+	for (usize i = 0; i < count; ++i) {
+		source[i] = static_cast<u32>(rng.next64());
+	}
+
+	auto key_of = [](const SortBenchItem& item) { return item.key; };
+	auto less = [](const SortBenchItem& a, const SortBenchItem& b) { return a.key < b.key; };
+
+	// Each run sorts a fresh copy of the same keys, reports ms for u32 keys
+	// and for 8 byte items sorted by key
+	auto run = [&](const char* name, auto&& sort_keys, auto&& sort_items) {
+		memcpy(keys, source, sizeof(u32) * count);
+		const f64 keys_ms = measure_ns_per_op(1000000, [&]() { sort_keys(); });
+
+		for (usize i = 0; i < count; ++i) {
+			items[i] = { source[i], static_cast<u32>(i) };
+		}
+		const f64 items_ms = measure_ns_per_op(1000000, [&]() { sort_items(); });
+
+		const bool sorted = std::is_sorted(keys, keys + count) && std::is_sorted(items, items + count, less);
+		printf("%-24s %12.2f %12.2f %s\n", name, keys_ms, items_ms, sorted ? "" : "NOT SORTED");
+	};
+
+	printf("%zu keys\n", count);
+	run("std::sort",
+		[&]() { std::sort(keys, keys + count); },
+		[&]() { std::sort(items, items + count, less); });
+	run("std::stable_sort",
+		[&]() { std::stable_sort(keys, keys + count); },
+		[&]() { std::stable_sort(items, items + count, less); });
+	run("sort_merge",
+		[&]() { edge::sort_merge(alloc, edge::Span<u32>{ keys, count }); },
+		[&]() { edge::sort_merge(alloc, edge::Span<SortBenchItem>{ items, count }, less); });
+	run("sort_radix",
+		[&]() { edge::sort_radix(alloc, edge::Span<u32>{ keys, count }); },
+		[&]() { edge::sort_radix(alloc, edge::Span<SortBenchItem>{ items, count }, key_of); });
+	run("sort_merge_parallel",
+		[&]() { edge::sort_merge_parallel(alloc, sched, edge::Span<u32>{ keys, count }); },
+		[&]() { edge::sort_merge_parallel(alloc, sched, edge::Span<SortBenchItem>{ items, count }, less); });
+	run("sort_radix_parallel",
+		[&]() { edge::sort_radix_parallel(alloc, sched, edge::Span<u32>{ keys, count }); },
+		[&]() { edge::sort_radix_parallel(alloc, sched, edge::Span<SortBenchItem>{ items, count }, key_of); });
+
+	alloc->deallocate_array(items, count);
+	alloc->deallocate_array(keys, count);
+	alloc->deallocate_array(source, count);
+}
+
+static void run_bench_sort(edge::NotNull<const edge::Allocator*> alloc) {
+	edge::Scheduler* sched = edge::Scheduler::create(alloc);
+	if (!sched) {
+		return;
+	}
+
+	printf("\n==============================================================");
+	printf("\n======================= Sort (ms) ============================");
+	printf("\n==============================================================\n");
+	printf("%-24s %12s %12s\n", "algorithm", "u32 keys", "8 byte items");
+	printf("background workers: %zu\n", sched->background_threads.size());
+
+	run_bench_sort_size(alloc, sched, 1000000);
+	run_bench_sort_size(alloc, sched, 10000000);
+
+	edge::Scheduler::destroy(alloc, sched);
+}
+
+template<typename F>
+static void run_bench_job_callable_case(edge::NotNull<const edge::Allocator*> alloc, const char* name, usize job_count, F&& make_job) {
+	usize sink = 0;
+	const usize allocs_before = alloc->get_alloc_count();
+	const f64 ns = measure_ns_per_op(job_count, [&]() {
+		for (usize i = 0; i < job_count; ++i) {
+			edge::Callable<void()> job = edge::callable_create_from_lambda(alloc, make_job(i, &sink));
+			job.invoke();
+			job.destroy(alloc);
+		}
+	});
+	const usize allocs = alloc->get_alloc_count() - allocs_before;
+
+	printf("%-24s %14.2f %14.2f\n", name, static_cast<f64>(allocs) / job_count, ns);
+	printf("sink: %zu\n", sink);
+}
+
+// Job::from_lambda builds its Callable the same way, these are the capture
+// shapes scheduler jobs and event listeners use
+static void run_bench_job_callable(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr usize JOB_COUNT = 1000000;
+
+	printf("\n==============================================================");
+	printf("\n=============== Job Callable create/invoke (1M) ==============");
+	printf("\n==============================================================\n");
+	printf("%-24s %14s %14s\n", "capture", "allocs/job", "ns/job");
+
+	run_bench_job_callable_case(alloc, "pointer", JOB_COUNT, [](usize, usize* sink) {
+		return [sink]() { (*sink)++; };
+	});
+	run_bench_job_callable_case(alloc, "pointer + index", JOB_COUNT, [](usize i, usize* sink) {
+		return [sink, i]() { *sink += i; };
+	});
+	run_bench_job_callable_case(alloc, "5 words", JOB_COUNT, [](usize i, usize* sink) {
+		return [sink, a = i, b = i + 1, c = i + 2, d = i + 3]() { *sink += a + b + c + d; };
+	});
+	// Past the inline capacity, still pays one allocation like every job used to
+	run_bench_job_callable_case(alloc, "9 words (heap)", JOB_COUNT, [](usize i, usize* sink) {
+		u64 values[8] = { i, i, i, i, i, i, i, i };
+		return [sink, values]() { for (u64 value : values) *sink += value; };
+	});
+}
+
+struct ConcurrentBenchArgs {
+	edge::ConcurrentHashMap<u64, u64>* map;
+	const edge::Allocator* alloc;
+	std::atomic<bool>* start;
+	u64 seed;
+	u32 key_count;
+	u32 op_count;
+	u32 read_percent;
+	u32 insert_percent;
+};
+
+static i32 concurrent_bench_thread(void* arg) {
+	ConcurrentBenchArgs* args = (ConcurrentBenchArgs*)arg;
+
+	edge::RngPCG rng = {};
+	rng.seed(args->seed);
+
+	while (!args->start->load(std::memory_order_acquire)) {
+		edge::thread_yield();
+	}
+
+	u64 sink = 0;
+	for (u32 i = 0; i < args->op_count; ++i) {
+		u64 key = edge::rng_gen_u32_bounded(rng, args->key_count);
+		u32 op = edge::rng_gen_u32_bounded(rng, 100);
+
+		auto guard = args->map->pin();
+		if (op < args->read_percent) {
+			if (u64* value = args->map->find(guard, key)) {
+				sink += *value;
+			}
+		}
+		else if (op < args->read_percent + args->insert_percent) {
+			sink += *args->map->get_or_insert_with(args->alloc, guard, key, [key]() { return key; });
+		}
+		else {
+			args->map->remove(args->alloc, key);
+		}
+	}
+
+	return static_cast<i32>(sink & 1);
+}
+
+static void run_bench_concurrent_hashmap(edge::NotNull<const edge::Allocator*> alloc) {
+	constexpr u32 KEY_COUNT = 100000;
+	constexpr u32 OPS_PER_THREAD = 500000;
+	constexpr u32 MAX_THREADS = 32;
+
+	struct Workload {
+		const char* name;
+		u32 read_percent;
+		u32 insert_percent;
+	};
+
+	const Workload workloads[] = {
+		{ "read heavy (98/1/1)", 98, 1 },
+		{ "mixed (70/20/10)", 70, 20 },
+	};
+
+	printf("\n==============================================================");
+	printf("\n================= ConcurrentHashMap Benchmark ================");
+	printf("\n==============================================================\n");
+
+	for (const Workload& workload : workloads) {
+		printf("\n------ %s ------\n", workload.name);
+		printf("%8s %14s\n", "threads", "Mops/s");
+
+		for (u32 thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2) {
+			edge::ConcurrentHashMap<u64, u64> map = {};
+			map.create(alloc, 0, KEY_COUNT);
+
+			for (u64 key = 0; key < KEY_COUNT; key += 2) {
+				map.insert(alloc, key, key);
+			}
+
+			std::atomic<bool> start = false;
+			edge::Thread threads[MAX_THREADS];
+			ConcurrentBenchArgs args[MAX_THREADS];
+
+			for (u32 t = 0; t < thread_count; ++t) {
+				args[t] = { &map, alloc.m_ptr, &start, 0x1234 + t, KEY_COUNT, OPS_PER_THREAD,
+					workload.read_percent, workload.insert_percent };
+				edge::thread_create(&threads[t], concurrent_bench_thread, &args[t]);
+			}
+
+			auto begin = std::chrono::high_resolution_clock::now();
+			start.store(true, std::memory_order_release);
+
+			for (u32 t = 0; t < thread_count; ++t) {
+				edge::thread_join(threads[t]);
+			}
+
+			auto end = std::chrono::high_resolution_clock::now();
+			f64 seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / 1e9;
+			printf("%8u %14.2f\n", thread_count, (static_cast<f64>(OPS_PER_THREAD) * thread_count) / seconds / 1e6);
+
+			map.destroy(alloc);
+		}
+	}
+}
+
+struct LatencyStats {
+	f64 p50;
+	f64 p99;
+	f64 p999;
+	f64 max;
+};
+
+static LatencyStats compute_latency_stats(u64* samples, usize count) {
+	std::sort(samples, samples + count);
+	return LatencyStats{
+		.p50 = static_cast<f64>(samples[count / 2]),
+		.p99 = static_cast<f64>(samples[(count * 99) / 100]),
+		.p999 = static_cast<f64>(samples[(count * 999) / 1000]),
+		.max = static_cast<f64>(samples[count - 1])
+	};
+}
+
+template<typename AllocFn, typename FreeFn>
+static void run_bench_alloc_latency(const char* name, AllocFn&& alloc_fn, FreeFn&& free_fn) {
+	constexpr usize NUM_SLOTS = 4096;
+	constexpr usize NUM_OPERATIONS = 1000000;
+
+	static void* slots[NUM_SLOTS] = {};
+	static u64 alloc_samples[NUM_OPERATIONS] = {};
+	static u64 free_samples[NUM_OPERATIONS] = {};
+
+	edge::RngPCG rng = {};
+	rng.seed(0xC0FFEE);
+
+	usize alloc_count = 0;
+	usize free_count = 0;
+
+	for (usize i = 0; i < NUM_OPERATIONS; ++i) {
+		usize slot = edge::rng_gen_u32_bounded(rng, NUM_SLOTS);
+
+		if (slots[slot]) {
+			auto start = std::chrono::high_resolution_clock::now();
+			free_fn(slots[slot]);
+			auto end = std::chrono::high_resolution_clock::now();
+			free_samples[free_count++] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+			slots[slot] = nullptr;
+		}
+		else {
+			// Mostly small sizes with a long tail of large ones
+			u32 bucket = edge::rng_gen_u32_bounded(rng, 100);
+			usize size = bucket < 80 ? 8 + edge::rng_gen_u32_bounded(rng, 248)
+				: bucket < 98 ? 256 + edge::rng_gen_u32_bounded(rng, 4096)
+				: 16384 + edge::rng_gen_u32_bounded(rng, 262144);
+
+			auto start = std::chrono::high_resolution_clock::now();
+			void* ptr = alloc_fn(size);
+			auto end = std::chrono::high_resolution_clock::now();
+			alloc_samples[alloc_count++] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+			// Touch the memory so both allocators pay for page faults the same way
+			*static_cast<volatile u8*>(ptr) = 1;
+			slots[slot] = ptr;
+		}
+	}
+
+	for (usize i = 0; i < NUM_SLOTS; ++i) {
+		if (slots[i]) {
+			free_fn(slots[i]);
+			slots[i] = nullptr;
+		}
+	}
+
+	LatencyStats alloc_stats = compute_latency_stats(alloc_samples, alloc_count);
+	LatencyStats free_stats = compute_latency_stats(free_samples, free_count);
+
+	printf("\n------ %s ------\n", name);
+	printf("alloc (%zu):  p50 %6.0f ns  p99 %6.0f ns  p999 %6.0f ns  max %8.0f ns\n",
+		alloc_count, alloc_stats.p50, alloc_stats.p99, alloc_stats.p999, alloc_stats.max);
+	printf("free  (%zu):  p50 %6.0f ns  p99 %6.0f ns  p999 %6.0f ns  max %8.0f ns\n",
+		free_count, free_stats.p50, free_stats.p99, free_stats.p999, free_stats.max);
+}
+
+static void run_bench_tlsf() {
+	printf("\n==============================================================");
+	printf("\n================= Allocator Latency Benchmark ================");
+	printf("\n==============================================================\n");
+
+	edge::Tlsf tlsf = {};
+	// Commit the whole pool up front so growth does not show up in the tail
+	if (!tlsf.create(512 * 1024 * 1024, 512 * 1024 * 1024)) {
+		printf("Failed to create tlsf pool\n");
+		return;
+	}
+
+	run_bench_alloc_latency("Tlsf",
+		[&tlsf](usize size) { return tlsf.alloc_ex(size, 16); },
+		[&tlsf](void* ptr) { tlsf.free(ptr); });
+
+	edge::TlsfStats stats = tlsf.stats();
+	printf("free blocks: %zu, fragmentation: %.3f\n", stats.free_block_count, stats.fragmentation());
+	tlsf.destroy();
+
+	run_bench_alloc_latency("aligned_malloc",
+		[](usize size) { return edge::detail::aligned_malloc(size, 16); },
+		[](void* ptr) { edge::detail::aligned_free(ptr); });
+}
+
 int main(void) {
 	edge::Allocator alloc = edge::Allocator::create_tracking();
 
-	edge::RngPCGGen rng = {};
-	rng.set_seed(42);
+	edge::RngPCG rng = {};
+	rng.seed(42);
 
 	DatasetStorage words_dataset = {};
 	generate_dataset1(&alloc, words_dataset, DATASET_SIZE, rng);
 
 	run_bench(&alloc, words_dataset, DATASET_SIZE);
-	//run_bench_std(words_dataset, DATASET_SIZE);
+	run_bench_std(words_dataset, DATASET_SIZE);
+	run_bench_hashmap_ops(&alloc);
+	run_bench_hash(&alloc);
+	run_bench_utf8(&alloc);
+	run_bench_string_search(&alloc);
+	run_bench_format();
+	run_bench_random(&alloc);
+	run_bench_math(&alloc);
+	run_bench_read_batch(&alloc);
+	run_bench_archive_mount(&alloc);
+	run_bench_walk(&alloc);
+	run_bench_watch(&alloc);
+	run_bench_concurrent_hashmap(&alloc);
+	run_bench_handle_pool(&alloc);
+	run_bench_list(&alloc);
+	run_bench_deque(&alloc);
+	run_bench_sort(&alloc);
+	run_bench_job_callable(&alloc);
+
+	run_bench_tlsf();
 	
 	for (edge::string str : words_dataset) {
 		alloc.deallocate(str.data);
@@ -1,15 +1,31 @@
+#include <arena.hpp>
 #include <array.hpp>
 #include <buffer.hpp>
 #include <bitarray.hpp>
+#include <bitset.hpp>
+#include <callable.hpp>
+#include <free_index_list.hpp>
+#include <concurrent_hashmap.hpp>
+#include <deque.hpp>
+#include <filesystem.hpp>
+#include <format.hpp>
+#include <handle_pool.hpp>
 #include <hashmap.hpp>
+#include <intrusive_list.hpp>
 #include <list.hpp>
 #include <mpmc_queue.hpp>
 #include <string.hpp>
+#include <string_id.hpp>
+#include <small_array.hpp>
+#include <sort.hpp>
 #include <span.hpp>
+#include <tlsf.hpp>
 
 #include <json.hpp>
 
 #include <random.hpp>
+#include <scheduler.hpp>
+#include <simd_math.hpp>
 #include <threads.hpp>
 
 #include <cstdio>
@@ -183,6 +199,109 @@ TEST(array_remove) {
 	return 0;
 }
 
+TEST(array_virtual) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::Array<i32> arr;
+
+	for (i32 i = 0; i < 100; i++) {
+		arr.push_back(&alloc, i);
+	}
+
+	SHOULD_EQUAL(arr.reserve_virtual(&alloc, 1 << 20), true);
+	SHOULD_EQUAL(arr.is_virtual(), true);
+	// Heap block was released when the elements moved into the reservation
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+
+	const i32* first = arr.data();
+	for (i32 i = 100; i < 200000; i++) {
+		arr.push_back(&alloc, i);
+	}
+
+	// Growth commits pages in place, elements never move
+	SHOULD_EQUAL(arr.data(), first);
+	SHOULD_EQUAL(arr[99], 99);
+	SHOULD_EQUAL(arr[199999], 199999);
+
+	arr.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(string_sso) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	edge::String str;
+	SHOULD_EQUAL(str.from_utf8(&alloc, u8"assets/mesh.bin", 15), true);
+	// Short strings stay inside the object
+	SHOULD_EQUAL(str.is_inline(), true);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	SHOULD_EQUAL(str.length(), 15);
+
+	SHOULD_EQUAL(str.append(&alloc, u8"_lod0"), true);
+	SHOULD_EQUAL(str.is_inline(), true);
+	SHOULD_EQUAL(str.compare(u8"assets/mesh.bin_lod0"), 0);
+
+	SHOULD_EQUAL(str.append(&alloc, u8"_variant"), true);
+	SHOULD_EQUAL(str.is_inline(), false);
+	SHOULD_EQUAL(str.length(), 28);
+	SHOULD_EQUAL(str.compare(u8"assets/mesh.bin_lod0_variant"), 0);
+	SHOULD_EQUAL(str.data()[str.length()], u8'\0');
+
+	str.remove(0, 7);
+	SHOULD_EQUAL(str.compare(u8"mesh.bin_lod0_variant"), 0);
+
+	str.destroy(&alloc);
+	SHOULD_EQUAL(str.is_inline(), true);
+	SHOULD_EQUAL(str.empty(), true);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(string_id) {
+	constexpr edge::StringId mesh_id{ u8"mesh" };
+	static_assert(mesh_id.valid());
+
+	const edge::StringId interned = edge::string_id_intern(u8"mesh");
+	SHOULD_EQUAL(interned == mesh_id, true);
+	SHOULD_EQUAL(edge::string_id_name(mesh_id) == edge::StringView<char8_t>{ u8"mesh" }, true);
+
+	SHOULD_EQUAL(edge::string_id_intern(u8"texture") == mesh_id, false);
+	SHOULD_EQUAL(edge::StringId{}.valid(), false);
+	SHOULD_EQUAL(edge::string_id_name(edge::StringId{ u8"never_interned" }).empty(), true);
+	return 0;
+}
+
+TEST(small_array_basic) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::SmallArray<i32, 4> arr;
+
+	for (i32 i = 0; i < 4; i++) {
+		arr.push_back(&alloc, i);
+	}
+
+	// Fits inline, nothing allocated yet
+	SHOULD_EQUAL(arr.is_inline(), true);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+
+	arr.push_back(&alloc, 4);
+	SHOULD_EQUAL(arr.is_inline(), false);
+	SHOULD_EQUAL(arr.spill_count(), 1u);
+	SHOULD_EQUAL(arr.size(), 5);
+
+	i32 sum = 0;
+	for (i32 value : arr) {
+		sum += value;
+	}
+	SHOULD_EQUAL(sum, 10);
+
+	arr.remove(0);
+	SHOULD_EQUAL(arr[0], 1);
+
+	arr.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
 TEST(list_basic) {
 	edge::Allocator alloc = edge::Allocator::create_tracking();
 	edge::List<i32> list;
@@ -326,6 +445,276 @@ TEST(list_find) {
 	return 0;
 }
 
+TEST(list_pooled) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::PooledList<i32> list;
+
+	for (i32 i = 0; i < 100; i++) {
+		list.push_back(&alloc, 99 - i);
+	}
+
+	// Nodes come from a few chunks instead of one allocation each
+	SHOULD_EQUAL(list.m_head->next == list.m_head + 1, true);
+
+	list.erase(&alloc, list.find(50));
+	list.erase(&alloc, list.find(0));
+	SHOULD_EQUAL(list.size(), 98);
+	SHOULD_EQUAL(*list.back(), 1);
+
+	list.sort([](const i32& a, const i32& b) -> i32 { return a - b; });
+	SHOULD_EQUAL(*list.front(), 1);
+	SHOULD_EQUAL(*list.back(), 99);
+
+	i32 prev = 0;
+	bool ordered = true;
+	for (i32 value : list) {
+		ordered &= value > prev && value != 50;
+		prev = value;
+	}
+	SHOULD_EQUAL(ordered, true);
+	SHOULD_EQUAL(list.m_tail->prev->data, 98);
+
+	// Freed nodes are reused before the pool grows
+	list.push_front(&alloc, 50);
+	list.push_front(&alloc, 0);
+	SHOULD_EQUAL(list.size(), 100);
+
+	list.clear(&alloc);
+	SHOULD_EQUAL(list.empty(), true);
+	list.push_back(&alloc, 7);
+	SHOULD_EQUAL(*list.front(), 7);
+
+	list.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+struct IntrusiveWaiter {
+	i32 id;
+	edge::IntrusiveListNode queue_node;
+	edge::IntrusiveListNode all_node;
+};
+
+TEST(intrusive_list_basic) {
+	using WaitQueue = edge::IntrusiveList<IntrusiveWaiter, &IntrusiveWaiter::queue_node>;
+	using AllWaiters = edge::IntrusiveList<IntrusiveWaiter, &IntrusiveWaiter::all_node>;
+
+	IntrusiveWaiter waiters[5] = {};
+	WaitQueue queue;
+	AllWaiters all;
+
+	for (i32 i = 0; i < 5; i++) {
+		waiters[i].id = i;
+		all.push_back(&waiters[i]);
+	}
+
+	queue.push_back(&waiters[1]);
+	queue.push_back(&waiters[3]);
+	queue.push_front(&waiters[0]);
+	queue.insert_after(&waiters[1], &waiters[2]);
+	queue.insert_before(&waiters[0], &waiters[4]);
+	SHOULD_EQUAL(queue.size(), 5);
+
+	i32 order[5] = {};
+	usize count = 0;
+	for (IntrusiveWaiter& waiter : queue) {
+		order[count++] = waiter.id;
+	}
+	SHOULD_EQUAL(order[0] == 4 && order[1] == 0 && order[2] == 1 && order[3] == 2 && order[4] == 3, true);
+
+	// Same owner, independent links
+	queue.remove(&waiters[2]);
+	SHOULD_EQUAL(queue.is_linked(&waiters[2]), false);
+	SHOULD_EQUAL(all.is_linked(&waiters[2]), true);
+	SHOULD_EQUAL(queue.next(&waiters[1])->id, 3);
+
+	SHOULD_EQUAL(queue.pop_front()->id, 4);
+	SHOULD_EQUAL(queue.pop_back()->id, 3);
+	SHOULD_EQUAL(queue.size(), 2);
+
+	WaitQueue other;
+	other.push_back(&waiters[3]);
+	queue.splice_back(other);
+	SHOULD_EQUAL(other.empty(), true);
+	SHOULD_EQUAL(queue.back()->id, 3);
+	SHOULD_EQUAL(queue.size(), 3);
+
+	queue.clear();
+	SHOULD_EQUAL(queue.is_linked(&waiters[0]), false);
+	SHOULD_EQUAL(all.size(), 5);
+	return 0;
+}
+
+TEST(deque_basic) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::Deque<i32> deque;
+
+	for (i32 i = 0; i < 10; i++) {
+		deque.push_back(&alloc, i);
+	}
+	for (i32 i = 1; i <= 4; i++) {
+		deque.push_front(&alloc, -i);
+	}
+	SHOULD_EQUAL(deque.capacity(), 16);
+	SHOULD_EQUAL(deque.front(), -4);
+	SHOULD_EQUAL(deque.back(), 9);
+
+	// Ring wraps, so the elements come back as two runs
+	auto spans = deque.as_spans();
+	SHOULD_EQUAL(spans.first.size(), 4);
+	SHOULD_EQUAL(spans.second.size(), 10);
+	SHOULD_EQUAL(spans.first[0], -4);
+	SHOULD_EQUAL(spans.second[0], 0);
+
+	// Growing while wrapped keeps the order
+	for (i32 i = 10; i < 20; i++) {
+		deque.push_back(&alloc, i);
+	}
+	SHOULD_EQUAL(deque.capacity(), 32);
+	bool ordered = true;
+	i32 expected = -4;
+	for (i32 value : deque) {
+		ordered &= value == expected++;
+	}
+	SHOULD_EQUAL(ordered, true);
+	SHOULD_EQUAL(deque[4], 0);
+
+	i32 value;
+	SHOULD_EQUAL(deque.pop_front(&value), true);
+	SHOULD_EQUAL(value, -4);
+	SHOULD_EQUAL(deque.pop_back(&value), true);
+	SHOULD_EQUAL(value, 19);
+
+	i32 batch[8] = { 100, 101, 102, 103, 104, 105, 106, 107 };
+	SHOULD_EQUAL(deque.push_back_range(&alloc, batch, 8), true);
+	SHOULD_EQUAL(deque.size(), 30);
+	SHOULD_EQUAL(deque.back(), 107);
+
+	i32 out[4] = {};
+	SHOULD_EQUAL(deque.pop_front_range(out, 4), 4);
+	SHOULD_EQUAL(out[0] == -3 && out[3] == 0, true);
+	SHOULD_EQUAL(deque.pop_front_range(nullptr, 100), 26);
+	SHOULD_EQUAL(deque.empty(), true);
+	SHOULD_EQUAL(deque.pop_back(), false);
+
+	deque.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+struct SortTestItem {
+	u32 key;
+	u32 order;
+};
+
+TEST(sort_radix_merge) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	i32 ints[] = { 5, -3, 1000000, -1000000, 0, 7, -3, 42 };
+	SHOULD_EQUAL(edge::sort_radix(&alloc, edge::Span<i32>{ ints }), true);
+	SHOULD_EQUAL(std::is_sorted(ints, ints + 8), true);
+
+	f32 floats[] = { 1.5f, -0.0f, -2.25f, 0.0f, 3.0f, -100.0f, 0.5f };
+	SHOULD_EQUAL(edge::sort_radix(&alloc, edge::Span<f32>{ floats }), true);
+	SHOULD_EQUAL(std::is_sorted(floats, floats + 7), true);
+	SHOULD_EQUAL(floats[0], -100.0f);
+
+	// Both sorts are stable, equal keys keep their input order
+	SortTestItem items[200];
+	SortTestItem merged[200];
+	edge::RngXoshiro256 rng = {};
+	rng.seed(7);
+	for (u32 i = 0; i < 200; i++) {
+		items[i] = { static_cast<u32>(rng.next64() % 10), i };
+		merged[i] = items[i];
+	}
+
+	SHOULD_EQUAL(edge::sort_radix(&alloc, edge::Span<SortTestItem>{ items }, [](const SortTestItem& item) { return item.key; }), true);
+	SHOULD_EQUAL(edge::sort_merge(&alloc, edge::Span<SortTestItem>{ merged }, [](const SortTestItem& a, const SortTestItem& b) { return a.key < b.key; }), true);
+
+	bool stable = true;
+	for (u32 i = 1; i < 200; i++) {
+		stable &= items[i - 1].key < items[i].key || (items[i - 1].key == items[i].key && items[i - 1].order < items[i].order);
+		stable &= items[i].key == merged[i].key && items[i].order == merged[i].order;
+	}
+	SHOULD_EQUAL(stable, true);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(sort_parallel) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::Scheduler* sched = edge::Scheduler::create(&alloc);
+	SHOULD_EQUAL(sched != nullptr, true);
+
+	// Every task index runs exactly once
+	std::atomic<u32> visits[edge::JOB_PARALLEL_FOR_MAX_TASKS] = {};
+	edge::job_parallel_for(&alloc, sched, edge::JOB_PARALLEL_FOR_MAX_TASKS, [&](const u32 task) { visits[task].fetch_add(1); });
+	bool visited_once = true;
+	for (const std::atomic<u32>& visit : visits) {
+		visited_once &= visit.load() == 1;
+	}
+	SHOULD_EQUAL(visited_once, true);
+
+	// Below the parallel threshold, sizes that no chunk count divides, and random, duplicate heavy and all equal keys.
+	// Both parallel sorts must match the stable serial merge item for item.
+	const usize sizes[] = { 1000, 100003, 300007 };
+	const u32 key_masks[] = { 0xFFFFFFFFu, 0xFFu, 0u };
+	edge::RngXoshiro256 rng = {};
+	rng.seed(11);
+
+	bool sorted = true;
+	bool stable = true;
+	for (const usize size : sizes) {
+		SortTestItem* reference = alloc.allocate_array<SortTestItem>(size);
+		SortTestItem* merged = alloc.allocate_array<SortTestItem>(size);
+		SortTestItem* radixed = alloc.allocate_array<SortTestItem>(size);
+		u32* keys = alloc.allocate_array<u32>(size);
+		u32* radix_keys = alloc.allocate_array<u32>(size);
+		u32* expected_keys = alloc.allocate_array<u32>(size);
+
+		for (const u32 key_mask : key_masks) {
+			for (usize i = 0; i < size; i++) {
+				reference[i] = { static_cast<u32>(rng.next64()) & key_mask, static_cast<u32>(i) };
+				merged[i] = reference[i];
+				radixed[i] = reference[i];
+				keys[i] = reference[i].key;
+				radix_keys[i] = reference[i].key;
+				expected_keys[i] = reference[i].key;
+			}
+
+			const auto less = [](const SortTestItem& a, const SortTestItem& b) { return a.key < b.key; };
+			sorted &= edge::sort_merge(&alloc, edge::Span<SortTestItem>{ reference, size }, less);
+			sorted &= edge::sort_merge_parallel(&alloc, sched, edge::Span<SortTestItem>{ merged, size }, less);
+			sorted &= edge::sort_radix_parallel(&alloc, sched, edge::Span<SortTestItem>{ radixed, size }, [](const SortTestItem& item) { return item.key; });
+			sorted &= edge::sort_merge_parallel(&alloc, sched, edge::Span<u32>{ keys, size });
+			sorted &= edge::sort_radix_parallel(&alloc, sched, edge::Span<u32>{ radix_keys, size });
+			std::sort(expected_keys, expected_keys + size);
+
+			for (usize i = 0; i < size; i++) {
+				sorted &= keys[i] == expected_keys[i] && radix_keys[i] == expected_keys[i];
+				stable &= merged[i].key == reference[i].key && merged[i].order == reference[i].order;
+				stable &= radixed[i].key == reference[i].key && radixed[i].order == reference[i].order;
+			}
+			sorted &= std::is_sorted(reference, reference + size, less);
+		}
+
+		alloc.deallocate_array(expected_keys, size);
+		alloc.deallocate_array(radix_keys, size);
+		alloc.deallocate_array(keys, size);
+		alloc.deallocate_array(radixed, size);
+		alloc.deallocate_array(merged, size);
+		alloc.deallocate_array(reference, size);
+	}
+	SHOULD_EQUAL(sorted, true);
+	SHOULD_EQUAL(stable, true);
+
+	edge::Scheduler::destroy(&alloc, sched);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
 TEST(hashmap_basic) {
 	edge::Allocator alloc = edge::Allocator::create_tracking();
 	edge::HashMap<i32, i32> map;
@@ -460,6 +849,55 @@ TEST(hashmap_clear) {
 	return 0;
 }
 
+TEST(hashmap_try_emplace) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::HashMap<i32, i32> map;
+
+	map.create(&alloc, 0);
+
+	auto [it, inserted] = map.try_emplace(&alloc, 7, 70);
+	SHOULD_EQUAL(inserted, true);
+	SHOULD_EQUAL(it->value, 70);
+
+	// Existing key keeps its value
+	auto [it2, inserted2] = map.try_emplace(&alloc, 7, 700);
+	SHOULD_EQUAL(inserted2, false);
+	SHOULD_EQUAL(it2->value, 70);
+	SHOULD_EQUAL(map.size(), 1);
+
+	map.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(hashmap_remove_many) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::HashMap<i32, i32> map;
+
+	map.create(&alloc, 0);
+
+	for (i32 i = 0; i < 1000; i++) {
+		map.insert(&alloc, i, i);
+	}
+
+	// Remove every other key, remaining keys must survive the backward shifts
+	for (i32 i = 0; i < 1000; i += 2) {
+		SHOULD_EQUAL(map.remove(&alloc, i), true);
+	}
+
+	SHOULD_EQUAL(map.size(), 500);
+
+	bool all_found = true;
+	for (i32 i = 0; i < 1000; i++) {
+		all_found &= map.contains(i) == (i % 2 == 1);
+	}
+	SHOULD_EQUAL(all_found, true);
+
+	map.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
 TEST(bitarray_basic) {
 	edge::BitArray<64> arr = {};
 
@@ -505,6 +943,7 @@ TEST(bitarray_set_all) {
 	for (i32 i = 0; i < 16; i++) {
 		SHOULD_EQUAL(arr.get(i), true);
 	}
+	SHOULD_EQUAL(arr.byte_count(), sizeof(arr));
 
 	return 0;
 }
@@ -552,6 +991,141 @@ TEST(bitarray_any_all) {
 	return 0;
 }
 
+TEST(bitset_hierarchical) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::BitSet bits;
+	// Three summary levels above the words
+	SHOULD_EQUAL(bits.create(&alloc, 300000), true);
+	SHOULD_EQUAL(bits.m_level_count, 4u);
+
+	SHOULD_EQUAL(bits.find_first_set(), edge::BITSET_NPOS);
+	SHOULD_EQUAL(bits.find_first_clear(), 0ull);
+
+	bits.set(123456);
+	bits.set(299999);
+	SHOULD_EQUAL(bits.find_first_set(), 123456ull);
+	SHOULD_EQUAL(bits.find_next_set(123457), 299999ull);
+	SHOULD_EQUAL(bits.find_next_set(300000), edge::BITSET_NPOS);
+	SHOULD_EQUAL(bits.count_set(), 2ull);
+
+	bits.set_range(0, 200000);
+	SHOULD_EQUAL(bits.count_set(), 200001ull);
+	SHOULD_EQUAL(bits.find_first_clear(), 200000ull);
+
+	// First run of 100 clear bits skips the hole before bit 299999
+	bits.clear_range(1000, 50);
+	bits.clear_range(5000, 100);
+	SHOULD_EQUAL(bits.find_clear_range(64), 5000ull);
+	SHOULD_EQUAL(bits.find_clear_range(200), 200000ull);
+	SHOULD_EQUAL(bits.find_clear_range(100000), edge::BITSET_NPOS);
+
+	bits.set_all();
+	SHOULD_EQUAL(bits.find_first_clear(), edge::BITSET_NPOS);
+	SHOULD_EQUAL(bits.count_set(), 300000ull);
+
+	SHOULD_EQUAL(bits.resize(&alloc, 300100), true);
+	SHOULD_EQUAL(bits.get(299999), true);
+	SHOULD_EQUAL(bits.find_first_clear(), 300000ull);
+
+	bits.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(free_index_list_range) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::FreeIndexList list;
+	SHOULD_EQUAL(list.create(&alloc, 1024), true);
+
+	u32 index = 0;
+	SHOULD_EQUAL(list.allocate(&index), true);
+	SHOULD_EQUAL(index, 0u);
+
+	u32 first = 0;
+	SHOULD_EQUAL(list.allocate_range(100, &first), true);
+	SHOULD_EQUAL(first, 1u);
+	SHOULD_EQUAL(list.allocate_range(16, &first), true);
+	SHOULD_EQUAL(first, 101u);
+
+	// A freed hole too small for the request is skipped
+	SHOULD_EQUAL(list.free_range(10, 8), true);
+	SHOULD_EQUAL(list.free_range(10, 8), false);
+	SHOULD_EQUAL(list.allocate_range(16, &first), true);
+	SHOULD_EQUAL(first, 117u);
+	SHOULD_EQUAL(list.allocate(&index), true);
+	SHOULD_EQUAL(index, 10u);
+
+	SHOULD_EQUAL(list.free(index), true);
+	SHOULD_EQUAL(list.free(index), false);
+
+	list.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(handle_pool_basic) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::HandlePool<i32> pool;
+	SHOULD_EQUAL(pool.create(&alloc), true);
+
+	edge::Handle handles[3000];
+	for (i32 i = 0; i < 3000; i++) {
+		handles[i] = pool.allocate_with_data(&alloc, i);
+	}
+	SHOULD_EQUAL(pool.size(), 3000);
+
+	// Free every other element, survivors stay reachable through their handles
+	for (i32 i = 0; i < 3000; i += 2) {
+		SHOULD_EQUAL(pool.free(handles[i]), true);
+	}
+	SHOULD_EQUAL(pool.size(), 1500);
+	SHOULD_EQUAL(pool.is_valid(handles[0]), false);
+	SHOULD_EQUAL(pool.free(handles[0]), false);
+	SHOULD_EQUAL(*pool.get(handles[2999]), 2999);
+
+	// Reused slot gets a new version, the stale handle stays dead
+	edge::Handle reused = pool.allocate_with_data(&alloc, 42);
+	SHOULD_EQUAL(reused.index, handles[2998].index);
+	SHOULD_EQUAL(pool.get(handles[2998]) == nullptr, true);
+	SHOULD_EQUAL(*pool.get(reused), 42);
+
+	i64 sum = 0;
+	for (auto entry : pool) {
+		SHOULD_EQUAL(*pool.get(entry.handle), *entry.element);
+		sum += *entry.element;
+	}
+	SHOULD_EQUAL(sum, 1500ll * 1500ll + 42);
+
+	pool.clear();
+	SHOULD_EQUAL(pool.is_empty(), true);
+	SHOULD_EQUAL(pool.is_valid(reused), false);
+
+	pool.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(handle_pool_handle64) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::HandlePool<u64, edge::Handle64> pool;
+	SHOULD_EQUAL(pool.create(&alloc, 16), true);
+
+	edge::Handle64 handle = pool.allocate_with_data(&alloc, 7ull);
+	for (i32 i = 0; i < 5000; i++) {
+		SHOULD_EQUAL(pool.free(handle), true);
+		handle = pool.allocate_with_data(&alloc, 7ull);
+	}
+
+	// 32 bit versions do not wrap where a 12 bit one would
+	SHOULD_EQUAL(handle.index, 0u);
+	SHOULD_EQUAL(handle.version, 5000u);
+	SHOULD_EQUAL(pool.is_valid(edge::HANDLE64_INVALID), false);
+
+	pool.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
 TEST(mpmc_queue_basic) {
 	edge::Allocator alloc = edge::Allocator::create_tracking();
 	edge::MPMCQueue<i32> queue;
@@ -743,6 +1317,1425 @@ TEST(mpmc_queue_multithreaded) {
 	return 0;
 }
 
+struct ConcurrentMapArgs {
+	edge::ConcurrentHashMap<i32, i32>* map;
+	const edge::Allocator* alloc;
+	std::atomic<i32>* construct_count;
+	i32 key_count;
+};
+
+i32 concurrent_map_thread(void* arg) {
+	ConcurrentMapArgs* args = (ConcurrentMapArgs*)arg;
+
+	for (i32 round = 0; round < 4; round++) {
+		for (i32 key = 0; key < args->key_count; key++) {
+			auto guard = args->map->pin();
+			i32* value = args->map->get_or_insert_with(args->alloc, guard, key, [&]() {
+				args->construct_count->fetch_add(1);
+				return key * 2;
+			});
+			assert(value && *value == key * 2);
+		}
+	}
+
+	return 0;
+}
+
+TEST(concurrent_hashmap_basic) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::ConcurrentHashMap<i32, i32> map;
+
+	SHOULD_EQUAL(map.create(&alloc, 4), true);
+
+	SHOULD_EQUAL(map.insert(&alloc, 1, 10), true);
+	SHOULD_EQUAL(map.insert(&alloc, 1, 20), false);
+	SHOULD_EQUAL(map.size(), 1);
+
+	{
+		auto guard = map.pin();
+		i32* value = map.find(guard, 1);
+		SHOULD_EQUAL(*value, 10);
+
+		// Pointer stays valid until the guard is released
+		SHOULD_EQUAL(map.remove(&alloc, 1), true);
+		SHOULD_EQUAL(*value, 10);
+		SHOULD_EQUAL(map.find(guard, 1) == nullptr, true);
+	}
+
+	map.reclaim(&alloc);
+	SHOULD_EQUAL(map.empty(), true);
+
+	map.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(concurrent_hashmap_multithreaded) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	edge::ConcurrentHashMap<i32, i32> map;
+
+	map.create(&alloc);
+
+	const i32 num_threads = 4;
+	const i32 key_count = 1000;
+	std::atomic<i32> construct_count{ 0 };
+
+	edge::Thread threads[num_threads];
+	ConcurrentMapArgs args = { &map, &alloc, &construct_count, key_count };
+
+	for (i32 i = 0; i < num_threads; i++) {
+		edge::thread_create(&threads[i], concurrent_map_thread, &args);
+	}
+
+	for (i32 i = 0; i < num_threads; i++) {
+		edge::thread_join(threads[i]);
+	}
+
+	// Every key constructed exactly once despite the races
+	SHOULD_EQUAL(construct_count.load(), key_count);
+	SHOULD_EQUAL(map.size(), (usize)key_count);
+
+	map.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(tlsf_basic) {
+	edge::Tlsf tlsf = {};
+	SHOULD_EQUAL(tlsf.create(16 * 1024 * 1024, 64 * 1024), true);
+
+	void* ptrs[256] = {};
+	for (usize i = 0; i < 256; ++i) {
+		ptrs[i] = tlsf.alloc(16 + (i * 37) % 2048);
+		SHOULD_EQUAL(ptrs[i] != nullptr, true);
+		SHOULD_EQUAL(reinterpret_cast<uintptr_t>(ptrs[i]) % alignof(max_align_t), 0ull);
+		memset(ptrs[i], (i32)i, 16);
+	}
+
+	// Commits past the initial 64 KiB
+	SHOULD_EQUAL(tlsf.m_committed > 64 * 1024, true);
+
+	for (usize i = 0; i < 256; i += 2) {
+		tlsf.free(ptrs[i]);
+		ptrs[i] = nullptr;
+	}
+
+	edge::TlsfStats stats = tlsf.stats();
+	SHOULD_EQUAL(stats.used_block_count, 128ull);
+	SHOULD_EQUAL(stats.fragmentation() > 0.0f, true);
+
+	void* aligned = tlsf.alloc_ex(100, 256);
+	SHOULD_EQUAL(reinterpret_cast<uintptr_t>(aligned) % 256, 0ull);
+	tlsf.free(aligned);
+
+	void* grown = tlsf.realloc_ex(ptrs[1], 8192, 16);
+	SHOULD_EQUAL(*static_cast<u8*>(grown), (u8)1);
+	ptrs[1] = grown;
+
+	for (usize i = 0; i < 256; ++i) {
+		tlsf.free(ptrs[i]);
+	}
+
+	// Everything coalesces back into a single free block
+	stats = tlsf.stats();
+	SHOULD_EQUAL(stats.used_block_count, 0ull);
+	SHOULD_EQUAL(stats.free_block_count, 1ull);
+	SHOULD_EQUAL(stats.fragmentation(), 0.0f);
+
+	tlsf.destroy();
+	return 0;
+}
+
+TEST(tlsf_allocator) {
+	edge::Tlsf tlsf = {};
+	SHOULD_EQUAL(tlsf.create(), true);
+
+	edge::Allocator alloc = tlsf.to_allocator();
+
+	edge::Array<i32> arr;
+	SHOULD_EQUAL(arr.reserve(&alloc, 4), true);
+	for (i32 i = 0; i < 10000; ++i) {
+		arr.push_back(&alloc, i);
+	}
+	SHOULD_EQUAL(arr[9999], 9999);
+	arr.destroy(&alloc);
+
+	SHOULD_EQUAL(tlsf.stats().used_block_count, 0ull);
+
+	tlsf.destroy();
+	return 0;
+}
+
+TEST(hash_xxh3) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	u8* data = alloc.allocate_array<u8>(2048);
+	for (usize i = 0; i < 2048; i++) {
+		data[i] = static_cast<u8>(i * 13 + 1);
+	}
+
+	// Reference XXH3 values, one per length class
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 0), 0x2d06800538d394c2ull);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 3), 0x2bfa43ae272efa4full);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 7), 0x9e6fc6618db75a2full);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 16), 0xb79429792c4fa7abull);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 100), 0x576896752624c190ull);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 200), 0x75416f6d84a08474ull);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 1000), 0x06238d5d60b01a4eull);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 2048), 0xbeb0626b68fd9a1cull);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 16, 42), 0x2d4b15e05962a2b9ull);
+	SHOULD_EQUAL(edge::hash_xxh3_64(data, 2048, 42), 0xb2ebb757040b22a6ull);
+	SHOULD_EQUAL(edge::hash_xxh3_128(data, 50), (edge::Hash128{ 0xf831b20b157ce46dull, 0x10c4ea6d8810e176ull }));
+	SHOULD_EQUAL(edge::hash_xxh3_128(data, 2048), (edge::Hash128{ 0xbeb0626b68fd9a1cull, 0xd726a769562f5b6aull }));
+
+	// Any split of the input gives the one-shot result
+	bool stream_matches = true;
+	const usize sizes[] = { 0, 5, 64, 240, 241, 256, 300, 1024, 1025, 2048 };
+	const usize chunks[] = { 1, 7, 64, 100, 333, 2048 };
+	for (usize size : sizes) {
+		for (usize chunk : chunks) {
+			edge::HashStream stream;
+			stream.reset(7);
+			for (usize offset = 0; offset < size; offset += chunk) {
+				stream.update(data + offset, std::min(chunk, size - offset));
+			}
+			stream_matches &= stream.digest64() == edge::hash_xxh3_64(data, size, 7);
+			stream_matches &= stream.digest128() == edge::hash_xxh3_128(data, size, 7);
+		}
+	}
+	SHOULD_EQUAL(stream_matches, true);
+
+	// Hashing goes through the bytes, not the string object
+	edge::String path = {};
+	path.from_utf8(&alloc, u8"assets/textures/terrain/grass_albedo.ktx2", 41);
+	SHOULD_EQUAL(edge::Hash<edge::String>{}(path), edge::Hash<edge::StringView<char8_t>>{}(edge::StringView<char8_t>{ path.data(), path.length() }));
+
+	path.destroy(&alloc);
+	alloc.deallocate_array(data, 2048);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(hash_crc32) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	// Standard check values for "123456789"
+	SHOULD_EQUAL(edge::hash_crc32("123456789", 9), 0xcbf43926u);
+	SHOULD_EQUAL(edge::hash_crc32c("123456789", 9), 0xe3069283u);
+	SHOULD_EQUAL(edge::hash_crc32(nullptr, 0), 0u);
+
+	constexpr usize SIZE = 100000;
+	u8* data = alloc.allocate_array<u8>(SIZE);
+	for (usize i = 0; i < SIZE; i++) {
+		data[i] = static_cast<u8>((i * 7919) >> 5);
+	}
+	const u32 whole = edge::hash_crc32(data, SIZE);
+	const u32 whole_c = edge::hash_crc32c(data, SIZE);
+
+	// Continuing and combining chunks both give the checksum of the whole buffer,
+	// chunk sizes cross the folded and the scalar paths
+	bool chunks_match = true;
+	const usize chunk_sizes[] = { 1, 15, 64, 127, 128, 4096, 33333 };
+	for (usize chunk : chunk_sizes) {
+		u32 continued = 0;
+		u32 combined = 0;
+		u32 combined_c = 0;
+		for (usize offset = 0; offset < SIZE; offset += chunk) {
+			const usize count = std::min(chunk, SIZE - offset);
+			continued = edge::hash_crc32(data + offset, count, continued);
+			combined = edge::hash_crc32_combine(combined, edge::hash_crc32(data + offset, count), count);
+			combined_c = edge::hash_crc32c_combine(combined_c, edge::hash_crc32c(data + offset, count), count);
+		}
+		chunks_match &= continued == whole && combined == whole && combined_c == whole_c;
+	}
+	SHOULD_EQUAL(chunks_match, true);
+
+	alloc.deallocate_array(data, SIZE);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(string_utf8) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	// Malformed sequences placed at the start, across a 16/32 byte block edge and at the end
+	const char* invalid[] = {
+		"\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xED\xA0\x80", "\xF0\x80\x80\x80",
+		"\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\x80", "\xC3", "\xE2\x82", "\xF0\x9F\x98", "\xFF"
+	};
+	bool invalid_rejected = true;
+	for (const char* seq : invalid) {
+		for (usize offset : { 0, 14, 31, 60 }) {
+			char8_t buffer[80];
+			memset(buffer, 'a', sizeof(buffer));
+			const usize seq_length = strlen(seq);
+			memcpy(buffer + offset, seq, seq_length);
+			invalid_rejected &= !edge::detail::utf8::validate_utf8(buffer, offset + seq_length);
+			invalid_rejected &= !edge::detail::utf8::validate_utf8(buffer, sizeof(buffer));
+		}
+	}
+	SHOULD_EQUAL(invalid_rejected, true);
+
+	// Random scalar values round trip through every encoding, ASCII runs hit the block fast paths
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x0717);
+	bool round_trip = true;
+	bool mutations_match = true;
+	char32_t code_points[256];
+	for (i32 iteration = 0; iteration < 2000; ++iteration) {
+		const usize count = rng.next64() % 256;
+		for (usize i = 0; i < count; ++i) {
+			const u64 kind = rng.next64() % 8;
+			char32_t cp = kind < 5 ? static_cast<char32_t>(0x20 + rng.next64() % 0x5F)
+				: kind == 5 ? static_cast<char32_t>(0x80 + rng.next64() % 0x780)
+				: kind == 6 ? static_cast<char32_t>(0x800 + rng.next64() % 0xF800)
+				: static_cast<char32_t>(0x10000 + rng.next64() % 0x100000);
+			if (cp >= 0xD800 && cp <= 0xDFFF) {
+				cp = U'?';
+			}
+			code_points[i] = cp;
+		}
+
+		edge::String utf8 = {};
+		if (count == 0 || !utf8.from_utf32(&alloc, code_points, count)) {
+			continue;
+		}
+
+		char16_t* utf16 = utf8.to_utf16(&alloc);
+		char32_t* utf32 = utf8.to_utf32(&alloc);
+		edge::String back = {};
+		round_trip &= utf16 && utf32 && back.from_utf16(&alloc, utf16, std::char_traits<char16_t>::length(utf16));
+		round_trip &= memcmp(utf32, code_points, count * sizeof(char32_t)) == 0 && utf32[count] == U'\0';
+		round_trip &= back.length() == utf8.length() && memcmp(back.data(), utf8.data(), utf8.length()) == 0;
+
+		// A mutated byte either still round trips or is rejected by validation and decoding alike
+		char8_t* bytes = back.data();
+		bytes[rng.next64() % back.length()] = static_cast<char8_t>(rng.next64());
+		const bool valid = edge::detail::utf8::validate_utf8(bytes, back.length());
+		char32_t* mutated = back.to_utf32(&alloc);
+		edge::String again = {};
+		mutations_match &= valid == (mutated != nullptr);
+		if (mutated) {
+			again.from_utf32(&alloc, mutated, edge::detail::utf8::utf32_length(bytes, back.length()));
+			mutations_match &= again.length() == back.length() && memcmp(again.data(), bytes, back.length()) == 0;
+			alloc.free(mutated);
+		}
+
+		again.destroy(&alloc);
+		back.destroy(&alloc);
+		alloc.free(utf32);
+		alloc.free(utf16);
+		utf8.destroy(&alloc);
+	}
+	SHOULD_EQUAL(round_trip, true);
+	SHOULD_EQUAL(mutations_match, true);
+
+	// Lone surrogates and out of range values are rejected when encoding
+	edge::String rejected = {};
+	const char16_t lone_low[] = u"0123456789abcdef\xDC00";
+	SHOULD_EQUAL(rejected.from_utf16(&alloc, lone_low), false);
+	const char32_t too_large[] = { U'a', 0x110000 };
+	SHOULD_EQUAL(rejected.from_utf32(&alloc, too_large, 2), false);
+	rejected.destroy(&alloc);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(string_view_search) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	// Matches land before, inside and after the vector blocks
+	constexpr usize SIZE = 200;
+	char8_t text[SIZE];
+	for (usize i = 0; i < SIZE; ++i) {
+		text[i] = static_cast<char8_t>(u8'a' + i % 7);
+	}
+	memcpy(text + 3, u8"needle", 6);
+	memcpy(text + 77, u8"needle", 6);
+	memcpy(text + 190, u8"needle", 6);
+	text[40] = u8'/';
+	text[150] = u8'\\';
+
+	const edge::StringView<char8_t> view = { text, SIZE };
+	SHOULD_EQUAL(view.find(u8"needle"), 3ull);
+	SHOULD_EQUAL(view.find(u8"needle", 4), 77ull);
+	SHOULD_EQUAL(view.find(u8"needle", 78), 190ull);
+	SHOULD_EQUAL(view.find(u8"needles"), SIZE_MAX);
+	SHOULD_EQUAL(view.rfind(u8"needle"), 190ull);
+	SHOULD_EQUAL(view.rfind(u8"needle", 189), 77ull);
+	SHOULD_EQUAL(view.find(u8'/'), 40ull);
+	SHOULD_EQUAL(view.rfind(u8'/'), 40ull);
+	SHOULD_EQUAL(view.find_first_of(u8"\\/"), 40ull);
+	SHOULD_EQUAL(view.find_last_of(u8"\\/"), 150ull);
+	SHOULD_EQUAL(view.find_last_of(u8"\\/", 149), 40ull);
+	SHOULD_EQUAL(view.find_first_of(u8"xyz"), SIZE_MAX);
+
+	// Longest path component through the separator search
+	const edge::StringView<char8_t> path = u8"C:\\projects\\edge/lib/base/include/string_view.hpp";
+	SHOULD_EQUAL(edge::filesystem::filename(path) == edge::StringView<char8_t>{ u8"string_view.hpp" }, true);
+	SHOULD_EQUAL(edge::filesystem::find_first_separator(path), 2ull);
+
+	// Split keeps empty fields between adjacent delimiters
+	const char8_t* expected[] = { u8"", u8"usr", u8"lib", u8"", u8"edge" };
+	usize field_count = 0;
+	bool fields_match = true;
+	for (edge::StringView<char8_t> field : edge::StringView<char8_t>{ u8"/usr\\lib//edge" }.split_any_of(u8"/\\")) {
+		fields_match &= field_count < 5 && field == edge::StringView<char8_t>{ expected[field_count] };
+		field_count++;
+	}
+	SHOULD_EQUAL(fields_match, true);
+	SHOULD_EQUAL(field_count, 5ull);
+
+	usize csv_count = 0;
+	for (edge::StringView<char8_t> field : edge::StringView<char8_t>{ u8"a,b,,c," }.split(u8',')) {
+		csv_count += field.length() <= 1;
+	}
+	SHOULD_EQUAL(csv_count, 5ull);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(format_basic) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	char buffer[128];
+	SHOULD_EQUAL(edge::format_to(buffer, "{} {} {}", -42, 18446744073709551615ull, true), 29ull);
+	SHOULD_EQUAL(strcmp(buffer, "-42 18446744073709551615 true"), 0);
+	edge::format_to(buffer, "{:x} {:#X} {:#b} {:o} {:c}", 255u, 3054u, 5, 8, 'z');
+	SHOULD_EQUAL(strcmp(buffer, "ff 0XBEE 0b101 10 z"), 0);
+	edge::format_to(buffer, "[{:>6}] [{:<6}] [{:^6}] [{:*^7}] [{:+05}]", 12, "ab", "mid", 'c', 42);
+	SHOULD_EQUAL(strcmp(buffer, "[    12] [ab    ] [ mid  ] [***c***] [+0042]"), 0);
+	edge::format_to(buffer, "{} {} {:.3f} {:e} {:g}", 0.1, 1.5f, 3.14159, 1234.5, 1e-7);
+	SHOULD_EQUAL(strcmp(buffer, "0.1 1.5 3.142 1.234500e+03 1e-07"), 0);
+	edge::format_to(buffer, "{{{}}} {:.2} {}", edge::StringView<char>{ "view" }, "truncated", nullptr);
+	SHOULD_EQUAL(strcmp(buffer, "{view} tr 0x0"), 0);
+
+	const i32 values[] = { 1, 2, 3 };
+	edge::format_to(buffer, "{} {:02x}", edge::Span<const i32>{ values, 3 }, edge::Span<const i32>{ values, 2 });
+	SHOULD_EQUAL(strcmp(buffer, "[1, 2, 3] [01, 02]"), 0);
+
+	// Integers agree with printf across the whole range
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x042);
+	bool printf_match = true;
+	for (i32 i = 0; i < 10000; ++i) {
+		const u64 value = rng.next64() >> (rng.next64() % 64);
+		char expected[64];
+		snprintf(expected, sizeof(expected), "%llu %lld %llx", static_cast<unsigned long long>(value),
+			static_cast<long long>(value), static_cast<unsigned long long>(value));
+		edge::format_to(buffer, "{} {} {:x}", value, static_cast<i64>(value), value);
+		printf_match &= strcmp(buffer, expected) == 0;
+	}
+	SHOULD_EQUAL(printf_match, true);
+
+	// Truncation keeps the terminator and reports the full length
+	char small[8];
+	SHOULD_EQUAL(edge::format_to(small, "{}-{}", 123456, 7890), 11ull);
+	SHOULD_EQUAL(strcmp(small, "123456-"), 0);
+	SHOULD_EQUAL(edge::formatted_size("{:>10}", 1), 10ull);
+
+	edge::String str = {};
+	SHOULD_EQUAL(str.from_utf8(&alloc, u8"x=", 2), true);
+	SHOULD_EQUAL(edge::format_append(&alloc, str, "{}|{:08.3f}", 5, -3.14159), true);
+	SHOULD_EQUAL(str.length(), 12ull);
+	SHOULD_EQUAL(memcmp(str.data(), u8"x=5|-003.142", 12), 0);
+	str.destroy(&alloc);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(random_batch) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	// Every lane follows the scalar generator advanced by one jump per lane
+	edge::RngXoshiro256 scalar = {};
+	scalar.seed(0x043);
+	edge::RngXoshiro256 lanes[edge::RNG_BATCH_LANES];
+	for (edge::RngXoshiro256& lane : lanes) {
+		lane = scalar;
+		scalar.jump();
+	}
+
+	edge::RngXoshiro256Batch batch = {};
+	batch.seed(0x043);
+	constexpr usize COUNT = 1003;
+	u64* values = alloc.allocate_array<u64>(COUNT);
+	batch.fill_u64(values, COUNT);
+	bool lanes_match = true;
+	for (usize i = 0; i < COUNT; ++i) {
+		lanes_match &= values[i] == lanes[i % edge::RNG_BATCH_LANES].next64();
+	}
+	SHOULD_EQUAL(lanes_match, true);
+
+	// 32-bit and float fills split the same outputs into halves
+	edge::RngXoshiro256Batch wide = {};
+	edge::RngXoshiro256Batch narrow = {};
+	edge::RngXoshiro256Batch unit = {};
+	wide.seed_stream(7, 2);
+	narrow.seed_stream(7, 2);
+	unit.seed_stream(7, 2);
+	u64 wide_values[64];
+	u32 narrow_values[128];
+	f32 unit_values[128];
+	wide.fill_u64(wide_values, 64);
+	narrow.fill_u32(narrow_values, 128);
+	unit.fill_f32(unit_values, 128);
+	SHOULD_EQUAL(memcmp(wide_values, narrow_values, sizeof(wide_values)), 0);
+	bool units_match = true;
+	for (usize i = 0; i < 128; ++i) {
+		units_match &= unit_values[i] == static_cast<f32>(narrow_values[i] >> 8) * (1.0f / 16777216.0f);
+	}
+	SHOULD_EQUAL(units_match, true);
+
+	// Streams are long jumps apart and the batch works with the generic helpers
+	edge::RngXoshiro256 stream_base = {};
+	stream_base.seed(7);
+	stream_base.long_jump();
+	stream_base.long_jump();
+	edge::RngXoshiro256Batch stream = {};
+	stream.seed_stream(7, 2);
+	SHOULD_EQUAL(stream.next64() == stream_base.next64(), true);
+	SHOULD_EQUAL(edge::rng_gen_u32_bounded(stream, 10) < 10, true);
+	const f32 ranged = edge::rng_gen_f32_range(stream_base, -1.0f, 1.0f);
+	SHOULD_EQUAL(ranged >= -1.0f && ranged < 1.0f, true);
+
+	// Ziggurat normals have the expected moments
+	constexpr usize NORMAL_COUNT = 1 << 20;
+	f32* normals = alloc.allocate_array<f32>(NORMAL_COUNT);
+	batch.fill_normal_f32(normals, NORMAL_COUNT, 2.0f, 3.0f);
+	f64 mean = 0.0;
+	f64 variance = 0.0;
+	for (usize i = 0; i < NORMAL_COUNT; ++i) {
+		mean += normals[i];
+	}
+	mean /= NORMAL_COUNT;
+	for (usize i = 0; i < NORMAL_COUNT; ++i) {
+		variance += (normals[i] - mean) * (normals[i] - mean);
+	}
+	variance /= NORMAL_COUNT;
+	SHOULD_EQUAL(mean > 1.98 && mean < 2.02, true);
+	SHOULD_EQUAL(variance > 8.9 && variance < 9.1, true);
+
+	alloc.deallocate_array(normals, NORMAL_COUNT);
+	alloc.deallocate_array(values, COUNT);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(filesystem_native) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+
+	edge::filesystem::Filesystem fs = {};
+	SHOULD_EQUAL(fs.create(&alloc), true);
+
+	SHOULD_EQUAL(fs.create_directories(u8"edge_fs_test/nested/dir"), true);
+	SHOULD_EQUAL(fs.is_directory(u8"edge_fs_test/nested/dir"), true);
+
+	// Positional writes and reads leave the stream position alone
+	constexpr usize SIZE = 64 * 1024;
+	u8* data = static_cast<u8*>(alloc.malloc(SIZE, edge::filesystem::FILE_DIRECT_ALIGNMENT));
+	for (usize i = 0; i < SIZE; ++i) {
+		data[i] = static_cast<u8>(i * 7 + (i >> 8));
+	}
+
+	const edge::StringView<char8_t> file_path = u8"edge_fs_test/nested/dir/data.bin";
+	edge::filesystem::IFile* file = fs.open_file(&alloc, file_path, AccessModeFlags{ AccessMode::Read } | AccessMode::Write | AccessMode::Create | AccessMode::Truncate);
+	SHOULD_EQUAL(file != nullptr, true);
+	SHOULD_EQUAL(file->write_at(0, data, SIZE), SIZE);
+	SHOULD_EQUAL(file->size(), static_cast<u64>(SIZE));
+
+	u8 chunk[1000];
+	SHOULD_EQUAL(file->read_at(12345, chunk, sizeof(chunk)), sizeof(chunk));
+	SHOULD_EQUAL(memcmp(chunk, data + 12345, sizeof(chunk)), 0);
+	SHOULD_EQUAL(file->read_at(SIZE - 10, chunk, sizeof(chunk)), 10ull);
+
+	// Stream interface on the same descriptor
+	SHOULD_EQUAL(file->seek(100, edge::filesystem::StreamOrigin::Begin), 100ull);
+	SHOULD_EQUAL(file->read(chunk, 1, 50), 50ull);
+	SHOULD_EQUAL(file->tell(), 150ull);
+	SHOULD_EQUAL(memcmp(chunk, data + 100, 50), 0);
+	SHOULD_EQUAL(file->seek(-16, edge::filesystem::StreamOrigin::End), SIZE - 16);
+	alloc.deallocate(file);
+
+	// Unbuffered streaming read with aligned buffer, offset and size
+	edge::filesystem::IFile* direct = fs.open_file(&alloc, file_path, AccessModeFlags{ AccessMode::Read } | AccessMode::Unbuffered | AccessMode::SequentialScan);
+	SHOULD_EQUAL(direct != nullptr, true);
+	u8* aligned = static_cast<u8*>(alloc.malloc(edge::filesystem::FILE_DIRECT_ALIGNMENT, edge::filesystem::FILE_DIRECT_ALIGNMENT));
+	SHOULD_EQUAL(direct->read_at(edge::filesystem::FILE_DIRECT_ALIGNMENT, aligned, edge::filesystem::FILE_DIRECT_ALIGNMENT), edge::filesystem::FILE_DIRECT_ALIGNMENT);
+	SHOULD_EQUAL(memcmp(aligned, data + edge::filesystem::FILE_DIRECT_ALIGNMENT, edge::filesystem::FILE_DIRECT_ALIGNMENT), 0);
+	alloc.free(aligned);
+	alloc.deallocate(direct);
+
+	// A nested mount takes priority over the working directory fallback
+	fs.mount(&alloc, u8"assets", edge::filesystem::create_native_filesystem(&alloc, u8"edge_fs_test/nested"));
+	SHOULD_EQUAL(fs.is_file(u8"assets/dir/data.bin"), true);
+	SHOULD_EQUAL(fs.is_file(u8"assets_other/dir/data.bin"), false);
+	fs.unmount(&alloc, u8"assets");
+	SHOULD_EQUAL(fs.exists(u8"assets/dir/data.bin"), false);
+
+	// Entry queries are cached until a change goes through the filesystem
+	SHOULD_EQUAL(fs.is_file(file_path), true);
+	SHOULD_EQUAL(edge::filesystem::remove_file(file_path), true);
+	SHOULD_EQUAL(fs.is_file(file_path), true);
+	fs.invalidate_cache();
+	SHOULD_EQUAL(fs.exists(file_path), false);
+
+	SHOULD_EQUAL(fs.remove(u8"edge_fs_test/nested/dir"), true);
+	SHOULD_EQUAL(fs.remove(u8"edge_fs_test/nested"), true);
+	SHOULD_EQUAL(fs.remove(u8"edge_fs_test"), true);
+	SHOULD_EQUAL(fs.is_directory(u8"edge_fs_test"), false);
+
+	alloc.free(data);
+	fs.destroy(&alloc);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+struct EntryCacheReaderArgs {
+	const edge::filesystem::Filesystem* fs;
+	std::atomic<bool>* done;
+};
+
+i32 entry_cache_reader_thread(void* arg) {
+	EntryCacheReaderArgs* args = (EntryCacheReaderArgs*)arg;
+	while (!args->done->load(std::memory_order_relaxed)) {
+		(void)args->fs->exists(u8"edge_fs_cache_test");
+	}
+	return 0;
+}
+
+TEST(filesystem_entry_cache) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	edge::filesystem::Filesystem fs = {};
+	SHOULD_EQUAL(fs.create(&alloc), true);
+
+	// Changes made through the facade are visible to the next query
+	SHOULD_EQUAL(fs.exists(u8"edge_fs_cache_test"), false);
+	SHOULD_EQUAL(fs.create_directory(u8"edge_fs_cache_test"), true);
+	SHOULD_EQUAL(fs.is_directory(u8"edge_fs_cache_test"), true);
+	SHOULD_EQUAL(fs.remove(u8"edge_fs_cache_test"), true);
+	SHOULD_EQUAL(fs.exists(u8"edge_fs_cache_test"), false);
+
+	// A reader refilling the slot while the entry changes can not pin a stale answer
+	std::atomic<bool> done{ false };
+	EntryCacheReaderArgs args = { &fs, &done };
+	edge::Thread reader;
+	edge::thread_create(&reader, entry_cache_reader_thread, &args);
+
+	bool coherent = true;
+	for (i32 round = 0; round < 5000 && coherent; ++round) {
+		fs.create_directory(u8"edge_fs_cache_test");
+		coherent = fs.exists(u8"edge_fs_cache_test");
+		fs.remove(u8"edge_fs_cache_test");
+		coherent = coherent && !fs.exists(u8"edge_fs_cache_test");
+	}
+
+	done.store(true, std::memory_order_relaxed);
+	edge::thread_join(reader);
+	SHOULD_EQUAL(coherent, true);
+
+	fs.destroy(&alloc);
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(filesystem_mapped) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+	using edge::filesystem::MapFlag;
+	using edge::filesystem::MapFlags;
+
+	constexpr usize SIZE = 3 * 65536 + 123;
+	u8* data = static_cast<u8*>(alloc.malloc(SIZE, 1));
+	for (usize i = 0; i < SIZE; ++i) {
+		data[i] = static_cast<u8>(i * 13 + (i >> 9));
+	}
+
+	const edge::StringView<char8_t> file_path = u8"edge_fs_mapped.bin";
+	edge::filesystem::IFile* file = edge::filesystem::open_native_file(&alloc, file_path, AccessModeFlags{ AccessMode::Write } | AccessMode::Create | AccessMode::Truncate);
+	SHOULD_EQUAL(file != nullptr, true);
+	SHOULD_EQUAL(file->write_at(0, data, SIZE), SIZE);
+	alloc.deallocate(file);
+
+	// Unaligned offset, the view still starts at the requested byte
+	edge::filesystem::MappedFile view = {};
+	SHOULD_EQUAL(view.map(file_path, 70001, 5000, MapFlags{ MapFlag::RandomAccess }), true);
+	SHOULD_EQUAL(view.size(), 5000ull);
+	SHOULD_EQUAL(memcmp(view.data(), data + 70001, view.size()), 0);
+	view.advise(100, 4000, MapFlags{ MapFlag::WillNeed } | MapFlag::HugePages);
+	view.unmap();
+	SHOULD_EQUAL(view.is_mapped(), false);
+
+	// Zero or oversized sizes clamp to the end of the file
+	SHOULD_EQUAL(view.map(file_path, 0, 0, MapFlags{ MapFlag::Sequential } | MapFlag::Populate), true);
+	SHOULD_EQUAL(view.size(), SIZE);
+	SHOULD_EQUAL(memcmp(view.data(), data, SIZE), 0);
+	SHOULD_EQUAL(view.map(file_path, SIZE - 7, SIZE), true);
+	SHOULD_EQUAL(view.size(), 7ull);
+	SHOULD_EQUAL(memcmp(view.data(), data + SIZE - 7, 7), 0);
+	view.unmap();
+
+	SHOULD_EQUAL(view.map(file_path, SIZE), false);
+	SHOULD_EQUAL(view.map(u8"edge_fs_mapped_missing.bin"), false);
+	SHOULD_EQUAL(view.is_mapped(), false);
+
+	SHOULD_EQUAL(edge::filesystem::remove_file(file_path), true);
+	alloc.free(data);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(filesystem_read_batch) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+	using edge::filesystem::ReadRequest;
+
+	constexpr usize SIZE = 100000;
+	u8* data = static_cast<u8*>(alloc.malloc(SIZE, 1));
+	for (usize i = 0; i < SIZE; ++i) {
+		data[i] = static_cast<u8>(i * 31 + (i >> 10));
+	}
+
+	const edge::StringView<char8_t> paths[] = { u8"edge_fs_batch_a.bin", u8"edge_fs_batch_b.bin" };
+	for (usize i = 0; i < 2; ++i) {
+		edge::filesystem::IFile* file = edge::filesystem::open_native_file(&alloc, paths[i], AccessModeFlags{ AccessMode::Write } | AccessMode::Create | AccessMode::Truncate);
+		SHOULD_EQUAL(file->write_at(0, data + i, SIZE - i), SIZE - i);
+		alloc.deallocate(file);
+	}
+
+	edge::Arena arena = {};
+	SHOULD_EQUAL(arena.create(1024 * 1024), true);
+
+	u8 buffers[6][4096];
+	ReadRequest requests[] = {
+		// Adjacent, gapped, overlapping and duplicate ranges in one file
+		{ .path = paths[0], .offset = 8192, .size = 4096, .buffer = buffers[0] },
+		{ .path = paths[0], .offset = 4096, .size = 4096, .buffer = buffers[1] },
+		{ .path = paths[0], .offset = 20000, .size = 1000, .buffer = buffers[2] },
+		{ .path = paths[0], .offset = 20500, .size = 1000, .buffer = buffers[3] },
+		{ .path = paths[0], .offset = 4096, .size = 4096, .buffer = buffers[4] },
+		// Whole files into the arena and a read past the end
+		{ .path = paths[1] },
+		{ .path = paths[0], .offset = 50000 },
+		{ .path = paths[1], .offset = SIZE - 100, .size = 4096, .buffer = buffers[5] },
+		// Failures
+		{ .path = u8"edge_fs_batch_missing.bin", .size = 16, .buffer = buffers[5] },
+		{ .path = paths[0], .offset = SIZE, .size = 16, .buffer = buffers[5] },
+		{ .path = u8"edge_fs_batch_missing.bin", .buffer = buffers[5] },
+	};
+
+	SHOULD_EQUAL(edge::filesystem::read_batch(&alloc, requests, &arena), 7ull);
+	SHOULD_EQUAL(memcmp(buffers[0], data + 8192, 4096), 0);
+	SHOULD_EQUAL(memcmp(buffers[1], data + 4096, 4096), 0);
+	SHOULD_EQUAL(memcmp(buffers[2], data + 20000, 1000), 0);
+	SHOULD_EQUAL(memcmp(buffers[3], data + 20500, 1000), 0);
+	SHOULD_EQUAL(memcmp(buffers[4], data + 4096, 4096), 0);
+	SHOULD_EQUAL(requests[5].size, SIZE - 1);
+	SHOULD_EQUAL(memcmp(requests[5].buffer, data + 1, SIZE - 1), 0);
+	SHOULD_EQUAL(requests[6].size, SIZE - 50000);
+	SHOULD_EQUAL(memcmp(requests[6].buffer, data + 50000, SIZE - 50000), 0);
+	SHOULD_EQUAL(requests[7].completed(), false);
+	SHOULD_EQUAL(requests[7].bytes_read, 99ull);
+	SHOULD_EQUAL(memcmp(buffers[5], data + SIZE - 99, 99), 0);
+	SHOULD_EQUAL(requests[7].status, edge::filesystem::ReadStatus::ShortRead);
+	SHOULD_EQUAL(requests[8].status, edge::filesystem::ReadStatus::OpenFailed);
+	SHOULD_EQUAL(requests[9].status, edge::filesystem::ReadStatus::OutOfRange);
+	SHOULD_EQUAL(requests[9].bytes_read, 0ull);
+	SHOULD_EQUAL(requests[10].completed(), false);
+	SHOULD_EQUAL(requests[10].status, edge::filesystem::ReadStatus::OpenFailed);
+
+	// Without an arena only caller buffers can be filled
+	ReadRequest unbuffered = { .path = paths[0] };
+	SHOULD_EQUAL(edge::filesystem::read_batch(&alloc, edge::Span<ReadRequest>{ &unbuffered, 1 }), 0ull);
+	SHOULD_EQUAL(unbuffered.status, edge::filesystem::ReadStatus::NoBuffer);
+
+	arena.destroy();
+	for (const edge::StringView<char8_t> path : paths) {
+		SHOULD_EQUAL(edge::filesystem::remove_file(path), true);
+	}
+	alloc.free(data);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+struct ArchiveTestEntry {
+	const char* name;
+	const char* prefix;
+	const char* contents;
+	char type;
+	const u8* deflated = nullptr;
+	u32 deflated_size = 0;
+};
+
+static void archive_test_put_u16(edge::Array<u8>& out, edge::NotNull<const edge::Allocator*> alloc, u32 value) {
+	out.push_back(alloc, static_cast<u8>(value));
+	out.push_back(alloc, static_cast<u8>(value >> 8));
+}
+
+static void archive_test_put_u32(edge::Array<u8>& out, edge::NotNull<const edge::Allocator*> alloc, u32 value) {
+	archive_test_put_u16(out, alloc, value & 0xFFFF);
+	archive_test_put_u16(out, alloc, value >> 16);
+}
+
+static void archive_test_put_bytes(edge::Array<u8>& out, edge::NotNull<const edge::Allocator*> alloc, const void* data, usize size) {
+	for (usize i = 0; i < size; ++i) {
+		out.push_back(alloc, static_cast<const u8*>(data)[i]);
+	}
+}
+
+static bool archive_test_write(edge::NotNull<const edge::Allocator*> alloc, const char8_t* path, const edge::Array<u8>& bytes) {
+	using edge::filesystem::AccessMode;
+	edge::filesystem::IFile* file = edge::filesystem::open_native_file(alloc, path, edge::filesystem::AccessModeFlags{ AccessMode::Write } | AccessMode::Create | AccessMode::Truncate);
+	if (!file) {
+		return false;
+	}
+	const bool written = file->write_at(0, bytes.data(), bytes.size()) == bytes.size();
+	alloc->deallocate(file);
+	return written;
+}
+
+// NOTE: Entries are stored unless they carry a raw deflate stream, with a local header extra field so the data offset has to come from the local header
+static bool archive_test_write_zip(edge::NotNull<const edge::Allocator*> alloc, const char8_t* path, const ArchiveTestEntry* entries, usize count) {
+	edge::Array<u8> bytes = {};
+	edge::Array<u8> directory = {};
+	for (usize i = 0; i < count; ++i) {
+		const u32 name_length = static_cast<u32>(strlen(entries[i].name));
+		const u32 size = static_cast<u32>(strlen(entries[i].contents));
+		const u32 method = entries[i].deflated ? 8 : 0;
+		const u32 stored_size = entries[i].deflated ? entries[i].deflated_size : size;
+		const u32 local_offset = static_cast<u32>(bytes.size());
+
+		archive_test_put_u32(bytes, alloc, 0x04034b50);
+		archive_test_put_u16(bytes, alloc, 10);
+		archive_test_put_u16(bytes, alloc, 0);
+		archive_test_put_u16(bytes, alloc, method);
+		archive_test_put_u32(bytes, alloc, 0);
+		archive_test_put_u32(bytes, alloc, 0);
+		archive_test_put_u32(bytes, alloc, stored_size);
+		archive_test_put_u32(bytes, alloc, size);
+		archive_test_put_u16(bytes, alloc, name_length);
+		archive_test_put_u16(bytes, alloc, 4);
+		archive_test_put_bytes(bytes, alloc, entries[i].name, name_length);
+		archive_test_put_u32(bytes, alloc, 0xCAFE);
+		if (entries[i].deflated) {
+			archive_test_put_bytes(bytes, alloc, entries[i].deflated, stored_size);
+		} else {
+			archive_test_put_bytes(bytes, alloc, entries[i].contents, size);
+		}
+
+		archive_test_put_u32(directory, alloc, 0x02014b50);
+		archive_test_put_u16(directory, alloc, 20);
+		archive_test_put_u16(directory, alloc, 10);
+		archive_test_put_u16(directory, alloc, 0);
+		archive_test_put_u16(directory, alloc, method);
+		archive_test_put_u32(directory, alloc, 0);
+		archive_test_put_u32(directory, alloc, 0);
+		archive_test_put_u32(directory, alloc, stored_size);
+		archive_test_put_u32(directory, alloc, size);
+		archive_test_put_u16(directory, alloc, name_length);
+		archive_test_put_u16(directory, alloc, 0);
+		archive_test_put_u16(directory, alloc, 0);
+		archive_test_put_u16(directory, alloc, 0);
+		archive_test_put_u16(directory, alloc, 0);
+		archive_test_put_u32(directory, alloc, 0);
+		archive_test_put_u32(directory, alloc, local_offset);
+		archive_test_put_bytes(directory, alloc, entries[i].name, name_length);
+	}
+
+	const u32 directory_offset = static_cast<u32>(bytes.size());
+	archive_test_put_bytes(bytes, alloc, directory.data(), directory.size());
+	archive_test_put_u32(bytes, alloc, 0x06054b50);
+	archive_test_put_u32(bytes, alloc, 0);
+	archive_test_put_u16(bytes, alloc, static_cast<u32>(count));
+	archive_test_put_u16(bytes, alloc, static_cast<u32>(count));
+	archive_test_put_u32(bytes, alloc, static_cast<u32>(directory.size()));
+	archive_test_put_u32(bytes, alloc, directory_offset);
+	archive_test_put_u16(bytes, alloc, 0);
+
+	const bool written = archive_test_write(alloc, path, bytes);
+	directory.destroy(alloc);
+	bytes.destroy(alloc);
+	return written;
+}
+
+static bool archive_test_write_tar(edge::NotNull<const edge::Allocator*> alloc, const char8_t* path, const ArchiveTestEntry* entries, usize count) {
+	edge::Array<u8> bytes = {};
+	for (usize i = 0; i < count; ++i) {
+		u8 header[512] = {};
+		const usize size = strlen(entries[i].contents);
+		memcpy(header, entries[i].name, strlen(entries[i].name));
+		memcpy(header + 100, "0000644", 7);
+		snprintf(reinterpret_cast<char*>(header + 124), 12, "%011o", static_cast<u32>(size));
+		header[156] = static_cast<u8>(entries[i].type);
+		memcpy(header + 257, "ustar", 6);
+		memcpy(header + 263, "00", 2);
+		if (entries[i].prefix) {
+			memcpy(header + 345, entries[i].prefix, strlen(entries[i].prefix));
+		}
+
+		u32 checksum = 0;
+		memset(header + 148, ' ', 8);
+		for (u8 byte : header) {
+			checksum += byte;
+		}
+		snprintf(reinterpret_cast<char*>(header + 148), 8, "%06o", checksum);
+
+		archive_test_put_bytes(bytes, alloc, header, sizeof(header));
+		archive_test_put_bytes(bytes, alloc, entries[i].contents, size);
+		while (bytes.size() % 512 != 0) {
+			bytes.push_back(alloc, 0);
+		}
+	}
+	for (usize i = 0; i < 1024; ++i) {
+		bytes.push_back(alloc, 0);
+	}
+
+	const bool written = archive_test_write(alloc, path, bytes);
+	bytes.destroy(alloc);
+	return written;
+}
+
+static bool archive_test_read_equals(edge::NotNull<const edge::Allocator*> alloc, const edge::filesystem::Filesystem& fs, edge::StringView<char8_t> path, const char* expected) {
+	edge::filesystem::IFile* file = fs.open_file(alloc, path, edge::filesystem::AccessModeFlags{ edge::filesystem::AccessMode::Read });
+	if (!file) {
+		return false;
+	}
+	char buffer[256] = {};
+	const usize size = strlen(expected);
+	const bool equal = file->size() == size && file->read(buffer, 1, sizeof(buffer)) == size && memcmp(buffer, expected, size) == 0;
+	alloc->deallocate(file);
+	return equal;
+}
+
+TEST(filesystem_archive) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+
+	const ArchiveTestEntry tar_entries[] = {
+		{ "shaders/mesh.slang", nullptr, "tar mesh shader", '0' },
+		{ "textures/stone.bin", nullptr, "stone texels", '0' },
+		{ "empty", nullptr, "", '5' },
+		{ "long.txt", "deep/nested", "prefixed name", '0' },
+	};
+	// Raw deflate of the contents, back references included
+	const u8 deflated[] = {
+		0x4B, 0x49, 0x4D, 0xCB, 0x49, 0x2C, 0x49, 0x4D, 0x51, 0xC8, 0x4D, 0x2D, 0xCE, 0x50,
+		0x28, 0xCE, 0x48, 0x4C, 0x49, 0x2D, 0xD2, 0x51, 0x48, 0x21, 0x5A, 0x14, 0x00,
+	};
+	const char* deflated_contents = "deflated mesh shader, deflated mesh shader, deflated mesh shader";
+	const ArchiveTestEntry zip_entries[] = {
+		{ "shaders/mesh.slang", nullptr, "zip mesh shader", 0 },
+		{ "./fonts/ui.ttf", nullptr, "font bytes", 0 },
+		{ "shaders/packed.slang", nullptr, deflated_contents, 0, deflated, sizeof(deflated) },
+	};
+	SHOULD_EQUAL(archive_test_write_tar(&alloc, u8"edge_fs_pack.tar", tar_entries, 4), true);
+	SHOULD_EQUAL(archive_test_write_zip(&alloc, u8"edge_fs_pack.zip", zip_entries, 3), true);
+
+	edge::filesystem::Filesystem fs = {};
+	SHOULD_EQUAL(fs.create(&alloc), true);
+
+	edge::filesystem::IFilesystem* tar = edge::filesystem::create_tar_filesystem(&alloc, u8"edge_fs_pack.tar");
+	edge::filesystem::IFilesystem* zip = edge::filesystem::create_zip_filesystem(&alloc, u8"edge_fs_pack.zip");
+	SHOULD_EQUAL(tar != nullptr, true);
+	SHOULD_EQUAL(zip != nullptr, true);
+	fs.mount(&alloc, u8"pack", tar);
+	fs.mount(&alloc, u8"pack", zip);
+
+	// The later mount shadows the earlier one, misses fall through
+	SHOULD_EQUAL(archive_test_read_equals(&alloc, fs, u8"pack/shaders/mesh.slang", "zip mesh shader"), true);
+	SHOULD_EQUAL(archive_test_read_equals(&alloc, fs, u8"pack/textures/stone.bin", "stone texels"), true);
+	SHOULD_EQUAL(archive_test_read_equals(&alloc, fs, u8"pack/fonts/ui.ttf", "font bytes"), true);
+	SHOULD_EQUAL(archive_test_read_equals(&alloc, fs, u8"pack/deep/nested/long.txt", "prefixed name"), true);
+
+	// Deflated entries inflate on open, without zlib they are refused
+#if EDGE_HAS_ZLIB
+	SHOULD_EQUAL(archive_test_read_equals(&alloc, fs, u8"pack/shaders/packed.slang", deflated_contents), true);
+#else
+	SHOULD_EQUAL(fs.open_file(&alloc, u8"pack/shaders/packed.slang", AccessModeFlags{ AccessMode::Read }) == nullptr, true);
+#endif
+
+	// Directories come from records and from entry parents
+	SHOULD_EQUAL(fs.is_directory(u8"pack/empty"), true);
+	SHOULD_EQUAL(fs.is_directory(u8"pack/deep/nested"), true);
+	SHOULD_EQUAL(fs.is_directory(u8"pack/fonts"), true);
+	SHOULD_EQUAL(fs.is_file(u8"pack/shaders"), false);
+	SHOULD_EQUAL(fs.exists(u8"pack/missing.txt"), false);
+
+	// Stream and positional reads over the mapping, writes are refused
+	edge::filesystem::IFile* file = fs.open_file(&alloc, u8"pack/textures/stone.bin", AccessModeFlags{ AccessMode::Read });
+	SHOULD_EQUAL(file != nullptr, true);
+	char chunk[8] = {};
+	SHOULD_EQUAL(file->seek(6, edge::filesystem::StreamOrigin::Begin), 6ull);
+	SHOULD_EQUAL(file->read(chunk, 1, 3), 3ull);
+	SHOULD_EQUAL(memcmp(chunk, "tex", 3), 0);
+	SHOULD_EQUAL(file->tell(), 9ull);
+	SHOULD_EQUAL(file->read_at(10, chunk, sizeof(chunk)), 2ull);
+	SHOULD_EQUAL(file->seek(1, edge::filesystem::StreamOrigin::End), SIZE_MAX);
+	SHOULD_EQUAL(file->write_at(0, chunk, 1), 0ull);
+	alloc.deallocate(file);
+	SHOULD_EQUAL(zip->open_file(&alloc, u8"fonts/ui.ttf", AccessModeFlags{ AccessMode::Write }) == nullptr, true);
+
+	fs.unmount(&alloc, u8"pack");
+	SHOULD_EQUAL(archive_test_read_equals(&alloc, fs, u8"pack/shaders/mesh.slang", "tar mesh shader"), true);
+	SHOULD_EQUAL(fs.exists(u8"pack/fonts/ui.ttf"), false);
+
+	SHOULD_EQUAL(edge::filesystem::create_zip_filesystem(&alloc, u8"edge_fs_pack.tar") == nullptr, true);
+
+	fs.destroy(&alloc);
+	SHOULD_EQUAL(edge::filesystem::remove_file(u8"edge_fs_pack.tar"), true);
+	SHOULD_EQUAL(edge::filesystem::remove_file(u8"edge_fs_pack.zip"), true);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+static void walk_test_write(edge::NotNull<const edge::Allocator*> alloc, const edge::StringView<char8_t> path, const usize size) {
+	using edge::filesystem::AccessMode;
+	using edge::filesystem::AccessModeFlags;
+
+	u8 data[256] = {};
+	edge::filesystem::IFile* file = edge::filesystem::open_native_file(alloc, path, AccessModeFlags{ AccessMode::Write } | AccessMode::Create | AccessMode::Truncate);
+	file->write_at(0, data, size);
+	alloc->deallocate(file);
+}
+
+TEST(filesystem_walk) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	using edge::filesystem::EntryFlag;
+	using edge::filesystem::WalkChange;
+	using edge::filesystem::WalkEntry;
+	using edge::filesystem::WalkFlag;
+	using edge::filesystem::WalkFlags;
+
+	SHOULD_EQUAL(edge::filesystem::create_directories(u8"edge_walk_test/a/b"), true);
+	SHOULD_EQUAL(edge::filesystem::create_directory(u8"edge_walk_test/c"), true);
+	walk_test_write(&alloc, u8"edge_walk_test/root.txt", 3);
+	walk_test_write(&alloc, u8"edge_walk_test/a/one.bin", 100);
+	walk_test_write(&alloc, u8"edge_walk_test/a/b/two.bin", 200);
+	walk_test_write(&alloc, u8"edge_walk_test/c/skip.bin", 50);
+
+	usize files = 0;
+	usize directories = 0;
+	u64 nested_size = 0;
+	auto callback = edge::filesystem::WalkCallback::create(&alloc, [&files, &directories, &nested_size](const WalkEntry& entry) {
+		files += entry.flags.has(EntryFlag::File) ? 1 : 0;
+		directories += entry.flags.has(EntryFlag::Directory) ? 1 : 0;
+		if (entry.path == edge::StringView<char8_t>{ u8"a/b/two.bin" }) {
+			nested_size = entry.size;
+		}
+	});
+
+	SHOULD_EQUAL(edge::filesystem::walk(&alloc, u8"edge_walk_test", {}, callback, WalkFlags{ WalkFlag::Recursive } | WalkFlag::Metadata), true);
+	SHOULD_EQUAL(files, 4ull);
+	SHOULD_EQUAL(directories, 3ull);
+	SHOULD_EQUAL(nested_size, 200ull);
+
+	// Listing types alone, one level deep
+	files = directories = 0;
+	SHOULD_EQUAL(edge::filesystem::walk(&alloc, u8"edge_walk_test", {}, callback, WalkFlags{}), true);
+	SHOULD_EQUAL(files, 1ull);
+	SHOULD_EQUAL(directories, 2ull);
+
+	// Rejected directories take their subtree with them
+	auto filter = edge::filesystem::WalkFilter::create(&alloc, [](const WalkEntry& entry) {
+		return entry.path != edge::StringView<char8_t>{ u8"c" };
+	});
+	files = directories = 0;
+	SHOULD_EQUAL(edge::filesystem::walk(&alloc, u8"edge_walk_test", filter, callback), true);
+	SHOULD_EQUAL(files, 3ull);
+	SHOULD_EQUAL(directories, 2ull);
+	SHOULD_EQUAL(edge::filesystem::walk(&alloc, u8"edge_walk_test_missing", {}, callback), false);
+
+	edge::filesystem::WalkSnapshot snapshot = {};
+	SHOULD_EQUAL(snapshot.capture(&alloc, u8"edge_walk_test"), true);
+	SHOULD_EQUAL(snapshot.size(), 7ull);
+	SHOULD_EQUAL(snapshot.find(u8"a/one.bin")->size, 100ull);
+	SHOULD_EQUAL(snapshot.find(u8"a/b")->flags.has(EntryFlag::Directory), true);
+	SHOULD_EQUAL(snapshot.find(u8"missing") == nullptr, true);
+	SHOULD_EQUAL(snapshot.save(&alloc, u8"edge_walk_test.snapshot"), true);
+	snapshot.destroy(&alloc);
+
+	edge::filesystem::WalkSnapshot loaded = {};
+	SHOULD_EQUAL(loaded.load(&alloc, u8"edge_walk_test.snapshot"), true);
+	SHOULD_EQUAL(loaded.size(), 7ull);
+	SHOULD_EQUAL(loaded.find(u8"a/b/two.bin")->size, 200ull);
+
+	walk_test_write(&alloc, u8"edge_walk_test/a/one.bin", 150);
+	walk_test_write(&alloc, u8"edge_walk_test/a/new.bin", 10);
+	SHOULD_EQUAL(edge::filesystem::remove_file(u8"edge_walk_test/c/skip.bin"), true);
+
+	usize changes[3] = {};
+	auto on_change = edge::filesystem::WalkChangeCallback::create(&alloc, [&changes](const WalkChange change, const WalkEntry& entry) {
+		changes[static_cast<u32>(change)] += entry.flags.has(EntryFlag::File) ? 1 : 0;
+	});
+	SHOULD_EQUAL(loaded.rescan(&alloc, u8"edge_walk_test", on_change), true);
+	SHOULD_EQUAL(changes[static_cast<u32>(WalkChange::Added)], 1ull);
+	SHOULD_EQUAL(changes[static_cast<u32>(WalkChange::Modified)], 1ull);
+	SHOULD_EQUAL(changes[static_cast<u32>(WalkChange::Removed)], 1ull);
+	SHOULD_EQUAL(loaded.find(u8"a/one.bin")->size, 150ull);
+	SHOULD_EQUAL(loaded.find(u8"c/skip.bin") == nullptr, true);
+
+	// A rescan of an unchanged tree is silent
+	changes[0] = changes[1] = changes[2] = 0;
+	SHOULD_EQUAL(loaded.rescan(&alloc, u8"edge_walk_test", on_change), true);
+	SHOULD_EQUAL(changes[0] + changes[1] + changes[2], 0ull);
+	SHOULD_EQUAL(loaded.load(&alloc, u8"edge_walk_test_missing.snapshot"), false);
+	SHOULD_EQUAL(loaded.size(), 7ull);
+	loaded.destroy(&alloc);
+
+	on_change.destroy(&alloc);
+	filter.destroy(&alloc);
+	callback.destroy(&alloc);
+
+	const edge::StringView<char8_t> leftovers[] = {
+		u8"edge_walk_test/root.txt", u8"edge_walk_test/a/one.bin", u8"edge_walk_test/a/new.bin",
+		u8"edge_walk_test/a/b/two.bin", u8"edge_walk_test.snapshot"
+	};
+	for (const edge::StringView<char8_t> path : leftovers) {
+		SHOULD_EQUAL(edge::filesystem::remove_file(path), true);
+	}
+	const edge::StringView<char8_t> leftover_directories[] = {
+		u8"edge_walk_test/a/b", u8"edge_walk_test/a", u8"edge_walk_test/c", u8"edge_walk_test"
+	};
+	for (const edge::StringView<char8_t> path : leftover_directories) {
+		SHOULD_EQUAL(edge::filesystem::remove_directory(path), true);
+	}
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+static usize watch_test_count(const edge::Span<const edge::filesystem::WatchEvent> events, const edge::StringView<char8_t> path, const edge::filesystem::WalkChange change) {
+	usize count = 0;
+	for (const edge::filesystem::WatchEvent& event : events) {
+		count += event.path == path && event.change == change ? 1 : 0;
+	}
+	return count;
+}
+
+TEST(filesystem_watch) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	using edge::filesystem::WalkChange;
+
+	SHOULD_EQUAL(edge::filesystem::create_directories(u8"edge_watch_test/nested"), true);
+
+	edge::filesystem::Watcher watcher = {};
+	if (!watcher.create(&alloc, 0)) {
+		// NOTE: No backend on this platform
+		SHOULD_EQUAL(watcher.poll(&alloc).size(), 0ull);
+		watcher.destroy(&alloc);
+		edge::filesystem::remove_directory(u8"edge_watch_test/nested");
+		edge::filesystem::remove_directory(u8"edge_watch_test");
+		SHOULD_EQUAL(alloc.get_net(), 0ull);
+		return 0;
+	}
+	SHOULD_EQUAL(watcher.add(&alloc, u8"edge_watch_test/"), true);
+	SHOULD_EQUAL(watcher.add(&alloc, u8"edge_watch_test_missing"), false);
+	SHOULD_EQUAL(watcher.poll(&alloc).size(), 0ull);
+
+	// Create, write and close fold into one addition
+	walk_test_write(&alloc, u8"edge_watch_test/shader.slang", 64);
+	walk_test_write(&alloc, u8"edge_watch_test/nested/texture.ktx", 32);
+	edge::Span<const edge::filesystem::WatchEvent> events = watcher.poll(&alloc);
+	SHOULD_EQUAL(events.size(), 2ull);
+	SHOULD_EQUAL(watch_test_count(events, u8"edge_watch_test/shader.slang", WalkChange::Added), 1ull);
+	SHOULD_EQUAL(watch_test_count(events, u8"edge_watch_test/nested/texture.ktx", WalkChange::Added), 1ull);
+
+	walk_test_write(&alloc, u8"edge_watch_test/shader.slang", 128);
+	walk_test_write(&alloc, u8"edge_watch_test/shader.slang", 96);
+	walk_test_write(&alloc, u8"edge_watch_test/scratch.tmp", 8);
+	SHOULD_EQUAL(edge::filesystem::remove_file(u8"edge_watch_test/scratch.tmp"), true);
+	SHOULD_EQUAL(edge::filesystem::remove_file(u8"edge_watch_test/nested/texture.ktx"), true);
+	events = watcher.poll(&alloc);
+	SHOULD_EQUAL(events.size(), 2ull);
+	SHOULD_EQUAL(watch_test_count(events, u8"edge_watch_test/shader.slang", WalkChange::Modified), 1ull);
+	SHOULD_EQUAL(watch_test_count(events, u8"edge_watch_test/nested/texture.ktx", WalkChange::Removed), 1ull);
+
+	// Directories created later are watched, files that beat the watch still show up
+	SHOULD_EQUAL(edge::filesystem::create_directories(u8"edge_watch_test/late/deeper"), true);
+	walk_test_write(&alloc, u8"edge_watch_test/late/deeper/mesh.bin", 16);
+	events = watcher.poll(&alloc);
+	SHOULD_EQUAL(watch_test_count(events, u8"edge_watch_test/late", WalkChange::Added), 1ull);
+	SHOULD_EQUAL(watch_test_count(events, u8"edge_watch_test/late/deeper/mesh.bin", WalkChange::Added), 1ull);
+	walk_test_write(&alloc, u8"edge_watch_test/late/deeper/mesh.bin", 24);
+	events = watcher.poll(&alloc);
+	SHOULD_EQUAL(events.size(), 1ull);
+	SHOULD_EQUAL(watch_test_count(events, u8"edge_watch_test/late/deeper/mesh.bin", WalkChange::Modified), 1ull);
+	SHOULD_EQUAL(watcher.overflowed(), false);
+	watcher.destroy(&alloc);
+
+	// Changes are held back until they settle
+	edge::filesystem::Watcher settling = {};
+	SHOULD_EQUAL(settling.create(&alloc, 60000), true);
+	SHOULD_EQUAL(settling.add(&alloc, u8"edge_watch_test", false), true);
+	walk_test_write(&alloc, u8"edge_watch_test/shader.slang", 32);
+	SHOULD_EQUAL(settling.poll(&alloc).size(), 0ull);
+	settling.destroy(&alloc);
+
+	const edge::StringView<char8_t> leftovers[] = { u8"edge_watch_test/shader.slang", u8"edge_watch_test/late/deeper/mesh.bin" };
+	for (const edge::StringView<char8_t> path : leftovers) {
+		SHOULD_EQUAL(edge::filesystem::remove_file(path), true);
+	}
+	const edge::StringView<char8_t> leftover_directories[] = {
+		u8"edge_watch_test/late/deeper", u8"edge_watch_test/late", u8"edge_watch_test/nested", u8"edge_watch_test"
+	};
+	for (const edge::StringView<char8_t> path : leftover_directories) {
+		SHOULD_EQUAL(edge::filesystem::remove_directory(path), true);
+	}
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+static bool simd_math_near(const f32 a, const f32 b, const f32 tolerance = 1e-4f) {
+	return std::fabs(a - b) <= tolerance * (1.0f + std::fabs(b));
+}
+
+static bool simd_math_mat4_near(const edge::Mat4& a, const edge::Mat4& b, const f32 tolerance = 1e-4f) {
+	f32 lhs[16];
+	f32 rhs[16];
+	memcpy(lhs, &a, sizeof(lhs));
+	memcpy(rhs, &b, sizeof(rhs));
+	for (usize i = 0; i < 16; ++i) {
+		if (!simd_math_near(lhs[i], rhs[i], tolerance)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static edge::Mat4 simd_math_mat4_mul_reference(const edge::Mat4& a, const edge::Mat4& b) {
+	f32 lhs[16];
+	f32 rhs[16];
+	f32 result[16] = {};
+	memcpy(lhs, &a, sizeof(lhs));
+	memcpy(rhs, &b, sizeof(rhs));
+	for (usize c = 0; c < 4; ++c) {
+		for (usize r = 0; r < 4; ++r) {
+			for (usize k = 0; k < 4; ++k) {
+				result[c * 4 + r] += lhs[k * 4 + r] * rhs[c * 4 + k];
+			}
+		}
+	}
+	edge::Mat4 out;
+	for (usize c = 0; c < 4; ++c) {
+		out.m_columns[c] = { result[c * 4], result[c * 4 + 1], result[c * 4 + 2], result[c * 4 + 3] };
+	}
+	return out;
+}
+
+TEST(simd_math) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+
+	edge::RngXoshiro256 rng = {};
+	rng.seed(0x044);
+
+	// Odd count so every kernel runs its scalar tail
+	constexpr usize COUNT = 37;
+	f32* soa = alloc.allocate_array<f32>(COUNT * 13);
+	for (usize i = 0; i < COUNT * 13; ++i) {
+		soa[i] = edge::rng_gen_f32_range(rng, -2.0f, 2.0f);
+	}
+	const edge::Vec3Soa translations = { soa, soa + COUNT, soa + COUNT * 2 };
+	const edge::QuatSoa rotations = { soa + COUNT * 3, soa + COUNT * 4, soa + COUNT * 5, soa + COUNT * 6 };
+	const edge::Vec3Soa scales = { soa + COUNT * 7, soa + COUNT * 8, soa + COUNT * 9 };
+	const edge::Vec3Soa points = { soa + COUNT * 10, soa + COUNT * 11, soa + COUNT * 12 };
+	for (usize i = 0; i < COUNT; ++i) {
+		const edge::Quat q = edge::quat_normalize({ rotations.m_x[i], rotations.m_y[i], rotations.m_z[i], rotations.m_w[i] });
+		rotations.m_x[i] = q.x;
+		rotations.m_y[i] = q.y;
+		rotations.m_z[i] = q.z;
+		rotations.m_w[i] = q.w;
+		scales.m_x[i] = std::fabs(scales.m_x[i]) + 0.5f;
+		scales.m_y[i] = std::fabs(scales.m_y[i]) + 0.5f;
+		scales.m_z[i] = std::fabs(scales.m_z[i]) + 0.5f;
+	}
+
+	// Batched TRS matches the single element path, which matches T * R * S
+	edge::Mat4* trs = alloc.allocate_array<edge::Mat4>(COUNT);
+	edge::mat4_from_trs_batch(translations, rotations, scales, trs, COUNT);
+	bool trs_match = true;
+	for (usize i = 0; i < COUNT; ++i) {
+		const edge::Vec3 t = { translations.m_x[i], translations.m_y[i], translations.m_z[i] };
+		const edge::Quat q = { rotations.m_x[i], rotations.m_y[i], rotations.m_z[i], rotations.m_w[i] };
+		const edge::Vec3 s = { scales.m_x[i], scales.m_y[i], scales.m_z[i] };
+		edge::Mat4 translate;
+		translate.m_columns[3] = { t.x, t.y, t.z, 1.0f };
+		edge::Mat4 scale;
+		scale.m_columns[0].x = s.x;
+		scale.m_columns[1].y = s.y;
+		scale.m_columns[2].z = s.z;
+		const edge::Mat4 expected = simd_math_mat4_mul_reference(simd_math_mat4_mul_reference(translate, edge::quat_to_mat4(q)), scale);
+		trs_match &= simd_math_mat4_near(trs[i], expected);
+		trs_match &= simd_math_mat4_near(trs[i], edge::mat4_from_trs(t, q, s));
+
+		// Rotating through the quaternion agrees with the matrix
+		const edge::Vec3 v = { points.m_x[i], points.m_y[i], points.m_z[i] };
+		const edge::Vec3 by_quat = edge::quat_rotate(q, v);
+		const edge::Vec3 by_matrix = edge::mat4_transform_vector(edge::quat_to_mat4(q), v);
+		trs_match &= simd_math_near(by_quat.x, by_matrix.x) && simd_math_near(by_quat.y, by_matrix.y) && simd_math_near(by_quat.z, by_matrix.z);
+	}
+	SHOULD_EQUAL(trs_match, true);
+
+	// Quaternion product composes rotations and slerp hits its endpoints
+	const edge::Quat qa = edge::quat_from_axis_angle({ 0.0f, 0.0f, 1.0f }, 0.5f);
+	const edge::Quat qb = edge::quat_from_axis_angle({ 1.0f, 0.0f, 0.0f }, -1.25f);
+	const edge::Mat4 composed = edge::quat_to_mat4(edge::quat_mul(qa, qb));
+	SHOULD_EQUAL(simd_math_mat4_near(composed, simd_math_mat4_mul_reference(edge::quat_to_mat4(qa), edge::quat_to_mat4(qb))), true);
+	const edge::Quat start = edge::quat_slerp(qa, qb, 0.0f);
+	const edge::Quat end = edge::quat_slerp(qa, qb, 1.0f);
+	SHOULD_EQUAL(simd_math_near(std::fabs(edge::quat_dot(start, qa)), 1.0f), true);
+	SHOULD_EQUAL(simd_math_near(std::fabs(edge::quat_dot(end, qb)), 1.0f), true);
+
+	// Batched multiply matches the reference, also when writing in place
+	edge::Mat4* products = alloc.allocate_array<edge::Mat4>(COUNT);
+	edge::mat4_mul_batch(trs, trs + 1, products, COUNT - 1);
+	bool mul_match = true;
+	for (usize i = 0; i + 1 < COUNT; ++i) {
+		mul_match &= simd_math_mat4_near(products[i], simd_math_mat4_mul_reference(trs[i], trs[i + 1]));
+		mul_match &= simd_math_mat4_near(edge::mat4_mul(trs[i], trs[i + 1]), products[i]);
+	}
+	SHOULD_EQUAL(mul_match, true);
+	const edge::Mat4 first_expected = simd_math_mat4_mul_reference(products[0], trs[0]);
+	edge::mat4_mul_batch(products, trs, products, 1);
+	SHOULD_EQUAL(simd_math_mat4_near(products[0], first_expected), true);
+
+	// Inverse times the matrix is the identity, singular inputs are flagged
+	edge::Mat4* inverses = alloc.allocate_array<edge::Mat4>(COUNT);
+	trs[5].m_columns[1] = {};
+	u8 invertible[(COUNT + 7) / 8] = {};
+	edge::mat4_inverse_batch(trs, inverses, COUNT, invertible);
+	bool inverse_match = true;
+	for (usize i = 0; i < COUNT; ++i) {
+		const bool ok = (invertible[i / 8] >> (i % 8)) & 1;
+		edge::Mat4 single;
+		const bool single_ok = edge::mat4_inverse(trs[i], single);
+		inverse_match &= ok == (i != 5) && single_ok == ok;
+		if (ok) {
+			inverse_match &= simd_math_mat4_near(simd_math_mat4_mul_reference(inverses[i], trs[i]), edge::Mat4{}, 1e-3f);
+			inverse_match &= simd_math_mat4_near(single, inverses[i]);
+		}
+	}
+	SHOULD_EQUAL(inverse_match, true);
+	SHOULD_EQUAL(inverses[5].m_columns[3].w, 0.0f);
+	SHOULD_EQUAL(simd_math_mat4_near(edge::mat4_transpose(edge::mat4_transpose(trs[3])), trs[3]), true);
+
+	// Point transform against the per point matrix-vector product
+	f32* transformed = alloc.allocate_array<f32>(COUNT * 3);
+	const edge::Vec3Soa out_points = { transformed, transformed + COUNT, transformed + COUNT * 2 };
+	edge::transform_points(trs[0], points, out_points, COUNT);
+	bool points_match = true;
+	for (usize i = 0; i < COUNT; ++i) {
+		const edge::Vec3 expected = edge::mat4_transform_point(trs[0], { points.m_x[i], points.m_y[i], points.m_z[i] });
+		points_match &= simd_math_near(out_points.m_x[i], expected.x) && simd_math_near(out_points.m_y[i], expected.y) && simd_math_near(out_points.m_z[i], expected.z);
+	}
+	SHOULD_EQUAL(points_match, true);
+
+	// Bounds of points and transformed boxes contain the transformed corners
+	const edge::Aabb bounds = edge::aabb_from_points(points, COUNT);
+	bool bounds_match = true;
+	for (usize i = 0; i < COUNT; ++i) {
+		bounds_match &= points.m_x[i] >= bounds.m_min.x && points.m_x[i] <= bounds.m_max.x;
+		bounds_match &= points.m_y[i] >= bounds.m_min.y && points.m_y[i] <= bounds.m_max.y;
+		bounds_match &= points.m_z[i] >= bounds.m_min.z && points.m_z[i] <= bounds.m_max.z;
+	}
+	SHOULD_EQUAL(bounds_match, true);
+
+	edge::Aabb* boxes = alloc.allocate_array<edge::Aabb>(COUNT);
+	edge::Aabb* world = alloc.allocate_array<edge::Aabb>(COUNT);
+	for (usize i = 0; i < COUNT; ++i) {
+		boxes[i].m_min = { -1.0f, -0.5f, -0.25f };
+		boxes[i].m_max = { points.m_x[i] + 2.0f, points.m_y[i] + 2.0f, points.m_z[i] + 2.0f };
+	}
+	edge::aabb_transform_batch(boxes, trs, world, COUNT);
+	bool boxes_match = true;
+	for (usize i = 0; i < COUNT; ++i) {
+		edge::Vec3 corners[8];
+		for (usize corner = 0; corner < 8; ++corner) {
+			const edge::Vec3 local = {
+				(corner & 1) ? boxes[i].m_max.x : boxes[i].m_min.x,
+				(corner & 2) ? boxes[i].m_max.y : boxes[i].m_min.y,
+				(corner & 4) ? boxes[i].m_max.z : boxes[i].m_min.z
+			};
+			corners[corner] = edge::mat4_transform_point(trs[i], local);
+		}
+		edge::Aabb expected = { corners[0], corners[0] };
+		for (const edge::Vec3& corner : corners) {
+			expected.m_min = { edge::min(expected.m_min.x, corner.x), edge::min(expected.m_min.y, corner.y), edge::min(expected.m_min.z, corner.z) };
+			expected.m_max = { edge::max(expected.m_max.x, corner.x), edge::max(expected.m_max.y, corner.y), edge::max(expected.m_max.z, corner.z) };
+		}
+		boxes_match &= simd_math_near(world[i].m_min.x, expected.m_min.x, 1e-3f) && simd_math_near(world[i].m_max.x, expected.m_max.x, 1e-3f);
+		boxes_match &= simd_math_near(world[i].m_min.y, expected.m_min.y, 1e-3f) && simd_math_near(world[i].m_max.y, expected.m_max.y, 1e-3f);
+		boxes_match &= simd_math_near(world[i].m_min.z, expected.m_min.z, 1e-3f) && simd_math_near(world[i].m_max.z, expected.m_max.z, 1e-3f);
+	}
+	SHOULD_EQUAL(boxes_match, true);
+
+	alloc.deallocate_array(world, COUNT);
+	alloc.deallocate_array(boxes, COUNT);
+	alloc.deallocate_array(transformed, COUNT * 3);
+	alloc.deallocate_array(inverses, COUNT);
+	alloc.deallocate_array(products, COUNT);
+	alloc.deallocate_array(trs, COUNT);
+	alloc.deallocate_array(soa, COUNT * 13);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
+TEST(callable_storage) {
+	edge::Allocator alloc = edge::Allocator::create_tracking();
+	const usize allocs_before = alloc.get_alloc_count();
+
+	i32 counter = 0;
+	auto by_ref = edge::callable_create_from_lambda(&alloc, [&counter](i32 add) { counter += add; });
+	auto by_value = edge::callable_create_from_lambda(&alloc, [a = 1ull, b = 2ull, c = 3ull]() { return a + b + c; });
+	auto from_func = edge::callable_create_from_func(&alloc, +[](i32 x) { return x * 2; });
+
+	// Small captures and plain functions live inline
+	SHOULD_EQUAL(alloc.get_alloc_count(), allocs_before);
+
+	by_ref.invoke(5);
+	SHOULD_EQUAL(counter, 5);
+	SHOULD_EQUAL(by_value.invoke(), 6ull);
+	SHOULD_EQUAL(from_func.invoke(21), 42);
+
+	// Copies are trivial and keep pointing at the same functor state
+	auto copy = by_ref;
+	copy.invoke(2);
+	SHOULD_EQUAL(counter, 7);
+
+	u64 big[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	auto oversized = edge::callable_create_from_lambda(&alloc, [big]() {
+		u64 sum = 0;
+		for (u64 value : big) sum += value;
+		return sum;
+	});
+	SHOULD_EQUAL(alloc.get_alloc_count(), allocs_before + 1);
+	SHOULD_EQUAL(oversized.invoke(), 36ull);
+
+	copy.destroy(&alloc);
+	by_value.destroy(&alloc);
+	from_func.destroy(&alloc);
+	oversized.destroy(&alloc);
+	SHOULD_EQUAL(oversized.is_valid(), false);
+
+	SHOULD_EQUAL(alloc.get_net(), 0ull);
+	return 0;
+}
+
 int main(void) {
 	//const char json_str[] = "{ \"key\" = \"Tvoja mama sosala zalupu\" }";
 	const char json_str[] = "\"Tvoja mama sosala zalupu\"";
@@ -754,12 +2747,22 @@ int main(void) {
 	RUN_TEST(array_resize);
 	RUN_TEST(array_remove);
 
+	RUN_TEST(array_virtual);
+	RUN_TEST(small_array_basic);
+	RUN_TEST(string_sso);
+	RUN_TEST(string_id);
+
 	RUN_TEST(list_basic);
 	RUN_TEST(list_push_pop);
 	RUN_TEST(list_insert_remove);
 	RUN_TEST(list_reverse);
 	RUN_TEST(list_sort);
 	RUN_TEST(list_find);
+	RUN_TEST(list_pooled);
+	RUN_TEST(intrusive_list_basic);
+	RUN_TEST(deque_basic);
+	RUN_TEST(sort_radix_merge);
+	RUN_TEST(sort_parallel);
 
 	RUN_TEST(hashmap_basic);
 	RUN_TEST(hashmap_update);
@@ -767,6 +2770,8 @@ int main(void) {
 	RUN_TEST(hashmap_iteration);
 	RUN_TEST(hashmap_rehash);
 	RUN_TEST(hashmap_clear);
+	RUN_TEST(hashmap_try_emplace);
+	RUN_TEST(hashmap_remove_many);
 
 	RUN_TEST(bitarray_basic);
 	RUN_TEST(bitarray_put);
@@ -774,11 +2779,38 @@ int main(void) {
 	RUN_TEST(bitarray_count);
 	RUN_TEST(bitarray_find_first);
 	RUN_TEST(bitarray_any_all);
+	RUN_TEST(bitset_hierarchical);
+	RUN_TEST(free_index_list_range);
+
+	RUN_TEST(handle_pool_basic);
+	RUN_TEST(handle_pool_handle64);
 
 	RUN_TEST(mpmc_queue_basic);
 	RUN_TEST(mpmc_queue_full);
 	RUN_TEST(mpmc_queue_try_operations);
 	RUN_TEST(mpmc_queue_multithreaded);
 
+	RUN_TEST(concurrent_hashmap_basic);
+	RUN_TEST(concurrent_hashmap_multithreaded);
+
+	RUN_TEST(tlsf_basic);
+	RUN_TEST(tlsf_allocator);
+
+	RUN_TEST(callable_storage);
+	RUN_TEST(hash_xxh3);
+	RUN_TEST(hash_crc32);
+	RUN_TEST(string_utf8);
+	RUN_TEST(string_view_search);
+	RUN_TEST(format_basic);
+	RUN_TEST(random_batch);
+	RUN_TEST(simd_math);
+	RUN_TEST(filesystem_native);
+	RUN_TEST(filesystem_entry_cache);
+	RUN_TEST(filesystem_mapped);
+	RUN_TEST(filesystem_read_batch);
+	RUN_TEST(filesystem_archive);
+	RUN_TEST(filesystem_walk);
+	RUN_TEST(filesystem_watch);
+
 	return 0;
 }
\ No newline at end of file
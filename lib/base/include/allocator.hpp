@@ -6,11 +6,18 @@
 #include <atomic>
 #include <new>
 
+#if defined(EDGE_PLATFORM_LINUX) || defined(EDGE_PLATFORM_ANDROID)
+#include <malloc.h>
+#elif defined(EDGE_PLATFORM_MACOS) || defined(EDGE_PLATFORM_IOS)
+#include <malloc/malloc.h>
+#endif
+
 namespace edge {
 namespace detail {
 struct AllocatorStats {
   std::atomic_size_t alloc_bytes;
   std::atomic_size_t free_bytes;
+  std::atomic_size_t alloc_count;
 };
 
 struct AllocationHeader {
@@ -82,6 +89,26 @@ inline void *aligned_realloc(void *ptr, const usize new_size,
 
 #if defined(EDGE_HAS_WINDOWS_API)
   return _aligned_realloc(ptr, new_size, alignment);
+#elif defined(EDGE_PLATFORM_POSIX)
+  // NOTE: malloc already satisfies small alignments, let the C runtime grow the
+  // block in place (glibc uses mremap for large blocks).
+  if (alignment <= alignof(max_align_t)) {
+    return realloc(ptr, new_size);
+  }
+
+  void *new_ptr = aligned_malloc(new_size, alignment);
+  if (!new_ptr) {
+    return nullptr;
+  }
+
+#if defined(EDGE_PLATFORM_MACOS) || defined(EDGE_PLATFORM_IOS)
+  const usize old_size = malloc_size(ptr);
+#else
+  const usize old_size = malloc_usable_size(ptr);
+#endif
+  memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+  aligned_free(ptr);
+  return new_ptr;
 #else
   void *new_ptr = aligned_malloc(new_size, alignment);
   if (!new_ptr) {
@@ -125,6 +152,7 @@ inline void *tracked_malloc(const usize size, const usize alignment, void *user_
 
   const auto stats = static_cast<AllocatorStats *>(user_data);
   stats->alloc_bytes.fetch_add(size);
+  stats->alloc_count.fetch_add(1);
 
   return static_cast<char *>(raw_ptr) + user_data_offset;
 }
@@ -215,6 +243,15 @@ struct Allocator {
     return stats->alloc_bytes.load() - stats->free_bytes.load();
   }
 
+  usize get_alloc_count() const {
+    const auto stats = static_cast<detail::AllocatorStats *>(user_data);
+    if (!stats) {
+      return ~0ull;
+    }
+
+    return stats->alloc_count.load();
+  }
+
   void *malloc(const usize size,
                const usize alignment = alignof(max_align_t)) const {
     if (!m_malloc) {
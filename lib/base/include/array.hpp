@@ -2,7 +2,9 @@
 #define EDGE_ARRAY_H
 
 #include "allocator.hpp"
+#include "math.hpp"
 #include "random_access_iterator.hpp"
+#include "vmem.hpp"
 
 #include <cstdlib>
 #include <cstring>
@@ -15,12 +17,15 @@ template <typename T> struct Array {
 
   void destroy(const NotNull<const Allocator *> alloc) {
     destroy_elements();
-    if (m_data) {
+    if (m_reserved_bytes) {
+      vmem_release(m_data, m_reserved_bytes);
+    } else if (m_data) {
       alloc->free(m_data);
     }
     m_data = nullptr;
     m_size = 0;
     m_capacity = 0;
+    m_reserved_bytes = 0;
   }
 
   void clear() {
@@ -36,6 +41,48 @@ template <typename T> struct Array {
     return grow_to(alloc, new_cap);
   }
 
+  // NOTE: Switches the array to a virtual memory reservation able to hold
+  // max_capacity elements. Pages are committed as the array grows, so growth
+  // never copies and element addresses stay stable. Meant for very large
+  // arrays, the reservation is rounded to whole pages.
+  bool reserve_virtual(const NotNull<const Allocator *> alloc,
+                       const size_type max_capacity) {
+    const usize page_size = vmem_page_size();
+    const usize reserve_bytes = align_up(max_capacity * sizeof(T), page_size);
+
+    if (m_reserved_bytes) {
+      return reserve_bytes <= m_reserved_bytes;
+    }
+
+    if (max_capacity < m_size) {
+      return false;
+    }
+
+    void *base = nullptr;
+    if (!vmem_reserve(&base, reserve_bytes)) {
+      return false;
+    }
+
+    const usize commit_bytes =
+        align_up((m_size ? m_size : 1) * sizeof(T), page_size);
+    if (!vmem_commit(base, commit_bytes)) {
+      vmem_release(base, reserve_bytes);
+      return false;
+    }
+
+    move_elements(static_cast<pointer>(base), m_data, m_size);
+    if (m_data) {
+      alloc->free(m_data);
+    }
+
+    m_data = static_cast<pointer>(base);
+    m_capacity = commit_bytes / sizeof(T);
+    m_reserved_bytes = reserve_bytes;
+    return true;
+  }
+
+  constexpr bool is_virtual() const noexcept { return m_reserved_bytes != 0; }
+
   bool resize(const NotNull<const Allocator *> alloc,
               const size_type new_size) {
     if (new_size > m_capacity) {
@@ -250,6 +297,7 @@ private:
   pointer m_data = nullptr;
   size_type m_size = 0;
   size_type m_capacity = 0;
+  usize m_reserved_bytes = 0;
 
   void destroy_elements() {
     if constexpr (!std::is_trivially_destructible_v<T>) {
@@ -261,6 +309,27 @@ private:
 
   bool grow_to(const NotNull<const Allocator *> alloc,
                const size_type new_cap) {
+    if (m_reserved_bytes) {
+      return commit_to(new_cap);
+    }
+
+    // NOTE: Relocatable elements survive a byte copy, so let the allocator
+    // resize the block, possibly in place.
+    if constexpr (TriviallyRelocatable<T>::value) {
+      if (alloc->m_realloc) {
+        auto new_data = static_cast<pointer>(
+            alloc->realloc(m_data, sizeof(T) * new_cap, alignof(T)));
+        assert(new_data && "Array: allocation failed during grow");
+        if (!new_data) {
+          return false;
+        }
+
+        m_data = new_data;
+        m_capacity = new_cap;
+        return true;
+      }
+    }
+
     auto new_data =
         static_cast<pointer>(alloc->malloc(sizeof(T) * new_cap, alignof(T)));
     assert(new_data && "Array: allocation failed during grow");
@@ -278,6 +347,33 @@ private:
     return true;
   }
 
+  bool commit_to(size_type new_cap) {
+    const usize max_capacity = m_reserved_bytes / sizeof(T);
+    if (new_cap > max_capacity) {
+      new_cap = max_capacity;
+    }
+
+    if (new_cap <= m_capacity) {
+      assert(false && "Array: virtual reservation exhausted");
+      return false;
+    }
+
+    const usize page_size = vmem_page_size();
+    const usize committed_bytes = align_down(m_capacity * sizeof(T), page_size);
+    usize commit_bytes = align_up(new_cap * sizeof(T), page_size);
+    if (commit_bytes > m_reserved_bytes) {
+      commit_bytes = m_reserved_bytes;
+    }
+
+    if (!vmem_commit(reinterpret_cast<u8 *>(m_data) + committed_bytes,
+                     commit_bytes - committed_bytes)) {
+      return false;
+    }
+
+    m_capacity = commit_bytes / sizeof(T);
+    return true;
+  }
+
   static void move_elements(pointer dst, pointer src, const size_type count) {
     if (!src || count == 0) {
       return;
@@ -294,6 +390,8 @@ private:
   }
 };
 
+template <typename T> struct TriviallyRelocatable<Array<T>> : std::true_type {};
+
 template <typename T, usize N> class StaticArray {
   static_assert(N > 0, "StaticArray: N must be greater than 0");
 
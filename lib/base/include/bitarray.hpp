@@ -3,28 +3,33 @@
 
 #include "stddef.hpp"
 
+#include <bit>
+
 namespace edge {
 template <usize BitCount> struct BitArray {
+  static constexpr usize WORD_COUNT = (BitCount + 63) / 64;
+
   static constexpr usize bit_count() { return BitCount; }
 
-  static constexpr usize byte_count() { return BitCount / 8; }
+  static constexpr usize byte_count() { return WORD_COUNT * sizeof(u64); }
 
-  constexpr void set(const usize index) { m_data[index / 8] |= (1 << (index % 8)); }
+  constexpr void set(const usize index) {
+    m_data[index / 64] |= (1ull << (index % 64));
+  }
 
   constexpr void clear(const usize index) {
-    m_data[index / 8] &= ~(1 << (index % 8));
+    m_data[index / 64] &= ~(1ull << (index % 64));
   }
 
   constexpr void toggle(const usize index) {
-    m_data[index / 8] ^= (1 << (index % 8));
+    m_data[index / 64] ^= (1ull << (index % 64));
   }
 
   constexpr bool get(const usize index) const {
-    return (m_data[index / 8] & (1 << (index % 8))) != 0;
+    return (m_data[index / 64] & (1ull << (index % 64))) != 0;
   }
 
   constexpr void put(const usize index, const bool value) {
-    value ? set(index) : clear(index);
     if (value) {
       set(index);
     } else {
@@ -32,36 +37,35 @@ template <usize BitCount> struct BitArray {
     }
   }
 
-  constexpr void clear_all() { memset(m_data, 0, sizeof(m_data)); }
+  constexpr void clear_all() {
+    for (usize i = 0; i < WORD_COUNT; i++) {
+      m_data[i] = 0ull;
+    }
+  }
 
-  constexpr void set_all() { memset(m_data, 0xFF, sizeof(m_data)); }
+  // NOTE: Bits past BitCount in the last word stay clear so counts and
+  // searches never see them.
+  constexpr void set_all() {
+    for (usize i = 0; i < WORD_COUNT; i++) {
+      m_data[i] = ~0ull;
+    }
+    if constexpr (BitCount % 64 != 0) {
+      m_data[WORD_COUNT - 1] = (1ull << (BitCount % 64)) - 1;
+    }
+  }
 
   constexpr usize count_set() const {
     usize count = 0;
-
-    for (usize i = 0; i < sizeof(m_data); i++) {
-      u8 byte = m_data[i];
-      while (byte) {
-        byte &= byte - 1;
-        count++;
-      }
+    for (usize i = 0; i < WORD_COUNT; i++) {
+      count += static_cast<usize>(std::popcount(m_data[i]));
     }
-
     return count;
   }
 
   constexpr usize find_first_set() const {
-    for (usize i = 0; i < sizeof(m_data); i++) {
+    for (usize i = 0; i < WORD_COUNT; i++) {
       if (m_data[i] != 0) {
-        for (usize bit = 0; bit < 8; bit++) {
-          const usize index = i * 8 + bit;
-          if (index >= BitCount) {
-            return -1;
-          }
-          if (m_data[i] & (1 << bit)) {
-            return index;
-          }
-        }
+        return i * 64 + static_cast<usize>(std::countr_zero(m_data[i]));
       }
     }
 
@@ -69,7 +73,7 @@ template <usize BitCount> struct BitArray {
   }
 
   constexpr bool any_set() const {
-    for (usize i = 0; i < sizeof(m_data); i++) {
+    for (usize i = 0; i < WORD_COUNT; i++) {
       if (m_data[i] != 0) {
         return true;
       }
@@ -80,8 +84,8 @@ template <usize BitCount> struct BitArray {
   constexpr bool all_clear() const { return !any_set(); }
 
 private:
-  u8 m_data[(BitCount + 7) / 8];
+  u64 m_data[WORD_COUNT];
 };
 } // namespace edge
 
-#endif
\ No newline at end of file
+#endif
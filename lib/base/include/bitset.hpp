@@ -0,0 +1,120 @@
+#ifndef EDGE_BITSET_H
+#define EDGE_BITSET_H
+
+#include "allocator.hpp"
+
+#include <bit>
+
+namespace edge {
+namespace detail {
+constexpr u32 BITSET_MAX_LEVELS = 6;
+
+usize bitset_popcount(const u64 *words, usize count);
+} // namespace detail
+
+constexpr usize BITSET_NPOS = ~0ull;
+
+// NOTE: Dynamically sized bitset with a summary hierarchy on top of the 64 bit
+// words. Each summary level keeps one bit per word of the level below for
+// "has a set bit" and one for "has a clear bit", so searches skip 64^n bits
+// per step and run in O(log64 n). Bits past size() read as clear and are never
+// returned by any search.
+struct BitSet {
+  u64 *m_words = nullptr;
+  usize m_size = 0ull;
+  u32 m_level_count = 0u;
+  usize m_level_words[detail::BITSET_MAX_LEVELS] = {};
+  u64 *m_any[detail::BITSET_MAX_LEVELS] = {};
+  u64 *m_not_full[detail::BITSET_MAX_LEVELS] = {};
+
+  bool create(NotNull<const Allocator *> alloc, usize bit_count);
+  void destroy(NotNull<const Allocator *> alloc);
+
+  // NOTE: Keeps existing bits, new bits start clear.
+  bool resize(NotNull<const Allocator *> alloc, usize bit_count);
+
+  usize size() const { return m_size; }
+
+  bool get(const usize index) const {
+    assert(index < m_size && "BitSet::get: index out of bounds");
+    return (m_words[index >> 6] >> (index & 63)) & 1ull;
+  }
+
+  void set(const usize index) {
+    assert(index < m_size && "BitSet::set: index out of bounds");
+    const usize word = index >> 6;
+    m_words[word] |= 1ull << (index & 63);
+    update_summary(word);
+  }
+
+  void clear(const usize index) {
+    assert(index < m_size && "BitSet::clear: index out of bounds");
+    const usize word = index >> 6;
+    m_words[word] &= ~(1ull << (index & 63));
+    update_summary(word);
+  }
+
+  void put(const usize index, const bool value) {
+    value ? set(index) : clear(index);
+  }
+
+  void set_range(usize first, usize count);
+  void clear_range(usize first, usize count);
+  void set_all() { set_range(0, m_size); }
+  void clear_all() { clear_range(0, m_size); }
+
+  usize find_first_set() const { return find_next_set(0); }
+  usize find_first_clear() const { return find_next_clear(0); }
+
+  // NOTE: First set or clear bit at or after from, BITSET_NPOS when none.
+  usize find_next_set(usize from) const;
+  usize find_next_clear(usize from) const;
+
+  // NOTE: Start of the first run of count clear bits at or after from. Each
+  // step jumps a whole set or clear run, useful for contiguous slot ranges.
+  usize find_clear_range(usize count, usize from = 0) const;
+
+  usize count_set() const;
+  bool any_set() const { return m_level_count && m_any[m_level_count - 1][0]; }
+  bool all_clear() const { return !any_set(); }
+
+private:
+  usize word_count() const { return m_level_words[0]; }
+
+  template <bool Set> u64 word_at(u32 level, usize index) const;
+  template <bool Set> usize find_next(usize from) const;
+
+  void update_summary(usize word);
+  void rebuild_summary(usize first_word, usize last_word);
+};
+
+inline void BitSet::update_summary(usize word) {
+  bool any = m_words[word] != 0ull;
+  bool not_full = m_words[word] != ~0ull;
+
+  // NOTE: Stop as soon as a level does not change, most updates touch only
+  // the first summary word.
+  for (u32 level = 1; level < m_level_count; ++level) {
+    const usize parent = word >> 6;
+    const u64 bit = 1ull << (word & 63);
+
+    const u64 old_any = m_any[level][parent];
+    const u64 old_not_full = m_not_full[level][parent];
+    const u64 new_any = any ? old_any | bit : old_any & ~bit;
+    const u64 new_not_full =
+        not_full ? old_not_full | bit : old_not_full & ~bit;
+    if (new_any == old_any && new_not_full == old_not_full) {
+      return;
+    }
+
+    m_any[level][parent] = new_any;
+    m_not_full[level][parent] = new_not_full;
+
+    any = new_any != 0ull;
+    not_full = new_not_full != 0ull;
+    word = parent;
+  }
+}
+} // namespace edge
+
+#endif
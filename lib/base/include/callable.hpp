@@ -27,61 +27,98 @@ template <typename R, typename... Args> struct callable_traits<R (*)(Args...)> {
   using return_type = R;
 };
 
+namespace detail {
+constexpr usize CALLABLE_INLINE_SIZE = 48;
+constexpr usize CALLABLE_INLINE_ALIGN = alignof(max_align_t);
+
+template <typename F>
+constexpr bool callable_fits_inline =
+    sizeof(F) <= CALLABLE_INLINE_SIZE && alignof(F) <= CALLABLE_INLINE_ALIGN &&
+    TriviallyRelocatable<F>::value;
+} // namespace detail
+
 template <typename> struct Callable;
 
+// NOTE: Functors that fit the inline storage and can be moved with memcpy live
+// in place, anything else is heap allocated and the storage holds the pointer.
+// Either way Callable itself is trivially copyable, copies share the functor
+// and exactly one of them has to be destroyed.
 template <typename R, typename... Args> struct Callable<R(Args...)> {
+  using InvokeFn = R (*)(void *storage, Args... args);
+  using DestroyFn = void (*)(void *storage, NotNull<const Allocator *> alloc);
+
+  alignas(detail::CALLABLE_INLINE_ALIGN) u8
+      storage[detail::CALLABLE_INLINE_SIZE];
+  InvokeFn invoke_fn = nullptr;
+  DestroyFn destroy_fn = nullptr;
+
+  template <typename F>
+  static Callable create(const NotNull<const Allocator *> alloc, F &&functor) {
+    using FType = std::decay_t<F>;
+
+    Callable result;
+    if constexpr (detail::callable_fits_inline<FType>) {
+      new (result.storage) FType(std::forward<F>(functor));
+      result.invoke_fn = [](void *storage, Args... args) -> R {
+        FType *fn = std::launder(static_cast<FType *>(storage));
+        return (*fn)(std::forward<Args>(args)...);
+      };
+
+      if constexpr (!std::is_trivially_destructible_v<FType>) {
+        result.destroy_fn = [](void *storage, NotNull<const Allocator *>) {
+          std::launder(static_cast<FType *>(storage))->~FType();
+        };
+      }
+    } else {
+      FType *stored = alloc->allocate<FType>(std::forward<F>(functor));
+      if (!stored) {
+        return result;
+      }
+
+      memcpy(result.storage, &stored, sizeof(FType *));
+      result.invoke_fn = [](void *storage, Args... args) -> R {
+        FType *fn;
+        memcpy(&fn, storage, sizeof(FType *));
+        return (*fn)(std::forward<Args>(args)...);
+      };
+      result.destroy_fn = [](void *storage,
+                             const NotNull<const Allocator *> alloc) {
+        FType *fn;
+        memcpy(&fn, storage, sizeof(FType *));
+        alloc->deallocate(fn);
+      };
+    }
+
+    return result;
+  }
+
   R invoke(Args... args) const {
-    return invoke_fn(data, std::forward<Args>(args)...);
+    return invoke_fn(const_cast<u8 *>(storage), std::forward<Args>(args)...);
   }
 
   void destroy(const NotNull<const Allocator *> alloc) {
-    if (data) {
-      alloc->deallocate(data);
+    if (destroy_fn) {
+      destroy_fn(storage, alloc);
     }
     invoke_fn = nullptr;
-    data = nullptr;
+    destroy_fn = nullptr;
   }
 
   bool is_valid() const { return invoke_fn != nullptr; }
-
-  R (*invoke_fn)(void *data, Args... args) = nullptr;
-  void *data = nullptr;
 };
 
 template <typename R, typename... Args>
 Callable<R(Args...)>
 callable_create_from_func(const NotNull<const Allocator *> alloc, R (*fn)(Args...)) {
-  using FnPtr = R (*)(Args...);
-
-  FnPtr *stored = alloc->allocate<FnPtr>(fn);
-
-  Callable<R(Args...)> result;
-  result.invoke_fn = [](void *data, Args... args) -> R {
-    FnPtr fn_ptr = *static_cast<FnPtr *>(data);
-    return fn_ptr(std::forward<Args>(args)...);
-  };
-  result.data = stored;
-  return result;
+  return Callable<R(Args...)>::create(alloc, fn);
 }
 
 template <typename F>
 auto callable_create_from_lambda(const NotNull<const Allocator *> alloc,
                                         F &&functor) {
-  using FType = std::decay_t<F>;
-  using Sig = callable_traits<FType>::signature;
-
-  auto *stored = alloc->allocate<FType>(std::forward<F>(functor));
-
-  return [=]<typename R, typename... Args>(R (*)(Args...)) {
-    Callable<R(Args...)> result;
-    result.invoke_fn = [](void *data, Args... args) -> R {
-      FType *fn = static_cast<FType *>(data);
-      return (*fn)(std::forward<Args>(args)...);
-    };
-    result.data = stored;
-    return result;
-  }(static_cast<Sig *>(nullptr));
+  using Sig = typename callable_traits<std::decay_t<F>>::signature;
+  return Callable<Sig>::create(alloc, std::forward<F>(functor));
 }
 } // namespace edge
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,253 @@
+#ifndef EDGE_CONCURRENT_HASHMAP_H
+#define EDGE_CONCURRENT_HASHMAP_H
+
+#include "array.hpp"
+#include "epoch.hpp"
+#include "hashmap.hpp"
+#include "threads.hpp"
+
+namespace edge {
+namespace detail {
+constexpr usize CONCURRENT_HASHMAP_DEFAULT_SHARD_COUNT = 64;
+constexpr usize CONCURRENT_HASHMAP_RECLAIM_THRESHOLD = 64;
+} // namespace detail
+
+// NOTE: Lock striped map for caches shared between workers. Each shard is a
+// HashMap of pointers guarded by a RwLock, values are allocated separately so
+// they keep their address across rehashes. Pointers returned by find and
+// get_or_insert_with stay valid while the EpochGuard they were obtained under
+// is alive, even if the key is removed concurrently. Values are expected to be
+// immutable after insertion.
+template <typename K, typename V, typename Hash = Hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+struct ConcurrentHashMap {
+  struct Retired {
+    V *value;
+    u64 epoch;
+  };
+
+  struct alignas(64) Shard {
+    RwLock lock = {};
+    HashMap<K, V *, Hash, KeyEqual> map = {};
+    Array<Retired> retired = {};
+  };
+
+  bool create(const NotNull<const Allocator *> alloc, usize shard_count = 0ull,
+              const usize initial_capacity = 0ull) {
+    if (shard_count == 0ull) {
+      shard_count = detail::CONCURRENT_HASHMAP_DEFAULT_SHARD_COUNT;
+    }
+
+    if (!is_pow2(shard_count)) {
+      shard_count = next_pow2(shard_count);
+    }
+
+    m_epoch = alloc->allocate<EpochDomain>();
+    if (!m_epoch) {
+      return false;
+    }
+
+    m_shards = alloc->allocate_array<Shard>(shard_count);
+    if (!m_shards) {
+      alloc->deallocate(m_epoch);
+      m_epoch = nullptr;
+      return false;
+    }
+
+    m_shard_count = shard_count;
+    m_shard_shift = 64 - static_cast<u32>(std::countr_zero(shard_count));
+
+    for (usize i = 0; i < m_shard_count; ++i) {
+      if (!m_shards[i].map.create(alloc, initial_capacity / m_shard_count)) {
+        destroy(alloc);
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // NOTE: Must not race with any other access.
+  void destroy(const NotNull<const Allocator *> alloc) {
+    for (usize i = 0; i < m_shard_count; ++i) {
+      Shard &shard = m_shards[i];
+      for (auto &entry : shard.map) {
+        alloc->deallocate(entry.value);
+      }
+      for (const Retired &retired : shard.retired) {
+        alloc->deallocate(retired.value);
+      }
+
+      shard.map.destroy(alloc);
+      shard.retired.destroy(alloc);
+    }
+
+    if (m_shards) {
+      alloc->deallocate_array(m_shards, m_shard_count);
+    }
+
+    if (m_epoch) {
+      alloc->deallocate(m_epoch);
+    }
+
+    m_shards = nullptr;
+    m_shard_count = 0ull;
+    m_epoch = nullptr;
+    m_size.store(0, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] EpochGuard pin() const { return EpochGuard{m_epoch}; }
+
+  V *find(const EpochGuard &guard, const K &key) const {
+    assert(guard.m_domain == m_epoch && "ConcurrentHashMap::find: foreign guard");
+    (void)guard;
+
+    Shard &shard = shard_for(key);
+    rwlock_lock_shared(&shard.lock);
+    auto it = shard.map.find(key);
+    V *value = it != shard.map.end() ? it->value : nullptr;
+    rwlock_unlock_shared(&shard.lock);
+
+    return value;
+  }
+
+  // NOTE: fn runs under the shard write lock, so it is called at most once per
+  // key even when many threads miss at the same time. Keep it short.
+  template <typename F>
+  V *get_or_insert_with(const NotNull<const Allocator *> alloc,
+                        const EpochGuard &guard, const K &key, F &&fn) {
+    if (V *value = find(guard, key)) {
+      return value;
+    }
+
+    Shard &shard = shard_for(key);
+    rwlock_lock(&shard.lock);
+
+    if (auto it = shard.map.find(key); it != shard.map.end()) {
+      V *value = it->value;
+      rwlock_unlock(&shard.lock);
+      return value;
+    }
+
+    V *value = alloc->allocate<V>(fn());
+    if (value && !shard.map.insert(alloc, key, value)) {
+      alloc->deallocate(value);
+      value = nullptr;
+    }
+
+    if (value) {
+      m_size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    rwlock_unlock(&shard.lock);
+    return value;
+  }
+
+  // NOTE: Does not overwrite, returns false when the key already exists.
+  bool insert(const NotNull<const Allocator *> alloc, const K &key,
+              const V &value) {
+    Shard &shard = shard_for(key);
+    rwlock_lock(&shard.lock);
+
+    bool inserted = false;
+    if (!shard.map.contains(key)) {
+      V *new_value = alloc->allocate<V>(value);
+      if (new_value && shard.map.insert(alloc, key, new_value)) {
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        inserted = true;
+      } else {
+        alloc->deallocate(new_value);
+      }
+    }
+
+    rwlock_unlock(&shard.lock);
+    return inserted;
+  }
+
+  bool remove(const NotNull<const Allocator *> alloc, const K &key) {
+    Shard &shard = shard_for(key);
+    rwlock_lock(&shard.lock);
+
+    // NOTE: Room in the retire list is made before the unlink, a value that
+    // could not be retired afterwards would leak.
+    Array<Retired> &retired = shard.retired;
+    if (retired.size() == retired.capacity() &&
+        !retired.reserve(alloc, retired.capacity() == 0
+                                    ? 16
+                                    : retired.capacity() * 2)) {
+      rwlock_unlock(&shard.lock);
+      return false;
+    }
+
+    V *value = nullptr;
+    const bool removed = shard.map.remove(alloc, key, &value);
+    if (removed) {
+      m_size.fetch_sub(1, std::memory_order_relaxed);
+
+      // NOTE: Readers may still hold the pointer, free it once every thread
+      // pinned before the unlink has left.
+      retired.push_back(Retired{value, m_epoch->current()});
+      if (retired.size() >= detail::CONCURRENT_HASHMAP_RECLAIM_THRESHOLD) {
+        reclaim_shard(alloc, shard);
+      }
+    }
+
+    rwlock_unlock(&shard.lock);
+    return removed;
+  }
+
+  [[nodiscard]] bool contains(const K &key) const {
+    Shard &shard = shard_for(key);
+    rwlock_lock_shared(&shard.lock);
+    const bool found = shard.map.contains(key);
+    rwlock_unlock_shared(&shard.lock);
+    return found;
+  }
+
+  // NOTE: Frees retired values that no reader can reference anymore.
+  void reclaim(const NotNull<const Allocator *> alloc) {
+    for (usize i = 0; i < m_shard_count; ++i) {
+      Shard &shard = m_shards[i];
+      rwlock_lock(&shard.lock);
+      reclaim_shard(alloc, shard);
+      rwlock_unlock(&shard.lock);
+    }
+  }
+
+  [[nodiscard]] usize size() const {
+    return m_size.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  Shard *m_shards = nullptr;
+  usize m_shard_count = 0ull;
+  u32 m_shard_shift = 0u;
+  EpochDomain *m_epoch = nullptr;
+  std::atomic<usize> m_size = 0ull;
+
+private:
+  // NOTE: The shard index comes from a multiplicative remix of the hash, the
+  // shard HashMap consumes the low bits itself.
+  Shard &shard_for(const K &key) const {
+    const u64 hash = static_cast<u64>(Hash{}(key)) * 0x9e3779b97f4a7c15ull;
+    return m_shards[m_shard_count > 1 ? hash >> m_shard_shift : 0];
+  }
+
+  void reclaim_shard(const NotNull<const Allocator *> alloc, Shard &shard) {
+    m_epoch->try_advance();
+
+    for (usize i = 0; i < shard.retired.size();) {
+      if (!m_epoch->is_safe(shard.retired[i].epoch)) {
+        ++i;
+        continue;
+      }
+
+      alloc->deallocate(shard.retired[i].value);
+      shard.retired[i] = shard.retired.back();
+      shard.retired.pop_back();
+    }
+  }
+};
+} // namespace edge
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef EDGE_DEQUE_H
+#define EDGE_DEQUE_H
+
+#include "allocator.hpp"
+#include "span.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace edge {
+template <TrivialType T> struct DequeSpans {
+  Span<T> first;
+  Span<T> second;
+};
+
+// NOTE: Ring buffer with a power of two capacity, pushes and pops at both
+// ends are O(1) amortized. Elements live in at most two contiguous runs, see
+// as_spans(). Growth goes through Allocator::realloc and only the wrapped
+// part of the ring is moved afterwards.
+template <TrivialType T> struct Deque {
+  EDGE_DECLARE_CONTAINER_HEADER(T)
+
+  struct Iterator {
+    const Deque *m_deque;
+    size_type m_index;
+
+    reference operator*() const {
+      return m_deque->m_data[(m_deque->m_head + m_index) &
+                             (m_deque->m_capacity - 1)];
+    }
+
+    pointer operator->() const { return &**this; }
+
+    Iterator &operator++() {
+      m_index++;
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return m_index == other.m_index && m_deque == other.m_deque;
+    }
+    bool operator!=(const Iterator &other) const { return !(*this == other); }
+  };
+
+  void destroy(const NotNull<const Allocator *> alloc) {
+    if (m_data) {
+      alloc->free(m_data);
+    }
+    m_data = nullptr;
+    m_capacity = 0;
+    m_head = 0;
+    m_size = 0;
+  }
+
+  void clear() {
+    m_head = 0;
+    m_size = 0;
+  }
+
+  // NOTE: Rounds up to a power of two.
+  bool reserve(const NotNull<const Allocator *> alloc, size_type capacity) {
+    if (capacity <= m_capacity) {
+      return true;
+    }
+    return grow_to(alloc, std::bit_ceil(capacity));
+  }
+
+  bool push_back(const NotNull<const Allocator *> alloc, const T &element) {
+    if (m_size == m_capacity && !grow(alloc, m_size + 1)) {
+      return false;
+    }
+
+    m_data[(m_head + m_size) & (m_capacity - 1)] = element;
+    m_size++;
+    return true;
+  }
+
+  bool push_front(const NotNull<const Allocator *> alloc, const T &element) {
+    if (m_size == m_capacity && !grow(alloc, m_size + 1)) {
+      return false;
+    }
+
+    m_head = (m_head - 1) & (m_capacity - 1);
+    m_data[m_head] = element;
+    m_size++;
+    return true;
+  }
+
+  // NOTE: Appends count elements with at most two memcpy calls.
+  bool push_back_range(const NotNull<const Allocator *> alloc,
+                       const T *elements, const size_type count) {
+    if (count == 0) {
+      return true;
+    }
+
+    if (m_size + count > m_capacity && !grow(alloc, m_size + count)) {
+      return false;
+    }
+
+    const size_type tail = (m_head + m_size) & (m_capacity - 1);
+    const size_type first_count =
+        count < m_capacity - tail ? count : m_capacity - tail;
+    memcpy(m_data + tail, elements, sizeof(T) * first_count);
+    memcpy(m_data, elements + first_count, sizeof(T) * (count - first_count));
+    m_size += count;
+    return true;
+  }
+
+  bool pop_front(pointer out_element = nullptr) {
+    if (m_size == 0) {
+      return false;
+    }
+
+    if (out_element) {
+      *out_element = m_data[m_head];
+    }
+    m_head = (m_head + 1) & (m_capacity - 1);
+    m_size--;
+    return true;
+  }
+
+  bool pop_back(pointer out_element = nullptr) {
+    if (m_size == 0) {
+      return false;
+    }
+
+    m_size--;
+    if (out_element) {
+      *out_element = m_data[(m_head + m_size) & (m_capacity - 1)];
+    }
+    return true;
+  }
+
+  // NOTE: Pops up to count elements from the front into out_elements, which
+  // may be null to just drop them. Returns the number popped.
+  size_type pop_front_range(pointer out_elements, size_type count) {
+    if (count > m_size) {
+      count = m_size;
+    }
+
+    if (out_elements && count > 0) {
+      const size_type first_count =
+          count < m_capacity - m_head ? count : m_capacity - m_head;
+      memcpy(out_elements, m_data + m_head, sizeof(T) * first_count);
+      memcpy(out_elements + first_count, m_data,
+             sizeof(T) * (count - first_count));
+    }
+
+    if (count > 0) {
+      m_head = (m_head + count) & (m_capacity - 1);
+      m_size -= count;
+    }
+    return count;
+  }
+
+  reference operator[](const size_type index) {
+    assert(index < m_size && "Deque::operator[]: index out of bounds");
+    return at(index);
+  }
+
+  const_reference operator[](const size_type index) const {
+    assert(index < m_size && "Deque::operator[]: index out of bounds");
+    return m_data[(m_head + index) & (m_capacity - 1)];
+  }
+
+  reference front() {
+    assert(m_size > 0 && "Deque::front(): deque is empty");
+    return m_data[m_head];
+  }
+
+  reference back() {
+    assert(m_size > 0 && "Deque::back(): deque is empty");
+    return at(m_size - 1);
+  }
+
+  // NOTE: Front to back order, second is empty unless the ring wraps.
+  DequeSpans<T> as_spans() const {
+    if (m_size == 0) {
+      return {};
+    }
+
+    const size_type first_count =
+        m_size < m_capacity - m_head ? m_size : m_capacity - m_head;
+    return {Span<T>{m_data + m_head, first_count},
+            Span<T>{m_data, m_size - first_count}};
+  }
+
+  size_type size() const { return m_size; }
+  size_type capacity() const { return m_capacity; }
+  bool empty() const { return m_size == 0; }
+
+  Iterator begin() const { return {this, 0}; }
+  Iterator end() const { return {this, m_size}; }
+
+private:
+  pointer m_data = nullptr;
+  size_type m_capacity = 0;
+  size_type m_head = 0;
+  size_type m_size = 0;
+
+  reference at(const size_type index) {
+    return m_data[(m_head + index) & (m_capacity - 1)];
+  }
+
+  bool grow(const NotNull<const Allocator *> alloc, const size_type required) {
+    size_type capacity = m_capacity ? m_capacity * 2 : 16;
+    while (capacity < required) {
+      capacity *= 2;
+    }
+    return grow_to(alloc, capacity);
+  }
+
+  bool grow_to(const NotNull<const Allocator *> alloc,
+               const size_type new_capacity) {
+    pointer new_data;
+    if (alloc->m_realloc) {
+      new_data = static_cast<pointer>(
+          alloc->realloc(m_data, sizeof(T) * new_capacity, alignof(T)));
+    } else {
+      new_data = static_cast<pointer>(
+          alloc->malloc(sizeof(T) * new_capacity, alignof(T)));
+      if (new_data && m_data) {
+        memcpy(new_data, m_data, sizeof(T) * m_capacity);
+        alloc->free(m_data);
+      }
+    }
+
+    assert(new_data && "Deque: allocation failed during grow");
+    if (!new_data) {
+      return false;
+    }
+
+    // NOTE: The run that wrapped to the start of the old block moves right
+    // behind the old end, new_capacity is at least twice the old one so it
+    // always fits.
+    const size_type old_capacity = m_capacity;
+    if (m_head + m_size > old_capacity) {
+      memcpy(new_data + old_capacity, new_data,
+             sizeof(T) * (m_head + m_size - old_capacity));
+    }
+
+    m_data = new_data;
+    m_capacity = new_capacity;
+    return true;
+  }
+};
+
+template <typename T> struct TriviallyRelocatable<Deque<T>> : std::true_type {};
+} // namespace edge
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef EDGE_EPOCH_H
+#define EDGE_EPOCH_H
+
+#include "stddef.hpp"
+
+#include <atomic>
+
+namespace edge {
+constexpr u32 EPOCH_MAX_THREADS = 128;
+
+namespace detail {
+// NOTE: Small per-thread index shared by all epoch domains, released when the
+// thread exits.
+u32 epoch_thread_index();
+} // namespace detail
+
+// NOTE: Epoch based reclamation. Readers pin the domain while they hold
+// pointers into a shared structure, writers unlink objects and tag them with
+// the current epoch. An object retired at epoch E is safe to free once the
+// global epoch reached E + 2, since every reader pinned before the unlink has
+// left by then.
+struct EpochDomain {
+  struct alignas(64) Participant {
+    // NOTE: 0 when not pinned, (epoch << 1) | 1 otherwise.
+    std::atomic<u64> epoch = 0ull;
+    u32 depth = 0u;
+  };
+
+  alignas(64) std::atomic<u64> m_global_epoch = 0ull;
+  Participant m_participants[EPOCH_MAX_THREADS] = {};
+
+  void enter();
+  void leave();
+  bool try_advance();
+
+  u64 current() const { return m_global_epoch.load(std::memory_order_acquire); }
+  bool is_safe(const u64 retire_epoch) const {
+    return current() >= retire_epoch + 2;
+  }
+};
+
+struct EpochGuard {
+  EpochDomain *m_domain = nullptr;
+
+  explicit EpochGuard(EpochDomain *domain) : m_domain(domain) {
+    m_domain->enter();
+  }
+
+  ~EpochGuard() {
+    if (m_domain) {
+      m_domain->leave();
+    }
+  }
+
+  EpochGuard(const EpochGuard &) = delete;
+  EpochGuard &operator=(const EpochGuard &) = delete;
+
+  EpochGuard(EpochGuard &&other) noexcept : m_domain(other.m_domain) {
+    other.m_domain = nullptr;
+  }
+};
+} // namespace edge
+
+#endif
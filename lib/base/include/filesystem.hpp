@@ -1,10 +1,20 @@
 #ifndef EDGE_FILESYSTEM_H
 #define EDGE_FILESYSTEM_H
 
+#include "arena.hpp"
 #include "array.hpp"
+#include "callable.hpp"
 #include "enumerator.hpp"
+#include "hashmap.hpp"
+#include "span.hpp"
 #include "string_view.hpp"
 
+#include <atomic>
+
+namespace edge {
+struct Scheduler;
+}
+
 namespace edge::filesystem {
 enum class AccessMode : u32 {
   Read = 1u << 0,
@@ -12,6 +22,14 @@ enum class AccessMode : u32 {
   Append = 1u << 2,
   Create = 1u << 3,
   Truncate = 1u << 4,
+  // NOTE: Access pattern hints, mapped to posix_fadvise and
+  // FILE_FLAG_SEQUENTIAL_SCAN/FILE_FLAG_RANDOM_ACCESS.
+  SequentialScan = 1u << 5,
+  RandomAccess = 1u << 6,
+  // NOTE: Bypasses the page cache (O_DIRECT, FILE_FLAG_NO_BUFFERING) for large
+  // streaming reads. Buffers, offsets and sizes must be aligned to
+  // FILE_DIRECT_ALIGNMENT. Falls back to buffered IO where unsupported.
+  Unbuffered = 1u << 7,
 };
 using AccessModeFlags = Flags<AccessMode>;
 
@@ -21,6 +39,32 @@ enum class EntryFlag : u32 {
 };
 using EntryFlags = Flags<EntryFlag>;
 
+enum class MapFlag : u32 {
+  Sequential = 1u << 0,
+  RandomAccess = 1u << 1,
+  WillNeed = 1u << 2,
+  // NOTE: Prefaults the whole range while mapping (MAP_POPULATE).
+  Populate = 1u << 3,
+  // NOTE: Transparent huge pages (MADV_HUGEPAGE) where the kernel supports
+  // them for file backed memory, ignored on Windows.
+  HugePages = 1u << 4,
+};
+using MapFlags = Flags<MapFlag>;
+
+enum class WalkFlag : u32 {
+  Recursive = 1u << 0,
+  // NOTE: Fills size and mtime. Without it only entries whose type the
+  // directory listing does not carry are stat'ed.
+  Metadata = 1u << 1,
+};
+using WalkFlags = Flags<WalkFlag>;
+
+enum class WalkChange : u32 {
+  Added,
+  Modified,
+  Removed,
+};
+
 enum struct StreamOrigin : u32 {
   Begin,
   Current,
@@ -30,10 +74,15 @@ enum struct StreamOrigin : u32 {
 
 EDGE_ENUM_FLAGS(filesystem::AccessMode)
 EDGE_ENUM_FLAGS(filesystem::EntryFlag)
+EDGE_ENUM_FLAGS(filesystem::MapFlag)
+EDGE_ENUM_FLAGS(filesystem::WalkFlag)
 
 namespace edge::filesystem {
 using Path = String;
 
+inline constexpr usize FILE_DIRECT_ALIGNMENT = 4096;
+inline constexpr u32 WATCH_DEFAULT_SETTLE_MS = 50;
+
 constexpr bool is_alpha(const char8_t c) {
   return (c >= u8'A' && c <= u8'Z') || (c >= u8'a' && c <= u8'z');
 }
@@ -43,21 +92,11 @@ constexpr bool is_separator(const char8_t c) {
 }
 
 constexpr usize find_last_separator(const StringView<char8_t> path) {
-  for (usize i = path.size(); i > 0; --i) {
-    if (is_separator(path[i - 1])) {
-      return i - 1;
-    }
-  }
-  return SIZE_MAX;
+  return path.find_last_of(u8"\\/");
 }
 
 constexpr usize find_first_separator(const StringView<char8_t> path) {
-  for (usize i = 0; i < path.size(); ++i) {
-    if (is_separator(path[i])) {
-      return i;
-    }
-  }
-  return SIZE_MAX;
+  return path.find_first_of(u8"\\/");
 }
 
 constexpr bool is_absolute(const StringView<char8_t> path) {
@@ -195,13 +234,21 @@ public:
 
   [[nodiscard]] virtual bool is_open() const = 0;
 
+  // NOTE: Returns the new position or SIZE_MAX on failure.
   [[nodiscard]] virtual usize seek(isize offset, StreamOrigin origin) = 0;
   [[nodiscard]] virtual usize tell() = 0;
+  [[nodiscard]] virtual u64 size() const = 0;
   virtual usize read(void *buffer_out, usize element_size,
                      usize element_count) const = 0;
   virtual usize write(const void *buffer_in, usize element_size,
                       usize element_count) const = 0;
 
+  // NOTE: Positional IO, safe to call from many threads on one file. Returns
+  // the byte count, short only at the end of the file or on error.
+  virtual usize read_at(u64 offset, void *buffer_out, usize size) const = 0;
+  virtual usize write_at(u64 offset, const void *buffer_in,
+                         usize size) const = 0;
+
   virtual bool flush() = 0;
 };
 
@@ -216,6 +263,153 @@ public:
   virtual bool remove(StringView<char8_t> path) = 0;
 
   virtual EntryFlags get_entry_flags(StringView<char8_t> path) = 0;
+
+  // NOTE: The returned file is released with alloc->deallocate, which closes
+  // it.
+  virtual IFile *open_file(NotNull<const Allocator *> alloc,
+                           StringView<char8_t> path, AccessModeFlags flags) = 0;
+};
+
+// NOTE: Read-only view of a file range. The OS handle is closed once the view
+// exists, the mapping alone keeps the pages alive until unmap.
+struct MappedFile {
+  const u8 *m_data = nullptr;
+  usize m_size = 0;
+  void *m_base = nullptr;
+  usize m_mapped_size = 0;
+
+  // NOTE: A size of 0 or one past the end maps up to the end of the file.
+  // Empty ranges fail.
+  bool map(StringView<char8_t> path, u64 offset = 0, usize size = 0,
+           MapFlags flags = MapFlags{});
+  void unmap();
+  // NOTE: Range hints relative to the view, rounded out to whole pages.
+  void advise(usize offset, usize size, MapFlags flags) const;
+
+  [[nodiscard]] bool is_mapped() const { return m_data != nullptr; }
+  [[nodiscard]] const u8 *data() const { return m_data; }
+  [[nodiscard]] usize size() const { return m_size; }
+};
+
+enum class ReadStatus : u32 {
+  Pending,
+  Completed,
+  OpenFailed,
+  // NOTE: The offset is at or past the end of the file.
+  OutOfRange,
+  // NOTE: No caller buffer and no arena, or the arena ran out.
+  NoBuffer,
+  // NOTE: Fewer than size bytes came back, bytes_read says how many.
+  ShortRead,
+};
+
+struct ReadRequest {
+  StringView<char8_t> path = {};
+  u64 offset = 0;
+  // NOTE: 0 reads up to the end of the file and is replaced with the
+  // resolved size.
+  usize size = 0;
+  // NOTE: Null buffers are allocated from the arena given to read_batch.
+  void *buffer = nullptr;
+  usize bytes_read = 0;
+  ReadStatus status = ReadStatus::Pending;
+
+  [[nodiscard]] bool completed() const {
+    return status == ReadStatus::Completed;
+  }
+};
+
+struct WalkEntry {
+  // NOTE: Relative to the walk root with '/' separators, only valid during
+  // the call it is passed to.
+  StringView<char8_t> path = {};
+  EntryFlags flags = {};
+  u64 size = 0;
+  // NOTE: Nanoseconds since the Unix epoch.
+  i64 mtime = 0;
+  // NOTE: Links are reported as their target but never descended into.
+  bool symlink = false;
+};
+
+// NOTE: Returning false skips the entry, and the whole subtree for
+// directories. An empty filter accepts everything.
+using WalkFilter = Callable<bool(const WalkEntry &)>;
+using WalkCallback = Callable<void(const WalkEntry &)>;
+using WalkChangeCallback = Callable<void(WalkChange, const WalkEntry &)>;
+
+struct WalkSnapshotEntry {
+  u64 size = 0;
+  i64 mtime = 0;
+  EntryFlags flags = {};
+};
+
+// NOTE: Persistent (path, size, mtime) listing of a tree. A rescan diffs a
+// fresh walk against it and reports only what changed.
+struct WalkSnapshot {
+  HashMap<StringView<char8_t>, WalkSnapshotEntry> m_entries = {};
+  Arena m_names = {};
+
+  bool create(NotNull<const Allocator *> alloc);
+  void destroy(NotNull<const Allocator *> alloc);
+
+  bool capture(NotNull<const Allocator *> alloc, StringView<char8_t> root,
+               const WalkFilter &filter = {}, Scheduler *sched = nullptr);
+  // NOTE: Directories only report Added and Removed, their mtime moves with
+  // every change to the children.
+  bool rescan(NotNull<const Allocator *> alloc, StringView<char8_t> root,
+              const WalkChangeCallback &callback,
+              const WalkFilter &filter = {}, Scheduler *sched = nullptr);
+
+  bool save(NotNull<const Allocator *> alloc, StringView<char8_t> path) const;
+  bool load(NotNull<const Allocator *> alloc, StringView<char8_t> path);
+
+  [[nodiscard]] const WalkSnapshotEntry *find(StringView<char8_t> path) const;
+  [[nodiscard]] usize size() const { return m_entries.size(); }
+};
+
+struct WatchEvent {
+  // NOTE: The watched directory joined with the changed path below it.
+  StringView<char8_t> path = {};
+  WalkChange change = WalkChange::Modified;
+};
+
+struct WatchPending {
+  WalkChange change = WalkChange::Modified;
+  i64 last_event = 0;
+};
+
+// NOTE: Change notifications for directory trees over inotify and
+// ReadDirectoryChangesW. poll never blocks, it drains the OS queue and folds
+// every event into one entry per path. A path is handed out once it has been
+// quiet for the settle time, so an editor's truncate, write and rename burst
+// arrives as a single change.
+struct Watcher {
+  void *m_native = nullptr;
+  HashMap<StringView<char8_t>, WatchPending> m_pending = {};
+  Array<WatchEvent> m_batch = {};
+  i64 m_settle_time = 0;
+  bool m_overflowed = false;
+
+  bool create(NotNull<const Allocator *> alloc,
+              u32 settle_ms = WATCH_DEFAULT_SETTLE_MS);
+  void destroy(NotNull<const Allocator *> alloc);
+
+  // NOTE: Recursive watches follow directories created later on.
+  bool add(NotNull<const Allocator *> alloc, StringView<char8_t> directory,
+           bool recursive = true);
+
+  // NOTE: Returns the changes that settled since the last call, valid until
+  // the next one. Call it once per frame.
+  Span<const WatchEvent> poll(NotNull<const Allocator *> alloc);
+  // NOTE: The OS dropped events during the last poll, anything below the
+  // watched directories may have changed. WalkSnapshot::rescan recovers.
+  [[nodiscard]] bool overflowed() const { return m_overflowed; }
+};
+
+struct ResolvedPath {
+  StringView<char8_t> relative_path;
+  IFilesystem *filesystem;
+  usize mount_index = SIZE_MAX;
 };
 
 struct MountPoint {
@@ -243,7 +437,16 @@ public:
   bool create_directories(StringView<char8_t> path);
   bool remove(StringView<char8_t> path) const;
 
+  IFile *open_file(NotNull<const Allocator *> alloc, StringView<char8_t> path,
+                   AccessModeFlags flags) const;
+
+  // NOTE: Entry queries are cached until the next change made through this
+  // object. Changes made behind its back need an explicit invalidation.
+  void invalidate_cache() const;
+
 private:
+  static constexpr usize ENTRY_CACHE_SIZE = 256;
+
   static Filesystem *s_instance;
 
   String m_cwd_path;
@@ -251,7 +454,23 @@ private:
   String m_cached_path;
   Array<MountPoint> m_mount_points;
 
-  MountPoint resolve_path(StringView<char8_t> path) const;
+  // NOTE: Direct mapped. A slot keeps the full path hash next to the path
+  // length, cache generation and entry flags, an odd sequence marks a write
+  // in progress so lookups from many threads stay lock free.
+  struct EntryCacheSlot {
+    std::atomic<u32> sequence = 0;
+    std::atomic<u64> hash = 0;
+    std::atomic<u64> state = 0;
+  };
+  mutable EntryCacheSlot m_entry_cache[ENTRY_CACHE_SIZE];
+  mutable std::atomic<u32> m_entry_cache_generation = 1;
+
+  // NOTE: Mounts overlay each other, the longest matching prefix comes first
+  // and later mounts come first on ties. Passing the previous result walks
+  // down to the next mount that covers the path.
+  ResolvedPath resolve_path(StringView<char8_t> path,
+                            const ResolvedPath *after = nullptr) const;
+  EntryFlags get_entry_flags(StringView<char8_t> path) const;
 };
 
 bool file_exists(StringView<char8_t> path);
@@ -264,5 +483,35 @@ bool remove_directory(StringView<char8_t> path);
 bool rename_path(StringView<char8_t> from, StringView<char8_t> to);
 bool copy_file(StringView<char8_t> from, StringView<char8_t> to);
 
+// NOTE: Opens a file on the OS filesystem, bypassing the mount points.
+IFile *open_native_file(NotNull<const Allocator *> alloc,
+                        StringView<char8_t> path, AccessModeFlags flags);
+// NOTE: Reads every request in one pass over the OS filesystem. Requests are
+// ordered by device, inode and offset, each file is opened once and nearby
+// ranges of a file are merged into a single vectored read. At most a few
+// hundred files are open at a time. Returns the number of completed requests.
+usize read_batch(NotNull<const Allocator *> alloc, Span<ReadRequest> requests,
+                 Arena *arena = nullptr);
+// NOTE: Enumerates root on the OS filesystem straight from the directory
+// listing (getdents64, FindFirstFileEx). With a scheduler, subtrees are
+// spread over the background workers and the callbacks run concurrently in
+// no particular order. Unreadable subdirectories are skipped, only a missing
+// root fails.
+bool walk(NotNull<const Allocator *> alloc, StringView<char8_t> root,
+          const WalkFilter &filter, const WalkCallback &callback,
+          WalkFlags flags = WalkFlags{WalkFlag::Recursive},
+          Scheduler *sched = nullptr);
+// NOTE: OS directory provider for Filesystem::mount, relative paths resolve
+// against root and absolute ones are used as is.
+IFilesystem *create_native_filesystem(NotNull<const Allocator *> alloc,
+                                      StringView<char8_t> root);
+// NOTE: Read-only providers for Filesystem::mount over a mapping of the whole
+// archive. Stored entries are read in place, deflated zip entries are inflated
+// on open when zlib is available.
+IFilesystem *create_zip_filesystem(NotNull<const Allocator *> alloc,
+                                   StringView<char8_t> archive_path);
+IFilesystem *create_tar_filesystem(NotNull<const Allocator *> alloc,
+                                   StringView<char8_t> archive_path);
+
 } // namespace edge::filesystem
 #endif
\ No newline at end of file
@@ -0,0 +1,446 @@
+#ifndef EDGE_FORMAT_H
+#define EDGE_FORMAT_H
+
+#include "arena.hpp"
+#include "span.hpp"
+#include "string_view.hpp"
+
+#include <type_traits>
+
+namespace edge {
+// NOTE: Replacement fields follow std::format: {} or {:[[fill]align][sign][#]
+// [0][width][.precision][type]}, {{ and }} are literal braces. Supported types
+// are d x X b o c for integers, f F e E g G for floats, s for strings and
+// bools and p for pointers. Span arguments apply the spec to every element.
+enum class FormatArgType : u8 {
+  None,
+  Bool,
+  Char,
+  Signed,
+  Unsigned,
+  Float,
+  Double,
+  CString,
+  String,
+  Pointer,
+  Span,
+};
+
+struct FormatSpec {
+  char m_fill = ' ';
+  char m_align = '\0';
+  char m_sign = '-';
+  bool m_alternate = false;
+  bool m_zero_pad = false;
+  u32 m_width = 0;
+  i32 m_precision = -1;
+  char m_type = '\0';
+};
+
+struct FormatArg {
+  struct StringValue {
+    const char *m_data;
+    usize m_length;
+  };
+
+  struct SpanValue {
+    const void *m_data;
+    usize m_count;
+    FormatArgType m_type;
+    u8 m_size;
+  };
+
+  FormatArgType m_type = FormatArgType::None;
+  union {
+    bool m_bool;
+    char m_char;
+    i64 m_signed;
+    u64 m_unsigned;
+    f32 m_float;
+    f64 m_double;
+    const char *m_cstring;
+    const void *m_pointer;
+    StringValue m_string;
+    SpanValue m_span;
+  };
+};
+
+// NOTE: Output window of a format call. Writes past the capacity are dropped
+// but still counted, so m_length is the full formatted size.
+struct FormatBuffer {
+  char *m_data = nullptr;
+  usize m_capacity = 0;
+  usize m_length = 0;
+
+  void write(const char *data, const usize count) {
+    if (count > 0 && m_length < m_capacity) {
+      const usize available = m_capacity - m_length;
+      memcpy(m_data + m_length, data, count < available ? count : available);
+    }
+    m_length += count;
+  }
+
+  void put(const char c) {
+    if (m_length < m_capacity) {
+      m_data[m_length] = c;
+    }
+    m_length++;
+  }
+
+  void fill(const char c, const usize count) {
+    if (count > 0 && m_length < m_capacity) {
+      const usize available = m_capacity - m_length;
+      memset(m_data + m_length, c, count < available ? count : available);
+    }
+    m_length += count;
+  }
+};
+
+namespace detail {
+template <typename T> struct IsStringView : std::false_type {};
+template <typename CharT, typename Traits>
+struct IsStringView<StringView<CharT, Traits>>
+    : std::bool_constant<sizeof(CharT) == 1> {};
+
+template <typename T> struct IsSpan : std::false_type {};
+template <typename T> struct IsSpan<Span<T>> : std::true_type {};
+
+template <typename T> constexpr FormatArgType format_scalar_type() {
+  if constexpr (std::is_same_v<T, bool>) {
+    return FormatArgType::Bool;
+  } else if constexpr (std::is_same_v<T, char> ||
+                       std::is_same_v<T, char8_t>) {
+    return FormatArgType::Char;
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    return FormatArgType::Signed;
+  } else if constexpr (std::is_integral_v<T>) {
+    return FormatArgType::Unsigned;
+  } else if constexpr (std::is_same_v<T, f32>) {
+    return FormatArgType::Float;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return FormatArgType::Double;
+  } else {
+    return FormatArgType::None;
+  }
+}
+
+template <typename T> constexpr FormatArgType format_arg_type() {
+  using U = std::remove_cvref_t<T>;
+  if constexpr (format_scalar_type<U>() != FormatArgType::None) {
+    return format_scalar_type<U>();
+  } else if constexpr (std::is_array_v<U> &&
+                       (std::is_same_v<std::remove_extent_t<U>, char> ||
+                        std::is_same_v<std::remove_extent_t<U>, char8_t>)) {
+    return FormatArgType::CString;
+  } else if constexpr (std::is_same_v<std::decay_t<U>, const char *> ||
+                       std::is_same_v<std::decay_t<U>, char *> ||
+                       std::is_same_v<std::decay_t<U>, const char8_t *> ||
+                       std::is_same_v<std::decay_t<U>, char8_t *>) {
+    return FormatArgType::CString;
+  } else if constexpr (IsStringView<U>::value || std::is_same_v<U, String>) {
+    return FormatArgType::String;
+  } else if constexpr (std::is_pointer_v<U> ||
+                       std::is_same_v<U, std::nullptr_t>) {
+    return FormatArgType::Pointer;
+  } else if constexpr (IsSpan<U>::value) {
+    return format_scalar_type<std::remove_cv_t<typename U::element_type>>() !=
+                   FormatArgType::None
+               ? FormatArgType::Span
+               : FormatArgType::None;
+  } else {
+    return FormatArgType::None;
+  }
+}
+
+template <typename T> constexpr FormatArgType format_element_type() {
+  using U = std::remove_cvref_t<T>;
+  if constexpr (IsSpan<U>::value) {
+    return format_scalar_type<std::remove_cv_t<typename U::element_type>>();
+  } else {
+    return FormatArgType::None;
+  }
+}
+
+template <typename T> FormatArg make_format_arg(const T &value) {
+  constexpr FormatArgType type = format_arg_type<T>();
+  static_assert(type != FormatArgType::None,
+                "edge::format: argument type is not formattable");
+
+  FormatArg arg = {};
+  arg.m_type = type;
+  if constexpr (type == FormatArgType::Bool) {
+    arg.m_bool = value;
+  } else if constexpr (type == FormatArgType::Char) {
+    arg.m_char = static_cast<char>(value);
+  } else if constexpr (type == FormatArgType::Signed) {
+    arg.m_signed = static_cast<i64>(value);
+  } else if constexpr (type == FormatArgType::Unsigned) {
+    arg.m_unsigned = static_cast<u64>(value);
+  } else if constexpr (type == FormatArgType::Float) {
+    arg.m_float = value;
+  } else if constexpr (type == FormatArgType::Double) {
+    arg.m_double = static_cast<f64>(value);
+  } else if constexpr (type == FormatArgType::CString) {
+    arg.m_cstring = reinterpret_cast<const char *>(value);
+  } else if constexpr (type == FormatArgType::String) {
+    arg.m_string = {reinterpret_cast<const char *>(value.data()),
+                    value.length()};
+  } else if constexpr (type == FormatArgType::Pointer) {
+    arg.m_pointer = static_cast<const void *>(value);
+  } else {
+    using Element = std::remove_cv_t<typename T::element_type>;
+    arg.m_span = {value.data(), value.size(), format_scalar_type<Element>(),
+                  static_cast<u8>(sizeof(Element))};
+  }
+  return arg;
+}
+
+// NOTE: Not constexpr on purpose, reaching it while checking a format string
+// at compile time turns into an error pointing at the message.
+inline void format_string_error(const char *message) { (void)message; }
+
+constexpr bool format_is_digit(const char c) { return c >= '0' && c <= '9'; }
+
+// NOTE: Parses the spec after ':' up to and including the closing brace.
+constexpr bool parse_format_spec(const char *&it, const char *end,
+                                 FormatSpec &spec) {
+  auto is_align = [](const char c) { return c == '<' || c == '>' || c == '^'; };
+
+  if (it + 1 < end && is_align(it[1]) && *it != '{' && *it != '}') {
+    spec.m_fill = *it;
+    spec.m_align = it[1];
+    it += 2;
+  } else if (it < end && is_align(*it)) {
+    spec.m_align = *it++;
+  }
+
+  if (it < end && (*it == '+' || *it == '-' || *it == ' ')) {
+    spec.m_sign = *it++;
+  }
+
+  if (it < end && *it == '#') {
+    spec.m_alternate = true;
+    it++;
+  }
+
+  if (it < end && *it == '0') {
+    spec.m_zero_pad = true;
+    it++;
+  }
+
+  while (it < end && format_is_digit(*it)) {
+    spec.m_width = spec.m_width * 10 + static_cast<u32>(*it++ - '0');
+  }
+
+  if (it < end && *it == '.') {
+    it++;
+    if (it >= end || !format_is_digit(*it)) {
+      return false;
+    }
+    spec.m_precision = 0;
+    while (it < end && format_is_digit(*it)) {
+      spec.m_precision = spec.m_precision * 10 + (*it++ - '0');
+    }
+  }
+
+  if (it < end && *it != '}') {
+    spec.m_type = *it++;
+  }
+
+  if (it >= end || *it != '}') {
+    return false;
+  }
+  it++;
+  return true;
+}
+
+constexpr bool format_spec_fits(const FormatSpec &spec,
+                                const FormatArgType type) {
+  const char t = spec.m_type;
+  const bool integer_type = t == 'd' || t == 'x' || t == 'X' || t == 'b' ||
+                            t == 'o' || t == 'c';
+  const bool float_type =
+      t == 'f' || t == 'F' || t == 'e' || t == 'E' || t == 'g' || t == 'G';
+
+  switch (type) {
+  case FormatArgType::Bool:
+    return (t == '\0' || t == 's' || integer_type) && spec.m_precision < 0;
+  case FormatArgType::Char:
+  case FormatArgType::Signed:
+  case FormatArgType::Unsigned:
+    return (t == '\0' || integer_type) && spec.m_precision < 0;
+  case FormatArgType::Float:
+  case FormatArgType::Double:
+    return t == '\0' || float_type;
+  case FormatArgType::CString:
+  case FormatArgType::String:
+    return t == '\0' || t == 's';
+  case FormatArgType::Pointer:
+    return (t == '\0' || t == 'p') && spec.m_precision < 0;
+  default:
+    return false;
+  }
+}
+
+constexpr void check_format_string(const char *it, const char *end,
+                                   const FormatArgType *types,
+                                   const FormatArgType *element_types,
+                                   const usize arg_count) {
+  usize next_arg = 0;
+  while (it < end) {
+    const char c = *it++;
+    if (c == '}') {
+      if (it >= end || *it != '}') {
+        format_string_error("edge::format: unmatched '}' in format string");
+      }
+      it++;
+      continue;
+    }
+
+    if (c != '{') {
+      continue;
+    }
+
+    if (it < end && *it == '{') {
+      it++;
+      continue;
+    }
+
+    FormatSpec spec = {};
+    if (it < end && *it == ':') {
+      it++;
+      if (!parse_format_spec(it, end, spec)) {
+        format_string_error("edge::format: malformed replacement field");
+      }
+    } else if (it < end && *it == '}') {
+      it++;
+    } else if (it >= end) {
+      format_string_error("edge::format: unterminated replacement field");
+    } else {
+      format_string_error("edge::format: only automatic {} indexing is "
+                          "supported");
+    }
+
+    if (next_arg >= arg_count) {
+      format_string_error("edge::format: more replacement fields than "
+                          "arguments");
+      return;
+    }
+
+    const FormatArgType type = types[next_arg] == FormatArgType::Span
+                                   ? element_types[next_arg]
+                                   : types[next_arg];
+    if (!format_spec_fits(spec, type)) {
+      format_string_error("edge::format: format spec does not fit the "
+                          "argument type");
+    }
+    next_arg++;
+  }
+
+  if (next_arg != arg_count) {
+    format_string_error("edge::format: fewer replacement fields than "
+                        "arguments");
+  }
+}
+
+usize vformat(FormatBuffer &out, const char *format, usize format_length,
+              const FormatArg *args, usize arg_count);
+} // namespace detail
+
+// NOTE: Format string checked against the argument types at compile time, a
+// mismatch fails the build inside check_format_string.
+template <typename... Args> struct FormatString {
+  template <usize N>
+  consteval FormatString(const char (&str)[N]) : m_data{str}, m_length{N - 1} {
+    constexpr FormatArgType types[] = {FormatArgType::None,
+                                       detail::format_arg_type<Args>()...};
+    constexpr FormatArgType element_types[] = {
+        FormatArgType::None, detail::format_element_type<Args>()...};
+    detail::check_format_string(m_data, m_data + m_length, types + 1,
+                                element_types + 1, sizeof...(Args));
+  }
+
+  const char *m_data;
+  usize m_length;
+};
+
+template <typename... Args>
+using FormatStringFor = FormatString<std::type_identity_t<Args>...>;
+
+// NOTE: Appends to an output window, lets a line be assembled from several
+// calls without tracking offsets. No terminator is written.
+template <typename... Args>
+void format_append(FormatBuffer &out, const FormatStringFor<Args...> format,
+                   const Args &...args) {
+  const FormatArg format_args[] = {FormatArg{},
+                                   detail::make_format_arg(args)...};
+  detail::vformat(out, format.m_data, format.m_length, format_args + 1,
+                  sizeof...(Args));
+}
+
+// NOTE: snprintf semantics, at most capacity - 1 characters plus a terminator
+// are written and the full formatted length is returned.
+template <typename... Args>
+usize format_to(char *buffer, const usize capacity,
+                const FormatStringFor<Args...> format, const Args &...args) {
+  FormatBuffer out = {buffer, capacity > 0 ? capacity - 1 : 0, 0};
+  format_append(out, format, args...);
+  if (capacity > 0) {
+    buffer[out.m_length < capacity ? out.m_length : capacity - 1] = '\0';
+  }
+  return out.m_length;
+}
+
+template <usize N, typename... Args>
+usize format_to(char (&buffer)[N], const FormatStringFor<Args...> format,
+                const Args &...args) {
+  return format_to(buffer, N, format, args...);
+}
+
+template <typename... Args>
+usize formatted_size(const FormatStringFor<Args...> format,
+                     const Args &...args) {
+  return format_to(nullptr, 0, format, args...);
+}
+
+// NOTE: Formats into arena memory, the view is null terminated. Short
+// results are formatted once on the stack, longer ones are measured first.
+template <typename... Args>
+StringView<char> format(Arena &arena, const FormatStringFor<Args...> format,
+                        const Args &...args) {
+  char stack[256];
+  const usize length = format_to(stack, format, args...);
+  auto *data = arena.alloc<char>(length + 1);
+  if (!data) {
+    return {};
+  }
+
+  if (length < sizeof(stack)) {
+    memcpy(data, stack, length + 1);
+  } else {
+    format_to(data, length + 1, format, args...);
+  }
+  return {data, length};
+}
+
+template <typename... Args>
+bool format_append(const NotNull<const Allocator *> alloc, String &str,
+                   const FormatStringFor<Args...> format, const Args &...args) {
+  char stack[256];
+  const usize length = format_to(stack, format, args...);
+  char8_t *tail = str.append_uninitialized(alloc, length);
+  if (!tail) {
+    return false;
+  }
+
+  if (length < sizeof(stack)) {
+    memcpy(tail, stack, length);
+  } else {
+    // NOTE: The terminator lands on the one String already keeps after data.
+    format_to(reinterpret_cast<char *>(tail), length + 1, format, args...);
+  }
+  return true;
+}
+} // namespace edge
+
+#endif
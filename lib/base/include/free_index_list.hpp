@@ -1,11 +1,13 @@
 #ifndef EDGE_FREE_INDEX_LIST_H
 #define EDGE_FREE_INDEX_LIST_H
 
-#include "allocator.hpp"
+#include "bitset.hpp"
 
 namespace edge {
+// NOTE: One bit per index, set while the index is in use. Always hands out
+// the lowest free index, ranges are found by skipping whole used runs.
 struct FreeIndexList {
-  u32 *m_indices = nullptr;
+  BitSet m_used = {};
   u32 m_capacity = 0ull;
   u32 m_count = 0ull;
 
@@ -14,27 +16,18 @@ struct FreeIndexList {
       return false;
     }
 
-    m_indices = alloc->allocate_array<u32>(capacity);
-    if (!m_indices) {
+    if (!m_used.create(alloc, capacity)) {
       return false;
     }
 
     m_capacity = capacity;
     m_count = capacity;
 
-    // Initialize with all indices available in reverse order
-    // So index 0 is allocated first
-    for (u32 i = 0; i < capacity; i++) {
-      m_indices[i] = capacity - 1 - i;
-    }
-
     return true;
   }
 
-  void destroy(const NotNull<const Allocator *> alloc) const {
-    if (m_indices) {
-      alloc->deallocate_array(m_indices, m_capacity);
-    }
+  void destroy(const NotNull<const Allocator *> alloc) {
+    m_used.destroy(alloc);
   }
 
   bool allocate(u32 *out_index) {
@@ -42,20 +35,57 @@ struct FreeIndexList {
       return false;
     }
 
-    *out_index = m_indices[--m_count];
+    const usize index = m_used.find_first_clear();
+    if (index == BITSET_NPOS) {
+      return false;
+    }
+
+    m_used.set(index);
+    m_count--;
+    *out_index = static_cast<u32>(index);
+    return true;
+  }
+
+  bool allocate_range(const u32 count, u32 *out_first) {
+    if (!out_first || count == 0 || count > m_count) {
+      return false;
+    }
+
+    const usize first = m_used.find_clear_range(count);
+    if (first == BITSET_NPOS) {
+      return false;
+    }
+
+    m_used.set_range(first, count);
+    m_count -= count;
+    *out_first = static_cast<u32>(first);
     return true;
   }
 
   bool free(const u32 index) {
-    if (m_count >= m_capacity) {
+    if (index >= m_capacity || !m_used.get(index)) {
+      return false;
+    }
+
+    m_used.clear(index);
+    m_count++;
+    return true;
+  }
+
+  // NOTE: Every index in the range must be in use.
+  bool free_range(const u32 first, const u32 count) {
+    if (first >= m_capacity || count > m_capacity - first) {
       return false;
     }
 
-    if (index >= m_capacity) {
+    const usize end = static_cast<usize>(first) + count;
+    if (const usize next_free = m_used.find_next_clear(first);
+        next_free != BITSET_NPOS && next_free < end) {
       return false;
     }
 
-    m_indices[m_count++] = index;
+    m_used.clear_range(first, count);
+    m_count += count;
     return true;
   }
 
@@ -66,15 +96,15 @@ struct FreeIndexList {
   bool empty() const { return m_count == 0; }
 
   void reset() {
+    m_used.clear_all();
     m_count = m_capacity;
-
-    for (u32 i = 0; i < m_capacity; i++) {
-      m_indices[i] = m_capacity - 1 - i;
-    }
   }
 
-  void clear() { m_count = 0; }
+  void clear() {
+    m_used.set_all();
+    m_count = 0;
+  }
 };
 } // namespace edge
 
-#endif
\ No newline at end of file
+#endif
@@ -11,6 +11,10 @@ constexpr u32 HANDLE_INDEX_BITS = 20;
 constexpr u32 HANDLE_VERSION_BITS = 12;
 
 struct Handle {
+  using VersionType = HandleVersionType;
+  static constexpr u32 INDEX_BITS = HANDLE_INDEX_BITS;
+  static constexpr u32 VERSION_BITS = HANDLE_VERSION_BITS;
+
   u32 version : HANDLE_VERSION_BITS;
   u32 index : HANDLE_INDEX_BITS;
 
@@ -44,41 +48,91 @@ constexpr u64 HANDLE_INDEX_MASK = (1ull << HANDLE_INDEX_BITS) - 1;
 constexpr u64 HANDLE_VERSION_MASK = (1ull << HANDLE_VERSION_BITS) - 1;
 constexpr u32 HANDLE_MAX_CAPACITY = HANDLE_INDEX_MASK;
 
-template <TrivialType T> struct HandlePool {
-  T *m_data = nullptr;
-  HandleVersionType *m_versions = nullptr;
-  Array<HandleIndexType> m_free_indices;
-  u32 m_capacity = 0ull;
-  u32 m_count = 0ull;
+// NOTE: Wide handle for pools that outgrow 2^20 slots or recycle slots fast
+// enough to wrap a 12 bit version.
+struct Handle64 {
+  using VersionType = u32;
+  static constexpr u32 INDEX_BITS = 32;
+  static constexpr u32 VERSION_BITS = 32;
+
+  u32 version;
+  u32 index;
+
+  constexpr Handle64() : version{~0u}, index{~0u} {}
+  constexpr explicit Handle64(const u64 raw)
+      : version{static_cast<u32>(raw)}, index{static_cast<u32>(raw >> 32)} {}
+  constexpr Handle64(const u32 idx, const u32 ver)
+      : version{ver}, index{idx} {}
+
+  constexpr explicit operator u64() const {
+    return (static_cast<u64>(index) << 32) | version;
+  }
+
+  constexpr bool operator==(const Handle64 &other) const = default;
+
+  constexpr bool is_invalid() const {
+    return index == ~0u && version == ~0u;
+  }
+};
+
+constexpr auto HANDLE64_INVALID = Handle64{};
+
+namespace detail {
+constexpr u32 HANDLE_POOL_PAGE_SIZE_LOG2 = 10;
+constexpr u32 HANDLE_POOL_PAGE_SIZE = 1u << HANDLE_POOL_PAGE_SIZE_LOG2;
+constexpr u32 HANDLE_POOL_DENSE_NONE = ~0u;
+
+template <typename H>
+concept PoolHandle = requires(H handle) {
+  typename H::VersionType;
+  { H::INDEX_BITS } -> std::convertible_to<u32>;
+  { H::VERSION_BITS } -> std::convertible_to<u32>;
+  { handle.is_invalid() } -> std::same_as<bool>;
+};
+} // namespace detail
+
+// NOTE: Sparse set. Handles index into paged sparse slots that store a
+// version and a position in the densely packed element array, so iteration
+// only touches live elements and the pool grows a page at a time without
+// moving existing slots. Handles stay valid until freed, element pointers are
+// invalidated by any allocate or free since free swaps the last element into
+// the hole.
+template <TrivialType T, detail::PoolHandle H = Handle> struct HandlePool {
+  using HandleType = H;
+
+  static constexpr u64 INDEX_MASK = (1ull << H::INDEX_BITS) - 1;
+  static constexpr u64 VERSION_MASK = (1ull << H::VERSION_BITS) - 1;
+  // NOTE: The all ones index is reserved for the invalid handle.
+  static constexpr u64 MAX_CAPACITY = INDEX_MASK;
+
+  struct Slot {
+    u32 dense;
+    u32 version;
+  };
+
+  Array<Slot *> m_pages;
+  Array<T> m_dense;
+  Array<H> m_dense_handles;
+  Array<u32> m_free_indices;
+  u32 m_slot_count = 0u;
 
   struct Iterator {
-    HandlePool<T> *m_pool;
+    HandlePool *m_pool;
     u32 m_current_index;
 
     struct Entry {
-      Handle handle;
+      H handle;
       T *element;
     };
 
     Iterator &operator++() {
-      if (m_pool) {
-        m_current_index++;
-        while (m_current_index < m_pool->m_capacity) {
-          auto handle =
-              Handle{m_current_index, m_pool->m_versions[m_current_index]};
-          if (m_pool->is_valid(handle)) {
-            break;
-          }
-          m_current_index++;
-        }
-      }
+      m_current_index++;
       return *this;
     }
 
     Entry operator*() const {
-      const auto handle =
-          Handle{m_current_index, m_pool->m_versions[m_current_index]};
-      return {handle, &m_pool->m_data[m_current_index]};
+      return {m_pool->m_dense_handles[m_current_index],
+              &m_pool->m_dense[m_current_index]};
     }
 
     bool operator!=(const Iterator &other) const {
@@ -91,32 +145,21 @@ template <TrivialType T> struct HandlePool {
 
   struct ConstIterator {
     const HandlePool *m_pool;
-    HandleIndexType m_current_index;
+    u32 m_current_index;
 
     struct Entry {
-      Handle handle;
+      H handle;
       const T *element;
     };
 
     ConstIterator &operator++() {
-      if (m_pool) {
-        m_current_index++;
-        while (m_current_index < m_pool->m_capacity) {
-          auto handle =
-              Handle{m_current_index, m_pool->m_versions[m_current_index]};
-          if (m_pool->is_valid(handle)) {
-            break;
-          }
-          m_current_index++;
-        }
-      }
+      m_current_index++;
       return *this;
     }
 
     Entry operator*() const {
-      const auto handle =
-          Handle{m_current_index, m_pool->m_versions[m_current_index]};
-      return {handle, &m_pool->m_data[m_current_index]};
+      return {m_pool->m_dense_handles[m_current_index],
+              &m_pool->m_dense[m_current_index]};
     }
 
     bool operator!=(const ConstIterator &other) const {
@@ -127,221 +170,200 @@ template <TrivialType T> struct HandlePool {
     }
   };
 
-  bool create(const NotNull<const Allocator *> alloc, const u32 capacity) {
-    if (capacity == 0 || capacity > HANDLE_MAX_CAPACITY) {
-      return false;
-    }
-
-    m_data = alloc->allocate_array<T>(capacity);
-    if (!m_data) {
+  // NOTE: capacity only pre-sizes the pool, it grows on demand past it.
+  bool create(const NotNull<const Allocator *> alloc, const u32 capacity = 0u) {
+    if (capacity > MAX_CAPACITY) {
       return false;
     }
 
-    m_versions = alloc->allocate_array<HandleVersionType>(capacity);
-    if (!m_versions) {
-      alloc->deallocate_array(m_data, m_capacity);
-      return false;
-    }
-
-    if (!m_free_indices.reserve(alloc, capacity)) {
-      alloc->deallocate_array(m_versions, m_capacity);
-      alloc->deallocate_array(m_data, m_capacity);
-      ;
-      return false;
-    }
-
-    m_capacity = capacity;
-    m_count = 0;
-
-    // Initialize free indices in reverse order (so 0 is allocated first)
-    for (usize i = 0; i < capacity; i++) {
-      const usize index = capacity - 1 - i;
-      m_free_indices.push_back(alloc, static_cast<HandleIndexType>(index));
+    if (capacity > 0) {
+      if (!m_dense.reserve(alloc, capacity) ||
+          !m_dense_handles.reserve(alloc, capacity) ||
+          !m_free_indices.reserve(alloc, capacity)) {
+        destroy(alloc);
+        return false;
+      }
     }
 
     return true;
   }
 
   void destroy(const NotNull<const Allocator *> alloc) {
-    m_free_indices.destroy(alloc);
-
-    if (m_versions) {
-      alloc->deallocate_array(m_versions, m_capacity);
+    for (Slot *page : m_pages) {
+      alloc->deallocate_array(page, detail::HANDLE_POOL_PAGE_SIZE);
     }
 
-    if (m_data) {
-      alloc->deallocate_array(m_data, m_capacity);
-    }
+    m_pages.destroy(alloc);
+    m_dense.destroy(alloc);
+    m_dense_handles.destroy(alloc);
+    m_free_indices.destroy(alloc);
+    m_slot_count = 0u;
   }
 
-  Handle allocate() {
-    if (m_free_indices.empty()) {
-      return HANDLE_INVALID;
-    }
-
-    HandleIndexType index;
-    if (!m_free_indices.pop_back(&index)) {
-      return HANDLE_INVALID;
-    }
-
-    memset(&m_data[index], 0, sizeof(T));
-
-    const auto version = m_versions[index];
-    m_count++;
-
-    return Handle{index, version};
+  H allocate(const NotNull<const Allocator *> alloc) {
+    return allocate_with_data(alloc, T{});
   }
 
-  Handle allocate_with_data(const T &element) {
-    if (m_free_indices.empty()) {
-      return HANDLE_INVALID;
+  H allocate_with_data(const NotNull<const Allocator *> alloc,
+                       const T &element) {
+    if (!reserve_for(alloc, m_dense, m_dense.size() + 1) ||
+        !reserve_for(alloc, m_dense_handles, m_dense.size() + 1)) {
+      return H{};
     }
 
-    HandleIndexType index;
-    if (!m_free_indices.pop_back(&index)) {
-      return HANDLE_INVALID;
+    u32 index;
+    if (!m_free_indices.empty()) {
+      m_free_indices.pop_back(&index);
+    } else if (!push_slot(alloc, &index)) {
+      return H{};
     }
 
-    memcpy(&m_data[index], &element, sizeof(T));
+    Slot &slot = slot_at(index);
+    slot.dense = static_cast<u32>(m_dense.size());
 
-    const auto version = m_versions[index];
-    m_count++;
+    const H handle{index, static_cast<typename H::VersionType>(slot.version)};
+    m_dense.push_back(alloc, element);
+    m_dense_handles.push_back(alloc, handle);
 
-    return Handle{index, version};
+    return handle;
   }
 
-  bool free(Handle handle) {
-    if (handle == HANDLE_INVALID) {
+  bool free(const H handle) {
+    Slot *slot = find_slot(handle);
+    if (!slot) {
       return false;
     }
 
-    if (handle.index >= m_capacity) {
-      return false;
-    }
-
-    if (m_versions[handle.index] != handle.version) {
-      return false;
+    const u32 dense = slot->dense;
+    const u32 last = static_cast<u32>(m_dense.size()) - 1;
+    if (dense != last) {
+      m_dense[dense] = m_dense[last];
+      m_dense_handles[dense] = m_dense_handles[last];
+      slot_at(m_dense_handles[dense].index).dense = dense;
     }
+    m_dense.pop_back();
+    m_dense_handles.pop_back();
 
-    // Increment version (wrapping around within version mask)
-    m_versions[handle.index] =
-        (m_versions[handle.index] + 1) & HANDLE_VERSION_MASK;
-
-    // Clear the element data
-    memset(&m_data[handle.index], 0, sizeof(T));
-
-    m_free_indices.push_back(handle.index);
-    m_count--;
+    slot->dense = detail::HANDLE_POOL_DENSE_NONE;
+    slot->version = static_cast<u32>((slot->version + 1) & VERSION_MASK);
 
+    // NOTE: Capacity for every slot index is reserved when the slot is
+    // created, so this never allocates.
+    m_free_indices.push_back(static_cast<u32>(handle.index));
     return true;
   }
 
-  T *get(Handle handle) {
-    if (handle == HANDLE_INVALID) {
-      return nullptr;
-    }
+  T *get(const H handle) {
+    const Slot *slot = find_slot(handle);
+    return slot ? &m_dense[slot->dense] : nullptr;
+  }
 
-    if (handle.index >= m_capacity) {
-      return nullptr;
-    }
+  const T *get(const H handle) const {
+    const Slot *slot = find_slot(handle);
+    return slot ? &m_dense[slot->dense] : nullptr;
+  }
 
-    if (m_versions[handle.index] != handle.version) {
-      return nullptr;
+  bool set(const H handle, const T &element) {
+    T *target = get(handle);
+    if (!target) {
+      return false;
     }
 
-    return &m_data[handle.index];
+    memcpy(target, &element, sizeof(T));
+    return true;
   }
 
-  const T *get(Handle handle) const {
-    if (handle == HANDLE_INVALID) {
-      return nullptr;
-    }
+  bool is_valid(const H handle) const { return find_slot(handle) != nullptr; }
 
-    if (handle.index >= m_capacity) {
-      return nullptr;
-    }
+  bool is_empty() const { return m_dense.empty(); }
 
-    if (m_versions[handle.index] != handle.version) {
-      return nullptr;
+  u32 size() const { return static_cast<u32>(m_dense.size()); }
+
+  // NOTE: Live elements and their handles as two packed arrays of size().
+  T *data() { return m_dense.data(); }
+  const T *data() const { return m_dense.data(); }
+  const H *handles() const { return m_dense_handles.data(); }
+
+  void clear() {
+    for (const H &handle : m_dense_handles) {
+      Slot &slot = slot_at(handle.index);
+      slot.dense = detail::HANDLE_POOL_DENSE_NONE;
+      slot.version = static_cast<u32>((slot.version + 1) & VERSION_MASK);
+      m_free_indices.push_back(static_cast<u32>(handle.index));
     }
 
-    return &m_data[handle.index];
+    m_dense.clear();
+    m_dense_handles.clear();
   }
 
-  bool set(Handle handle, const T &element) {
-    if (handle == HANDLE_INVALID) {
-      return false;
-    }
+  Iterator begin() { return {this, 0u}; }
+  Iterator end() { return {this, size()}; }
+  ConstIterator begin() const { return {this, 0u}; }
+  ConstIterator end() const { return {this, size()}; }
 
-    if (handle.index >= m_capacity) {
-      return false;
+private:
+  // NOTE: Geometric growth, Array::reserve allocates exactly what it is asked.
+  template <typename U>
+  static bool reserve_for(const NotNull<const Allocator *> alloc,
+                          Array<U> &array, const usize required) {
+    if (required <= array.capacity()) {
+      return true;
     }
 
-    if (m_versions[handle.index] != handle.version) {
-      return false;
+    usize capacity = array.capacity() ? array.capacity() * 2 : 16;
+    while (capacity < required) {
+      capacity *= 2;
     }
+    return array.reserve(alloc, capacity);
+  }
 
-    memcpy(&m_data[handle.index], &element, sizeof(T));
-    return true;
+  Slot &slot_at(const u32 index) const {
+    return m_pages[index >> detail::HANDLE_POOL_PAGE_SIZE_LOG2]
+                  [index & (detail::HANDLE_POOL_PAGE_SIZE - 1)];
   }
 
-  bool is_valid(const Handle handle) const {
-    if (handle == HANDLE_INVALID) {
-      return false;
+  Slot *find_slot(const H handle) const {
+    const u32 index = static_cast<u32>(handle.index);
+    if (index >= m_slot_count) {
+      return nullptr;
     }
 
-    if (handle.index >= m_capacity) {
-      return false;
+    Slot &slot = slot_at(index);
+    if (slot.dense == detail::HANDLE_POOL_DENSE_NONE ||
+        slot.version != static_cast<u32>(handle.version)) {
+      return nullptr;
     }
 
-    return m_versions[handle.index] == handle.version;
+    return &slot;
   }
 
-  bool is_full() const { return m_free_indices.empty(); }
-
-  bool is_empty() const { return m_count == 0; }
-
-  void clear() {
-    m_free_indices.clear();
-
-    // Re-initialize free indices and increment versions
-    for (u32 i = 0; i < m_capacity; i++) {
-      u32 index = m_capacity - 1 - i;
-      m_free_indices.push_back(index);
-
-      m_versions[i] = (m_versions[i] + 1) & HANDLE_VERSION_MASK;
-
-      memset(&m_data[i], 0, sizeof(T));
+  bool push_slot(const NotNull<const Allocator *> alloc, u32 *out_index) {
+    if (m_slot_count >= MAX_CAPACITY) {
+      return false;
     }
 
-    m_count = 0;
-  }
-
-  Iterator begin() {
-    HandleIndexType index = 0;
-    while (index < m_capacity) {
-      if (const auto handle = Handle{index, m_versions[index]}; is_valid(handle)) {
-        break;
+    if ((m_slot_count & (detail::HANDLE_POOL_PAGE_SIZE - 1)) == 0) {
+      if (!reserve_for(alloc, m_pages, m_pages.size() + 1) ||
+          !reserve_for(alloc, m_free_indices,
+                       m_slot_count + detail::HANDLE_POOL_PAGE_SIZE)) {
+        return false;
       }
-      index++;
-    }
-    return {this, index};
-  }
 
-  Iterator end() { return {this, m_capacity}; }
+      Slot *page =
+          alloc->allocate_array<Slot>(detail::HANDLE_POOL_PAGE_SIZE);
+      if (!page) {
+        return false;
+      }
 
-  ConstIterator begin() const {
-    HandleIndexType index = 0;
-    while (index < m_capacity) {
-      if (const auto handle = Handle{index, m_versions[index]}; is_valid(handle)) {
-        break;
+      for (u32 i = 0; i < detail::HANDLE_POOL_PAGE_SIZE; ++i) {
+        page[i] = {detail::HANDLE_POOL_DENSE_NONE, 0u};
       }
-      index++;
+      m_pages.push_back(alloc, page);
     }
-    return {this, index};
-  }
 
-  ConstIterator end() const { return {this, m_capacity}; }
+    *out_index = m_slot_count++;
+    return true;
+  }
 };
 } // namespace edge
 
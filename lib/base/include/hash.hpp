@@ -34,9 +34,59 @@ inline u64 hash_fnv1a64(const void *key, const u64 len) {
   return hash;
 }
 
-u32 hash_crc32(const void *data, usize size);
+// NOTE: IEEE 802.3 CRC32 as used by zip, gzip and png, and CRC32C
+// (Castagnoli) as used by iSCSI and ext4. Pass a previous result as crc to
+// continue a checksum over more data. Large inputs are folded with PCLMUL when
+// the target has it, CRC32C also uses the SSE4.2 and ARMv8 crc instructions.
+u32 hash_crc32(const void *data, usize size, u32 crc = 0u);
+u32 hash_crc32c(const void *data, usize size, u32 crc = 0u);
+
+// NOTE: Checksum of A followed by B from the checksums of both parts and the
+// size of B, O(log size2). Lets large buffers be checksummed in parallel
+// chunks.
+u32 hash_crc32_combine(u32 crc1, u32 crc2, u64 size2);
+u32 hash_crc32c_combine(u32 crc1, u32 crc2, u64 size2);
 usize hash_pointer(const void *ptr);
 
+struct Hash128 {
+  u64 low = 0ull;
+  u64 high = 0ull;
+
+  constexpr bool operator==(const Hash128 &other) const = default;
+};
+
+// NOTE: XXH3, results match the reference implementation for the same seed
+// so hashes can be stored or compared against other tools. Inputs up to 240
+// bytes take a branchy short path, longer ones run 64 byte stripes through
+// SSE2/AVX2/NEON accumulators.
+u64 hash_xxh3_64(const void *data, usize size, u64 seed = 0ull);
+Hash128 hash_xxh3_128(const void *data, usize size, u64 seed = 0ull);
+
+namespace detail {
+constexpr usize XXH3_SECRET_SIZE = 192ull;
+constexpr usize XXH3_BUFFER_SIZE = 256ull;
+} // namespace detail
+
+// NOTE: Incremental XXH3 for data that arrives in pieces, both digests equal
+// the one-shot functions over the concatenated input. Call reset() first.
+// Keeps no pointers into the caller's data, digests do not modify the state so
+// updates can continue afterwards.
+struct HashStream {
+  alignas(64) u64 m_acc[8];
+  alignas(64) u8 m_secret[detail::XXH3_SECRET_SIZE];
+  alignas(64) u8 m_buffer[detail::XXH3_BUFFER_SIZE];
+  u64 m_seed = 0ull;
+  u64 m_total_size = 0ull;
+  usize m_buffered = 0ull;
+  usize m_stripes_in_block = 0ull;
+
+  void reset(u64 seed = 0ull);
+  void update(const void *data, usize size);
+
+  u64 digest64() const;
+  Hash128 digest128() const;
+};
+
 constexpr inline usize hash_combine(usize hash1, const usize hash2) {
   if constexpr (sizeof(usize) == 8) {
     hash1 ^= hash2 + 0x9e3779b97f4a7c15ULL + (hash1 << 6) + (hash1 >> 2);
@@ -5,19 +5,129 @@
 #include "hash.hpp"
 #include "math.hpp"
 
+#include <bit>
+
 namespace edge {
 namespace detail {
 constexpr usize HASHMAP_DEFAULT_BUCKET_COUNT = 16;
-constexpr f32 HASHMAP_MAX_LOAD_FACTOR = 0.75f;
+constexpr f32 HASHMAP_MAX_LOAD_FACTOR = 0.875f;
+
+constexpr usize HASHMAP_GROUP_WIDTH = 16;
+constexpr u8 HASHMAP_CTRL_EMPTY = 0x80;
+
+// NOTE: Low 7 bits of the hash are kept in the control byte, the rest selects
+// the home slot. Hash<T> for small integers only fills the low 32 bits so the
+// top bits can not be used here.
+EDGE_FORCE_INLINE u8 hashmap_h2(const usize hash) {
+  return static_cast<u8>(hash & 0x7f);
+}
+
+EDGE_FORCE_INLINE usize hashmap_h1(const usize hash) { return hash >> 7; }
+
+struct HashMapBitMask {
+#if EDGE_HAS_NEON
+  static constexpr u32 SHIFT = 2;
+#else
+  static constexpr u32 SHIFT = 0;
+#endif
+
+  u64 mask;
+
+  explicit operator bool() const { return mask != 0; }
+  u32 lowest() const {
+    return static_cast<u32>(std::countr_zero(mask)) >> SHIFT;
+  }
+  void clear_lowest() { mask &= mask - 1; }
+};
+
+// NOTE: 16 control bytes matched at once. The control array is padded with a
+// copy of its first 15 bytes so a group can start at any slot without wrapping.
+struct HashMapGroup {
+#if EDGE_HAS_SSE2
+  __m128i ctrl;
+
+  explicit HashMapGroup(const u8 *pos)
+      : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+  HashMapBitMask match(const u8 h2) const {
+    const __m128i eq = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(h2)));
+    return {static_cast<u32>(_mm_movemask_epi8(eq))};
+  }
+
+  HashMapBitMask match_empty() const {
+    return {static_cast<u32>(_mm_movemask_epi8(ctrl))};
+  }
+
+  HashMapBitMask match_full() const {
+    return {static_cast<u32>(~_mm_movemask_epi8(ctrl)) & 0xffffu};
+  }
+#elif EDGE_HAS_NEON
+  uint8x16_t ctrl;
+
+  explicit HashMapGroup(const u8 *pos) : ctrl(vld1q_u8(pos)) {}
+
+  static u64 to_mask(const uint8x16_t lanes) {
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(lanes), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) &
+           0x8888888888888888ull;
+  }
+
+  HashMapBitMask match(const u8 h2) const {
+    return {to_mask(vceqq_u8(ctrl, vdupq_n_u8(h2)))};
+  }
+
+  HashMapBitMask match_empty() const {
+    return {to_mask(vtstq_u8(ctrl, vdupq_n_u8(HASHMAP_CTRL_EMPTY)))};
+  }
+
+  HashMapBitMask match_full() const {
+    return {to_mask(vcltq_u8(ctrl, vdupq_n_u8(HASHMAP_CTRL_EMPTY)))};
+  }
+#else
+  u8 ctrl[HASHMAP_GROUP_WIDTH];
+
+  explicit HashMapGroup(const u8 *pos) { memcpy(ctrl, pos, sizeof(ctrl)); }
+
+  HashMapBitMask match(const u8 h2) const {
+    u64 mask = 0;
+    for (usize i = 0; i < HASHMAP_GROUP_WIDTH; ++i) {
+      mask |= static_cast<u64>(ctrl[i] == h2) << i;
+    }
+    return {mask};
+  }
+
+  HashMapBitMask match_empty() const {
+    u64 mask = 0;
+    for (usize i = 0; i < HASHMAP_GROUP_WIDTH; ++i) {
+      mask |= static_cast<u64>(ctrl[i] >> 7) << i;
+    }
+    return {mask};
+  }
+
+  HashMapBitMask match_full() const {
+    return {~match_empty().mask & 0xffffull};
+  }
+#endif
+};
+
+template <typename Hash, typename KeyEqual, typename K, typename Q>
+concept HashMapLookupKey =
+    std::same_as<K, Q> || requires {
+      typename Hash::is_transparent;
+      typename KeyEqual::is_transparent;
+    };
 } // namespace detail
 
 template <typename K, typename V> struct HashMapEntry {
   K key = {};
   V value = {};
   usize hash = 0;
-  HashMapEntry *next = nullptr;
 };
 
+// NOTE: Open addressing with linear probing scanned 16 control bytes at a time.
+// Removal shifts the following cluster back instead of leaving tombstones, so
+// lookups never degrade after many removals. Insert and remove invalidate
+// iterators and entry pointers.
 template <typename K, typename V, typename Hash = Hash<K>,
           typename KeyEqual = std::equal_to<K>>
 struct HashMap {
@@ -31,42 +141,25 @@ struct HashMap {
 
   struct Iterator {
     const HashMap *map;
-    usize bucket_index;
-    HashMapEntry<K, V> *current;
+    usize index;
 
     bool operator==(const Iterator &other) const {
-      return current == other.current;
+      return index == other.index;
     }
 
     bool operator!=(const Iterator &other) const {
-      return current != other.current;
+      return index != other.index;
     }
 
-    HashMapEntry<K, V> &operator*() const { return *current; }
-    HashMapEntry<K, V> *operator->() const { return current; }
+    HashMapEntry<K, V> &operator*() const { return map->m_slots[index]; }
+    HashMapEntry<K, V> *operator->() const { return &map->m_slots[index]; }
 
     Iterator &operator++() {
-      if (!map || !current) {
-        return *this;
-      }
-
-      // Try next in chain
-      if (current->next) {
-        current = current->next;
+      if (!map || index >= map->m_capacity) {
         return *this;
       }
 
-      // Find next non-empty bucket
-      for (usize i = bucket_index + 1; i < map->m_bucket_count; i++) {
-        if (map->m_buckets[i]) {
-          bucket_index = i;
-          current = map->m_buckets[i];
-          return *this;
-        }
-      }
-
-      // End of iteration
-      current = nullptr;
+      index = map->next_full_slot(index + 1);
       return *this;
     }
 
@@ -77,50 +170,48 @@ struct HashMap {
     }
   };
 
+  struct InsertResult {
+    Iterator iterator;
+    bool inserted;
+  };
+
   bool create(const NotNull<const Allocator *> alloc,
               usize initial_bucket_count = 0ull) {
-    if (initial_bucket_count == 0ull) {
+    if (initial_bucket_count < detail::HASHMAP_DEFAULT_BUCKET_COUNT) {
       initial_bucket_count = detail::HASHMAP_DEFAULT_BUCKET_COUNT;
     }
 
-    if (!is_pow2(initial_bucket_count)) {
-      initial_bucket_count = next_pow2(initial_bucket_count);
-    }
-
-    m_buckets =
-        alloc->allocate_array<HashMapEntry<K, V> *>(initial_bucket_count);
-    if (!m_buckets) {
-      return false;
-    }
-
-    m_bucket_count = initial_bucket_count;
     m_size = 0ull;
-
-    return true;
+    return rehash(alloc, initial_bucket_count);
   }
 
   void destroy(const NotNull<const Allocator *> alloc) {
     clear(alloc);
 
-    if (m_buckets) {
-      alloc->deallocate_array(m_buckets, m_bucket_count);
+    if (m_slots) {
+      alloc->free(m_slots);
     }
+
+    m_slots = nullptr;
+    m_ctrl = nullptr;
+    m_capacity = 0ull;
   }
 
   void clear(const NotNull<const Allocator *> alloc) {
-    for (usize i = 0; i < m_bucket_count; i++) {
-      HashMapEntry<K, V> *entry = m_buckets[i];
-      while (entry) {
-        entry->key.~K();
-        entry->value.~V();
-
-        HashMapEntry<K, V> *next = entry->next;
-        alloc->deallocate(entry);
-        entry = next;
+    (void)alloc;
+
+    if (m_size == 0) {
+      return;
+    }
+
+    for (usize i = 0; i < m_capacity; i++) {
+      if (!(m_ctrl[i] & detail::HASHMAP_CTRL_EMPTY)) {
+        m_slots[i].~HashMapEntry<K, V>();
       }
-      m_buckets[i] = nullptr;
     }
 
+    memset(m_ctrl, detail::HASHMAP_CTRL_EMPTY,
+           m_capacity + detail::HASHMAP_GROUP_WIDTH - 1);
     m_size = 0;
   }
 
@@ -129,97 +220,119 @@ struct HashMap {
       return false;
     }
 
+    if (new_bucket_count < detail::HASHMAP_DEFAULT_BUCKET_COUNT) {
+      new_bucket_count = detail::HASHMAP_DEFAULT_BUCKET_COUNT;
+    }
+
     if (!is_pow2(new_bucket_count)) {
       new_bucket_count = next_pow2(new_bucket_count);
     }
 
-    HashMapEntry<K, V> **new_buckets =
-        alloc->allocate_array<HashMapEntry<K, V> *>(new_bucket_count);
-    if (!new_buckets) {
+    if (static_cast<f32>(m_size) >
+        static_cast<f32>(new_bucket_count) * detail::HASHMAP_MAX_LOAD_FACTOR) {
+      return false;
+    }
+
+    // NOTE: Slots and control bytes share one allocation.
+    const usize slots_size = new_bucket_count * sizeof(HashMapEntry<K, V>);
+    const usize ctrl_size = new_bucket_count + detail::HASHMAP_GROUP_WIDTH - 1;
+    constexpr usize alignment = alignof(HashMapEntry<K, V>) > 16
+                                    ? alignof(HashMapEntry<K, V>)
+                                    : 16;
+
+    void *storage = alloc->malloc(slots_size + ctrl_size, alignment);
+    if (!storage) {
       return false;
     }
 
-    // Rehash all entries
-    for (usize i = 0; i < m_bucket_count; i++) {
-      HashMapEntry<K, V> *entry = m_buckets[i];
-      while (entry) {
-        HashMapEntry<K, V> *next = entry->next;
+    HashMapEntry<K, V> *old_slots = m_slots;
+    const u8 *old_ctrl = m_ctrl;
+    const usize old_capacity = m_capacity;
 
-        usize bucket_index = entry->hash & (new_bucket_count - 1);
-        entry->next = new_buckets[bucket_index];
-        new_buckets[bucket_index] = entry;
+    m_slots = static_cast<HashMapEntry<K, V> *>(storage);
+    m_ctrl = static_cast<u8 *>(storage) + slots_size;
+    m_capacity = new_bucket_count;
+    memset(m_ctrl, detail::HASHMAP_CTRL_EMPTY, ctrl_size);
 
-        entry = next;
+    for (usize i = 0; i < old_capacity; i++) {
+      if (old_ctrl[i] & detail::HASHMAP_CTRL_EMPTY) {
+        continue;
       }
+
+      const usize index = find_insert_slot(old_slots[i].hash);
+      new (&m_slots[index]) HashMapEntry<K, V>(std::move(old_slots[i]));
+      set_ctrl(index, old_ctrl[i]);
+      old_slots[i].~HashMapEntry<K, V>();
     }
 
-    alloc->deallocate_array(m_buckets, m_bucket_count);
-    m_buckets = new_buckets;
-    m_bucket_count = new_bucket_count;
+    if (old_slots) {
+      alloc->free(old_slots);
+    }
 
     return true;
   }
 
+  bool reserve(const NotNull<const Allocator *> alloc, const usize count) {
+    const auto required = static_cast<usize>(
+        static_cast<f32>(count) / detail::HASHMAP_MAX_LOAD_FACTOR) + 1;
+    if (required <= m_capacity) {
+      return true;
+    }
+    return rehash(alloc, required);
+  }
+
   f32 load_factor() const {
-    if (m_bucket_count == 0) {
+    if (m_capacity == 0) {
       return 0.0f;
     }
-    return static_cast<f32>(m_size) / static_cast<f32>(m_bucket_count);
+    return static_cast<f32>(m_size) / static_cast<f32>(m_capacity);
+  }
+
+  template <typename... Args>
+  InsertResult try_emplace(const NotNull<const Allocator *> alloc,
+                           const K &key, Args &&...args) {
+    return emplace_impl(alloc, key, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  InsertResult try_emplace(const NotNull<const Allocator *> alloc, K &&key,
+                           Args &&...args) {
+    return emplace_impl(alloc, std::move(key), std::forward<Args>(args)...);
   }
 
   bool insert(const NotNull<const Allocator *> alloc, const K &key,
               const V &value) {
-    // Check load factor and rehash if needed
-    if (load_factor() >= detail::HASHMAP_MAX_LOAD_FACTOR) {
-      rehash(alloc, m_bucket_count * 2);
+    auto [it, inserted] = try_emplace(alloc, key, value);
+    if (it == end()) {
+      return false;
     }
 
-    usize hash = Hash{}(key);
-    usize bucket_index = hash & (m_bucket_count - 1);
-
-    // Check if key already exists
-    HashMapEntry<K, V> *entry = m_buckets[bucket_index];
-    while (entry) {
-      if (entry->hash == hash && KeyEqual{}(entry->key, key)) {
-        // Update existing value
-        entry->value = value;
-        return true;
-      }
-      entry = entry->next;
+    if (!inserted) {
+      it->value = value;
     }
+    return true;
+  }
 
-    // Create new entry
-    HashMapEntry<K, V> *new_entry =
-        alloc->allocate<HashMapEntry<K, V>>(key, value, hash, nullptr);
-    if (!new_entry) {
+  bool insert(const NotNull<const Allocator *> alloc, K &&key, V &&value) {
+    auto [it, inserted] = try_emplace(alloc, std::move(key), std::move(value));
+    if (it == end()) {
       return false;
     }
 
-    new_entry->next = m_buckets[bucket_index];
-    m_buckets[bucket_index] = new_entry;
-    m_size++;
-
+    if (!inserted) {
+      it->value = std::move(value);
+    }
     return true;
   }
 
-  Iterator find(const K &key) {
-    usize hash = Hash{}(key);
-    usize bucket_index = hash & (m_bucket_count - 1);
-
-    HashMapEntry<K, V> *entry = m_buckets[bucket_index];
-    while (entry) {
-      if (entry->hash == hash && KeyEqual{}(entry->key, key)) {
-        return Iterator{
-            .map = this, .bucket_index = bucket_index, .current = entry};
-      }
-      entry = entry->next;
-    }
-
-    return end();
+  template <typename Q>
+    requires detail::HashMapLookupKey<Hash, KeyEqual, K, Q>
+  Iterator find(const Q &key) const {
+    return Iterator{.map = this, .index = find_index(key, Hash{}(key))};
   }
 
   Iterator find(const K &key) const {
-    return const_cast<HashMap *>(this)->find(key);
+    return Iterator{.map = this, .index = find_index(key, Hash{}(key))};
   }
 
   V &operator[](const K &key) {
@@ -242,66 +355,164 @@ struct HashMap {
     return dummy;
   }
 
+  template <typename Q>
+    requires detail::HashMapLookupKey<Hash, KeyEqual, K, Q>
+  bool remove(const NotNull<const Allocator *> alloc, const Q &key,
+              V *out_value = nullptr) {
+    (void)alloc;
+
+    const usize index = find_index(key, Hash{}(key));
+    if (index == m_capacity) {
+      return false;
+    }
+
+    if (out_value) {
+      *out_value = std::move(m_slots[index].value);
+    }
+
+    m_slots[index].~HashMapEntry<K, V>();
+    m_size--;
+
+    // NOTE: Backward shift, pull every following entry of the cluster that is
+    // allowed to live in the hole into it, so no tombstones are needed.
+    const usize mask = m_capacity - 1;
+    usize hole = index;
+    for (usize next = (index + 1) & mask;
+         !(m_ctrl[next] & detail::HASHMAP_CTRL_EMPTY);
+         next = (next + 1) & mask) {
+      const usize home = detail::hashmap_h1(m_slots[next].hash) & mask;
+      if (((next - home) & mask) < ((next - hole) & mask)) {
+        continue;
+      }
+
+      new (&m_slots[hole]) HashMapEntry<K, V>(std::move(m_slots[next]));
+      m_slots[next].~HashMapEntry<K, V>();
+      set_ctrl(hole, m_ctrl[next]);
+      hole = next;
+    }
+
+    set_ctrl(hole, detail::HASHMAP_CTRL_EMPTY);
+    return true;
+  }
+
   bool remove(const NotNull<const Allocator *> alloc, const K &key,
               V *out_value = nullptr) {
-    usize hash = Hash{}(key);
-    usize bucket_index = hash % m_bucket_count;
+    return remove<K>(alloc, key, out_value);
+  }
 
-    HashMapEntry<K, V> *entry = m_buckets[bucket_index];
-    HashMapEntry<K, V> *prev = nullptr;
+  Iterator begin() const {
+    return Iterator{.map = this, .index = next_full_slot(0)};
+  }
 
-    while (entry) {
-      if (entry->hash == hash && KeyEqual{}(entry->key, key)) {
-        if (out_value) {
-          *out_value = entry->value;
-        }
+  Iterator end() const { return Iterator{.map = this, .index = m_capacity}; }
 
-        if (prev) {
-          prev->next = entry->next;
-        } else {
-          m_buckets[bucket_index] = entry->next;
-        }
+  template <typename Q>
+    requires detail::HashMapLookupKey<Hash, KeyEqual, K, Q>
+  [[nodiscard]] bool contains(const Q &key) const {
+    return find(key) != end();
+  }
+  [[nodiscard]] bool contains(const K &key) const { return find(key) != end(); }
+  [[nodiscard]] bool empty() const { return m_size == 0; }
+  [[nodiscard]] usize size() const { return m_size; }
+
+  HashMapEntry<K, V> *m_slots = nullptr;
+  u8 *m_ctrl = nullptr;
+  usize m_capacity = 0ull;
+  usize m_size = 0ull;
+
+private:
+  void set_ctrl(const usize index, const u8 value) {
+    m_ctrl[index] = value;
+    if (index < detail::HASHMAP_GROUP_WIDTH - 1) {
+      m_ctrl[m_capacity + index] = value;
+    }
+  }
 
-        alloc->deallocate(entry);
-        m_size--;
+  template <typename Q>
+  usize find_index(const Q &key, const usize hash) const {
+    if (m_capacity == 0) {
+      return 0;
+    }
 
-        return true;
+    const usize mask = m_capacity - 1;
+    const u8 h2 = detail::hashmap_h2(hash);
+    usize pos = detail::hashmap_h1(hash) & mask;
+
+    for (usize probed = 0; probed < m_capacity;
+         probed += detail::HASHMAP_GROUP_WIDTH) {
+      const detail::HashMapGroup group(m_ctrl + pos);
+      for (auto match = group.match(h2); match; match.clear_lowest()) {
+        const usize index = (pos + match.lowest()) & mask;
+        const HashMapEntry<K, V> &slot = m_slots[index];
+        if (slot.hash == hash && KeyEqual{}(slot.key, key)) {
+          return index;
+        }
       }
 
-      prev = entry;
-      entry = entry->next;
+      // NOTE: Linear probing keeps every cluster contiguous, an empty slot
+      // past the home position means the key is not in the table.
+      if (group.match_empty()) {
+        break;
+      }
+
+      pos = (pos + detail::HASHMAP_GROUP_WIDTH) & mask;
     }
 
-    return false;
+    return m_capacity;
   }
 
-  Iterator begin() {
-    Iterator it;
-    it.map = this;
-    it.bucket_index = 0;
-    it.current = nullptr;
+  usize find_insert_slot(const usize hash) const {
+    const usize mask = m_capacity - 1;
+    usize pos = detail::hashmap_h1(hash) & mask;
 
-    for (usize i = 0; i < m_bucket_count; i++) {
-      if (m_buckets[i]) {
-        return Iterator{
-            .map = this, .bucket_index = i, .current = m_buckets[i]};
+    while (true) {
+      const detail::HashMapGroup group(m_ctrl + pos);
+      if (auto empty = group.match_empty()) {
+        return (pos + empty.lowest()) & mask;
       }
+      pos = (pos + detail::HASHMAP_GROUP_WIDTH) & mask;
     }
+  }
 
-    return Iterator{this, 0, nullptr};
+  usize next_full_slot(usize index) const {
+    while (index < m_capacity) {
+      const detail::HashMapGroup group(m_ctrl + index);
+      if (auto full = group.match_full()) {
+        index += full.lowest();
+        return index < m_capacity ? index : m_capacity;
+      }
+      index += detail::HASHMAP_GROUP_WIDTH;
+    }
+    return m_capacity;
   }
 
-  Iterator end() { return Iterator{this, 0, nullptr}; }
-  Iterator begin() const { return const_cast<HashMap *>(this)->begin(); }
-  Iterator end() const { return const_cast<HashMap *>(this)->end(); }
+  template <typename KeyArg, typename... Args>
+  InsertResult emplace_impl(const NotNull<const Allocator *> alloc,
+                            KeyArg &&key, Args &&...args) {
+    const usize hash = Hash{}(key);
+    if (const usize index = find_index(key, hash); index != m_capacity) {
+      return {Iterator{.map = this, .index = index}, false};
+    }
 
-  [[nodiscard]] bool contains(const K &key) const { return find(key) != end(); }
-  [[nodiscard]] bool empty() const { return m_size == 0; }
-  [[nodiscard]] usize size() const { return m_size; }
+    if (m_capacity == 0 ||
+        static_cast<f32>(m_size + 1) >
+            static_cast<f32>(m_capacity) * detail::HASHMAP_MAX_LOAD_FACTOR) {
+      const usize new_capacity = m_capacity
+                                     ? m_capacity * 2
+                                     : detail::HASHMAP_DEFAULT_BUCKET_COUNT;
+      if (!rehash(alloc, new_capacity)) {
+        return {end(), false};
+      }
+    }
 
-  HashMapEntry<K, V> **m_buckets = nullptr;
-  usize m_bucket_count = 0ull;
-  usize m_size = 0ull;
+    const usize index = find_insert_slot(hash);
+    new (&m_slots[index]) HashMapEntry<K, V>{
+        K(std::forward<KeyArg>(key)), V(std::forward<Args>(args)...), hash};
+    set_ctrl(index, detail::hashmap_h2(hash));
+    m_size++;
+
+    return {Iterator{.map = this, .index = index}, true};
+  }
 };
 } // namespace edge
 
@@ -0,0 +1,225 @@
+#ifndef EDGE_INTRUSIVE_LIST_H
+#define EDGE_INTRUSIVE_LIST_H
+
+#include "stddef.hpp"
+
+namespace edge {
+struct IntrusiveListNode {
+  IntrusiveListNode *next = nullptr;
+  IntrusiveListNode *prev = nullptr;
+};
+
+// NOTE: Doubly linked list threaded through an IntrusiveListNode member of
+// the owner, linking never allocates. An owner can sit in as many lists as it
+// has nodes but in only one list per node, and it must be removed before it
+// is freed.
+template <typename T, IntrusiveListNode T::*Node> struct IntrusiveList {
+  IntrusiveListNode *m_head = nullptr;
+  IntrusiveListNode *m_tail = nullptr;
+  usize m_size = 0ull;
+  // NOTE: Distance from an owner to its node, taken from the first item that
+  // is linked. Every owner reached through a node was linked first, so it is
+  // always set by the time a node has to be mapped back.
+  usize m_node_offset = 0ull;
+
+  struct Iterator {
+    IntrusiveListNode *current;
+    usize node_offset;
+
+    bool operator==(const Iterator &other) const {
+      return current == other.current;
+    }
+
+    bool operator!=(const Iterator &other) const {
+      return current != other.current;
+    }
+
+    T &operator*() const { return *owner(current, node_offset); }
+
+    T *operator->() const { return owner(current, node_offset); }
+
+    Iterator &operator++() {
+      if (current) {
+        current = current->next;
+      }
+      return *this;
+    }
+  };
+
+  static T *owner(IntrusiveListNode *node, const usize node_offset) {
+    return node ? reinterpret_cast<T *>(reinterpret_cast<u8 *>(node) -
+                                        node_offset)
+                : nullptr;
+  }
+
+  T *owner(IntrusiveListNode *node) const { return owner(node, m_node_offset); }
+
+  static IntrusiveListNode *node_of(T *item) { return &(item->*Node); }
+
+  void push_front(T *item) {
+    IntrusiveListNode *node = node_of(item);
+    assert(!is_linked(item) && "IntrusiveList::push_front: item already linked");
+    record_node_offset(item, node);
+
+    node->prev = nullptr;
+    node->next = m_head;
+    if (m_head) {
+      m_head->prev = node;
+    } else {
+      m_tail = node;
+    }
+    m_head = node;
+    m_size++;
+  }
+
+  void push_back(T *item) {
+    IntrusiveListNode *node = node_of(item);
+    assert(!is_linked(item) && "IntrusiveList::push_back: item already linked");
+    record_node_offset(item, node);
+
+    node->next = nullptr;
+    node->prev = m_tail;
+    if (m_tail) {
+      m_tail->next = node;
+    } else {
+      m_head = node;
+    }
+    m_tail = node;
+    m_size++;
+  }
+
+  // NOTE: Links item right after position, position must be in this list.
+  void insert_after(T *position, T *item) {
+    IntrusiveListNode *at = node_of(position);
+    if (at == m_tail) {
+      push_back(item);
+      return;
+    }
+
+    IntrusiveListNode *node = node_of(item);
+    assert(!is_linked(item) && "IntrusiveList::insert_after: item already linked");
+
+    node->prev = at;
+    node->next = at->next;
+    at->next->prev = node;
+    at->next = node;
+    m_size++;
+  }
+
+  void insert_before(T *position, T *item) {
+    IntrusiveListNode *at = node_of(position);
+    if (at == m_head) {
+      push_front(item);
+      return;
+    }
+
+    IntrusiveListNode *node = node_of(item);
+    assert(!is_linked(item) && "IntrusiveList::insert_before: item already linked");
+
+    node->next = at;
+    node->prev = at->prev;
+    at->prev->next = node;
+    at->prev = node;
+    m_size++;
+  }
+
+  void remove(T *item) {
+    IntrusiveListNode *node = node_of(item);
+    assert(is_linked(item) && "IntrusiveList::remove: item is not linked");
+
+    if (node->prev) {
+      node->prev->next = node->next;
+    } else {
+      m_head = node->next;
+    }
+
+    if (node->next) {
+      node->next->prev = node->prev;
+    } else {
+      m_tail = node->prev;
+    }
+
+    node->next = nullptr;
+    node->prev = nullptr;
+    m_size--;
+  }
+
+  T *pop_front() {
+    T *item = front();
+    if (item) {
+      remove(item);
+    }
+    return item;
+  }
+
+  T *pop_back() {
+    T *item = back();
+    if (item) {
+      remove(item);
+    }
+    return item;
+  }
+
+  // NOTE: Moves every item of other to the end of this list in O(1).
+  void splice_back(IntrusiveList &other) {
+    if (!other.m_head) {
+      return;
+    }
+
+    if (m_tail) {
+      m_tail->next = other.m_head;
+      other.m_head->prev = m_tail;
+    } else {
+      m_head = other.m_head;
+      m_node_offset = other.m_node_offset;
+    }
+    m_tail = other.m_tail;
+    m_size += other.m_size;
+
+    other.m_head = nullptr;
+    other.m_tail = nullptr;
+    other.m_size = 0;
+  }
+
+  // NOTE: Unlinks every item so they can be pushed into another list.
+  void clear() {
+    IntrusiveListNode *current = m_head;
+    while (current) {
+      IntrusiveListNode *next = current->next;
+      current->next = nullptr;
+      current->prev = nullptr;
+      current = next;
+    }
+
+    m_head = nullptr;
+    m_tail = nullptr;
+    m_size = 0;
+  }
+
+  // NOTE: Meant for this list, the only item of another list linked through
+  // the same node reads as unlinked.
+  bool is_linked(T *item) const {
+    const IntrusiveListNode *node = node_of(item);
+    return node->prev || node->next || m_head == node;
+  }
+
+  T *front() const { return owner(m_head); }
+  T *back() const { return owner(m_tail); }
+  T *next(T *item) const { return owner(node_of(item)->next); }
+  T *prev(T *item) const { return owner(node_of(item)->prev); }
+
+  bool empty() const { return m_size == 0; }
+  usize size() const { return m_size; }
+
+  Iterator begin() const { return Iterator{m_head, m_node_offset}; }
+  Iterator end() const { return Iterator{nullptr, m_node_offset}; }
+
+private:
+  void record_node_offset(T *item, IntrusiveListNode *node) {
+    m_node_offset = static_cast<usize>(reinterpret_cast<u8 *>(node) -
+                                       reinterpret_cast<u8 *>(item));
+  }
+};
+} // namespace edge
+
+#endif
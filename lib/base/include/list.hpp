@@ -11,69 +11,173 @@ template <TrivialType T> struct ListNode {
 };
 
 namespace detail {
+constexpr u32 LIST_POOL_FIRST_CHUNK = 32;
+constexpr u32 LIST_POOL_MAX_CHUNK = 4096;
+
+// NOTE: Merges two null terminated runs through next only, ties take left
+// so the sort stays stable.
 template <TrivialType T, typename Comparator>
-ListNode<T> *merge_sorted(ListNode<T> *left, ListNode<T> *right,
-                          Comparator &&compare) {
-  if (!left) {
-    return right;
+ListNode<T> *merge_runs(ListNode<T> *left, ListNode<T> *right,
+                        Comparator &compare) {
+  ListNode<T> head;
+  ListNode<T> *tail = &head;
+
+  while (left && right) {
+    if (compare(left->data, right->data) <= 0) {
+      tail->next = left;
+      left = left->next;
+    } else {
+      tail->next = right;
+      right = right->next;
+    }
+    tail = tail->next;
   }
 
-  if (!right) {
-    return left;
-  }
+  tail->next = left ? left : right;
+  return head.next;
+}
 
-  ListNode<T> *result = nullptr;
+// NOTE: Bottom-up merge sort with binary counter bins, bin i holds a sorted
+// run of 2^i nodes. Runs are merged while they are still hot in cache and
+// nothing recurses, prev pointers are relinked in a single final pass.
+template <TrivialType T, typename Comparator>
+ListNode<T> *merge_sort_nodes(ListNode<T> *head, Comparator &&compare,
+                              ListNode<T> **out_tail) {
+  constexpr u32 BIN_COUNT = 64;
+  ListNode<T> *bins[BIN_COUNT] = {};
+  u32 used_bins = 0;
+
+  while (head) {
+    ListNode<T> *carry = head;
+    head = head->next;
+    carry->next = nullptr;
 
-  if (compare(left->data, right->data) <= 0) {
-    result = left;
-    result->next = merge_sorted(left->next, right, compare);
-    if (result->next) {
-      result->next->prev = result;
+    u32 bin = 0;
+    for (; bin < used_bins && bins[bin]; ++bin) {
+      carry = merge_runs(bins[bin], carry, compare);
+      bins[bin] = nullptr;
     }
-    result->prev = nullptr;
-  } else {
-    result = right;
-    result->next = merge_sorted(left, right->next, compare);
-    if (result->next) {
-      result->next->prev = result;
+
+    bins[bin] = carry;
+    if (bin == used_bins) {
+      used_bins++;
     }
-    result->prev = nullptr;
   }
 
+  // NOTE: Higher bins hold older nodes, they go on the left.
+  ListNode<T> *result = nullptr;
+  for (u32 bin = 0; bin < used_bins; ++bin) {
+    if (bins[bin]) {
+      result = merge_runs(bins[bin], result, compare);
+    }
+  }
+
+  ListNode<T> *prev = nullptr;
+  for (ListNode<T> *node = result; node; node = node->next) {
+    node->prev = prev;
+    prev = node;
+  }
+
+  *out_tail = prev;
   return result;
 }
 
-template <TrivialType T, typename Comparator>
-ListNode<T> *merge_sort_nodes(ListNode<T> *head, Comparator &&compare) {
-  if (!head || !head->next) {
-    return head;
+// NOTE: Hands out nodes from chunks of growing size, freed nodes go to an
+// intrusive free list. Nodes pushed in order end up next to each other.
+template <TrivialType T> struct ListNodePool {
+  struct Chunk {
+    Chunk *next;
+    u32 capacity;
+    u32 used;
+  };
+
+  static constexpr usize NODE_OFFSET =
+      (sizeof(Chunk) + alignof(ListNode<T>) - 1) & ~(alignof(ListNode<T>) - 1);
+  static constexpr usize CHUNK_ALIGN = alignof(ListNode<T>) > alignof(Chunk)
+                                           ? alignof(ListNode<T>)
+                                           : alignof(Chunk);
+
+  Chunk *m_chunks = nullptr;
+  ListNode<T> *m_free = nullptr;
+
+  ListNode<T> *allocate(const NotNull<const Allocator *> alloc) {
+    if (m_free) {
+      ListNode<T> *node = m_free;
+      m_free = node->next;
+      return node;
+    }
+
+    if (!m_chunks || m_chunks->used == m_chunks->capacity) {
+      const u32 capacity =
+          m_chunks ? (m_chunks->capacity < LIST_POOL_MAX_CHUNK
+                          ? m_chunks->capacity * 2
+                          : LIST_POOL_MAX_CHUNK)
+                   : LIST_POOL_FIRST_CHUNK;
+      auto *chunk = static_cast<Chunk *>(alloc->malloc(
+          NODE_OFFSET + sizeof(ListNode<T>) * capacity, CHUNK_ALIGN));
+      if (!chunk) {
+        return nullptr;
+      }
+
+      chunk->next = m_chunks;
+      chunk->capacity = capacity;
+      chunk->used = 0;
+      m_chunks = chunk;
+    }
+
+    return nodes(m_chunks) + m_chunks->used++;
   }
 
-  ListNode<T> *slow = head;
-  ListNode<T> *fast = head->next;
+  void free(ListNode<T> *node) {
+    node->next = m_free;
+    m_free = node;
+  }
 
-  while (fast && fast->next) {
-    slow = slow->next;
-    fast = fast->next->next;
+  // NOTE: Keeps only the newest and largest chunk around for reuse.
+  void reset(const NotNull<const Allocator *> alloc) {
+    if (!m_chunks) {
+      return;
+    }
+
+    release_chunks(alloc, m_chunks->next);
+    m_chunks->next = nullptr;
+    m_chunks->used = 0;
+    m_free = nullptr;
   }
 
-  ListNode<T> *mid = slow->next;
-  slow->next = nullptr;
-  if (mid) {
-    mid->prev = nullptr;
+  void destroy(const NotNull<const Allocator *> alloc) {
+    release_chunks(alloc, m_chunks);
+    m_chunks = nullptr;
+    m_free = nullptr;
   }
 
-  ListNode<T> *left = merge_sort_nodes(head, compare);
-  ListNode<T> *right = merge_sort_nodes(mid, compare);
+private:
+  static ListNode<T> *nodes(Chunk *chunk) {
+    return reinterpret_cast<ListNode<T> *>(reinterpret_cast<u8 *>(chunk) +
+                                           NODE_OFFSET);
+  }
 
-  return merge_sorted(left, right, compare);
-}
+  static void release_chunks(const NotNull<const Allocator *> alloc,
+                             Chunk *chunk) {
+    while (chunk) {
+      Chunk *next = chunk->next;
+      alloc->free(chunk);
+      chunk = next;
+    }
+  }
+};
+
+struct ListNoPool {};
 } // namespace detail
 
-template <TrivialType T> struct List {
+// NOTE: Pooled lists take their nodes from a chunked pool owned by the list
+// instead of one allocation per element, destroy() releases the pool.
+template <TrivialType T, bool Pooled = false> struct List {
   ListNode<T> *m_head = nullptr;
   ListNode<T> *m_tail = nullptr;
   usize m_size = 0ull;
+  [[no_unique_address]] std::conditional_t<Pooled, detail::ListNodePool<T>,
+                                           detail::ListNoPool> m_pool = {};
 
   struct Iterator {
     ListNode<T> *current;
@@ -118,11 +222,15 @@ template <TrivialType T> struct List {
   };
 
   void clear(const NotNull<const Allocator *> alloc) {
-    ListNode<T> *current = m_head;
-    while (current) {
-      ListNode<T> *next = current->next;
-      alloc->deallocate(current);
-      current = next;
+    if constexpr (Pooled) {
+      m_pool.reset(alloc);
+    } else {
+      ListNode<T> *current = m_head;
+      while (current) {
+        ListNode<T> *next = current->next;
+        alloc->deallocate(current);
+        current = next;
+      }
     }
 
     m_head = nullptr;
@@ -131,7 +239,7 @@ template <TrivialType T> struct List {
   }
 
   bool push_front(const NotNull<const Allocator *> alloc, const T &element) {
-    auto *node = alloc->allocate<ListNode<T>>(element, nullptr, nullptr);
+    auto *node = allocate_node(alloc, element);
     if (!node) {
       return false;
     }
@@ -149,10 +257,15 @@ template <TrivialType T> struct List {
     return true;
   }
 
-  void destroy(const NotNull<const Allocator *> alloc) { clear(alloc); }
+  void destroy(const NotNull<const Allocator *> alloc) {
+    clear(alloc);
+    if constexpr (Pooled) {
+      m_pool.destroy(alloc);
+    }
+  }
 
   bool push_back(const NotNull<const Allocator *> alloc, const T &element) {
-    ListNode<T> *node = alloc->allocate<ListNode<T>>(element, nullptr, nullptr);
+    ListNode<T> *node = allocate_node(alloc, element);
     if (!node) {
       return false;
     }
@@ -188,7 +301,7 @@ template <TrivialType T> struct List {
       m_tail = nullptr;
     }
 
-    alloc->deallocate(node);
+    free_node(alloc, node);
     m_size--;
 
     return true;
@@ -212,7 +325,7 @@ template <TrivialType T> struct List {
       m_head = nullptr;
     }
 
-    alloc->deallocate(node);
+    free_node(alloc, node);
     m_size--;
 
     return true;
@@ -267,8 +380,7 @@ template <TrivialType T> struct List {
       return push_back(alloc, element);
     }
 
-    ListNode<T> *new_node =
-        alloc->allocate<ListNode<T>>(element, nullptr, nullptr);
+    ListNode<T> *new_node = allocate_node(alloc, element);
     if (!new_node) {
       return false;
     }
@@ -312,12 +424,32 @@ template <TrivialType T> struct List {
     current->prev->next = current->next;
     current->next->prev = current->prev;
 
-    alloc->deallocate(current);
+    free_node(alloc, current);
     m_size--;
 
     return true;
   }
 
+  // NOTE: Unlinks a node returned by find or find_if.
+  void erase(const NotNull<const Allocator *> alloc, ListNode<T> *node) {
+    assert(node && m_size > 0 && "List::erase: invalid node");
+
+    if (node->prev) {
+      node->prev->next = node->next;
+    } else {
+      m_head = node->next;
+    }
+
+    if (node->next) {
+      node->next->prev = node->prev;
+    } else {
+      m_tail = node->prev;
+    }
+
+    free_node(alloc, node);
+    m_size--;
+  }
+
   bool empty() const { return m_size == 0; }
 
   usize size() const { return m_size; }
@@ -371,12 +503,7 @@ template <TrivialType T> struct List {
       return;
     }
 
-    m_head = detail::merge_sort_nodes(m_head, compare);
-
-    m_tail = m_head;
-    while (m_tail && m_tail->next) {
-      m_tail = m_tail->next;
-    }
+    m_head = detail::merge_sort_nodes(m_head, compare, &m_tail);
   }
 
   Iterator begin() {
@@ -394,7 +521,31 @@ template <TrivialType T> struct List {
   Iterator end() const {
     return {nullptr};
   }
+
+private:
+  ListNode<T> *allocate_node(const NotNull<const Allocator *> alloc,
+                             const T &element) {
+    if constexpr (Pooled) {
+      ListNode<T> *node = m_pool.allocate(alloc);
+      if (node) {
+        *node = {element, nullptr, nullptr};
+      }
+      return node;
+    } else {
+      return alloc->allocate<ListNode<T>>(element, nullptr, nullptr);
+    }
+  }
+
+  void free_node(const NotNull<const Allocator *> alloc, ListNode<T> *node) {
+    if constexpr (Pooled) {
+      m_pool.free(node);
+    } else {
+      alloc->deallocate(node);
+    }
+  }
 };
+
+template <TrivialType T> using PooledList = List<T, true>;
 } // namespace edge
 
 #endif
\ No newline at end of file
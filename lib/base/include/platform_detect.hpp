@@ -214,7 +214,10 @@ extern "C" {
 #define EDGE_HAS_AES 1
 #endif
 
-#if defined(__PCLMUL__)
+// NOTE: MSVC has no PCLMUL macro and its intrinsics need no flag, /arch:AVX2
+// implies the instruction.
+#if defined(__PCLMUL__) ||                                                     \
+    (defined(_MSC_VER) && !defined(__clang__) && defined(__AVX2__))
 #define EDGE_HAS_PCLMUL 1
 #endif
 
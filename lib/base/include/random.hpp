@@ -39,6 +39,9 @@ struct RngXoshiro256 {
   static constexpr u64 jump_values[] = {
       0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL,
       0x39abdc4529b1661cULL};
+  static constexpr u64 long_jump_values[] = {
+      0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL,
+      0x39109bb02acbe635ULL};
 
   constexpr void seed(const u64 seed_val) noexcept {
     u64 z = seed_val;
@@ -67,11 +70,19 @@ struct RngXoshiro256 {
 
   constexpr u32 next32() noexcept { return static_cast<u32>(next64()); }
 
-  constexpr void jump() noexcept {
+  // NOTE: Advances by 2^128 steps, used to split one seed into
+  // non-overlapping streams.
+  constexpr void jump() noexcept { apply_jump(jump_values); }
+
+  // NOTE: Advances by 2^192 steps, one long jump per worker leaves room for
+  // 2^64 regular jumps inside each worker stream.
+  constexpr void long_jump() noexcept { apply_jump(long_jump_values); }
+
+  constexpr void apply_jump(const u64 (&polynomial)[4]) noexcept {
     u64 s0 = 0, s1 = 0, s2 = 0, s3 = 0;
     for (i32 i = 0; i < 4; i++) {
       for (i32 b = 0; b < 64; b++) {
-        if (jump_values[i] & (1ULL << b)) {
+        if (polynomial[i] & (1ULL << b)) {
           s0 ^= s[0];
           s1 ^= s[1];
           s2 ^= s[2];
@@ -102,6 +113,47 @@ struct RngSplitMix64 {
   constexpr u32 next32() noexcept { return static_cast<u32>(next64()); }
 };
 
+constexpr usize RNG_BATCH_LANES = 8;
+constexpr usize RNG_BATCH_BUFFER = RNG_BATCH_LANES * 4;
+
+// NOTE: Eight xoshiro256** streams stepped side by side in SIMD registers.
+// Lane i is the scalar generator advanced by i jumps, outputs are written
+// lane interleaved. Fill calls always consume whole steps, so a count that
+// is not a multiple of the step width drops the rest of the last step.
+struct RngXoshiro256Batch {
+  alignas(32) u64 m_state[4][RNG_BATCH_LANES] = {};
+  u64 m_buffer[RNG_BATCH_BUFFER] = {};
+  usize m_buffer_pos = RNG_BATCH_BUFFER;
+
+  void seed(const u64 seed_val) noexcept { seed_stream(seed_val, 0); }
+
+  // NOTE: Independent stream per worker, the scalar generator is long jumped
+  // stream times before the lanes are split off it.
+  void seed_stream(u64 seed_val, u32 stream) noexcept;
+  void seed_lanes(RngXoshiro256 base) noexcept;
+
+  u64 next64() noexcept {
+    if (m_buffer_pos == RNG_BATCH_BUFFER) {
+      fill_u64(m_buffer, RNG_BATCH_BUFFER);
+      m_buffer_pos = 0;
+    }
+    return m_buffer[m_buffer_pos++];
+  }
+
+  u32 next32() noexcept { return static_cast<u32>(next64()); }
+
+  void fill_u64(u64 *out, usize count) noexcept;
+  void fill_u32(u32 *out, usize count) noexcept;
+  // NOTE: Uniform in [0, 1) with 24 bits of precision.
+  void fill_f32(f32 *out, usize count) noexcept;
+  void fill_f32_range(f32 *out, usize count, f32 min_val,
+                      f32 max_val) noexcept;
+  // NOTE: Marsaglia and Tsang ziggurat, 256 layers. Draws come from a
+  // private block, whatever is left of it is dropped when the call returns.
+  void fill_normal_f32(f32 *out, usize count, f32 mean = 0.0f,
+                       f32 stddev = 1.0f) noexcept;
+};
+
 template <typename T>
 concept RngAlgorithm = requires(T rng, u64 seed) {
   { rng.seed(seed) } -> std::same_as<void>;
@@ -146,7 +198,7 @@ constexpr f32 rng_gen_f32(Algorithm &state) noexcept {
 template <RngAlgorithm Algorithm>
 constexpr f32 rng_gen_f32_range(Algorithm &state, f32 min_val,
                                 const f32 max_val) noexcept {
-  return min_val + state.next32() * (max_val - min_val);
+  return min_val + rng_gen_f32(state) * (max_val - min_val);
 }
 
 template <RngAlgorithm Algorithm>
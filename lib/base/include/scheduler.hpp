@@ -10,6 +10,7 @@
 #include "fiber.hpp"
 
 #include <atomic>
+#include <variant>
 
 namespace edge {
 struct Scheduler;
@@ -152,6 +153,56 @@ template <typename T> void job_return(T &&value) {
   promise->status.store(Job::State::Completed, std::memory_order_release);
 }
 
+constexpr u32 JOB_PARALLEL_FOR_MAX_TASKS = 32;
+
+// NOTE: Runs fn(task_index) for every index below task_count and returns once
+// all of them are done. Task 0 runs on the calling thread, the rest become
+// background jobs. A job caller yields while it waits, any other thread spins
+// on thread_yield. Tasks that cannot get a job run inline.
+template <typename F>
+void job_parallel_for(const NotNull<const Allocator *> alloc,
+                      const NotNull<Scheduler *> sched, const u32 task_count,
+                      F &&fn) {
+  assert(task_count <= JOB_PARALLEL_FOR_MAX_TASKS &&
+         "job_parallel_for: too many tasks");
+  if (task_count == 0) {
+    return;
+  }
+
+  std::atomic<u32> remaining = task_count;
+  Job *jobs[JOB_PARALLEL_FOR_MAX_TASKS];
+  u32 job_count = 0;
+
+  for (u32 i = 1; i < task_count; ++i) {
+    Job *job = Job::from_lambda(alloc, sched, [&fn, &remaining, i]() {
+      fn(i);
+      remaining.fetch_sub(1, std::memory_order_release);
+    });
+
+    if (job) {
+      jobs[job_count++] = job;
+    } else {
+      fn(i);
+      remaining.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  if (job_count > 0) {
+    sched->schedule(Span<Job *>{jobs, job_count});
+  }
+
+  fn(0u);
+  remaining.fetch_sub(1, std::memory_order_relaxed);
+
+  while (remaining.load(std::memory_order_acquire) > 0) {
+    if (job_current() && is_running_in_job()) {
+      job_yield();
+    } else {
+      thread_yield();
+    }
+  }
+}
+
 template <typename E> void job_failed(E &&error) {
   Job *job = job_current();
   if (!job || !job->promise) {
@@ -0,0 +1,338 @@
+#ifndef EDGE_SIMD_MATH_H
+#define EDGE_SIMD_MATH_H
+
+#include "math.hpp"
+#include "stddef.hpp"
+
+#include <cstring>
+
+namespace edge {
+#if EDGE_HAS_SSE2
+using F32x4 = __m128;
+#elif EDGE_HAS_NEON
+using F32x4 = float32x4_t;
+#else
+struct F32x4 {
+  f32 m_lanes[4];
+};
+#endif
+
+struct Vec3 {
+  f32 x = 0.0f;
+  f32 y = 0.0f;
+  f32 z = 0.0f;
+};
+
+struct alignas(16) Vec4 {
+  f32 x = 0.0f;
+  f32 y = 0.0f;
+  f32 z = 0.0f;
+  f32 w = 0.0f;
+};
+
+struct alignas(16) Quat {
+  f32 x = 0.0f;
+  f32 y = 0.0f;
+  f32 z = 0.0f;
+  f32 w = 1.0f;
+};
+
+// NOTE: Column major with the same memory layout as glm::mat4, m_columns[3]
+// holds the translation.
+struct alignas(16) Mat4 {
+  Vec4 m_columns[4] = {{1.0f, 0.0f, 0.0f, 0.0f},
+                       {0.0f, 1.0f, 0.0f, 0.0f},
+                       {0.0f, 0.0f, 1.0f, 0.0f},
+                       {0.0f, 0.0f, 0.0f, 1.0f}};
+};
+
+struct Aabb {
+  Vec3 m_min;
+  Vec3 m_max;
+};
+
+// NOTE: Structure of arrays views used by the batch kernels, every pointer
+// addresses count elements.
+struct Vec3Soa {
+  f32 *m_x = nullptr;
+  f32 *m_y = nullptr;
+  f32 *m_z = nullptr;
+};
+
+struct QuatSoa {
+  f32 *m_x = nullptr;
+  f32 *m_y = nullptr;
+  f32 *m_z = nullptr;
+  f32 *m_w = nullptr;
+};
+
+#if EDGE_HAS_SSE2
+inline F32x4 f32x4_set(const f32 x, const f32 y, const f32 z, const f32 w) {
+  return _mm_setr_ps(x, y, z, w);
+}
+inline F32x4 f32x4_splat(const f32 value) { return _mm_set1_ps(value); }
+inline F32x4 f32x4_load(const f32 *data) { return _mm_loadu_ps(data); }
+inline void f32x4_store(f32 *data, const F32x4 value) {
+  _mm_storeu_ps(data, value);
+}
+inline F32x4 f32x4_add(const F32x4 a, const F32x4 b) { return _mm_add_ps(a, b); }
+inline F32x4 f32x4_sub(const F32x4 a, const F32x4 b) { return _mm_sub_ps(a, b); }
+inline F32x4 f32x4_mul(const F32x4 a, const F32x4 b) { return _mm_mul_ps(a, b); }
+inline F32x4 f32x4_div(const F32x4 a, const F32x4 b) { return _mm_div_ps(a, b); }
+inline F32x4 f32x4_min(const F32x4 a, const F32x4 b) { return _mm_min_ps(a, b); }
+inline F32x4 f32x4_max(const F32x4 a, const F32x4 b) { return _mm_max_ps(a, b); }
+inline F32x4 f32x4_sqrt(const F32x4 a) { return _mm_sqrt_ps(a); }
+inline F32x4 f32x4_abs(const F32x4 a) {
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+}
+inline F32x4 f32x4_madd(const F32x4 a, const F32x4 b, const F32x4 c) {
+#if EDGE_HAS_FMA
+  return _mm_fmadd_ps(a, b, c);
+#else
+  return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+template <i32 X, i32 Y, i32 Z, i32 W> inline F32x4 f32x4_swizzle(const F32x4 a) {
+  return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X));
+}
+inline f32 f32x4_x(const F32x4 a) { return _mm_cvtss_f32(a); }
+#elif EDGE_HAS_NEON
+inline F32x4 f32x4_set(const f32 x, const f32 y, const f32 z, const f32 w) {
+  const f32 values[4] = {x, y, z, w};
+  return vld1q_f32(values);
+}
+inline F32x4 f32x4_splat(const f32 value) { return vdupq_n_f32(value); }
+inline F32x4 f32x4_load(const f32 *data) { return vld1q_f32(data); }
+inline void f32x4_store(f32 *data, const F32x4 value) { vst1q_f32(data, value); }
+inline F32x4 f32x4_add(const F32x4 a, const F32x4 b) { return vaddq_f32(a, b); }
+inline F32x4 f32x4_sub(const F32x4 a, const F32x4 b) { return vsubq_f32(a, b); }
+inline F32x4 f32x4_mul(const F32x4 a, const F32x4 b) { return vmulq_f32(a, b); }
+inline F32x4 f32x4_min(const F32x4 a, const F32x4 b) { return vminq_f32(a, b); }
+inline F32x4 f32x4_max(const F32x4 a, const F32x4 b) { return vmaxq_f32(a, b); }
+inline F32x4 f32x4_abs(const F32x4 a) { return vabsq_f32(a); }
+#if defined(EDGE_ARCH_AARCH64)
+inline F32x4 f32x4_div(const F32x4 a, const F32x4 b) { return vdivq_f32(a, b); }
+inline F32x4 f32x4_sqrt(const F32x4 a) { return vsqrtq_f32(a); }
+inline F32x4 f32x4_madd(const F32x4 a, const F32x4 b, const F32x4 c) {
+  return vfmaq_f32(c, a, b);
+}
+#else
+inline F32x4 f32x4_div(const F32x4 a, const F32x4 b) {
+  F32x4 inv = vrecpeq_f32(b);
+  inv = vmulq_f32(inv, vrecpsq_f32(b, inv));
+  inv = vmulq_f32(inv, vrecpsq_f32(b, inv));
+  return vmulq_f32(a, inv);
+}
+inline F32x4 f32x4_sqrt(const F32x4 a) {
+  const f32 values[4] = {std::sqrt(vgetq_lane_f32(a, 0)),
+                         std::sqrt(vgetq_lane_f32(a, 1)),
+                         std::sqrt(vgetq_lane_f32(a, 2)),
+                         std::sqrt(vgetq_lane_f32(a, 3))};
+  return vld1q_f32(values);
+}
+inline F32x4 f32x4_madd(const F32x4 a, const F32x4 b, const F32x4 c) {
+  return vmlaq_f32(c, a, b);
+}
+#endif
+template <i32 X, i32 Y, i32 Z, i32 W> inline F32x4 f32x4_swizzle(const F32x4 a) {
+  F32x4 result = vmovq_n_f32(vgetq_lane_f32(a, X));
+  result = vsetq_lane_f32(vgetq_lane_f32(a, Y), result, 1);
+  result = vsetq_lane_f32(vgetq_lane_f32(a, Z), result, 2);
+  return vsetq_lane_f32(vgetq_lane_f32(a, W), result, 3);
+}
+inline f32 f32x4_x(const F32x4 a) { return vgetq_lane_f32(a, 0); }
+#else
+inline F32x4 f32x4_set(const f32 x, const f32 y, const f32 z, const f32 w) {
+  return {{x, y, z, w}};
+}
+inline F32x4 f32x4_splat(const f32 value) { return {{value, value, value, value}}; }
+inline F32x4 f32x4_load(const f32 *data) {
+  return {{data[0], data[1], data[2], data[3]}};
+}
+inline void f32x4_store(f32 *data, const F32x4 value) {
+  memcpy(data, value.m_lanes, sizeof(value.m_lanes));
+}
+
+#define EDGE_F32X4_LANEWISE(name, expr)                                        \
+  inline F32x4 name(const F32x4 a, const F32x4 b) {                            \
+    F32x4 result;                                                              \
+    for (i32 i = 0; i < 4; ++i) {                                              \
+      const f32 x = a.m_lanes[i];                                              \
+      const f32 y = b.m_lanes[i];                                              \
+      result.m_lanes[i] = (expr);                                              \
+    }                                                                          \
+    return result;                                                             \
+  }
+EDGE_F32X4_LANEWISE(f32x4_add, x + y)
+EDGE_F32X4_LANEWISE(f32x4_sub, x - y)
+EDGE_F32X4_LANEWISE(f32x4_mul, x * y)
+EDGE_F32X4_LANEWISE(f32x4_div, x / y)
+EDGE_F32X4_LANEWISE(f32x4_min, y < x ? y : x)
+EDGE_F32X4_LANEWISE(f32x4_max, x < y ? y : x)
+#undef EDGE_F32X4_LANEWISE
+
+inline F32x4 f32x4_sqrt(const F32x4 a) {
+  return {{std::sqrt(a.m_lanes[0]), std::sqrt(a.m_lanes[1]),
+           std::sqrt(a.m_lanes[2]), std::sqrt(a.m_lanes[3])}};
+}
+inline F32x4 f32x4_abs(const F32x4 a) {
+  return {{std::fabs(a.m_lanes[0]), std::fabs(a.m_lanes[1]),
+           std::fabs(a.m_lanes[2]), std::fabs(a.m_lanes[3])}};
+}
+inline F32x4 f32x4_madd(const F32x4 a, const F32x4 b, const F32x4 c) {
+  return f32x4_add(f32x4_mul(a, b), c);
+}
+template <i32 X, i32 Y, i32 Z, i32 W> inline F32x4 f32x4_swizzle(const F32x4 a) {
+  return {{a.m_lanes[X], a.m_lanes[Y], a.m_lanes[Z], a.m_lanes[W]}};
+}
+inline f32 f32x4_x(const F32x4 a) { return a.m_lanes[0]; }
+#endif
+
+template <i32 Lane> inline F32x4 f32x4_splat_lane(const F32x4 a) {
+  return f32x4_swizzle<Lane, Lane, Lane, Lane>(a);
+}
+
+inline F32x4 f32x4_load(const Vec4 &v) { return f32x4_load(&v.x); }
+inline void f32x4_store(Vec4 &v, const F32x4 value) { f32x4_store(&v.x, value); }
+
+inline F32x4 f32x4_dot4(const F32x4 a, const F32x4 b) {
+  const F32x4 product = f32x4_mul(a, b);
+  const F32x4 pairs = f32x4_add(product, f32x4_swizzle<1, 0, 3, 2>(product));
+  return f32x4_add(pairs, f32x4_swizzle<2, 3, 0, 1>(pairs));
+}
+
+inline Vec3 vec3_add(const Vec3 a, const Vec3 b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+inline Vec3 vec3_sub(const Vec3 a, const Vec3 b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+inline Vec3 vec3_scale(const Vec3 a, const f32 s) {
+  return {a.x * s, a.y * s, a.z * s};
+}
+inline f32 vec3_dot(const Vec3 a, const Vec3 b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+inline Vec3 vec3_cross(const Vec3 a, const Vec3 b) {
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+// NOTE: Columns of b are combinations of the columns of a, four broadcasts
+// and four multiply-adds per output column.
+inline Mat4 mat4_mul(const Mat4 &a, const Mat4 &b) {
+  const F32x4 a0 = f32x4_load(a.m_columns[0]);
+  const F32x4 a1 = f32x4_load(a.m_columns[1]);
+  const F32x4 a2 = f32x4_load(a.m_columns[2]);
+  const F32x4 a3 = f32x4_load(a.m_columns[3]);
+
+  Mat4 result;
+  for (i32 i = 0; i < 4; ++i) {
+    const F32x4 column = f32x4_load(b.m_columns[i]);
+    F32x4 value = f32x4_mul(a0, f32x4_splat_lane<0>(column));
+    value = f32x4_madd(a1, f32x4_splat_lane<1>(column), value);
+    value = f32x4_madd(a2, f32x4_splat_lane<2>(column), value);
+    value = f32x4_madd(a3, f32x4_splat_lane<3>(column), value);
+    f32x4_store(result.m_columns[i], value);
+  }
+  return result;
+}
+
+inline Vec4 mat4_mul(const Mat4 &m, const Vec4 &v) {
+  const F32x4 value = f32x4_load(v);
+  F32x4 result = f32x4_mul(f32x4_load(m.m_columns[0]), f32x4_splat_lane<0>(value));
+  result = f32x4_madd(f32x4_load(m.m_columns[1]), f32x4_splat_lane<1>(value), result);
+  result = f32x4_madd(f32x4_load(m.m_columns[2]), f32x4_splat_lane<2>(value), result);
+  result = f32x4_madd(f32x4_load(m.m_columns[3]), f32x4_splat_lane<3>(value), result);
+  Vec4 out;
+  f32x4_store(out, result);
+  return out;
+}
+
+inline Vec3 mat4_transform_point(const Mat4 &m, const Vec3 p) {
+  const Vec4 result = mat4_mul(m, Vec4{p.x, p.y, p.z, 1.0f});
+  return {result.x, result.y, result.z};
+}
+
+inline Vec3 mat4_transform_vector(const Mat4 &m, const Vec3 v) {
+  const Vec4 result = mat4_mul(m, Vec4{v.x, v.y, v.z, 0.0f});
+  return {result.x, result.y, result.z};
+}
+
+Mat4 mat4_transpose(const Mat4 &m);
+// NOTE: Returns false and leaves out untouched for a singular matrix.
+bool mat4_inverse(const Mat4 &m, Mat4 &out);
+Mat4 mat4_from_trs(Vec3 translation, Quat rotation, Vec3 scale);
+
+// NOTE: Hamilton product, the result applies b first and then a.
+inline Quat quat_mul(const Quat &a, const Quat &b) {
+  const F32x4 qa = f32x4_set(a.x, a.y, a.z, a.w);
+  const F32x4 qb = f32x4_set(b.x, b.y, b.z, b.w);
+
+  F32x4 result = f32x4_mul(f32x4_splat_lane<3>(qa), qb);
+  result = f32x4_madd(
+      f32x4_mul(f32x4_splat_lane<0>(qa), f32x4_set(1.0f, -1.0f, 1.0f, -1.0f)),
+      f32x4_swizzle<3, 2, 1, 0>(qb), result);
+  result = f32x4_madd(
+      f32x4_mul(f32x4_splat_lane<1>(qa), f32x4_set(1.0f, 1.0f, -1.0f, -1.0f)),
+      f32x4_swizzle<2, 3, 0, 1>(qb), result);
+  result = f32x4_madd(
+      f32x4_mul(f32x4_splat_lane<2>(qa), f32x4_set(-1.0f, 1.0f, 1.0f, -1.0f)),
+      f32x4_swizzle<1, 0, 3, 2>(qb), result);
+
+  alignas(16) f32 values[4];
+  f32x4_store(values, result);
+  return {values[0], values[1], values[2], values[3]};
+}
+
+inline Quat quat_conjugate(const Quat &q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+inline f32 quat_dot(const Quat &a, const Quat &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+inline Quat quat_normalize(const Quat &q) {
+  const f32 length_sq = quat_dot(q, q);
+  if (length_sq <= 0.0f) {
+    return {};
+  }
+  const f32 inv = 1.0f / std::sqrt(length_sq);
+  return {q.x * inv, q.y * inv, q.z * inv, q.w * inv};
+}
+
+inline Quat quat_from_axis_angle(const Vec3 axis, const f32 angle) {
+  const f32 s = std::sin(angle * 0.5f);
+  return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f)};
+}
+
+// NOTE: v + 2w(u x v) + 2u x (u x v) for a unit quaternion, no matrix.
+inline Vec3 quat_rotate(const Quat &q, const Vec3 v) {
+  const Vec3 u = {q.x, q.y, q.z};
+  const Vec3 t = vec3_scale(vec3_cross(u, v), 2.0f);
+  return vec3_add(vec3_add(v, vec3_scale(t, q.w)), vec3_cross(u, t));
+}
+
+Quat quat_slerp(const Quat &a, const Quat &b, f32 t);
+Mat4 quat_to_mat4(const Quat &q);
+
+// NOTE: Batch kernels. Sizes are in elements, inputs and outputs may not
+// overlap unless noted.
+
+// NOTE: out = m * (in, 1) for count points, in and out may be the same view.
+void transform_points(const Mat4 &m, const Vec3Soa &in, const Vec3Soa &out,
+                      usize count);
+// NOTE: out[i] = a[i] * b[i], out may alias a or b.
+void mat4_mul_batch(const Mat4 *a, const Mat4 *b, Mat4 *out, usize count);
+// NOTE: Singular inputs produce a zero matrix and clear their bit in the
+// optional invertible mask (one bit per element, count rounded up to bytes).
+void mat4_inverse_batch(const Mat4 *in, Mat4 *out, usize count,
+                        u8 *invertible = nullptr);
+void mat4_from_trs_batch(const Vec3Soa &translations, const QuatSoa &rotations,
+                         const Vec3Soa &scales, Mat4 *out, usize count);
+// NOTE: Arvo's method, the center is transformed and the half extents go
+// through the absolute rotation and scale part.
+void aabb_transform_batch(const Aabb *local, const Mat4 *transforms, Aabb *out,
+                          usize count);
+Aabb aabb_from_points(const Vec3Soa &points, usize count);
+} // namespace edge
+
+#endif
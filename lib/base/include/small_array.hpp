@@ -0,0 +1,326 @@
+#ifndef EDGE_SMALL_ARRAY_H
+#define EDGE_SMALL_ARRAY_H
+
+#include "allocator.hpp"
+#include "random_access_iterator.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace edge {
+namespace detail {
+inline std::atomic<usize> g_small_array_spill_count = 0ull;
+} // namespace detail
+
+// NOTE: Total number of times any SmallArray moved its elements to the heap,
+// useful to tune N for hot call sites.
+inline usize small_array_total_spill_count() {
+  return detail::g_small_array_spill_count.load(std::memory_order_relaxed);
+}
+
+// NOTE: Same interface as Array, the first N elements live inside the object
+// and the allocator is only touched once the array outgrows them. Storage is
+// never moved back inline, clear() keeps the heap block.
+template <typename T, usize N> struct SmallArray {
+  static_assert(N > 0, "SmallArray: N must be greater than 0");
+
+  EDGE_DECLARE_CONTAINER_HEADER(T)
+
+  void destroy(const NotNull<const Allocator *> alloc) {
+    destroy_elements();
+    if (m_heap) {
+      alloc->free(m_heap);
+    }
+    m_heap = nullptr;
+    m_size = 0;
+    m_capacity = N;
+  }
+
+  void clear() {
+    destroy_elements();
+    m_size = 0;
+  }
+
+  bool reserve(const NotNull<const Allocator *> alloc,
+               const size_type new_cap) {
+    if (new_cap <= m_capacity) {
+      return true;
+    }
+    return grow_to(alloc, new_cap);
+  }
+
+  bool resize(const NotNull<const Allocator *> alloc,
+              const size_type new_size) {
+    if (new_size > m_capacity) {
+      if (!grow_to(alloc, new_size)) {
+        return false;
+      }
+    }
+
+    pointer elements = data();
+    if (new_size > m_size) {
+      if constexpr (std::is_trivially_constructible_v<T> &&
+                    std::is_trivially_destructible_v<T>) {
+        memset(&elements[m_size], 0, sizeof(T) * (new_size - m_size));
+      } else {
+        for (size_type i = m_size; i < new_size; ++i) {
+          new (&elements[i]) T();
+        }
+      }
+    } else if (new_size < m_size) {
+      if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (size_type i = new_size; i < m_size; ++i) {
+          elements[i].~T();
+        }
+      }
+    }
+    m_size = new_size;
+    return true;
+  }
+
+  constexpr reference operator[](size_type index) {
+    assert(index < m_size && "SmallArray::operator[]: index out of bounds");
+    return data()[index];
+  }
+
+  constexpr const_reference operator[](size_type index) const {
+    assert(index < m_size && "SmallArray::operator[]: index out of bounds");
+    return data()[index];
+  }
+
+  constexpr reference front() {
+    assert(m_size > 0 && "SmallArray::front(): array is empty");
+    return data()[0];
+  }
+
+  constexpr const_reference front() const {
+    assert(m_size > 0 && "SmallArray::front(): array is empty");
+    return data()[0];
+  }
+
+  constexpr reference back() {
+    assert(m_size > 0 && "SmallArray::back(): array is empty");
+    return data()[m_size - 1];
+  }
+
+  constexpr const_reference back() const {
+    assert(m_size > 0 && "SmallArray::back(): array is empty");
+    return data()[m_size - 1];
+  }
+
+  constexpr size_type size() const noexcept { return m_size; }
+
+  constexpr size_type capacity() const noexcept { return m_capacity; }
+
+  constexpr bool empty() const noexcept { return m_size == 0; }
+
+  constexpr bool is_inline() const noexcept { return m_heap == nullptr; }
+
+  constexpr u32 spill_count() const noexcept { return m_spill_count; }
+
+  bool push_back(const NotNull<const Allocator *> alloc, const_reference value) {
+    if (m_size == m_capacity) {
+      if (!grow_to(alloc, m_capacity * 2)) {
+        return false;
+      }
+    }
+    new (&data()[m_size++]) T(value);
+    return true;
+  }
+
+  bool push_back(const_reference value) {
+    const bool is_full = m_size >= m_capacity;
+    assert(!is_full && "SmallArray is already full.");
+    if (is_full) {
+      return false;
+    }
+    new (&data()[m_size++]) T(value);
+    return true;
+  }
+
+  bool push_back(const NotNull<const Allocator *> alloc, T &&value) {
+    if (m_size == m_capacity) {
+      if (!grow_to(alloc, m_capacity * 2)) {
+        return false;
+      }
+    }
+    new (&data()[m_size++]) T(std::move(value));
+    return true;
+  }
+
+  bool push_back(T &&value) {
+    const bool is_full = m_size >= m_capacity;
+    assert(!is_full && "SmallArray is already full.");
+    if (is_full) {
+      return false;
+    }
+    new (&data()[m_size++]) T(std::move(value));
+    return true;
+  }
+
+  template <typename... Args>
+  bool emplace_back(const NotNull<const Allocator *> alloc, Args &&...args) {
+    if (m_size == m_capacity) {
+      if (!grow_to(alloc, m_capacity * 2)) {
+        return false;
+      }
+    }
+    new (&data()[m_size++]) T(std::forward<Args>(args)...);
+    return true;
+  }
+
+  bool pop_back(pointer out_element = nullptr) {
+    assert(m_size > 0 && "SmallArray::pop_back: array is empty");
+    if (m_size == 0) {
+      return false;
+    }
+
+    pointer elements = data();
+    --m_size;
+    if (out_element) {
+      if constexpr (std::is_move_assignable_v<T> &&
+                    !std::is_trivially_copyable_v<T>) {
+        *out_element = std::move(elements[m_size]);
+      } else {
+        *out_element = elements[m_size];
+      }
+    }
+
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      elements[m_size].~T();
+    }
+
+    return true;
+  }
+
+  bool insert(const NotNull<const Allocator *> alloc, size_type index,
+              const_reference value) {
+    assert(index <= m_size && "SmallArray::insert: index out of bounds");
+    if (index > m_size) {
+      return false;
+    }
+
+    if (m_size == m_capacity) {
+      if (!grow_to(alloc, m_capacity * 2)) {
+        return false;
+      }
+    }
+
+    pointer elements = data();
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (index < m_size) {
+        memmove(&elements[index + 1], &elements[index],
+                sizeof(T) * (m_size - index));
+      }
+      elements[index] = value;
+    } else {
+      if (index < m_size) {
+        new (&elements[m_size]) T(std::move(elements[m_size - 1]));
+        for (usize i = m_size - 1; i > index; --i) {
+          elements[i] = std::move(elements[i - 1]);
+        }
+        elements[index] = value;
+      } else {
+        new (&elements[index]) T(value);
+      }
+    }
+    ++m_size;
+
+    return true;
+  }
+
+  bool remove(size_type index, pointer out_element = nullptr) {
+    assert(index < m_size && "SmallArray::erase: index out of bounds");
+    if (index >= m_size) {
+      return false;
+    }
+
+    pointer elements = data();
+    if (out_element) {
+      if constexpr (std::is_move_assignable_v<T> &&
+                    !std::is_trivially_copyable_v<T>) {
+        *out_element = std::move(elements[index]);
+      } else {
+        *out_element = elements[index];
+      }
+    }
+
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (index < m_size - 1) {
+        memmove(&elements[index], &elements[index + 1],
+                sizeof(T) * (m_size - index - 1));
+      }
+    } else {
+      for (size_type i = index; i < m_size - 1; ++i) {
+        elements[i] = std::move(elements[i + 1]);
+      }
+      elements[m_size - 1].~T();
+    }
+    --m_size;
+
+    return true;
+  }
+
+  constexpr pointer data() noexcept {
+    return m_heap ? m_heap : reinterpret_cast<pointer>(m_inline);
+  }
+
+  constexpr const_pointer data() const noexcept {
+    return m_heap ? m_heap : reinterpret_cast<const_pointer>(m_inline);
+  }
+
+  EDGE_DECLARE_RANDOM_ACCESS_ITERATOR(T, data(), m_size)
+
+private:
+  pointer m_heap = nullptr;
+  size_type m_size = 0;
+  size_type m_capacity = N;
+  u32 m_spill_count = 0;
+  alignas(T) u8 m_inline[sizeof(T) * N];
+
+  void destroy_elements() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      pointer elements = data();
+      for (size_type i = m_size; i > 0; --i) {
+        elements[i - 1].~T();
+      }
+    }
+  }
+
+  bool grow_to(const NotNull<const Allocator *> alloc,
+               const size_type new_cap) {
+    auto new_data =
+        static_cast<pointer>(alloc->malloc(sizeof(T) * new_cap, alignof(T)));
+    assert(new_data && "SmallArray: allocation failed during grow");
+    if (!new_data) {
+      return false;
+    }
+
+    pointer old_data = data();
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (m_size > 0) {
+        memcpy(new_data, old_data, sizeof(T) * m_size);
+      }
+    } else {
+      for (size_type i = 0; i < m_size; ++i) {
+        new (&new_data[i]) T(std::move(old_data[i]));
+        old_data[i].~T();
+      }
+    }
+
+    if (m_heap) {
+      alloc->free(m_heap);
+    } else {
+      m_spill_count++;
+      detail::g_small_array_spill_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_heap = new_data;
+    m_capacity = new_cap;
+    return true;
+  }
+};
+} // namespace edge
+
+#endif
@@ -0,0 +1,421 @@
+#ifndef EDGE_SORT_H
+#define EDGE_SORT_H
+
+#include "allocator.hpp"
+#include "scheduler.hpp"
+#include "span.hpp"
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+namespace edge {
+namespace detail {
+constexpr usize SORT_INSERTION_RUN = 32;
+constexpr usize SORT_PARALLEL_MIN_CHUNK = 1ull << 14;
+constexpr u32 SORT_RADIX_BITS = 8;
+constexpr u32 SORT_RADIX_BUCKETS = 1u << SORT_RADIX_BITS;
+
+template <typename T, typename Less>
+void sort_insertion(T *items, const usize count, Less &less) {
+  for (usize i = 1; i < count; ++i) {
+    T value = items[i];
+    usize j = i;
+    while (j > 0 && less(value, items[j - 1])) {
+      items[j] = items[j - 1];
+      --j;
+    }
+    items[j] = value;
+  }
+}
+
+// NOTE: Ties take from a, which keeps the merge stable.
+template <typename T, typename Less>
+void sort_merge_into(const T *a, const usize a_count, const T *b,
+                     const usize b_count, T *out, Less &less) {
+  usize i = 0;
+  usize j = 0;
+  while (i < a_count && j < b_count) {
+    if (less(b[j], a[i])) {
+      *out++ = b[j++];
+    } else {
+      *out++ = a[i++];
+    }
+  }
+
+  memcpy(out, a + i, sizeof(T) * (a_count - i));
+  memcpy(out + (a_count - i), b + j, sizeof(T) * (b_count - j));
+}
+
+// NOTE: How many elements of a land in the first d outputs of a stable merge
+// of a and b, the split point for merging one pair on several threads.
+template <typename T, typename Less>
+usize sort_merge_corank(const T *a, const usize a_count, const T *b,
+                        const usize b_count, const usize d, Less &less) {
+  usize lo = d > b_count ? d - b_count : 0;
+  usize hi = d < a_count ? d : a_count;
+  while (lo < hi) {
+    const usize i = lo + (hi - lo) / 2;
+    const usize j = d - i;
+    if (j > 0 && i < a_count && !less(b[j - 1], a[i])) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+// NOTE: Bottom-up, insertion sorted runs first, then merges ping-pong between
+// items and scratch. The result always ends up in items.
+template <typename T, typename Less>
+void sort_merge_range(T *items, T *scratch, const usize count, Less &less) {
+  for (usize first = 0; first < count; first += SORT_INSERTION_RUN) {
+    const usize run = count - first < SORT_INSERTION_RUN ? count - first
+                                                         : SORT_INSERTION_RUN;
+    sort_insertion(items + first, run, less);
+  }
+
+  T *src = items;
+  T *dst = scratch;
+  for (usize width = SORT_INSERTION_RUN; width < count; width *= 2) {
+    for (usize first = 0; first < count; first += 2 * width) {
+      const usize middle = first + width < count ? first + width : count;
+      const usize last = middle + width < count ? middle + width : count;
+      sort_merge_into(src + first, middle - first, src + middle, last - middle,
+                      dst + first, less);
+    }
+
+    T *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != items) {
+    memcpy(items, src, sizeof(T) * count);
+  }
+}
+
+template <typename T>
+T *sort_allocate_scratch(const NotNull<const Allocator *> alloc,
+                         const usize count) {
+  return static_cast<T *>(alloc->malloc(sizeof(T) * count, alignof(T)));
+}
+
+// NOTE: Chunks a parallel sort splits into, a power of two so merge rounds
+// pair up evenly. One chunk means the serial path is faster.
+inline u32 sort_parallel_chunks(const NotNull<Scheduler *> sched,
+                                const usize count) {
+  const usize workers = sched->background_threads.size() + 1;
+  usize chunks = count / SORT_PARALLEL_MIN_CHUNK;
+  if (chunks > workers) {
+    chunks = workers;
+  }
+  if (chunks > JOB_PARALLEL_FOR_MAX_TASKS) {
+    chunks = JOB_PARALLEL_FOR_MAX_TASKS;
+  }
+  return chunks > 1 ? static_cast<u32>(std::bit_floor(chunks)) : 1u;
+}
+
+template <typename Key>
+u32 sort_radix_digit(const Key key, const u32 pass) {
+  return static_cast<u32>(key >> (pass * SORT_RADIX_BITS)) &
+         (SORT_RADIX_BUCKETS - 1);
+}
+} // namespace detail
+
+// NOTE: Order preserving unsigned keys for sort_radix. Negative floats come
+// first, -0.0 sorts before +0.0 and NaNs go to the ends.
+template <std::unsigned_integral T> constexpr T radix_key(const T value) {
+  return value;
+}
+
+template <std::signed_integral T>
+constexpr std::make_unsigned_t<T> radix_key(const T value) {
+  using U = std::make_unsigned_t<T>;
+  return static_cast<U>(value) ^ (U{1} << (sizeof(T) * 8 - 1));
+}
+
+constexpr u32 radix_key(const f32 value) {
+  const u32 bits = std::bit_cast<u32>(value);
+  return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+}
+
+constexpr u64 radix_key(const f64 value) {
+  const u64 bits = std::bit_cast<u64>(value);
+  return bits & 0x8000000000000000ull ? ~bits : bits | 0x8000000000000000ull;
+}
+
+// NOTE: Stable merge sort, scratch for count elements comes from alloc.
+template <TrivialType T, typename Less>
+bool sort_merge(const NotNull<const Allocator *> alloc, Span<T> items,
+                Less &&less) {
+  if (items.size() <= detail::SORT_INSERTION_RUN) {
+    detail::sort_insertion(items.data(), items.size(), less);
+    return true;
+  }
+
+  T *scratch = detail::sort_allocate_scratch<T>(alloc, items.size());
+  if (!scratch) {
+    return false;
+  }
+
+  detail::sort_merge_range(items.data(), scratch, items.size(), less);
+  alloc->free(scratch);
+  return true;
+}
+
+template <TrivialType T>
+bool sort_merge(const NotNull<const Allocator *> alloc, Span<T> items) {
+  return sort_merge(alloc, items,
+                    [](const T &a, const T &b) { return a < b; });
+}
+
+// NOTE: Stable LSD radix sort on the unsigned key key_fn returns, one byte
+// per pass. All digit histograms are built in one read and passes where every
+// key shares the digit are skipped, so small key ranges cost fewer passes.
+template <TrivialType T, typename KeyFn>
+bool sort_radix(const NotNull<const Allocator *> alloc, Span<T> items,
+                KeyFn &&key_fn) {
+  using Key = std::invoke_result_t<KeyFn &, const T &>;
+  static_assert(std::is_unsigned_v<Key>,
+                "sort_radix: key_fn must return an unsigned integer");
+  constexpr u32 PASS_COUNT = sizeof(Key) * 8 / detail::SORT_RADIX_BITS;
+
+  const usize count = items.size();
+  if (count < 2) {
+    return true;
+  }
+
+  T *scratch = detail::sort_allocate_scratch<T>(alloc, count);
+  usize *histograms = alloc->allocate_array<usize>(
+      PASS_COUNT * detail::SORT_RADIX_BUCKETS);
+  if (!scratch || !histograms) {
+    alloc->free(scratch);
+    alloc->deallocate_array(histograms, PASS_COUNT * detail::SORT_RADIX_BUCKETS);
+    return false;
+  }
+
+  T *src = items.data();
+  T *dst = scratch;
+
+  for (usize i = 0; i < count; ++i) {
+    const Key key = key_fn(src[i]);
+    for (u32 pass = 0; pass < PASS_COUNT; ++pass) {
+      histograms[pass * detail::SORT_RADIX_BUCKETS +
+                 detail::sort_radix_digit(key, pass)]++;
+    }
+  }
+
+  for (u32 pass = 0; pass < PASS_COUNT; ++pass) {
+    usize *offsets = histograms + pass * detail::SORT_RADIX_BUCKETS;
+    if (offsets[detail::sort_radix_digit(key_fn(src[0]), pass)] == count) {
+      continue;
+    }
+
+    usize sum = 0;
+    for (u32 bucket = 0; bucket < detail::SORT_RADIX_BUCKETS; ++bucket) {
+      const usize bucket_count = offsets[bucket];
+      offsets[bucket] = sum;
+      sum += bucket_count;
+    }
+
+    for (usize i = 0; i < count; ++i) {
+      dst[offsets[detail::sort_radix_digit(key_fn(src[i]), pass)]++] = src[i];
+    }
+
+    T *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != items.data()) {
+    memcpy(items.data(), src, sizeof(T) * count);
+  }
+
+  alloc->deallocate_array(histograms, PASS_COUNT * detail::SORT_RADIX_BUCKETS);
+  alloc->free(scratch);
+  return true;
+}
+
+template <TrivialType T>
+  requires std::is_arithmetic_v<T>
+bool sort_radix(const NotNull<const Allocator *> alloc, Span<T> items) {
+  return sort_radix(alloc, items, [](const T &value) { return radix_key(value); });
+}
+
+// NOTE: Stable merge sort on the scheduler. Every chunk is sorted by its own
+// job, then each merge round splits every pair at corank points so all jobs
+// stay busy down to the last merge. Falls back to sort_merge when the input
+// is too small to split.
+template <TrivialType T, typename Less>
+bool sort_merge_parallel(const NotNull<const Allocator *> alloc,
+                         const NotNull<Scheduler *> sched, Span<T> items,
+                         Less &&less) {
+  const usize count = items.size();
+  const u32 chunks = detail::sort_parallel_chunks(sched, count);
+  if (chunks == 1) {
+    return sort_merge(alloc, items, less);
+  }
+
+  T *scratch = detail::sort_allocate_scratch<T>(alloc, count);
+  if (!scratch) {
+    return false;
+  }
+
+  T *data = items.data();
+  auto chunk_start = [count, chunks](const usize chunk) {
+    return count * chunk / chunks;
+  };
+
+  job_parallel_for(alloc, sched, chunks, [&](const u32 chunk) {
+    const usize first = chunk_start(chunk);
+    const usize last = chunk_start(chunk + 1);
+    detail::sort_merge_range(data + first, scratch + first, last - first, less);
+  });
+
+  T *src = data;
+  T *dst = scratch;
+  for (u32 run_chunks = 1; run_chunks < chunks; run_chunks *= 2) {
+    const u32 pieces_per_pair = 2 * run_chunks;
+
+    job_parallel_for(alloc, sched, chunks, [&](const u32 task) {
+      const u32 pair_chunk = task / pieces_per_pair * pieces_per_pair;
+      const u32 piece = task % pieces_per_pair;
+
+      const usize first = chunk_start(pair_chunk);
+      const usize middle = chunk_start(pair_chunk + run_chunks);
+      const usize last = chunk_start(pair_chunk + pieces_per_pair);
+      const T *a = src + first;
+      const T *b = src + middle;
+      const usize a_count = middle - first;
+      const usize b_count = last - middle;
+
+      const usize out_first = (last - first) * piece / pieces_per_pair;
+      const usize out_last = (last - first) * (piece + 1) / pieces_per_pair;
+      const usize a_first =
+          detail::sort_merge_corank(a, a_count, b, b_count, out_first, less);
+      const usize a_last =
+          detail::sort_merge_corank(a, a_count, b, b_count, out_last, less);
+      const usize b_first = out_first - a_first;
+      const usize b_last = out_last - a_last;
+
+      detail::sort_merge_into(a + a_first, a_last - a_first, b + b_first,
+                              b_last - b_first, dst + first + out_first, less);
+    });
+
+    T *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != data) {
+    job_parallel_for(alloc, sched, chunks, [&](const u32 chunk) {
+      const usize first = chunk_start(chunk);
+      memcpy(data + first, src + first,
+             sizeof(T) * (chunk_start(chunk + 1) - first));
+    });
+  }
+
+  alloc->free(scratch);
+  return true;
+}
+
+template <TrivialType T>
+bool sort_merge_parallel(const NotNull<const Allocator *> alloc,
+                         const NotNull<Scheduler *> sched, Span<T> items) {
+  return sort_merge_parallel(alloc, sched, items,
+                             [](const T &a, const T &b) { return a < b; });
+}
+
+// NOTE: Parallel LSD radix sort, each pass builds per chunk histograms and
+// scatters every chunk on its own job. Chunk offsets are laid out in chunk
+// order inside each bucket, so the sort stays stable.
+template <TrivialType T, typename KeyFn>
+bool sort_radix_parallel(const NotNull<const Allocator *> alloc,
+                         const NotNull<Scheduler *> sched, Span<T> items,
+                         KeyFn &&key_fn) {
+  using Key = std::invoke_result_t<KeyFn &, const T &>;
+  static_assert(std::is_unsigned_v<Key>,
+                "sort_radix_parallel: key_fn must return an unsigned integer");
+  constexpr u32 PASS_COUNT = sizeof(Key) * 8 / detail::SORT_RADIX_BITS;
+
+  const usize count = items.size();
+  const u32 chunks = detail::sort_parallel_chunks(sched, count);
+  if (chunks == 1) {
+    return sort_radix(alloc, items, key_fn);
+  }
+
+  const usize histogram_size = chunks * detail::SORT_RADIX_BUCKETS;
+  T *scratch = detail::sort_allocate_scratch<T>(alloc, count);
+  usize *histograms = alloc->allocate_array<usize>(histogram_size);
+  if (!scratch || !histograms) {
+    alloc->free(scratch);
+    alloc->deallocate_array(histograms, histogram_size);
+    return false;
+  }
+
+  T *src = items.data();
+  T *dst = scratch;
+  auto chunk_start = [count, chunks](const usize chunk) {
+    return count * chunk / chunks;
+  };
+
+  for (u32 pass = 0; pass < PASS_COUNT; ++pass) {
+    job_parallel_for(alloc, sched, chunks, [&](const u32 chunk) {
+      usize *counts = histograms + chunk * detail::SORT_RADIX_BUCKETS;
+      memset(counts, 0, sizeof(usize) * detail::SORT_RADIX_BUCKETS);
+      for (usize i = chunk_start(chunk); i < chunk_start(chunk + 1); ++i) {
+        counts[detail::sort_radix_digit(key_fn(src[i]), pass)]++;
+      }
+    });
+
+    usize sum = 0;
+    bool single_bucket = false;
+    for (u32 bucket = 0; bucket < detail::SORT_RADIX_BUCKETS; ++bucket) {
+      const usize bucket_first = sum;
+      for (u32 chunk = 0; chunk < chunks; ++chunk) {
+        usize &slot = histograms[chunk * detail::SORT_RADIX_BUCKETS + bucket];
+        const usize chunk_count = slot;
+        slot = sum;
+        sum += chunk_count;
+      }
+      single_bucket |= sum - bucket_first == count;
+    }
+
+    if (single_bucket) {
+      continue;
+    }
+
+    job_parallel_for(alloc, sched, chunks, [&](const u32 chunk) {
+      usize *offsets = histograms + chunk * detail::SORT_RADIX_BUCKETS;
+      for (usize i = chunk_start(chunk); i < chunk_start(chunk + 1); ++i) {
+        dst[offsets[detail::sort_radix_digit(key_fn(src[i]), pass)]++] =
+            src[i];
+      }
+    });
+
+    T *tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != items.data()) {
+    memcpy(items.data(), src, sizeof(T) * count);
+  }
+
+  alloc->deallocate_array(histograms, histogram_size);
+  alloc->free(scratch);
+  return true;
+}
+
+template <TrivialType T>
+  requires std::is_arithmetic_v<T>
+bool sort_radix_parallel(const NotNull<const Allocator *> alloc,
+                         const NotNull<Scheduler *> sched, Span<T> items) {
+  return sort_radix_parallel(alloc, sched, items,
+                             [](const T &value) { return radix_key(value); });
+}
+} // namespace edge
+
+#endif
@@ -27,6 +27,13 @@ template <typename T>
 concept TrivialType =
     std::is_trivially_destructible_v<T> || std::is_trivially_copyable_v<T>;
 
+// NOTE: Types that can be moved to a new address with a plain memcpy and no
+// destructor call on the old copy. Specialize for owning types that never point
+// into themselves, such as containers holding only heap pointers.
+template <typename T>
+struct TriviallyRelocatable
+    : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
 template <typename T>
 concept Character = std::same_as<std::remove_cv_t<T>, char> ||
                     std::same_as<std::remove_cv_t<T>, char8_t> ||
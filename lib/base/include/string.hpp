@@ -5,12 +5,15 @@
 #include "hash.hpp"
 #include <string>
 
+#include <bit>
 #include <cstdlib>
 #include <cstring>
 
 namespace edge {
 namespace detail {
 constexpr usize STRING_DEFAULT_CAPACITY = 16;
+// NOTE: Longest string kept inline, 22 bytes on 64 bit targets.
+constexpr usize STRING_SSO_CAPACITY = sizeof(usize) * 3 - 2;
 
 namespace utf8 {
 constexpr bool is_continuation_byte(const char8_t c) {
@@ -175,20 +178,28 @@ inline bool encode_char(const char16_t cp_high, const char16_t cp_low,
   return encode_char(cp, out, len);
 }
 
-inline bool validate_utf8(const char8_t *data, const usize length) {
-  usize pos = 0;
-  while (pos < length) {
-    usize cp_size = 0;
-    if (char32_t cp = 0; !decode_char(data + pos, length - pos, cp, cp_size)) {
-      return false;
-    }
-    pos += cp_size;
-  }
-  return true;
-}
+// NOTE: Strict validation, overlong forms, surrogates and code points past
+// U+10FFFF are rejected. Vectorized with SSSE3, AVX2 or NEON when available.
+bool validate_utf8(const char8_t *data, usize length);
+
+// NOTE: The helpers below expect input that already passed validate_utf8.
+usize utf16_length(const char8_t *data, usize length);
+usize utf32_length(const char8_t *data, usize length);
+usize convert_to_utf16(const char8_t *data, usize length, char16_t *out);
+usize convert_to_utf32(const char8_t *data, usize length, char32_t *out);
+
+// NOTE: out needs room for length * 3 (UTF-16) or length * 4 (UTF-32) bytes.
+bool convert_from_utf16(const char16_t *data, usize length, char8_t *out,
+                        usize &out_length);
+bool convert_from_utf32(const char32_t *data, usize length, char8_t *out,
+                        usize &out_length);
 } // namespace utf8
 } // namespace detail
 
+// NOTE: Strings up to STRING_SSO_CAPACITY bytes are stored inside the object,
+// longer ones go to the heap. The last byte of the object tells the two apart:
+// it holds the inline length, or the top byte of the heap capacity where the
+// highest bit is always set. Copies are shallow, as before.
 struct String {
   using traits_type = std::char_traits<char8_t>;
   using value_type = char8_t;
@@ -201,10 +212,6 @@ struct String {
   using size_type = usize;
   using difference_type = isize;
 
-  char8_t *m_data = nullptr;
-  usize m_length = 0ull;
-  usize m_capacity = 0ull;
-
   String() = default;
 
   String(const NotNull<const Allocator *> alloc, const char *cstr,
@@ -229,56 +236,47 @@ struct String {
 
   bool from_raw(const NotNull<const Allocator *> alloc, const char *cstr,
                 const usize len) {
-    if (!cstr) {
-      return allocate(alloc, len + 1);
+    clear();
+    if (!reserve(alloc, len + 1)) {
+      return false;
     }
 
-    traits_type::copy(m_data, reinterpret_cast<const char8_t *>(cstr), len);
-    m_data[len] = u8'\0';
-    m_length = len;
-    m_capacity = len + 1;
+    if (cstr) {
+      traits_type::copy(data(), reinterpret_cast<const char8_t *>(cstr), len);
+      set_length(len);
+    }
 
     return true;
   }
 
   bool from_utf8(const NotNull<const Allocator *> alloc, const char8_t *cstr,
                  const usize len) {
+    clear();
     if (!cstr) {
-      return allocate(alloc, detail::STRING_DEFAULT_CAPACITY);
+      return reserve(alloc, detail::STRING_DEFAULT_CAPACITY);
     }
 
     if (!detail::utf8::validate_utf8(cstr, len)) {
       return false;
     }
 
-    m_data =
-        static_cast<char8_t *>(alloc->malloc(len + 1, alignof(value_type)));
-    if (!m_data) {
+    if (!reserve(alloc, len + 1)) {
       return false;
     }
 
-    traits_type::copy(m_data, cstr, len);
-    m_data[len] = u8'\0';
-    m_length = len;
-    m_capacity = len + 1;
+    traits_type::copy(data(), cstr, len);
+    set_length(len);
 
     return true;
   }
 
   bool from_utf16(const NotNull<const Allocator *> alloc, const char16_t *str,
                   const usize len) {
+    clear();
     if (!str) {
-      return allocate(alloc, detail::STRING_DEFAULT_CAPACITY);
+      return reserve(alloc, detail::STRING_DEFAULT_CAPACITY);
     }
 
-    const usize capacity = len * 4;
-    m_data = static_cast<char8_t *>(
-        alloc->malloc(capacity + 1, alignof(value_type)));
-    if (!m_data) {
-      return false;
-    }
-    m_capacity = capacity;
-
     return append(alloc, str, len);
   }
 
@@ -290,18 +288,11 @@ struct String {
 
   bool from_utf32(const NotNull<const Allocator *> alloc, const char32_t *str,
                   const usize len) {
+    clear();
     if (!str) {
-      return allocate(alloc, detail::STRING_DEFAULT_CAPACITY);
+      return reserve(alloc, detail::STRING_DEFAULT_CAPACITY);
     }
 
-    const usize capacity = len * 4;
-    m_data = static_cast<char8_t *>(
-        alloc->malloc(capacity + 1, alignof(value_type)));
-    if (!m_data) {
-      return false;
-    }
-    m_capacity = capacity;
-
     return append(alloc, str, len);
   }
 
@@ -313,124 +304,84 @@ struct String {
 
   [[nodiscard]] char16_t *
   to_utf16(const NotNull<const Allocator *> alloc) const {
-    usize len = 0, pos = 0, out_pos = 0;
-
-    while (pos < m_length) {
-      const value_type first_byte = m_data[pos];
-      const usize seq_len = detail::utf8::char_byte_count(first_byte);
-
-      if (seq_len == 0) {
-        return nullptr;
-      }
-
-      // 4-byte UTF-8 sequences become surrogate pairs (2 UTF-16 units)
-      len += (seq_len == 4) ? 2 : 1;
-      pos += seq_len;
+    const char8_t *str = data();
+    const usize str_length = length();
+    if (!detail::utf8::validate_utf8(str, str_length)) {
+      return nullptr;
     }
 
-    pos = 0;
-
+    const usize len = detail::utf8::utf16_length(str, str_length);
     auto *out = static_cast<char16_t *>(
-        alloc->malloc(len * sizeof(char16_t), alignof(char16_t)));
+        alloc->malloc((len + 1) * sizeof(char16_t), alignof(char16_t)));
     if (!out) {
       return nullptr;
     }
 
-    while (pos < m_length) {
-      usize bytes_readed = 0;
-      char32_t cp;
-      if (!detail::utf8::decode_char(m_data + pos, m_length - pos, cp,
-                                     bytes_readed)) {
-        alloc->free(out);
-        return nullptr;
-      }
-
-      if (cp <= 0xFFFF) {
-        out[out_pos++] = static_cast<char16_t>(cp);
-      } else {
-        // Encode as surrogate pair
-        cp -= 0x10000;
-        out[out_pos++] = static_cast<char16_t>(0xD800 + (cp >> 10));
-        out[out_pos++] = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
-      }
-      pos += bytes_readed;
-    }
-
-    out[out_pos] = u'\0';
+    out[detail::utf8::convert_to_utf16(str, str_length, out)] = u'\0';
     return out;
   }
 
   [[nodiscard]] char32_t *
   to_utf32(const NotNull<const Allocator *> alloc) const {
-    usize len = 0, pos = 0, out_pos = 0;
-
-    while (pos < m_length) {
-      const value_type first_byte = m_data[pos];
-      const usize seq_len = detail::utf8::char_byte_count(first_byte);
-
-      if (seq_len == 0) {
-        return nullptr;
-      }
-
-      len++;
-      pos += seq_len;
+    const char8_t *str = data();
+    const usize str_length = length();
+    if (!detail::utf8::validate_utf8(str, str_length)) {
+      return nullptr;
     }
 
-    pos = 0;
-
+    const usize len = detail::utf8::utf32_length(str, str_length);
     auto *out = static_cast<char32_t *>(
-        alloc->malloc(len * sizeof(char32_t), alignof(char32_t)));
+        alloc->malloc((len + 1) * sizeof(char32_t), alignof(char32_t)));
     if (!out) {
       return nullptr;
     }
 
-    while (pos < m_length) {
-      usize bytes_readed = 0;
-      if (!detail::utf8::decode_char(m_data + pos, m_length - pos,
-                                     out[out_pos++], bytes_readed)) {
-        alloc->free(out);
-        return nullptr;
-      }
-      pos += bytes_readed;
-    }
-
-    out[out_pos] = U'\0';
+    out[detail::utf8::convert_to_utf32(str, str_length, out)] = U'\0';
     return out;
   }
 
   void destroy(const NotNull<const Allocator *> alloc) {
-    if (m_data) {
-      alloc->deallocate_array(m_data, m_capacity);
-      m_data = nullptr;
-      m_length = 0;
-      m_capacity = 0;
+    if (is_heap()) {
+      alloc->free(m_heap.data);
     }
+    reset_inline();
   }
 
-  void clear() {
-    m_length = 0;
-    if (m_data) {
-      m_data[0] = u8'\0';
-    }
-  }
+  void clear() { set_length(0); }
 
   bool reserve(const NotNull<const Allocator *> alloc, usize capacity) {
     if (capacity == 0) {
       capacity = detail::STRING_DEFAULT_CAPACITY;
     }
 
-    if (capacity <= m_capacity) {
+    if (capacity <= this->capacity()) {
       return true;
     }
 
-    auto *new_data = static_cast<char8_t *>(
-        alloc->realloc(m_data, capacity, alignof(value_type)));
+    if (is_heap()) {
+      auto *new_data = static_cast<char8_t *>(
+          alloc->realloc(m_heap.data, capacity, alignof(value_type)));
+      if (!new_data) {
+        return false;
+      }
+
+      m_heap.data = new_data;
+      m_heap.capacity = capacity | HEAP_FLAG;
+      return true;
+    }
+
+    auto *new_data =
+        static_cast<char8_t *>(alloc->malloc(capacity, alignof(value_type)));
     if (!new_data) {
       return false;
     }
 
-    m_data = new_data;
-    m_capacity = capacity;
+    const usize len = length();
+    traits_type::copy(new_data, m_inline, len + 1);
+
+    m_heap.data = new_data;
+    m_heap.length = len;
+    m_heap.capacity = capacity | HEAP_FLAG;
 
     return true;
   }
@@ -456,13 +407,26 @@ struct String {
       return false;
     }
 
-    traits_type::copy(m_data + m_length, buffer, length);
-    m_length += length;
-    m_data[m_length] = u8'\0';
+    const usize old_length = this->length();
+    traits_type::copy(data() + old_length, buffer, length);
+    set_length(old_length + length);
 
     return true;
   }
 
+  // NOTE: Extends the string by count bytes and returns the new tail for the
+  // caller to fill, nullptr when the allocation fails.
+  char8_t *append_uninitialized(const NotNull<const Allocator *> alloc,
+                                const usize count) {
+    if (!grow(alloc, count + 1)) {
+      return nullptr;
+    }
+
+    const usize old_length = length();
+    set_length(old_length + count);
+    return data() + old_length;
+  }
+
   template <typename T>
     requires std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>
   bool append(const NotNull<const Allocator *> alloc, const T *buffer,
@@ -471,58 +435,27 @@ struct String {
       return false;
     }
 
-    auto *data = static_cast<char8_t *>(
-        alloc->malloc((len * 4) + 1, alignof(value_type)));
-    if (!data) {
+    // NOTE: Encode straight into the tail, the worst case is 4 bytes per unit.
+    if (!grow(alloc, (len * 4) + 1)) {
       return false;
     }
 
+    char8_t *out = data() + length();
     usize pos = 0;
 
+    bool converted;
     if constexpr (std::is_same_v<T, char16_t>) {
-      for (usize i = 0; i < len; ++i) {
-        usize bytes_count = 0;
-
-        if (char16_t c = buffer[i]; detail::utf8::is_high_surrogate(c)) {
-          // Check for incomplete surrogate pair
-          if (i + 1 >= len) {
-            alloc->free(data);
-            return false;
-          }
-
-          if (const char16_t low = buffer[++i];
-              !detail::utf8::encode_char(c, low, data + pos, bytes_count)) {
-            alloc->free(data);
-            return false;
-          }
-        } else {
-          if (!detail::utf8::encode_char(c, data + pos, bytes_count)) {
-            alloc->free(data);
-            return false;
-          }
-        }
-        pos += bytes_count;
-      }
-    } else if constexpr (std::is_same_v<T, char32_t>) {
-      for (usize i = 0; i < len; ++i) {
-        usize bytes_count = 0;
-        if (!detail::utf8::encode_char(buffer[i], data + pos, bytes_count)) {
-          alloc->free(data);
-          return false;
-        }
-        pos += bytes_count;
-      }
+      converted = detail::utf8::convert_from_utf16(buffer, len, out, pos);
+    } else {
+      converted = detail::utf8::convert_from_utf32(buffer, len, out, pos);
     }
 
-    if (!grow(alloc, pos + 1)) {
+    if (!converted) {
+      out[0] = u8'\0';
       return false;
     }
 
-    traits_type::copy(m_data + m_length, data, pos);
-    m_length += pos;
-    m_data[m_length] = u8'\0';
-
-    alloc->free(data);
+    set_length(length() + pos);
     return true;
   }
 
@@ -531,9 +464,9 @@ struct String {
       return false;
     }
 
-    m_data[m_length] = c;
-    m_length++;
-    m_data[m_length] = u8'\0';
+    const usize old_length = length();
+    data()[old_length] = c;
+    set_length(old_length + 1);
     return true;
   }
 
@@ -546,15 +479,7 @@ struct String {
       return false;
     }
 
-    if (!grow(alloc, byte_len)) {
-      return false;
-    }
-
-    traits_type::copy(m_data + m_length, buf, byte_len);
-    m_length += byte_len;
-    m_data[m_length] = u8'\0';
-
-    return true;
+    return append(alloc, buf, byte_len);
   }
 
   bool append(const NotNull<const Allocator *> alloc, const char16_t cp_high,
@@ -565,22 +490,14 @@ struct String {
       return false;
     }
 
-    if (!grow(alloc, byte_len)) {
-      return false;
-    }
-
-    traits_type::copy(m_data + m_length, buf, byte_len);
-    m_length += byte_len;
-    m_data[m_length] = u8'\0';
-
-    return true;
+    return append(alloc, buf, byte_len);
   }
 
   // TODO: Not needed for now, but in future may be having insert for other
   // encodings will be cool to haves
   bool insert(const NotNull<const Allocator *> alloc, const usize pos,
               const char8_t *text) {
-    if (!text || pos > m_length) {
+    if (!text || pos > length()) {
       return false;
     }
 
@@ -593,76 +510,70 @@ struct String {
       return false;
     }
 
-    traits_type::move(m_data + pos + text_len, m_data + pos,
-                      m_length - pos + 1);
-    traits_type::copy(m_data + pos, text, text_len);
-    m_length += text_len;
+    const usize old_length = length();
+    char8_t *str = data();
+    traits_type::move(str + pos + text_len, str + pos, old_length - pos);
+    traits_type::copy(str + pos, text, text_len);
+    set_length(old_length + text_len);
 
     return true;
   }
 
   bool remove(const usize pos, usize length) {
-    if (pos >= m_length) {
+    const usize old_length = this->length();
+    if (pos >= old_length) {
       return false;
     }
 
-    if (pos + length > m_length) {
-      length = m_length - pos;
+    if (pos + length > old_length) {
+      length = old_length - pos;
     }
 
-    traits_type::move(m_data + pos, m_data + pos + length,
-                      m_length - pos - length + 1);
-    m_length -= length;
+    char8_t *str = data();
+    traits_type::move(str + pos, str + pos + length,
+                      old_length - pos - length);
+    set_length(old_length - length);
 
     return true;
   }
 
-  [[nodiscard]] bool empty() const { return m_length == 0; }
+  [[nodiscard]] bool empty() const { return length() == 0; }
 
   template <typename CharT>
     requires std::same_as<CharT, char> || std::same_as<CharT, char8_t>
   [[nodiscard]] i32 compare(const CharT *other) const {
-    if (!m_data) {
-      return other ? -1 : 0;
-    }
-
     if (!other) {
-      return 1;
+      return empty() ? 0 : 1;
     }
 
+    const usize other_length =
+        traits_type::length(reinterpret_cast<const char8_t *>(other));
+    const usize str_length = length();
     return traits_type::compare(
-        m_data, reinterpret_cast<const char8_t *>(other),
-        m_length < traits_type::length(reinterpret_cast<const char8_t *>(other))
-            ? m_length
-            : traits_type::length(reinterpret_cast<const char8_t *>(other)));
+        data(), reinterpret_cast<const char8_t *>(other),
+        str_length < other_length ? str_length : other_length);
   }
 
   [[nodiscard]] i32 compare(const String &str2) const {
-    if (!m_data) {
-      return str2.m_data ? -1 : 0;
-    }
-
-    if (!str2.m_data) {
-      return 1;
-    }
-
-    const usize min_len = m_length < str2.m_length ? m_length : str2.m_length;
-    if (const i32 result = traits_type::compare(m_data, str2.m_data, min_len);
+    const usize str_length = length();
+    const usize other_length = str2.length();
+    const usize min_len = str_length < other_length ? str_length : other_length;
+    if (const i32 result = traits_type::compare(data(), str2.data(), min_len);
         result != 0) {
       return result;
     }
 
-    if (m_length < str2.m_length) {
+    if (str_length < other_length) {
       return -1;
     }
-    if (m_length > str2.m_length) {
+    if (str_length > other_length) {
       return 1;
     }
     return 0;
   }
 
   [[nodiscard]] usize find(const char8_t *needle) const {
-    if (!m_data || !needle) {
+    if (!needle) {
       return SIZE_MAX;
     }
 
@@ -671,12 +582,14 @@ struct String {
       return 0;
     }
 
-    if (needle_len > m_length) {
+    const usize str_length = length();
+    if (needle_len > str_length) {
       return SIZE_MAX;
     }
 
-    for (usize i = 0; i <= m_length - needle_len; ++i) {
-      if (traits_type::compare(m_data + i, needle, needle_len) == 0) {
+    const char8_t *str = data();
+    for (usize i = 0; i <= str_length - needle_len; ++i) {
+      if (traits_type::compare(str + i, needle, needle_len) == 0) {
         return i;
       }
     }
@@ -685,63 +598,101 @@ struct String {
   }
 
   [[nodiscard]] usize find(const value_type c, const usize pos = 0) const {
-    if (!m_data || pos >= m_length) {
+    const usize str_length = length();
+    if (pos >= str_length) {
       return SIZE_MAX;
     }
 
-    const char8_t *result = traits_type::find(m_data + pos, m_length - pos, c);
-    return result ? static_cast<usize>(result - m_data) : SIZE_MAX;
+    const char8_t *str = data();
+    const char8_t *result = traits_type::find(str + pos, str_length - pos, c);
+    return result ? static_cast<usize>(result - str) : SIZE_MAX;
   }
 
   bool duplicate(const NotNull<const Allocator *> alloc, String &dest) const {
-    return dest.from_utf8(alloc, m_data, m_length);
+    return dest.from_utf8(alloc, data(), length());
   }
 
-  [[nodiscard]] constexpr const_reference front() const {
-    assert(m_length > 0 && "front() called on empty String");
-    return m_data[0];
+  [[nodiscard]] const_reference front() const {
+    assert(!empty() && "front() called on empty String");
+    return data()[0];
   }
 
-  [[nodiscard]] constexpr const_reference back() const {
-    assert(m_length > 0 && "back() called on empty String");
-    return m_data[m_length - 1];
+  [[nodiscard]] const_reference back() const {
+    assert(!empty() && "back() called on empty String");
+    return data()[length() - 1];
   }
 
-  char8_t *data() { return m_data; }
-  const char8_t *data() const { return m_data; }
-  usize length() const { return m_length; }
+  // NOTE: Never null, an empty string points at its inline terminator.
+  char8_t *data() { return is_heap() ? m_heap.data : m_inline; }
+  const char8_t *data() const { return is_heap() ? m_heap.data : m_inline; }
 
-  [[nodiscard]] iterator begin() { return m_data; }
-  [[nodiscard]] iterator end() { return m_data + m_length; }
-  [[nodiscard]] iterator begin() const { return m_data; }
-  [[nodiscard]] iterator end() const { return m_data + m_length; }
+  usize length() const {
+    return is_heap() ? m_heap.length : static_cast<usize>(tag());
+  }
 
-private:
-  bool allocate(const NotNull<const Allocator *> alloc, usize capacity) {
-    if (capacity < detail::STRING_DEFAULT_CAPACITY) {
-      capacity = detail::STRING_DEFAULT_CAPACITY;
-    }
+  // NOTE: Bytes available including the terminator.
+  usize capacity() const {
+    return is_heap() ? m_heap.capacity & ~HEAP_FLAG
+                     : detail::STRING_SSO_CAPACITY + 1;
+  }
 
-    m_data = alloc->allocate_array<char8_t>(capacity);
-    if (!m_data) {
-      return false;
-    }
+  bool is_inline() const { return !is_heap(); }
 
-    m_data[0] = u8'\0';
-    m_length = 0;
-    m_capacity = capacity;
+  [[nodiscard]] iterator begin() { return data(); }
+  [[nodiscard]] iterator end() { return data() + length(); }
+  [[nodiscard]] const_iterator begin() const { return data(); }
+  [[nodiscard]] const_iterator end() const { return data() + length(); }
 
-    return true;
+private:
+  struct HeapStorage {
+    char8_t *data;
+    usize length;
+    usize capacity;
+  };
+
+  static constexpr usize SSO_TAG = sizeof(HeapStorage) - 1;
+  static constexpr usize HEAP_FLAG = static_cast<usize>(1)
+                                     << (sizeof(usize) * 8 - 1);
+
+  static_assert(std::endian::native == std::endian::little,
+                "String: SSO tag byte assumes a little endian layout");
+  static_assert(detail::STRING_SSO_CAPACITY + 1 == SSO_TAG,
+                "String: inline buffer must end right before the tag byte");
+
+  union {
+    HeapStorage m_heap;
+    char8_t m_inline[sizeof(HeapStorage)] = {};
+  };
+
+  // NOTE: char8_t does not alias other types, the tag is read and written
+  // through u8 since it overlaps the heap capacity.
+  u8 tag() const { return reinterpret_cast<const u8 *>(this)[SSO_TAG]; }
+  bool is_heap() const { return (tag() & 0x80) != 0; }
+
+  void reset_inline() { memset(m_inline, 0, sizeof(m_inline)); }
+
+  // NOTE: Updates the length and writes the terminator.
+  void set_length(const usize length) {
+    if (is_heap()) {
+      m_heap.length = length;
+      m_heap.data[length] = u8'\0';
+    } else {
+      assert(length <= detail::STRING_SSO_CAPACITY &&
+             "String: inline length out of range");
+      m_inline[length] = u8'\0';
+      reinterpret_cast<u8 *>(this)[SSO_TAG] = static_cast<u8>(length);
+    }
   }
 
   bool grow(const NotNull<const Allocator *> alloc, const usize additional) {
-    const usize required = m_length + additional;
-    if (required <= m_capacity) {
+    const usize required = length() + additional;
+    const usize current = capacity();
+    if (required <= current) {
       return true;
     }
 
-    usize new_capacity = m_capacity;
-    if (new_capacity == 0) {
+    usize new_capacity = current;
+    if (new_capacity < detail::STRING_DEFAULT_CAPACITY) {
       new_capacity = detail::STRING_DEFAULT_CAPACITY;
     }
 
@@ -753,17 +704,18 @@ private:
   }
 };
 
+static_assert(sizeof(String) == 3 * sizeof(usize),
+              "String: SSO must not grow the object");
+
+template <> struct TriviallyRelocatable<String> : std::true_type {};
+
 inline bool operator==(const String &lhs, const String &rhs) {
   return lhs.compare(rhs) == 0;
 }
 
 template <> struct Hash<String> {
   EDGE_FORCE_INLINE usize operator()(const String &string) const {
-#if EDGE_HAS_SSE4_2
-    return hash_crc32(string.m_data, string.m_length);
-#else
-    return hash_fnv1a64(string.m_data, string.m_length);
-#endif
+    return static_cast<usize>(hash_xxh3_64(string.data(), string.length()));
   }
 };
 } // namespace edge
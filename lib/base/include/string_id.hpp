@@ -0,0 +1,56 @@
+#ifndef EDGE_STRING_ID_H
+#define EDGE_STRING_ID_H
+
+#include "string_view.hpp"
+
+namespace edge {
+namespace detail {
+constexpr usize STRING_ID_ARENA_SIZE = 64 * 1024 * 1024;
+
+// NOTE: FNV-1a, usable in constant expressions so ids of literals cost
+// nothing at runtime. The empty string maps to the invalid id.
+constexpr u64 string_id_hash(const char8_t *str, const usize len) {
+  if (len == 0) {
+    return 0ull;
+  }
+
+  u64 hash = 0xcbf29ce484222325ull;
+  for (usize i = 0; i < len; ++i) {
+    hash ^= static_cast<u8>(str[i]);
+    hash *= 0x100000001b3ull;
+  }
+
+  return hash;
+}
+} // namespace detail
+
+// NOTE: 64 bit name of a string, equality and hashing are a single integer
+// operation. Constructing an id only hashes, call string_id_intern to make
+// the text available through string_id_name. Interning asserts on hash
+// collisions between different strings.
+struct StringId {
+  u64 m_hash = 0ull;
+
+  constexpr StringId() = default;
+  constexpr explicit StringId(const u64 hash) : m_hash{hash} {}
+  constexpr StringId(const StringView<char8_t> str)
+      : m_hash{detail::string_id_hash(str.data(), str.length())} {}
+
+  [[nodiscard]] constexpr bool valid() const { return m_hash != 0ull; }
+
+  constexpr bool operator==(const StringId &other) const = default;
+};
+
+// NOTE: Thread safe. Interned text lives in a global arena until the process
+// exits.
+StringId string_id_intern(StringView<char8_t> str);
+StringView<char8_t> string_id_name(StringId id);
+
+template <> struct Hash<StringId> {
+  EDGE_FORCE_INLINE usize operator()(const StringId &id) const {
+    return static_cast<usize>(id.m_hash);
+  }
+};
+} // namespace edge
+
+#endif
@@ -4,6 +4,23 @@
 #include "string.hpp"
 
 namespace edge {
+namespace detail {
+// NOTE: Byte search kernels used by StringView, vectorized with SSE2, AVX2 or
+// NEON. Results are offsets from data, SIZE_MAX when nothing matches.
+usize find_byte(const void *data, usize length, u8 value);
+usize rfind_byte(const void *data, usize length, u8 value);
+usize find_byte_of(const void *data, usize length, const void *set,
+                   usize set_length);
+usize rfind_byte_of(const void *data, usize length, const void *set,
+                    usize set_length);
+usize find_bytes(const void *data, usize length, const void *needle,
+                 usize needle_length);
+usize rfind_bytes(const void *data, usize length, const void *needle,
+                  usize needle_length);
+} // namespace detail
+
+template <Character CharT, typename Traits> struct StringSplit;
+
 template <Character CharT, typename Traits = std::char_traits<CharT>>
 struct StringView {
   using value_type = CharT;
@@ -16,6 +33,11 @@ struct StringView {
   using size_type = usize;
   using difference_type = isize;
 
+  // NOTE: Only plain byte strings can go through the byte kernels, custom
+  // traits may compare characters differently.
+  static constexpr bool BYTE_SEARCH =
+      sizeof(CharT) == 1 && std::is_same_v<Traits, std::char_traits<CharT>>;
+
   constexpr StringView() : m_data{nullptr} {}
 
   constexpr StringView(const StringView &) = default;
@@ -71,7 +93,7 @@ struct StringView {
     assert(offset < m_length && "offset in substr() is too big");
 
     size_type actual_count = count;
-    if (offset + count > m_length) {
+    if (count > m_length - offset) {
       actual_count = m_length - offset;
     }
 
@@ -145,6 +167,14 @@ struct StringView {
       return SIZE_MAX;
     }
 
+    if constexpr (BYTE_SEARCH) {
+      if (!std::is_constant_evaluated()) {
+        const usize result = detail::find_bytes(
+            m_data + pos, m_length - pos, needle.m_data, needle.m_length);
+        return result != SIZE_MAX ? result + pos : SIZE_MAX;
+      }
+    }
+
     for (size_type i = pos; i <= m_length - needle.m_length; ++i) {
       if (Traits::compare(m_data + i, needle.m_data, needle.m_length) == 0) {
         return i;
@@ -159,6 +189,14 @@ struct StringView {
       return SIZE_MAX;
     }
 
+    if constexpr (BYTE_SEARCH) {
+      if (!std::is_constant_evaluated()) {
+        const usize result = detail::find_byte(m_data + pos, m_length - pos,
+                                               static_cast<u8>(c));
+        return result != SIZE_MAX ? result + pos : SIZE_MAX;
+      }
+    }
+
     const_pointer result = Traits::find(m_data + pos, m_length - pos, c);
     return result ? static_cast<size_type>(result - m_data) : SIZE_MAX;
   }
@@ -177,6 +215,13 @@ struct StringView {
       pos = last_possible;
     }
 
+    if constexpr (BYTE_SEARCH) {
+      if (!std::is_constant_evaluated()) {
+        return detail::rfind_bytes(m_data, pos + needle.m_length,
+                                   needle.m_data, needle.m_length);
+      }
+    }
+
     for (size_type i = pos + 1; i > 0; --i) {
       size_type idx = i - 1;
       if (Traits::compare(m_data + idx, needle.m_data, needle.m_length) == 0) {
@@ -196,6 +241,12 @@ struct StringView {
       pos = m_length - 1;
     }
 
+    if constexpr (BYTE_SEARCH) {
+      if (!std::is_constant_evaluated()) {
+        return detail::rfind_byte(m_data, pos + 1, static_cast<u8>(c));
+      }
+    }
+
     for (size_type i = pos + 1; i > 0; --i) {
       if (Traits::eq(m_data[i - 1], c)) {
         return i - 1;
@@ -205,6 +256,61 @@ struct StringView {
     return SIZE_MAX;
   }
 
+  constexpr size_type find_first_of(const StringView set,
+                                    const size_type pos = 0) const {
+    if (pos >= m_length || set.empty()) {
+      return SIZE_MAX;
+    }
+
+    if constexpr (BYTE_SEARCH) {
+      if (!std::is_constant_evaluated()) {
+        const usize result = detail::find_byte_of(
+            m_data + pos, m_length - pos, set.m_data, set.m_length);
+        return result != SIZE_MAX ? result + pos : SIZE_MAX;
+      }
+    }
+
+    for (size_type i = pos; i < m_length; ++i) {
+      if (Traits::find(set.m_data, set.m_length, m_data[i])) {
+        return i;
+      }
+    }
+
+    return SIZE_MAX;
+  }
+
+  constexpr size_type find_last_of(const StringView set,
+                                   size_type pos = SIZE_MAX) const {
+    if (m_length == 0 || set.empty()) {
+      return SIZE_MAX;
+    }
+
+    if (pos >= m_length) {
+      pos = m_length - 1;
+    }
+
+    if constexpr (BYTE_SEARCH) {
+      if (!std::is_constant_evaluated()) {
+        return detail::rfind_byte_of(m_data, pos + 1, set.m_data,
+                                     set.m_length);
+      }
+    }
+
+    for (size_type i = pos + 1; i > 0; --i) {
+      if (Traits::find(set.m_data, set.m_length, m_data[i - 1])) {
+        return i - 1;
+      }
+    }
+
+    return SIZE_MAX;
+  }
+
+  // NOTE: Iterates the fields between delimiters without allocating, empty
+  // fields are kept and an empty view yields nothing.
+  constexpr StringSplit<CharT, Traits> split(const CharT delimiter) const;
+  constexpr StringSplit<CharT, Traits>
+  split_any_of(StringView delimiters) const;
+
   constexpr const_iterator begin() const { return m_data; }
 
   constexpr const_iterator end() const { return m_data + m_length; }
@@ -213,6 +319,74 @@ struct StringView {
   usize m_length = 0;
 };
 
+template <Character CharT, typename Traits> struct StringSplit {
+  using View = StringView<CharT, Traits>;
+
+  struct Iterator {
+    const StringSplit *m_split = nullptr;
+    View m_token = {};
+    // NOTE: Start of the following field, SIZE_MAX once m_token is the last.
+    usize m_next = 0;
+    bool m_done = true;
+
+    constexpr View operator*() const { return m_token; }
+
+    constexpr Iterator &operator++() {
+      m_split->advance(*this);
+      return *this;
+    }
+
+    constexpr bool operator==(const Iterator &other) const {
+      return m_done == other.m_done && (m_done || m_next == other.m_next);
+    }
+  };
+
+  constexpr Iterator begin() const {
+    Iterator it = {this, {}, 0, m_source.empty()};
+    if (!it.m_done) {
+      advance(it);
+    }
+    return it;
+  }
+
+  constexpr Iterator end() const { return Iterator{}; }
+
+  constexpr void advance(Iterator &it) const {
+    if (it.m_next == SIZE_MAX) {
+      it.m_done = true;
+      return;
+    }
+
+    const usize start = it.m_next;
+    const usize found = m_any_of ? m_source.find_first_of(m_delimiters, start)
+                                 : m_source.find(m_delimiter, start);
+    if (found == SIZE_MAX) {
+      it.m_token = View{m_source.data() + start, m_source.length() - start};
+      it.m_next = SIZE_MAX;
+    } else {
+      it.m_token = View{m_source.data() + start, found - start};
+      it.m_next = found + 1;
+    }
+  }
+
+  View m_source = {};
+  View m_delimiters = {};
+  CharT m_delimiter = {};
+  bool m_any_of = false;
+};
+
+template <Character CharT, typename Traits>
+constexpr StringSplit<CharT, Traits>
+StringView<CharT, Traits>::split(const CharT delimiter) const {
+  return StringSplit<CharT, Traits>{*this, {}, delimiter, false};
+}
+
+template <Character CharT, typename Traits>
+constexpr StringSplit<CharT, Traits>
+StringView<CharT, Traits>::split_any_of(const StringView delimiters) const {
+  return StringSplit<CharT, Traits>{*this, delimiters, {}, true};
+}
+
 template <Character CharT, typename Traits>
 constexpr bool operator==(StringView<CharT, Traits> lhs,
                           StringView<CharT, Traits> rhs) {
@@ -223,11 +397,8 @@ template <Character CharT, typename Traits>
 struct Hash<StringView<CharT, Traits>> {
   EDGE_FORCE_INLINE usize
   operator()(const StringView<CharT, Traits> &sv) const {
-#if EDGE_HAS_SSE4_2
-    return hash_crc32(sv.data(), sv.length() * sizeof(CharT));
-#else
-    return hash_fnv1a64(sv.data(), sv.length() * sizeof(CharT));
-#endif
+    return static_cast<usize>(
+        hash_xxh3_64(sv.data(), sv.length() * sizeof(CharT)));
   }
 };
 } // namespace edge
@@ -66,6 +66,12 @@ struct OnceFlag {
 #error "Unsupported platform"
 #endif
 
+// NOTE: Writer preferring reader/writer lock built on a single futex word.
+// Spins briefly before sleeping, never allocates.
+struct RwLock {
+  std::atomic<u32> state = 0u;
+};
+
 ThreadResult thread_create(Thread *thr, ThreadFunc func, void *arg);
 ThreadResult thread_join(const Thread &thr, i32 *res = nullptr);
 ThreadResult thread_detach(const Thread &thr);
@@ -97,6 +103,13 @@ ThreadResult cond_wait(const ConditionVariable *cnd, const Mutex *mtx);
 ThreadResult cond_timedwait(const ConditionVariable *cnd, const Mutex *mtx,
                             const std::chrono::nanoseconds &timeout);
 
+void rwlock_lock_shared(RwLock *lock);
+bool rwlock_try_lock_shared(RwLock *lock);
+void rwlock_unlock_shared(RwLock *lock);
+void rwlock_lock(RwLock *lock);
+bool rwlock_try_lock(RwLock *lock);
+void rwlock_unlock(RwLock *lock);
+
 void call_once(OnceFlag *flag, void (*func)());
 
 ThreadResult thread_set_affinity(const Thread &thr, i32 core_id,
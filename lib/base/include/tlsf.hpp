@@ -0,0 +1,150 @@
+#ifndef EDGE_TLSF_H
+#define EDGE_TLSF_H
+
+#include "allocator.hpp"
+#include "vmem.hpp"
+
+namespace edge {
+constexpr usize TLSF_MAX_SIZE = 256 * 1024 * 1024;
+constexpr usize TLSF_COMMIT_CHUNK_SIZE = 1024 * 1024;
+
+constexpr u32 TLSF_SL_INDEX_COUNT_LOG2 = 5;
+constexpr u32 TLSF_ALIGN_SIZE_LOG2 = 4;
+constexpr u32 TLSF_FL_INDEX_MAX = 38;
+
+constexpr usize TLSF_ALIGN_SIZE = 1ull << TLSF_ALIGN_SIZE_LOG2;
+constexpr u32 TLSF_SL_INDEX_COUNT = 1u << TLSF_SL_INDEX_COUNT_LOG2;
+constexpr u32 TLSF_FL_INDEX_SHIFT =
+    TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2;
+constexpr u32 TLSF_FL_INDEX_COUNT = TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1;
+constexpr usize TLSF_SMALL_BLOCK_SIZE = 1ull << TLSF_FL_INDEX_SHIFT;
+
+struct TlsfBlock;
+
+struct TlsfStats {
+  usize committed_bytes = 0;
+  usize used_bytes = 0;
+  usize free_bytes = 0;
+  usize overhead_bytes = 0;
+  usize used_block_count = 0;
+  usize free_block_count = 0;
+  usize largest_free_block = 0;
+
+  // NOTE: 0 when all free memory is one block, approaches 1 as free memory
+  // gets split into many small blocks.
+  f32 fragmentation() const {
+    if (free_bytes == 0) {
+      return 0.0f;
+    }
+    return 1.0f - static_cast<f32>(largest_free_block) /
+                      static_cast<f32>(free_bytes);
+  }
+};
+
+// NOTE: Two-level segregated fit allocator. Every alloc/free is O(1) with a
+// bounded number of steps, the only non constant path is committing more
+// pages when the pool runs out, which can be avoided by committing the whole
+// pool on create. Not thread safe.
+struct Tlsf {
+  void *m_base = nullptr;
+  usize m_reserved = 0ull;
+  usize m_committed = 0ull;
+  usize m_page_size = 0ull;
+
+  TlsfBlock *m_first_block = nullptr;
+  TlsfBlock *m_sentinel = nullptr;
+
+  u32 m_fl_bitmap = 0u;
+  u32 m_sl_bitmap[TLSF_FL_INDEX_COUNT] = {};
+  TlsfBlock *m_blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT] = {};
+
+  bool create(usize reserve_size = 0, usize commit_size = 0);
+  void destroy();
+
+  void *alloc_ex(usize size, usize alignment);
+  void *alloc(const usize size) { return alloc_ex(size, alignof(max_align_t)); }
+  void *realloc_ex(void *ptr, usize size, usize alignment);
+  void free(void *ptr);
+
+  template <typename T> T *alloc(const usize count = 1) {
+    return static_cast<T *>(alloc_ex(sizeof(T) * count, alignof(T)));
+  }
+
+  static usize block_size(const void *ptr);
+
+  // NOTE: Walks every physical block in the pool, O(n) in block count. Do not
+  // call from latency sensitive code.
+  template <typename F> void walk(F &&fn) const;
+  TlsfStats stats() const;
+
+  Allocator to_allocator();
+
+private:
+  bool grow(usize required_size);
+  void insert_free_block(TlsfBlock *block);
+  void remove_free_block(TlsfBlock *block);
+  TlsfBlock *find_free_block(usize size);
+  TlsfBlock *merge_prev(TlsfBlock *block);
+  TlsfBlock *merge_next(TlsfBlock *block);
+  void trim_free(TlsfBlock *block, usize size);
+  TlsfBlock *trim_free_leading(TlsfBlock *block, usize size);
+  void trim_used(TlsfBlock *block, usize size);
+};
+
+struct TlsfBlock {
+  static constexpr usize FREE_BIT = 1ull << 0;
+  static constexpr usize SIZE_MASK = ~(TLSF_ALIGN_SIZE - 1);
+
+  // NOTE: Header is always valid, free list links live in the payload and only
+  // while the block is free.
+  TlsfBlock *prev_phys;
+  usize size_and_flags;
+
+  TlsfBlock *next_free;
+  TlsfBlock *prev_free;
+
+  static constexpr usize header_size() {
+    return sizeof(TlsfBlock *) + sizeof(usize);
+  }
+  static constexpr usize min_size() {
+    return sizeof(TlsfBlock) - header_size();
+  }
+
+  usize size() const { return size_and_flags & SIZE_MASK; }
+  void set_size(const usize size) {
+    size_and_flags = size | (size_and_flags & FREE_BIT);
+  }
+
+  bool is_free() const { return (size_and_flags & FREE_BIT) != 0; }
+  void set_free(const bool free) {
+    size_and_flags = free ? (size_and_flags | FREE_BIT)
+                          : (size_and_flags & ~FREE_BIT);
+  }
+
+  bool is_last() const { return size() == 0; }
+
+  void *payload() { return reinterpret_cast<u8 *>(this) + header_size(); }
+  const void *payload() const {
+    return reinterpret_cast<const u8 *>(this) + header_size();
+  }
+
+  TlsfBlock *next_phys() const {
+    return reinterpret_cast<TlsfBlock *>(
+        reinterpret_cast<uintptr_t>(payload()) + size());
+  }
+
+  static TlsfBlock *from_payload(const void *ptr) {
+    return reinterpret_cast<TlsfBlock *>(reinterpret_cast<uintptr_t>(ptr) -
+                                         header_size());
+  }
+};
+
+template <typename F> void Tlsf::walk(F &&fn) const {
+  for (TlsfBlock *block = m_first_block; block && !block->is_last();
+       block = block->next_phys()) {
+    fn(block->payload(), block->size(), !block->is_free());
+  }
+}
+} // namespace edge
+
+#endif
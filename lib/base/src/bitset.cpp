@@ -0,0 +1,313 @@
+#include "bitset.hpp"
+
+namespace edge {
+namespace detail {
+usize bitset_popcount(const u64 *words, const usize count) {
+  usize total = 0;
+  usize i = 0;
+
+#if EDGE_HAS_AVX2
+  // NOTE: Nibble lookup through vpshufb, byte counts are summed into 64 bit
+  // lanes with vpsadbw.
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i acc = _mm256_setzero_si256();
+
+  for (; i + 4 <= count; i += 4) {
+    const __m256i value =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+    const __m256i lo = _mm256_and_si256(value, low_mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask);
+    const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                          _mm256_shuffle_epi8(lookup, hi));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, zero));
+  }
+
+  total += static_cast<usize>(_mm256_extract_epi64(acc, 0)) +
+           static_cast<usize>(_mm256_extract_epi64(acc, 1)) +
+           static_cast<usize>(_mm256_extract_epi64(acc, 2)) +
+           static_cast<usize>(_mm256_extract_epi64(acc, 3));
+#endif
+
+  for (; i < count; ++i) {
+    total += static_cast<usize>(std::popcount(words[i]));
+  }
+
+  return total;
+}
+} // namespace detail
+
+bool BitSet::create(const NotNull<const Allocator *> alloc,
+                    const usize bit_count) {
+  usize level_words[detail::BITSET_MAX_LEVELS] = {};
+  u32 level_count = 0;
+  usize total_words = 0;
+
+  if (bit_count > 0) {
+    usize words = (bit_count + 63) >> 6;
+    for (;;) {
+      if (level_count == detail::BITSET_MAX_LEVELS) {
+        return false;
+      }
+
+      level_words[level_count] = words;
+      // NOTE: Summary levels hold two words per entry, any and not full.
+      total_words += level_count == 0 ? words : words * 2;
+      level_count++;
+
+      if (words == 1) {
+        break;
+      }
+      words = (words + 63) >> 6;
+    }
+  }
+
+  u64 *block = nullptr;
+  if (total_words > 0) {
+    block = alloc->allocate_array<u64>(total_words);
+    if (!block) {
+      return false;
+    }
+    memset(block, 0, total_words * sizeof(u64));
+  }
+
+  m_words = block;
+  m_size = bit_count;
+  m_level_count = level_count;
+
+  u64 *cursor = block;
+  for (u32 level = 0; level < detail::BITSET_MAX_LEVELS; ++level) {
+    m_level_words[level] = level_words[level];
+    m_any[level] = nullptr;
+    m_not_full[level] = nullptr;
+
+    if (level >= level_count) {
+      continue;
+    }
+
+    if (level == 0) {
+      cursor += level_words[0];
+      continue;
+    }
+
+    m_any[level] = cursor;
+    cursor += level_words[level];
+    m_not_full[level] = cursor;
+    cursor += level_words[level];
+  }
+
+  if (level_count > 0) {
+    rebuild_summary(0, word_count() - 1);
+  }
+
+  return true;
+}
+
+void BitSet::destroy(const NotNull<const Allocator *> alloc) {
+  if (m_words) {
+    alloc->free(m_words);
+  }
+
+  *this = {};
+}
+
+bool BitSet::resize(const NotNull<const Allocator *> alloc,
+                    const usize bit_count) {
+  BitSet resized = {};
+  if (!resized.create(alloc, bit_count)) {
+    return false;
+  }
+
+  const usize copy_words = word_count() < resized.word_count()
+                               ? word_count()
+                               : resized.word_count();
+  if (copy_words > 0) {
+    memcpy(resized.m_words, m_words, copy_words * sizeof(u64));
+
+    // NOTE: Drop bits that fell off the end when shrinking.
+    if (const usize tail = bit_count & 63; tail != 0 && bit_count < m_size) {
+      resized.m_words[copy_words - 1] &= (1ull << tail) - 1;
+    }
+
+    resized.rebuild_summary(0, copy_words - 1);
+  }
+
+  destroy(alloc);
+  *this = resized;
+  return true;
+}
+
+void BitSet::set_range(const usize first, usize count) {
+  if (first >= m_size || count == 0) {
+    return;
+  }
+
+  if (count > m_size - first) {
+    count = m_size - first;
+  }
+
+  const usize last = first + count - 1;
+  const usize first_word = first >> 6;
+  const usize last_word = last >> 6;
+  const u64 first_mask = ~0ull << (first & 63);
+  const u64 last_mask = ~0ull >> (63 - (last & 63));
+
+  if (first_word == last_word) {
+    m_words[first_word] |= first_mask & last_mask;
+  } else {
+    m_words[first_word] |= first_mask;
+    for (usize i = first_word + 1; i < last_word; ++i) {
+      m_words[i] = ~0ull;
+    }
+    m_words[last_word] |= last_mask;
+  }
+
+  rebuild_summary(first_word, last_word);
+}
+
+void BitSet::clear_range(const usize first, usize count) {
+  if (first >= m_size || count == 0) {
+    return;
+  }
+
+  if (count > m_size - first) {
+    count = m_size - first;
+  }
+
+  const usize last = first + count - 1;
+  const usize first_word = first >> 6;
+  const usize last_word = last >> 6;
+  const u64 first_mask = ~0ull << (first & 63);
+  const u64 last_mask = ~0ull >> (63 - (last & 63));
+
+  if (first_word == last_word) {
+    m_words[first_word] &= ~(first_mask & last_mask);
+  } else {
+    m_words[first_word] &= ~first_mask;
+    for (usize i = first_word + 1; i < last_word; ++i) {
+      m_words[i] = 0ull;
+    }
+    m_words[last_word] &= ~last_mask;
+  }
+
+  rebuild_summary(first_word, last_word);
+}
+
+usize BitSet::find_next_set(const usize from) const {
+  return find_next<true>(from);
+}
+
+usize BitSet::find_next_clear(const usize from) const {
+  return find_next<false>(from);
+}
+
+usize BitSet::find_clear_range(const usize count, const usize from) const {
+  if (count == 0) {
+    return from <= m_size ? from : BITSET_NPOS;
+  }
+
+  usize start = find_next_clear(from);
+  while (start != BITSET_NPOS) {
+    if (count > m_size - start) {
+      return BITSET_NPOS;
+    }
+
+    usize end = find_next_set(start);
+    if (end == BITSET_NPOS) {
+      end = m_size;
+    }
+
+    if (end - start >= count) {
+      return start;
+    }
+
+    start = find_next_clear(end);
+  }
+
+  return BITSET_NPOS;
+}
+
+usize BitSet::count_set() const {
+  return detail::bitset_popcount(m_words, word_count());
+}
+
+template <bool Set> u64 BitSet::word_at(const u32 level, const usize index) const {
+  if (level == 0) {
+    return Set ? m_words[index] : ~m_words[index];
+  }
+  return Set ? m_any[level][index] : m_not_full[level][index];
+}
+
+template <bool Set> usize BitSet::find_next(const usize from) const {
+  if (from >= m_size) {
+    return BITSET_NPOS;
+  }
+
+  // NOTE: Climb until a level has a candidate right of the current position,
+  // then descend taking the lowest candidate on every level.
+  u32 level = 0;
+  usize index = from;
+  for (;;) {
+    const usize word = index >> 6;
+    if (word >= m_level_words[level]) {
+      return BITSET_NPOS;
+    }
+
+    if (const u64 bits = word_at<Set>(level, word) & (~0ull << (index & 63));
+        bits != 0ull) {
+      index = (word << 6) | static_cast<usize>(std::countr_zero(bits));
+      break;
+    }
+
+    if (++level == m_level_count) {
+      return BITSET_NPOS;
+    }
+    index = word + 1;
+  }
+
+  while (level > 0) {
+    --level;
+    index = (index << 6) |
+            static_cast<usize>(std::countr_zero(word_at<Set>(level, index)));
+  }
+
+  // NOTE: The tail of the last word reads as clear, do not report it.
+  return index < m_size ? index : BITSET_NPOS;
+}
+
+void BitSet::rebuild_summary(usize first_word, usize last_word) {
+  for (u32 level = 1; level < m_level_count; ++level) {
+    const usize child_count = m_level_words[level - 1];
+    const usize first_parent = first_word >> 6;
+    const usize last_parent = last_word >> 6;
+
+    for (usize parent = first_parent; parent <= last_parent; ++parent) {
+      const usize child_begin = parent << 6;
+      const usize child_end =
+          child_begin + 64 < child_count ? child_begin + 64 : child_count;
+
+      u64 any = 0ull;
+      u64 not_full = 0ull;
+      for (usize child = child_begin; child < child_end; ++child) {
+        const u64 bit = 1ull << (child & 63);
+        if (level == 1) {
+          any |= m_words[child] != 0ull ? bit : 0ull;
+          not_full |= m_words[child] != ~0ull ? bit : 0ull;
+        } else {
+          any |= m_any[level - 1][child] != 0ull ? bit : 0ull;
+          not_full |= m_not_full[level - 1][child] != 0ull ? bit : 0ull;
+        }
+      }
+
+      m_any[level][parent] = any;
+      m_not_full[level][parent] = not_full;
+    }
+
+    first_word = first_parent;
+    last_word = last_parent;
+  }
+}
+} // namespace edge
@@ -0,0 +1,82 @@
+#include "epoch.hpp"
+#include "threads.hpp"
+
+#include <bit>
+
+namespace edge {
+namespace detail {
+static std::atomic<u64> g_epoch_thread_slots[EPOCH_MAX_THREADS / 64] = {};
+
+struct EpochThreadSlot {
+  u32 index = EPOCH_MAX_THREADS;
+
+  ~EpochThreadSlot() {
+    if (index < EPOCH_MAX_THREADS) {
+      g_epoch_thread_slots[index / 64].fetch_and(~(1ull << (index % 64)),
+                                                 std::memory_order_release);
+    }
+  }
+};
+
+static thread_local EpochThreadSlot t_epoch_thread_slot = {};
+
+u32 epoch_thread_index() {
+  if (EDGE_LIKELY(t_epoch_thread_slot.index < EPOCH_MAX_THREADS)) {
+    return t_epoch_thread_slot.index;
+  }
+
+  // NOTE: More live threads than slots would have to wait for one to exit.
+  while (true) {
+    for (u32 word = 0; word < EPOCH_MAX_THREADS / 64; ++word) {
+      u64 bits = g_epoch_thread_slots[word].load(std::memory_order_relaxed);
+      while (~bits) {
+        const u32 bit = static_cast<u32>(std::countr_zero(~bits));
+        if (g_epoch_thread_slots[word].compare_exchange_weak(
+                bits, bits | (1ull << bit), std::memory_order_acquire,
+                std::memory_order_relaxed)) {
+          t_epoch_thread_slot.index = word * 64 + bit;
+          return t_epoch_thread_slot.index;
+        }
+      }
+    }
+    thread_yield();
+  }
+}
+} // namespace detail
+
+void EpochDomain::enter() {
+  Participant &participant = m_participants[detail::epoch_thread_index()];
+  if (participant.depth++ != 0) {
+    return;
+  }
+
+  const u64 epoch = m_global_epoch.load(std::memory_order_relaxed);
+  participant.epoch.store((epoch << 1) | 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochDomain::leave() {
+  Participant &participant = m_participants[detail::epoch_thread_index()];
+  if (--participant.depth != 0) {
+    return;
+  }
+
+  participant.epoch.store(0, std::memory_order_release);
+}
+
+bool EpochDomain::try_advance() {
+  u64 epoch = m_global_epoch.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  for (const Participant &participant : m_participants) {
+    const u64 local = participant.epoch.load(std::memory_order_acquire);
+    if ((local & 1) && (local >> 1) != epoch) {
+      return false;
+    }
+  }
+
+  return m_global_epoch.compare_exchange_strong(epoch, epoch + 1,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed);
+}
+} // namespace edge
@@ -1,6 +1,6 @@
 #include "filesystem.hpp"
 
-#include <winternl.h>
+#include "hash.hpp"
 
 namespace edge::filesystem {
 Filesystem *Filesystem::s_instance = nullptr;
@@ -9,6 +9,8 @@ String get_system_cwd(NotNull<const Allocator*> alloc);
 String get_system_temp_path(NotNull<const Allocator*> alloc);
 String get_system_cached_path(NotNull<const Allocator*> alloc);
 
+constexpr u32 ENTRY_CACHE_GENERATION_MASK = 0xFFFFu;
+
 void Filesystem::set_instance(Filesystem *instance) { s_instance = instance; }
 Filesystem *Filesystem::get_instance() { return s_instance; }
 
@@ -16,6 +18,14 @@ bool Filesystem::create(const NotNull<const Allocator *> alloc) {
   m_cwd_path = get_system_cwd(alloc);
   m_temp_path = get_system_temp_path(alloc);
   m_cached_path = get_system_cached_path(alloc);
+
+  // NOTE: The working directory is the fallback mount, every path that no
+  // other mount claims goes to the OS.
+  IFilesystem *native = create_native_filesystem(alloc, m_cwd_path);
+  if (!native) {
+    return false;
+  }
+  mount(alloc, u8"", native);
   return true;
 }
 
@@ -25,6 +35,7 @@ void Filesystem::destroy(const NotNull<const Allocator *> alloc) {
     filesystem->destroy(alloc);
     alloc->deallocate(filesystem);
   }
+  m_mount_points.destroy(alloc);
 
   m_cwd_path.destroy(alloc);
   m_temp_path.destroy(alloc);
@@ -37,11 +48,13 @@ void Filesystem::mount(const NotNull<const Allocator *> alloc,
   m_mount_points.emplace_back(
       alloc, String{alloc, mount_point.data(), mount_point.length()},
       filesystem);
+  invalidate_cache();
 }
 
 void Filesystem::unmount(const NotNull<const Allocator *> alloc,
                          const StringView<char8_t> mount_point) {
-  for (usize i = 0; i < m_mount_points.size(); ++i) {
+  // NOTE: Stacked mounts on one point come off in reverse order.
+  for (usize i = m_mount_points.size(); i-- > 0;) {
     if (const StringView<char8_t> mp = m_mount_points[i].path;
         mp == mount_point) {
       MountPoint mount_point = {};
@@ -49,63 +62,190 @@ void Filesystem::unmount(const NotNull<const Allocator *> alloc,
       mount_point.path.destroy(alloc);
       mount_point.filesystem->destroy(alloc);
       alloc->deallocate(mount_point.filesystem);
+      invalidate_cache();
       return;
     }
   }
 }
 
 bool Filesystem::exists(const StringView<char8_t> path) const {
-  auto [relative_path, filesystem] = resolve_path(path);
-  if (!filesystem) {
-    return false;
-  }
-  return filesystem->get_entry_flags(relative_path).any();
+  return get_entry_flags(path).any();
 }
 
 bool Filesystem::is_file(const StringView<char8_t> path) const {
-  auto [relative_path, filesystem] = resolve_path(path);
-  if (!filesystem) {
-    return false;
-  }
-  return filesystem->get_entry_flags(relative_path).has(EntryFlag::File);
+  return get_entry_flags(path).has(EntryFlag::File);
 }
 
 bool Filesystem::is_directory(const StringView<char8_t> path) const {
-  auto [relative_path, filesystem] = resolve_path(path);
-  if (!filesystem) {
-    return false;
-  }
-  return filesystem->get_entry_flags(relative_path).has(EntryFlag::Directory);
+  return get_entry_flags(path).has(EntryFlag::Directory);
 }
 
 bool Filesystem::create_directory(const StringView<char8_t> path) const {
-  auto [relative_path, filesystem] = resolve_path(path);
+  auto [relative_path, filesystem, mount_index] = resolve_path(path);
   if (!filesystem) {
     return false;
   }
-  return filesystem->create_directory(relative_path);
+  const bool created = filesystem->create_directory(relative_path);
+  invalidate_cache();
+  return created;
 }
 
 bool Filesystem::create_directories(const StringView<char8_t> path) {
-  auto [relative_path, filesystem] = resolve_path(path);
-  if (!filesystem) {
+  auto [relative_path, filesystem, mount_index] = resolve_path(path);
+  if (!filesystem || relative_path.empty()) {
     return false;
   }
 
-  // TODO: NOT IMPLEMENTED
-
-  return true;
+  // NOTE: Intermediate failures are expected for components that already
+  // exist, only the leaf decides the result.
+  for (usize i = 1; i < relative_path.size(); ++i) {
+    if (is_separator(relative_path[i]) && !is_separator(relative_path[i - 1])) {
+      filesystem->create_directory(relative_path.substr(0, i));
+    }
+  }
+  const bool created =
+      filesystem->create_directory(relative_path) ||
+      filesystem->get_entry_flags(relative_path).has(EntryFlag::Directory);
+  invalidate_cache();
+  return created;
 }
 
 bool Filesystem::remove(const StringView<char8_t> path) const {
-  auto [relative_path, filesystem] = resolve_path(path);
+  auto [relative_path, filesystem, mount_index] = resolve_path(path);
   if (!filesystem) {
     return false;
   }
-  return filesystem->remove(relative_path);
+  const bool removed = filesystem->remove(relative_path);
+  invalidate_cache();
+  return removed;
 }
 
-MountPoint Filesystem::resolve_path(const StringView<char8_t> path) const {
-  return {};
+IFile *Filesystem::open_file(const NotNull<const Allocator *> alloc,
+                             const StringView<char8_t> path,
+                             const AccessModeFlags flags) const {
+  const bool writes = flags.has(AccessMode::Write) ||
+                      flags.has(AccessMode::Append) ||
+                      flags.has(AccessMode::Create) ||
+                      flags.has(AccessMode::Truncate);
+  if (!writes) {
+    for (ResolvedPath resolved = resolve_path(path); resolved.filesystem;
+         resolved = resolve_path(path, &resolved)) {
+      if (IFile *file = resolved.filesystem->open_file(
+              alloc, resolved.relative_path, flags)) {
+        return file;
+      }
+    }
+    return nullptr;
+  }
+
+  // NOTE: Writes only go to the top mount, lower layers stay untouched.
+  auto [relative_path, filesystem, mount_index] = resolve_path(path);
+  if (!filesystem) {
+    return nullptr;
+  }
+  IFile *file = filesystem->open_file(alloc, relative_path, flags);
+  if (flags.has(AccessMode::Create) || flags.has(AccessMode::Truncate)) {
+    invalidate_cache();
+  }
+  return file;
+}
+
+void Filesystem::invalidate_cache() const {
+  const u32 generation =
+      m_entry_cache_generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+  if ((generation & ENTRY_CACHE_GENERATION_MASK) != 0) {
+    return;
+  }
+
+  // NOTE: The packed generation wrapped, old slots could match again.
+  for (EntryCacheSlot &slot : m_entry_cache) {
+    slot.state.store(0, std::memory_order_relaxed);
+  }
+  m_entry_cache_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+ResolvedPath Filesystem::resolve_path(const StringView<char8_t> path,
+                                      const ResolvedPath *after) const {
+  ResolvedPath result = {path, nullptr};
+  usize best_length = 0;
+  const usize after_length =
+      after ? m_mount_points[after->mount_index].path.length() : SIZE_MAX;
+
+  // NOTE: Longest mount point prefix on a component boundary wins, later
+  // mounts win ties.
+  for (usize i = 0; i < m_mount_points.size(); ++i) {
+    const MountPoint &mount_point = m_mount_points[i];
+    const StringView<char8_t> mp = mount_point.path;
+    if (!path.starts_with(mp)) {
+      continue;
+    }
+    if (!mp.empty() && path.size() > mp.size() &&
+        !is_separator(path[mp.size()]) && !is_separator(mp.back())) {
+      continue;
+    }
+    if (result.filesystem && mp.size() < best_length) {
+      continue;
+    }
+    if (after && (mp.size() > after_length ||
+                  (mp.size() == after_length && i >= after->mount_index))) {
+      continue;
+    }
+
+    StringView<char8_t> relative_path = path;
+    relative_path.remove_prefix(mp.size());
+    while (!mp.empty() && !relative_path.empty() &&
+           is_separator(relative_path.front())) {
+      relative_path.remove_prefix(1);
+    }
+
+    result = {relative_path, mount_point.filesystem, i};
+    best_length = mp.size();
+  }
+
+  return result;
+}
+
+EntryFlags Filesystem::get_entry_flags(const StringView<char8_t> path) const {
+  const u64 hash = hash_xxh3_64(path.data(), path.size());
+  const u64 generation =
+      m_entry_cache_generation.load(std::memory_order_acquire) &
+      ENTRY_CACHE_GENERATION_MASK;
+  const u64 state = (static_cast<u64>(path.size()) << 32) | (generation << 8);
+  const bool cacheable = path.size() <= UINT32_MAX;
+
+  EntryCacheSlot &slot = m_entry_cache[hash & (ENTRY_CACHE_SIZE - 1)];
+  if (cacheable) {
+    const u32 sequence = slot.sequence.load(std::memory_order_acquire);
+    const u64 cached_hash = slot.hash.load(std::memory_order_relaxed);
+    const u64 cached = slot.state.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if ((sequence & 1) == 0 &&
+        slot.sequence.load(std::memory_order_relaxed) == sequence &&
+        cached_hash == hash && (cached & ~0xFFull) == state) {
+      return EntryFlags{static_cast<u32>(cached & 0xFF)};
+    }
+  }
+
+  EntryFlags flags = {};
+  for (ResolvedPath resolved = resolve_path(path);
+       resolved.filesystem && !flags.any();
+       resolved = resolve_path(path, &resolved)) {
+    flags = resolved.filesystem->get_entry_flags(resolved.relative_path);
+  }
+
+  // NOTE: Stored with the generation read before the query. Mutations bump
+  // the generation once they have landed, so a change that raced with the
+  // query leaves an entry that never matches. A slot another thread is
+  // writing is left to that thread.
+  u32 sequence = slot.sequence.load(std::memory_order_relaxed);
+  if (cacheable && (sequence & 1) == 0 &&
+      slot.sequence.compare_exchange_strong(sequence, sequence + 1,
+                                            std::memory_order_relaxed)) {
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.hash.store(hash, std::memory_order_relaxed);
+    slot.state.store(state | (flags.value() & 0xFF), std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+  }
+  return flags;
 }
-} // namespace edge::filesystem
\ No newline at end of file
+} // namespace edge::filesystem
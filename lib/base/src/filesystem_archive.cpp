@@ -0,0 +1,690 @@
+#include "filesystem.hpp"
+
+#include "allocator.hpp"
+#include "hashmap.hpp"
+
+#include <cstring>
+
+#if EDGE_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace edge::filesystem {
+constexpr u32 ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr u32 ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+constexpr u32 ZIP_END_SIGNATURE = 0x06054b50;
+constexpr u32 ZIP64_END_SIGNATURE = 0x06064b50;
+constexpr u32 ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+constexpr usize ZIP_LOCAL_HEADER_SIZE = 30;
+constexpr usize ZIP_CENTRAL_HEADER_SIZE = 46;
+constexpr usize ZIP_END_SIZE = 22;
+constexpr usize ZIP_MAX_COMMENT_SIZE = 0xFFFF;
+constexpr u16 ZIP_METHOD_STORED = 0;
+constexpr u16 ZIP_METHOD_DEFLATE = 8;
+
+constexpr usize TAR_BLOCK_SIZE = 512;
+
+static u16 read_u16_le(const u8 *data) {
+  return static_cast<u16>(data[0] | (data[1] << 8));
+}
+
+static u32 read_u32_le(const u8 *data) {
+  return static_cast<u32>(data[0]) | (static_cast<u32>(data[1]) << 8) |
+         (static_cast<u32>(data[2]) << 16) | (static_cast<u32>(data[3]) << 24);
+}
+
+static u64 read_u64_le(const u8 *data) {
+  return static_cast<u64>(read_u32_le(data)) |
+         (static_cast<u64>(read_u32_le(data + 4)) << 32);
+}
+
+static StringView<char8_t> normalize_archive_path(StringView<char8_t> path) {
+  while (!path.empty() &&
+         (is_separator(path.front()) ||
+          (path.size() > 1 && path[0] == u8'.' && is_separator(path[1])))) {
+    path.remove_prefix(path.front() == u8'.' ? 2 : 1);
+  }
+  while (!path.empty() && is_separator(path.back())) {
+    path.remove_suffix(1);
+  }
+  return path;
+}
+
+struct ArchiveEntry {
+  // NOTE: Zip entries point at their local header, which is only parsed on
+  // open so mounting never touches the data pages. Tar entries point at the
+  // data.
+  u64 offset = 0;
+  u64 compressed_size = 0;
+  u64 size = 0;
+  u16 method = ZIP_METHOD_STORED;
+  EntryFlags flags = {};
+};
+
+class ArchiveFile final : public IFile {
+public:
+  ArchiveFile(const u8 *data, const usize size, u8 *owned_data,
+              const Allocator *alloc)
+      : m_data{data}, m_size{size}, m_owned_data{owned_data}, m_alloc{alloc} {}
+  ~ArchiveFile() override { close(); }
+
+  bool open(StringView<char8_t>, AccessModeFlags) override { return false; }
+
+  void close() override {
+    if (m_owned_data) {
+      m_alloc->free(m_owned_data);
+    }
+    m_data = nullptr;
+    m_owned_data = nullptr;
+    m_size = 0;
+    m_position = 0;
+  }
+
+  bool is_open() const override { return m_data != nullptr; }
+
+  usize seek(const isize offset, const StreamOrigin origin) override {
+    isize base = 0;
+    switch (origin) {
+    case StreamOrigin::Current:
+      base = static_cast<isize>(m_position);
+      break;
+    case StreamOrigin::End:
+      base = static_cast<isize>(m_size);
+      break;
+    default:
+      break;
+    }
+
+    const isize position = base + offset;
+    if (!is_open() || position < 0 || static_cast<usize>(position) > m_size) {
+      return SIZE_MAX;
+    }
+    m_position = static_cast<usize>(position);
+    return m_position;
+  }
+
+  usize tell() override { return m_position; }
+
+  u64 size() const override { return m_size; }
+
+  usize read(void *buffer_out, const usize element_size,
+             const usize element_count) const override {
+    const usize bytes =
+        read_at(m_position, buffer_out, element_size * element_count);
+    m_position += bytes;
+    return bytes;
+  }
+
+  usize write(const void *, usize, usize) const override { return 0; }
+
+  usize read_at(const u64 offset, void *buffer_out,
+                const usize size) const override {
+    if (!is_open() || !buffer_out || offset >= m_size) {
+      return 0;
+    }
+    const usize available = m_size - static_cast<usize>(offset);
+    const usize bytes = size < available ? size : available;
+    memcpy(buffer_out, m_data + offset, bytes);
+    return bytes;
+  }
+
+  usize write_at(u64, const void *, usize) const override { return 0; }
+
+  bool flush() override { return is_open(); }
+
+private:
+  const u8 *m_data = nullptr;
+  usize m_size = 0;
+  // NOTE: Position is per handle state like a file descriptor offset, read
+  // stays const to match the native files.
+  mutable usize m_position = 0;
+  u8 *m_owned_data = nullptr;
+  const Allocator *m_alloc = nullptr;
+};
+
+// NOTE: Read-only mount over a mapping of the whole archive. The index is
+// built once in create, lookups afterwards are lock free reads.
+class ArchiveFilesystem : public IFilesystem {
+public:
+  explicit ArchiveFilesystem(const String &archive_path)
+      : m_archive_path(archive_path) {}
+
+  bool create(const NotNull<const Allocator *> alloc) override {
+    if (!m_archive.map(m_archive_path, 0, 0,
+                       MapFlags{MapFlag::RandomAccess})) {
+      return false;
+    }
+    if (!m_entries.create(alloc)) {
+      return false;
+    }
+    return build_index(alloc);
+  }
+
+  void destroy(const NotNull<const Allocator *> alloc) override {
+    for (char8_t *name : m_owned_names) {
+      alloc->free(name);
+    }
+    m_owned_names.destroy(alloc);
+    m_entries.destroy(alloc);
+    m_archive.unmap();
+    m_archive_path.destroy(alloc);
+  }
+
+  bool create_directory(StringView<char8_t>) override { return false; }
+  bool remove(StringView<char8_t>) override { return false; }
+
+  EntryFlags get_entry_flags(const StringView<char8_t> path) override {
+    const StringView<char8_t> key = normalize_archive_path(path);
+    if (key.empty()) {
+      return EntryFlags{EntryFlag::Directory};
+    }
+    const auto found = m_entries.find(key);
+    return found != m_entries.end() ? found->value.flags : EntryFlags{};
+  }
+
+  IFile *open_file(const NotNull<const Allocator *> alloc,
+                   const StringView<char8_t> path,
+                   const AccessModeFlags flags) override {
+    if (flags.has(AccessMode::Write) || flags.has(AccessMode::Append) ||
+        flags.has(AccessMode::Create) || flags.has(AccessMode::Truncate)) {
+      return nullptr;
+    }
+
+    const auto found = m_entries.find(normalize_archive_path(path));
+    if (found == m_entries.end() ||
+        !found->value.flags.has(EntryFlag::File)) {
+      return nullptr;
+    }
+
+    const ArchiveEntry &entry = found->value;
+    const u8 *data = entry_data(entry);
+    if (!data) {
+      return nullptr;
+    }
+
+    u8 *owned_data = nullptr;
+    if (entry.method == ZIP_METHOD_DEFLATE) {
+      owned_data = inflate_entry(alloc, data, entry);
+      if (!owned_data) {
+        return nullptr;
+      }
+      data = owned_data;
+    } else if (entry.method != ZIP_METHOD_STORED) {
+      return nullptr;
+    }
+
+    ArchiveFile *file = alloc->allocate<ArchiveFile>(
+        data, static_cast<usize>(entry.size), owned_data, alloc.m_ptr);
+    if (!file && owned_data) {
+      alloc->free(owned_data);
+    }
+    return file;
+  }
+
+protected:
+  virtual bool build_index(NotNull<const Allocator *> alloc) = 0;
+  // NOTE: Start of the entry bytes in the mapping, nullptr when the archive
+  // is truncated.
+  virtual const u8 *entry_data(const ArchiveEntry &entry) const = 0;
+
+  bool add_entry(const NotNull<const Allocator *> alloc,
+                 const StringView<char8_t> path, const ArchiveEntry &entry) {
+    const StringView<char8_t> key = normalize_archive_path(path);
+    if (key.empty()) {
+      return true;
+    }
+
+    // NOTE: Later copies of a path win, matching what extraction would leave.
+    auto [it, inserted] = m_entries.try_emplace(alloc, key, entry);
+    if (it == m_entries.end()) {
+      return false;
+    }
+    if (!inserted) {
+      it->value = entry;
+    }
+
+    // NOTE: Archives may omit directory records, every parent of an entry is
+    // added so directory queries still answer. Parents of an already known
+    // directory are known too.
+    StringView<char8_t> parent = key;
+    for (usize pos = find_last_separator(parent); pos != SIZE_MAX && pos > 0;
+         pos = find_last_separator(parent)) {
+      parent.remove_suffix(parent.size() - pos);
+      auto [parent_it, parent_inserted] = m_entries.try_emplace(
+          alloc, parent, ArchiveEntry{.flags = EntryFlags{EntryFlag::Directory}});
+      if (parent_it == m_entries.end()) {
+        return false;
+      }
+      if (!parent_inserted) {
+        break;
+      }
+    }
+    return true;
+  }
+
+  // NOTE: Names that are not stored contiguously in the archive are joined
+  // into memory that lives as long as the index.
+  StringView<char8_t> own_name(const NotNull<const Allocator *> alloc,
+                               const StringView<char8_t> prefix,
+                               const StringView<char8_t> name) {
+    const usize length = prefix.size() + 1 + name.size();
+    auto *buffer = static_cast<char8_t *>(alloc->malloc(length, 1));
+    if (!buffer) {
+      return {};
+    }
+    if (!m_owned_names.push_back(alloc, buffer)) {
+      alloc->free(buffer);
+      return {};
+    }
+    memcpy(buffer, prefix.data(), prefix.size());
+    buffer[prefix.size()] = u8'/';
+    memcpy(buffer + prefix.size() + 1, name.data(), name.size());
+    return {buffer, length};
+  }
+
+  String m_archive_path;
+  MappedFile m_archive;
+  HashMap<StringView<char8_t>, ArchiveEntry> m_entries;
+  Array<char8_t *> m_owned_names;
+
+private:
+  u8 *inflate_entry(const NotNull<const Allocator *> alloc, const u8 *data,
+                    const ArchiveEntry &entry) const {
+#if EDGE_HAS_ZLIB
+    auto *output = static_cast<u8 *>(
+        alloc->malloc(entry.size > 0 ? static_cast<usize>(entry.size) : 1, 1));
+    if (!output) {
+      return nullptr;
+    }
+
+    z_stream stream = {};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+      alloc->free(output);
+      return nullptr;
+    }
+
+    // NOTE: Sizes were validated against the mapping while indexing, zlib
+    // counts are 32 bit so large entries are fed in slices.
+    const u8 *input = data;
+    u64 input_left = entry.compressed_size;
+    u64 output_done = 0;
+    int result = Z_OK;
+    while (result == Z_OK) {
+      const uInt input_slice =
+          static_cast<uInt>(input_left < 0x40000000u ? input_left : 0x40000000u);
+      const u64 output_left = entry.size - output_done;
+      const uInt output_slice = static_cast<uInt>(
+          output_left < 0x40000000u ? output_left : 0x40000000u);
+
+      stream.next_in = const_cast<Bytef *>(input);
+      stream.avail_in = input_slice;
+      stream.next_out = output + output_done;
+      stream.avail_out = output_slice;
+
+      result = inflate(&stream, Z_NO_FLUSH);
+      const uInt consumed = input_slice - stream.avail_in;
+      const uInt produced = output_slice - stream.avail_out;
+      input += consumed;
+      input_left -= consumed;
+      output_done += produced;
+      if (result == Z_OK && consumed == 0 && produced == 0) {
+        result = Z_DATA_ERROR;
+      }
+    }
+    inflateEnd(&stream);
+
+    if (result != Z_STREAM_END || output_done != entry.size) {
+      alloc->free(output);
+      return nullptr;
+    }
+    return output;
+#else
+    (void)alloc;
+    (void)data;
+    (void)entry;
+    return nullptr;
+#endif
+  }
+};
+
+class ZipFilesystem final : public ArchiveFilesystem {
+public:
+  using ArchiveFilesystem::ArchiveFilesystem;
+
+protected:
+  bool build_index(const NotNull<const Allocator *> alloc) override {
+    const u8 *archive = m_archive.data();
+    const usize archive_size = m_archive.size();
+    if (archive_size < ZIP_END_SIZE) {
+      return false;
+    }
+
+    // NOTE: The end record sits before a comment of up to 64 KiB, scanned
+    // backwards for its signature.
+    usize end_offset = SIZE_MAX;
+    const usize scan_limit = archive_size - ZIP_END_SIZE;
+    const usize scan_floor = scan_limit > ZIP_MAX_COMMENT_SIZE
+                                 ? scan_limit - ZIP_MAX_COMMENT_SIZE
+                                 : 0;
+    for (usize offset = scan_limit + 1; offset-- > scan_floor;) {
+      if (read_u32_le(archive + offset) == ZIP_END_SIGNATURE) {
+        end_offset = offset;
+        break;
+      }
+    }
+    if (end_offset == SIZE_MAX) {
+      return false;
+    }
+
+    const u8 *end = archive + end_offset;
+    u64 entry_count = read_u16_le(end + 10);
+    u64 directory_size = read_u32_le(end + 12);
+    u64 directory_offset = read_u32_le(end + 16);
+
+    if ((entry_count == 0xFFFF || directory_size == 0xFFFFFFFFu ||
+         directory_offset == 0xFFFFFFFFu) &&
+        end_offset >= 20 &&
+        read_u32_le(end - 20) == ZIP64_LOCATOR_SIGNATURE) {
+      const u64 zip64_offset = read_u64_le(end - 20 + 8);
+      if (zip64_offset > archive_size || archive_size - zip64_offset < 56 ||
+          read_u32_le(archive + zip64_offset) != ZIP64_END_SIGNATURE) {
+        return false;
+      }
+      const u8 *zip64_end = archive + zip64_offset;
+      entry_count = read_u64_le(zip64_end + 32);
+      directory_size = read_u64_le(zip64_end + 40);
+      directory_offset = read_u64_le(zip64_end + 48);
+    }
+
+    if (directory_offset > archive_size ||
+        directory_size > archive_size - directory_offset) {
+      return false;
+    }
+
+    const u8 *cursor = archive + directory_offset;
+    const u8 *directory_end = cursor + directory_size;
+    for (u64 i = 0; i < entry_count; ++i) {
+      if (static_cast<usize>(directory_end - cursor) <
+              ZIP_CENTRAL_HEADER_SIZE ||
+          read_u32_le(cursor) != ZIP_CENTRAL_HEADER_SIGNATURE) {
+        return false;
+      }
+
+      const u16 general_flags = read_u16_le(cursor + 8);
+      const u16 method = read_u16_le(cursor + 10);
+      u64 compressed_size = read_u32_le(cursor + 20);
+      u64 size = read_u32_le(cursor + 24);
+      const u16 name_length = read_u16_le(cursor + 28);
+      const u16 extra_length = read_u16_le(cursor + 30);
+      const u16 comment_length = read_u16_le(cursor + 32);
+      u64 local_offset = read_u32_le(cursor + 42);
+
+      const usize record_size = ZIP_CENTRAL_HEADER_SIZE + name_length +
+                                extra_length + comment_length;
+      if (static_cast<usize>(directory_end - cursor) < record_size) {
+        return false;
+      }
+
+      const u8 *name = cursor + ZIP_CENTRAL_HEADER_SIZE;
+      const u8 *extra = name + name_length;
+      const u8 *extra_end = extra + extra_length;
+      while (extra_end - extra >= 4) {
+        const u16 id = read_u16_le(extra);
+        const u16 length = read_u16_le(extra + 2);
+        const u8 *field = extra + 4;
+        if (extra_end - field < length) {
+          break;
+        }
+        // NOTE: Zip64 values are present only for the fields that overflowed,
+        // in this order.
+        if (id == 0x0001) {
+          const u8 *value = field;
+          const u8 *value_end = field + length;
+          if (size == 0xFFFFFFFFu && value_end - value >= 8) {
+            size = read_u64_le(value);
+            value += 8;
+          }
+          if (compressed_size == 0xFFFFFFFFu && value_end - value >= 8) {
+            compressed_size = read_u64_le(value);
+            value += 8;
+          }
+          if (local_offset == 0xFFFFFFFFu && value_end - value >= 8) {
+            local_offset = read_u64_le(value);
+          }
+        }
+        extra = field + length;
+      }
+      cursor += record_size;
+
+      const StringView<char8_t> path = {reinterpret_cast<const char8_t *>(name),
+                                        name_length};
+      const bool is_directory = name_length > 0 && is_separator(path.back());
+      // NOTE: Encrypted entries are left out, they can not be served.
+      if ((general_flags & 1u) != 0 && !is_directory) {
+        continue;
+      }
+      if (!is_directory && (local_offset > archive_size ||
+                            compressed_size > archive_size - local_offset)) {
+        return false;
+      }
+
+      const ArchiveEntry entry = {
+          .offset = local_offset,
+          .compressed_size = compressed_size,
+          .size = size,
+          .method = method,
+          .flags = EntryFlags{is_directory ? EntryFlag::Directory
+                                         : EntryFlag::File}};
+      if (!add_entry(alloc, path, entry)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const u8 *entry_data(const ArchiveEntry &entry) const override {
+    const usize archive_size = m_archive.size();
+    if (entry.offset > archive_size ||
+        archive_size - entry.offset < ZIP_LOCAL_HEADER_SIZE) {
+      return nullptr;
+    }
+
+    const u8 *header = m_archive.data() + entry.offset;
+    if (read_u32_le(header) != ZIP_LOCAL_HEADER_SIGNATURE) {
+      return nullptr;
+    }
+
+    // NOTE: The local extra field may differ from the central one, only the
+    // local lengths locate the data.
+    const u64 data_offset = entry.offset + ZIP_LOCAL_HEADER_SIZE +
+                            read_u16_le(header + 26) + read_u16_le(header + 28);
+    if (data_offset > archive_size ||
+        entry.compressed_size > archive_size - data_offset ||
+        (entry.method == ZIP_METHOD_STORED &&
+         entry.size != entry.compressed_size)) {
+      return nullptr;
+    }
+    return m_archive.data() + data_offset;
+  }
+};
+
+class TarFilesystem final : public ArchiveFilesystem {
+public:
+  using ArchiveFilesystem::ArchiveFilesystem;
+
+protected:
+  bool build_index(const NotNull<const Allocator *> alloc) override {
+    const u8 *archive = m_archive.data();
+    const usize archive_size = m_archive.size();
+
+    StringView<char8_t> long_name = {};
+    for (usize offset = 0; archive_size - offset >= TAR_BLOCK_SIZE;) {
+      const u8 *header = archive + offset;
+      if (header[0] == 0) {
+        break;
+      }
+      if (!valid_checksum(header)) {
+        return false;
+      }
+
+      const u64 size = parse_number(header + 124, 12);
+      const usize data_offset = offset + TAR_BLOCK_SIZE;
+      if (size > archive_size - data_offset) {
+        return false;
+      }
+      const u8 *data = archive + data_offset;
+      const usize padded_size =
+          (static_cast<usize>(size) + TAR_BLOCK_SIZE - 1) & ~(TAR_BLOCK_SIZE - 1);
+      offset = data_offset + padded_size > archive_size
+                   ? archive_size
+                   : data_offset + padded_size;
+
+      const char8_t type = static_cast<char8_t>(header[156]);
+      if (type == u8'L') {
+        long_name = field_string(data, static_cast<usize>(size));
+        continue;
+      }
+      if (type == u8'x') {
+        if (const StringView<char8_t> pax_path =
+                pax_record_path(data, static_cast<usize>(size));
+            !pax_path.empty()) {
+          long_name = pax_path;
+        }
+        continue;
+      }
+
+      const bool is_file = type == u8'0' || type == u8'\0' || type == u8'7';
+      const bool is_directory = type == u8'5';
+      if (is_file || is_directory) {
+        StringView<char8_t> path = long_name;
+        if (path.empty()) {
+          path = field_string(header, 100);
+          const StringView<char8_t> prefix = field_string(header + 345, 155);
+          const bool ustar = memcmp(header + 257, "ustar", 5) == 0;
+          if (ustar && !prefix.empty()) {
+            path = own_name(alloc, prefix, path);
+            if (path.empty()) {
+              return false;
+            }
+          }
+        }
+
+        const ArchiveEntry entry = {
+            .offset = data_offset,
+            .compressed_size = is_file ? size : 0,
+            .size = is_file ? size : 0,
+            .method = ZIP_METHOD_STORED,
+            .flags = EntryFlags{is_file ? EntryFlag::File
+                                    : EntryFlag::Directory}};
+        if (!add_entry(alloc, path, entry)) {
+          return false;
+        }
+      }
+      long_name = {};
+    }
+    return true;
+  }
+
+  const u8 *entry_data(const ArchiveEntry &entry) const override {
+    return m_archive.data() + entry.offset;
+  }
+
+private:
+  static StringView<char8_t> field_string(const u8 *field,
+                                          const usize capacity) {
+    usize length = 0;
+    while (length < capacity && field[length] != 0) {
+      ++length;
+    }
+    return {reinterpret_cast<const char8_t *>(field), length};
+  }
+
+  // NOTE: Octal text, or big endian base 256 when the high bit of the first
+  // byte is set (GNU extension for sizes of 8 GiB and up).
+  static u64 parse_number(const u8 *field, const usize capacity) {
+    u64 value = 0;
+    if (field[0] & 0x80) {
+      for (usize i = 1; i < capacity; ++i) {
+        value = (value << 8) | field[i];
+      }
+      return value;
+    }
+    for (usize i = 0; i < capacity; ++i) {
+      if (field[i] >= '0' && field[i] <= '7') {
+        value = (value << 3) | static_cast<u64>(field[i] - '0');
+      } else if (field[i] != ' ' || value != 0) {
+        break;
+      }
+    }
+    return value;
+  }
+
+  static bool valid_checksum(const u8 *header) {
+    u64 sum = 0;
+    for (usize i = 0; i < TAR_BLOCK_SIZE; ++i) {
+      sum += i >= 148 && i < 156 ? static_cast<u8>(' ') : header[i];
+    }
+    return sum == parse_number(header + 148, 8);
+  }
+
+  // NOTE: Pax records are "<length> <key>=<value>\n", only the path matters
+  // for the index.
+  static StringView<char8_t> pax_record_path(const u8 *data, const usize size) {
+    usize offset = 0;
+    while (offset < size) {
+      usize length = 0;
+      usize cursor = offset;
+      while (cursor < size && data[cursor] >= '0' && data[cursor] <= '9') {
+        length = length * 10 + (data[cursor++] - '0');
+      }
+      if (length > size - offset || cursor + 1 >= offset + length ||
+          data[cursor] != ' ') {
+        break;
+      }
+
+      const StringView<char8_t> record = {
+          reinterpret_cast<const char8_t *>(data + cursor + 1),
+          offset + length - cursor - 2};
+      if (record.starts_with(u8"path=")) {
+        StringView<char8_t> path = record;
+        path.remove_prefix(5);
+        return path;
+      }
+      offset += length;
+    }
+    return {};
+  }
+};
+
+template <typename T>
+static IFilesystem *create_archive_filesystem(
+    const NotNull<const Allocator *> alloc,
+    const StringView<char8_t> archive_path) {
+  String path_copy = {};
+  if (!path_copy.from_utf8(alloc, archive_path.data(), archive_path.size())) {
+    return nullptr;
+  }
+
+  T *filesystem = alloc->allocate<T>(path_copy);
+  if (!filesystem) {
+    path_copy.destroy(alloc);
+    return nullptr;
+  }
+  if (!filesystem->create(alloc)) {
+    filesystem->destroy(alloc);
+    alloc->deallocate(filesystem);
+    return nullptr;
+  }
+  return filesystem;
+}
+
+IFilesystem *create_zip_filesystem(const NotNull<const Allocator *> alloc,
+                                   const StringView<char8_t> archive_path) {
+  return create_archive_filesystem<ZipFilesystem>(alloc, archive_path);
+}
+
+IFilesystem *create_tar_filesystem(const NotNull<const Allocator *> alloc,
+                                   const StringView<char8_t> archive_path) {
+  return create_archive_filesystem<TarFilesystem>(alloc, archive_path);
+}
+} // namespace edge::filesystem
@@ -0,0 +1,1332 @@
+#include "filesystem.hpp"
+
+#include "allocator.hpp"
+#include "arena.hpp"
+#include "sort.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if EDGE_PLATFORM_LINUX || EDGE_PLATFORM_ANDROID
+#include <sys/inotify.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
+namespace edge::filesystem {
+constexpr usize NATIVE_PATH_CAPACITY = 4096;
+
+static bool to_native_path(const StringView<char8_t> path, char *out,
+                           const usize out_cap) {
+  if (path.empty() || path.size() >= out_cap) {
+    return false;
+  }
+  memcpy(out, path.data(), path.size());
+  out[path.size()] = '\0';
+  return true;
+}
+
+static bool join_native_path(const StringView<char8_t> root,
+                             const StringView<char8_t> path, char *out,
+                             const usize out_cap) {
+  if (root.empty() || is_absolute(path)) {
+    return to_native_path(path, out, out_cap);
+  }
+  if (path.empty()) {
+    return to_native_path(root, out, out_cap);
+  }
+
+  const bool needs_separator = !is_separator(root.back());
+  const usize length = root.size() + (needs_separator ? 1 : 0) + path.size();
+  if (length >= out_cap) {
+    return false;
+  }
+
+  char *cursor = out;
+  memcpy(cursor, root.data(), root.size());
+  cursor += root.size();
+  if (needs_separator) {
+    *cursor++ = '/';
+  }
+  memcpy(cursor, path.data(), path.size());
+  out[length] = '\0';
+  return true;
+}
+
+static String string_from_env(const NotNull<const Allocator *> alloc,
+                              const char *name, const char *suffix,
+                              const char *fallback) {
+  const char *value = getenv(name);
+  if (!value || !*value) {
+    return String{alloc, fallback, strlen(fallback)};
+  }
+
+  String result = {alloc, value, strlen(value)};
+  if (suffix) {
+    result.append(alloc, reinterpret_cast<const char8_t *>(suffix),
+                  strlen(suffix));
+  }
+  return result;
+}
+
+String get_system_cwd(const NotNull<const Allocator *> alloc) {
+  char buffer[NATIVE_PATH_CAPACITY];
+  if (!getcwd(buffer, sizeof(buffer))) {
+    return String{alloc, ".", 1};
+  }
+  return String{alloc, buffer, strlen(buffer)};
+}
+
+String get_system_temp_path(const NotNull<const Allocator *> alloc) {
+  return string_from_env(alloc, "TMPDIR", nullptr, "/tmp");
+}
+
+String get_system_cached_path(const NotNull<const Allocator *> alloc) {
+  if (const char *xdg = getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+    return String{alloc, xdg, strlen(xdg)};
+  }
+  return string_from_env(alloc, "HOME", "/.cache", "/tmp");
+}
+
+static EntryFlags native_entry_flags(const char *path) {
+  struct stat st;
+  if (stat(path, &st) != 0) {
+    return EntryFlags{};
+  }
+  if (S_ISDIR(st.st_mode)) {
+    return EntryFlags{EntryFlag::Directory};
+  }
+  if (S_ISREG(st.st_mode)) {
+    return EntryFlags{EntryFlag::File};
+  }
+  return EntryFlags{};
+}
+
+static bool native_remove(const char *path) {
+  struct stat st;
+  if (lstat(path, &st) != 0) {
+    return false;
+  }
+  return S_ISDIR(st.st_mode) ? rmdir(path) == 0 : unlink(path) == 0;
+}
+
+class NativeFile final : public IFile {
+public:
+  ~NativeFile() override { close(); }
+
+  bool open(const StringView<char8_t> path,
+            const AccessModeFlags flags) override {
+    char native_path[NATIVE_PATH_CAPACITY];
+    if (!to_native_path(path, native_path, sizeof(native_path))) {
+      return false;
+    }
+    return open_native(native_path, flags);
+  }
+
+  bool open_native(const char *path, const AccessModeFlags flags) {
+    if (is_open()) {
+      return false;
+    }
+
+    const bool reads = flags.has(AccessMode::Read);
+    const bool writes =
+        flags.has(AccessMode::Write) || flags.has(AccessMode::Append);
+
+    int open_flags = O_CLOEXEC;
+    if (reads && writes) {
+      open_flags |= O_RDWR;
+    } else if (writes) {
+      open_flags |= O_WRONLY;
+    } else {
+      open_flags |= O_RDONLY;
+    }
+    if (flags.has(AccessMode::Create)) {
+      open_flags |= O_CREAT;
+    }
+    if (flags.has(AccessMode::Truncate)) {
+      open_flags |= O_TRUNC;
+    }
+
+#if defined(O_DIRECT)
+    if (flags.has(AccessMode::Unbuffered)) {
+      m_fd = ::open(path, open_flags | O_DIRECT, 0644);
+      // NOTE: tmpfs and some network filesystems reject O_DIRECT, the request
+      // is a hint so it degrades to buffered IO.
+      if (m_fd < 0 && errno != EINVAL) {
+        return false;
+      }
+    }
+#endif
+    if (m_fd < 0) {
+      m_fd = ::open(path, open_flags, 0644);
+    }
+    if (m_fd < 0) {
+      return false;
+    }
+
+#if EDGE_PLATFORM_MACOS
+    if (flags.has(AccessMode::Unbuffered)) {
+      fcntl(m_fd, F_NOCACHE, 1);
+    }
+#endif
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (flags.has(AccessMode::SequentialScan)) {
+      posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    } else if (flags.has(AccessMode::RandomAccess)) {
+      posix_fadvise(m_fd, 0, 0, POSIX_FADV_RANDOM);
+    }
+#endif
+
+    // NOTE: Positioned at the end like the Windows backend rather than
+    // O_APPEND, which would make write_at ignore its offset on Linux.
+    if (flags.has(AccessMode::Append)) {
+      lseek(m_fd, 0, SEEK_END);
+    }
+
+    return true;
+  }
+
+  void close() override {
+    if (is_open()) {
+      ::close(m_fd);
+      m_fd = -1;
+    }
+  }
+
+  bool is_open() const override { return m_fd >= 0; }
+
+  usize seek(const isize offset, const StreamOrigin origin) override {
+    if (!is_open()) {
+      return SIZE_MAX;
+    }
+
+    int whence = SEEK_SET;
+    switch (origin) {
+    case StreamOrigin::Current:
+      whence = SEEK_CUR;
+      break;
+    case StreamOrigin::End:
+      whence = SEEK_END;
+      break;
+    default:
+      break;
+    }
+
+    const off_t position = lseek(m_fd, static_cast<off_t>(offset), whence);
+    return position < 0 ? SIZE_MAX : static_cast<usize>(position);
+  }
+
+  usize tell() override {
+    if (!is_open()) {
+      return 0;
+    }
+    const off_t position = lseek(m_fd, 0, SEEK_CUR);
+    return position < 0 ? 0 : static_cast<usize>(position);
+  }
+
+  u64 size() const override {
+    struct stat st;
+    if (!is_open() || fstat(m_fd, &st) != 0) {
+      return 0;
+    }
+    return static_cast<u64>(st.st_size);
+  }
+
+  usize read(void *buffer_out, const usize element_size,
+             const usize element_count) const override {
+    if (!is_open() || !buffer_out || element_size == 0 || element_count == 0) {
+      return 0;
+    }
+
+    u8 *cursor = static_cast<u8 *>(buffer_out);
+    usize remaining = element_size * element_count;
+    usize total = 0;
+    while (remaining > 0) {
+      const ssize_t bytes = ::read(m_fd, cursor + total, remaining);
+      if (bytes < 0 && errno == EINTR) {
+        continue;
+      }
+      if (bytes <= 0) {
+        break;
+      }
+      total += static_cast<usize>(bytes);
+      remaining -= static_cast<usize>(bytes);
+    }
+    return total;
+  }
+
+  usize write(const void *buffer_in, const usize element_size,
+              const usize element_count) const override {
+    if (!is_open() || !buffer_in || element_size == 0 || element_count == 0) {
+      return 0;
+    }
+
+    const u8 *cursor = static_cast<const u8 *>(buffer_in);
+    usize remaining = element_size * element_count;
+    usize total = 0;
+    while (remaining > 0) {
+      const ssize_t bytes = ::write(m_fd, cursor + total, remaining);
+      if (bytes < 0 && errno == EINTR) {
+        continue;
+      }
+      if (bytes <= 0) {
+        break;
+      }
+      total += static_cast<usize>(bytes);
+      remaining -= static_cast<usize>(bytes);
+    }
+    return total;
+  }
+
+  usize read_at(const u64 offset, void *buffer_out,
+                const usize size) const override {
+    if (!is_open() || !buffer_out || size == 0) {
+      return 0;
+    }
+
+    u8 *cursor = static_cast<u8 *>(buffer_out);
+    usize total = 0;
+    while (total < size) {
+      const ssize_t bytes = pread(m_fd, cursor + total, size - total,
+                                  static_cast<off_t>(offset + total));
+      if (bytes < 0 && errno == EINTR) {
+        continue;
+      }
+      if (bytes <= 0) {
+        break;
+      }
+      total += static_cast<usize>(bytes);
+    }
+    return total;
+  }
+
+  usize write_at(const u64 offset, const void *buffer_in,
+                 const usize size) const override {
+    if (!is_open() || !buffer_in || size == 0) {
+      return 0;
+    }
+
+    const u8 *cursor = static_cast<const u8 *>(buffer_in);
+    usize total = 0;
+    while (total < size) {
+      const ssize_t bytes = pwrite(m_fd, cursor + total, size - total,
+                                   static_cast<off_t>(offset + total));
+      if (bytes < 0 && errno == EINTR) {
+        continue;
+      }
+      if (bytes <= 0) {
+        break;
+      }
+      total += static_cast<usize>(bytes);
+    }
+    return total;
+  }
+
+  bool flush() override {
+    if (!is_open()) {
+      return false;
+    }
+#if EDGE_PLATFORM_MACOS
+    return fsync(m_fd) == 0;
+#else
+    return fdatasync(m_fd) == 0;
+#endif
+  }
+
+private:
+  int m_fd = -1;
+};
+
+class NativeFilesystem final : public IFilesystem {
+public:
+  explicit NativeFilesystem(const String &root) : m_root(root) {}
+
+  bool create(NotNull<const Allocator *>) override { return true; }
+
+  void destroy(const NotNull<const Allocator *> alloc) override {
+    m_root.destroy(alloc);
+  }
+
+  bool create_directory(const StringView<char8_t> path) override {
+    char native_path[NATIVE_PATH_CAPACITY];
+    if (!join_native_path(m_root, path, native_path, sizeof(native_path))) {
+      return false;
+    }
+    return mkdir(native_path, 0755) == 0 ||
+           (errno == EEXIST &&
+            native_entry_flags(native_path).has(EntryFlag::Directory));
+  }
+
+  bool remove(const StringView<char8_t> path) override {
+    char native_path[NATIVE_PATH_CAPACITY];
+    if (!join_native_path(m_root, path, native_path, sizeof(native_path))) {
+      return false;
+    }
+    return native_remove(native_path);
+  }
+
+  EntryFlags get_entry_flags(const StringView<char8_t> path) override {
+    char native_path[NATIVE_PATH_CAPACITY];
+    if (!join_native_path(m_root, path, native_path, sizeof(native_path))) {
+      return EntryFlags{};
+    }
+    return native_entry_flags(native_path);
+  }
+
+  IFile *open_file(const NotNull<const Allocator *> alloc,
+                   const StringView<char8_t> path,
+                   const AccessModeFlags flags) override {
+    char native_path[NATIVE_PATH_CAPACITY];
+    if (!join_native_path(m_root, path, native_path, sizeof(native_path))) {
+      return nullptr;
+    }
+
+    NativeFile *file = alloc->allocate<NativeFile>();
+    if (!file) {
+      return nullptr;
+    }
+    if (!file->open_native(native_path, flags)) {
+      alloc->deallocate(file);
+      return nullptr;
+    }
+    return file;
+  }
+
+private:
+  String m_root;
+};
+
+bool MappedFile::map(const StringView<char8_t> path, const u64 offset,
+                     usize size, const MapFlags flags) {
+  unmap();
+
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return false;
+  }
+
+  const int fd = ::open(native_path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || offset >= static_cast<u64>(st.st_size)) {
+    ::close(fd);
+    return false;
+  }
+
+  const u64 available = static_cast<u64>(st.st_size) - offset;
+  if (size == 0 || size > available) {
+    size = static_cast<usize>(available);
+  }
+
+  const u64 page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+  const u64 aligned_offset = offset & ~(page_size - 1);
+  const usize delta = static_cast<usize>(offset - aligned_offset);
+
+  int map_flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+  if (flags.has(MapFlag::Populate)) {
+    map_flags |= MAP_POPULATE;
+  }
+#endif
+
+  void *base = mmap(nullptr, size + delta, PROT_READ, map_flags, fd,
+                    static_cast<off_t>(aligned_offset));
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+
+  m_base = base;
+  m_mapped_size = size + delta;
+  m_data = static_cast<const u8 *>(base) + delta;
+  m_size = size;
+
+  advise(0, size, flags);
+  return true;
+}
+
+void MappedFile::unmap() {
+  if (m_base) {
+    munmap(m_base, m_mapped_size);
+  }
+  *this = {};
+}
+
+void MappedFile::advise(const usize offset, usize size,
+                        const MapFlags flags) const {
+  if (!m_base || offset >= m_size) {
+    return;
+  }
+  if (size > m_size - offset) {
+    size = m_size - offset;
+  }
+
+  const uintptr_t page_mask = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1;
+  const uintptr_t begin =
+      reinterpret_cast<uintptr_t>(m_data + offset) & ~page_mask;
+  const uintptr_t end = reinterpret_cast<uintptr_t>(m_data + offset + size);
+  void *address = reinterpret_cast<void *>(begin);
+  const usize length = static_cast<usize>(end - begin);
+
+  if (flags.has(MapFlag::Sequential)) {
+    madvise(address, length, MADV_SEQUENTIAL);
+  } else if (flags.has(MapFlag::RandomAccess)) {
+    madvise(address, length, MADV_RANDOM);
+  }
+  if (flags.has(MapFlag::WillNeed)) {
+    madvise(address, length, MADV_WILLNEED);
+  }
+#if defined(MADV_HUGEPAGE)
+  if (flags.has(MapFlag::HugePages)) {
+    madvise(address, length, MADV_HUGEPAGE);
+  }
+#endif
+}
+
+// NOTE: Holes up to this size between two ranges of a file are read into
+// scratch memory instead of splitting the read.
+constexpr usize READ_BATCH_MAX_GAP = 16 * 1024;
+// NOTE: Well below IOV_MAX, which POSIX only guarantees to be 16 but every
+// supported kernel raises to 1024.
+constexpr usize READ_BATCH_MAX_SEGMENTS = 256;
+// NOTE: Well below the usual 1024 descriptor soft limit, the rest of the
+// process keeps its headroom however many files a batch names.
+constexpr usize READ_BATCH_MAX_OPEN = 256;
+
+struct ReadBatchEntry {
+  u64 device;
+  u64 inode;
+  u64 offset;
+  u32 request;
+  int fd;
+};
+
+struct ReadBatchRun {
+  u64 offset;
+  u64 end;
+  u32 first_entry;
+  u32 entry_count;
+  u32 first_segment;
+  u32 segment_count;
+  int fd;
+};
+
+static usize read_vectored(const int fd, iovec *segments, usize segment_count,
+                           u64 offset) {
+  usize total = 0;
+  while (segment_count > 0) {
+    const ssize_t bytes = preadv(fd, segments, static_cast<int>(segment_count),
+                                 static_cast<off_t>(offset));
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      break;
+    }
+
+    total += static_cast<usize>(bytes);
+    offset += static_cast<u64>(bytes);
+
+    usize consumed = static_cast<usize>(bytes);
+    while (segment_count > 0 && consumed >= segments->iov_len) {
+      consumed -= segments->iov_len;
+      ++segments;
+      --segment_count;
+    }
+    if (segment_count > 0) {
+      segments->iov_base = static_cast<u8 *>(segments->iov_base) + consumed;
+      segments->iov_len -= consumed;
+    }
+  }
+  return total;
+}
+
+static void advise_will_need(const int fd, const u64 offset, const u64 size) {
+#if defined(POSIX_FADV_WILLNEED)
+  posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(size),
+                POSIX_FADV_WILLNEED);
+#elif EDGE_PLATFORM_MACOS
+  radvisory advisory = {};
+  advisory.ra_offset = static_cast<off_t>(offset);
+  advisory.ra_count = static_cast<int>(size > INT32_MAX ? INT32_MAX : size);
+  fcntl(fd, F_RDADVISE, &advisory);
+#endif
+}
+
+usize read_batch(const NotNull<const Allocator *> alloc,
+                 Span<ReadRequest> requests, Arena *arena) {
+  const usize count = requests.size();
+  if (count == 0) {
+    return 0;
+  }
+
+  const usize fd_capacity =
+      count < READ_BATCH_MAX_OPEN ? count : READ_BATCH_MAX_OPEN;
+  auto *entries = static_cast<ReadBatchEntry *>(
+      alloc->malloc(sizeof(ReadBatchEntry) * count, alignof(ReadBatchEntry)));
+  auto *runs = static_cast<ReadBatchRun *>(
+      alloc->malloc(sizeof(ReadBatchRun) * count, alignof(ReadBatchRun)));
+  auto *segments = static_cast<iovec *>(
+      alloc->malloc(sizeof(iovec) * count * 2, alignof(iovec)));
+  auto *fds =
+      static_cast<int *>(alloc->malloc(sizeof(int) * fd_capacity, alignof(int)));
+  u8 *gap = static_cast<u8 *>(alloc->malloc(READ_BATCH_MAX_GAP, 16));
+  if (!entries || !runs || !segments || !fds || !gap) {
+    alloc->free(entries);
+    alloc->free(runs);
+    alloc->free(segments);
+    alloc->free(fds);
+    alloc->free(gap);
+    return 0;
+  }
+
+  for (usize i = 0; i < count; ++i) {
+    requests[i].bytes_read = 0;
+    requests[i].status = ReadStatus::Pending;
+    entries[i] = {0, 0, requests[i].offset, static_cast<u32>(i), -1};
+  }
+
+  // NOTE: Grouping by path opens every file once. A failed sort only costs
+  // duplicate opens.
+  sort_merge(alloc, Span<ReadBatchEntry>{entries, count},
+             [requests](const ReadBatchEntry &a, const ReadBatchEntry &b) {
+               return requests[a.request].path.compare(
+                          requests[b.request].path) < 0;
+             });
+
+  // NOTE: Files are taken in path order windows of at most fd_capacity open
+  // descriptors, each window is read and closed before the next one opens.
+  // Physical ordering only applies within a window.
+  for (usize window = 0; window < count;) {
+    usize fd_count = 0;
+    usize entry_count = 0;
+    u64 file_size = 0;
+    ReadBatchEntry file = {0, 0, 0, 0, -1};
+    usize i = window;
+    for (; i < count; ++i) {
+      ReadBatchEntry entry = entries[i];
+      ReadRequest &request = requests[entry.request];
+
+      if (i == window || request.path != requests[file.request].path) {
+        if (fd_count == fd_capacity) {
+          break;
+        }
+        file = {0, 0, 0, entry.request, -1};
+
+        char native_path[NATIVE_PATH_CAPACITY];
+        struct stat st;
+        if (to_native_path(request.path, native_path, sizeof(native_path))) {
+          file.fd = ::open(native_path, O_RDONLY | O_CLOEXEC);
+        }
+        // NOTE: Out of descriptors under a tighter limit, the file is retried
+        // once this window has closed its own.
+        if (file.fd < 0 && fd_count > 0 &&
+            (errno == EMFILE || errno == ENFILE)) {
+          break;
+        }
+        if (file.fd >= 0 && fstat(file.fd, &st) != 0) {
+          ::close(file.fd);
+          file.fd = -1;
+        }
+        if (file.fd >= 0) {
+          fds[fd_count++] = file.fd;
+          file.device = static_cast<u64>(st.st_dev);
+          file.inode = static_cast<u64>(st.st_ino);
+          file_size = static_cast<u64>(st.st_size);
+        }
+      }
+
+      if (file.fd < 0) {
+        request.status = ReadStatus::OpenFailed;
+        continue;
+      }
+      if (request.offset >= file_size) {
+        request.status = ReadStatus::OutOfRange;
+        continue;
+      }
+      if (request.size == 0) {
+        request.size = static_cast<usize>(file_size - request.offset);
+      }
+      if (!request.buffer && arena) {
+        request.buffer = arena->alloc(request.size);
+      }
+      if (!request.buffer) {
+        request.status = ReadStatus::NoBuffer;
+        continue;
+      }
+
+      entry.device = file.device;
+      entry.inode = file.inode;
+      entry.fd = file.fd;
+      entries[window + entry_count++] = entry;
+    }
+
+    ReadBatchEntry *batch = entries + window;
+    window = i;
+
+    // NOTE: Physical order, hard links to one inode land next to each other.
+    sort_merge(alloc, Span<ReadBatchEntry>{batch, entry_count},
+               [](const ReadBatchEntry &a, const ReadBatchEntry &b) {
+                 if (a.device != b.device) {
+                   return a.device < b.device;
+                 }
+                 if (a.inode != b.inode) {
+                   return a.inode < b.inode;
+                 }
+                 return a.offset < b.offset;
+               });
+
+    usize run_count = 0;
+    usize segment_count = 0;
+    for (usize j = 0; j < entry_count;) {
+      const ReadBatchEntry &first = batch[j];
+      ReadBatchRun &run = runs[run_count++];
+      run = {first.offset, first.offset, static_cast<u32>(j), 0,
+             static_cast<u32>(segment_count), 0, first.fd};
+
+      // NOTE: Overlapping ranges start a new run, one vectored read can not
+      // land the same bytes in two buffers.
+      for (; j < entry_count &&
+             run.segment_count + 2 <= READ_BATCH_MAX_SEGMENTS;
+           ++j) {
+        const ReadBatchEntry &entry = batch[j];
+        const ReadRequest &request = requests[entry.request];
+        if (run.entry_count > 0) {
+          if (entry.device != first.device || entry.inode != first.inode ||
+              entry.offset < run.end ||
+              entry.offset - run.end > READ_BATCH_MAX_GAP) {
+            break;
+          }
+          if (entry.offset > run.end) {
+            segments[segment_count++] = {
+                gap, static_cast<usize>(entry.offset - run.end)};
+            ++run.segment_count;
+          }
+        }
+
+        segments[segment_count++] = {request.buffer, request.size};
+        ++run.segment_count;
+        ++run.entry_count;
+        run.end = entry.offset + request.size;
+      }
+    }
+
+    // NOTE: Readahead for the whole window is queued before the first
+    // blocking read, so the device sees every range at once.
+    for (usize j = 0; j < run_count; ++j) {
+      advise_will_need(runs[j].fd, runs[j].offset,
+                       runs[j].end - runs[j].offset);
+    }
+
+    for (usize j = 0; j < run_count; ++j) {
+      const ReadBatchRun &run = runs[j];
+      const usize total = read_vectored(run.fd, segments + run.first_segment,
+                                        run.segment_count, run.offset);
+
+      for (u32 k = 0; k < run.entry_count; ++k) {
+        const ReadBatchEntry &entry = batch[run.first_entry + k];
+        ReadRequest &request = requests[entry.request];
+        const usize position = static_cast<usize>(entry.offset - run.offset);
+        if (total > position) {
+          request.bytes_read =
+              total - position < request.size ? total - position : request.size;
+        }
+        request.status = request.bytes_read == request.size
+                             ? ReadStatus::Completed
+                             : ReadStatus::ShortRead;
+      }
+    }
+
+    for (usize j = 0; j < fd_count; ++j) {
+      ::close(fds[j]);
+    }
+  }
+
+  alloc->free(entries);
+  alloc->free(runs);
+  alloc->free(segments);
+  alloc->free(fds);
+  alloc->free(gap);
+
+  usize completed = 0;
+  for (const ReadRequest &request : requests) {
+    completed += request.completed() ? 1 : 0;
+  }
+  return completed;
+}
+
+#if EDGE_PLATFORM_LINUX || EDGE_PLATFORM_ANDROID
+struct LinuxDirent64 {
+  u64 d_ino;
+  i64 d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[1];
+};
+#endif
+
+static i64 stat_mtime(const struct stat &st) {
+#if EDGE_PLATFORM_MACOS
+  return static_cast<i64>(st.st_mtimespec.tv_sec) * 1000000000ll +
+         st.st_mtimespec.tv_nsec;
+#else
+  return static_cast<i64>(st.st_mtim.tv_sec) * 1000000000ll +
+         st.st_mtim.tv_nsec;
+#endif
+}
+
+static void emit_directory_entry(const int fd, const char *name,
+                                 const unsigned char type, const bool metadata,
+                                 void (*fn)(const WalkEntry &, void *),
+                                 void *user_data) {
+  if (name[0] == '.' &&
+      (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+    return;
+  }
+
+  WalkEntry entry = {};
+  entry.path = StringView<char8_t>{reinterpret_cast<const char8_t *>(name),
+                                   strlen(name)};
+  entry.symlink = type == DT_LNK;
+  if (type == DT_DIR) {
+    entry.flags = EntryFlags{EntryFlag::Directory};
+  } else if (type == DT_REG) {
+    entry.flags = EntryFlags{EntryFlag::File};
+  }
+
+  // NOTE: The listing type is enough unless metadata is wanted, the entry is
+  // a link or the filesystem does not report types.
+  if (metadata || type == DT_LNK || type == DT_UNKNOWN) {
+    struct stat st;
+    if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+      return;
+    }
+    if (S_ISLNK(st.st_mode)) {
+      entry.symlink = true;
+      if (fstatat(fd, name, &st, 0) != 0) {
+        return;
+      }
+    }
+    entry.flags = S_ISDIR(st.st_mode)   ? EntryFlags{EntryFlag::Directory}
+                  : S_ISREG(st.st_mode) ? EntryFlags{EntryFlag::File}
+                                        : EntryFlags{};
+    entry.size = S_ISREG(st.st_mode) ? static_cast<u64>(st.st_size) : 0;
+    entry.mtime = stat_mtime(st);
+  }
+
+  if (entry.flags.any()) {
+    fn(entry, user_data);
+  }
+}
+
+bool read_directory(const StringView<char8_t> root,
+                    const StringView<char8_t> directory, const bool metadata,
+                    u8 *buffer, const usize buffer_size,
+                    void (*fn)(const WalkEntry &, void *), void *user_data) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!join_native_path(root, directory, native_path, sizeof(native_path))) {
+    return false;
+  }
+
+  const int fd = open(native_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+#if EDGE_PLATFORM_LINUX || EDGE_PLATFORM_ANDROID
+  // NOTE: Raw getdents64 fills the whole caller buffer per call, readdir
+  // would go through its own 32 KiB one.
+  for (;;) {
+    const long count = syscall(SYS_getdents64, fd, buffer, buffer_size);
+    if (count <= 0) {
+      break;
+    }
+    for (long position = 0; position < count;) {
+      const auto *record =
+          reinterpret_cast<const LinuxDirent64 *>(buffer + position);
+      position += record->d_reclen;
+      emit_directory_entry(fd, record->d_name, record->d_type, metadata, fn,
+                           user_data);
+    }
+  }
+  close(fd);
+#else
+  (void)buffer;
+  (void)buffer_size;
+  DIR *dir = fdopendir(fd);
+  if (!dir) {
+    close(fd);
+    return false;
+  }
+  while (const dirent *record = readdir(dir)) {
+    emit_directory_entry(fd, record->d_name, record->d_type, metadata, fn,
+                         user_data);
+  }
+  closedir(dir);
+#endif
+  return true;
+}
+
+#if EDGE_PLATFORM_LINUX || EDGE_PLATFORM_ANDROID
+constexpr usize WATCH_BUFFER_SIZE = 64 * 1024;
+constexpr u32 WATCH_EVENT_MASK = IN_CREATE | IN_DELETE | IN_MODIFY |
+                                 IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM |
+                                 IN_MOVED_TO | IN_ONLYDIR;
+
+struct InotifyDirectory {
+  // NOTE: Null terminated, the watched root joined with the relative path.
+  char8_t *path = nullptr;
+  usize length = 0;
+  bool recursive = false;
+};
+
+struct InotifyWatcher {
+  int fd = -1;
+  HashMap<i32, InotifyDirectory> directories = {};
+  alignas(inotify_event) u8 buffer[WATCH_BUFFER_SIZE];
+};
+
+static bool inotify_watch_directory(const NotNull<const Allocator *> alloc,
+                                    InotifyWatcher *watcher,
+                                    const StringView<char8_t> path,
+                                    const bool recursive) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return false;
+  }
+  const int wd = inotify_add_watch(watcher->fd, native_path, WATCH_EVENT_MASK);
+  if (wd < 0) {
+    return false;
+  }
+
+  // NOTE: The kernel hands out the same descriptor for a directory that is
+  // already watched.
+  if (watcher->directories.find(wd) != watcher->directories.end()) {
+    return true;
+  }
+  auto *copy = static_cast<char8_t *>(alloc->malloc(path.size() + 1, 1));
+  if (!copy) {
+    inotify_rm_watch(watcher->fd, wd);
+    return false;
+  }
+  memcpy(copy, path.data(), path.size());
+  copy[path.size()] = u8'\0';
+  const InotifyDirectory directory = {
+      .path = copy, .length = path.size(), .recursive = recursive};
+  if (watcher->directories.try_emplace(alloc, wd, directory).iterator ==
+      watcher->directories.end()) {
+    inotify_rm_watch(watcher->fd, wd);
+    alloc->free(copy);
+    return false;
+  }
+  return true;
+}
+
+// NOTE: Watches every directory below path. With a sink, files already in
+// there are reported as added, they may have been created before the watch
+// on their directory existed.
+static void inotify_watch_tree(
+    const NotNull<const Allocator *> alloc, InotifyWatcher *watcher,
+    const StringView<char8_t> path,
+    void (*fn)(StringView<char8_t>, WalkChange, void *), void *user_data) {
+  auto callback = WalkCallback::create(alloc, [&](const WalkEntry &entry) {
+    char8_t child[NATIVE_PATH_CAPACITY];
+    const usize length = path.size() + 1 + entry.path.size();
+    if (length >= sizeof(child)) {
+      return;
+    }
+    memcpy(child, path.data(), path.size());
+    child[path.size()] = u8'/';
+    memcpy(child + path.size() + 1, entry.path.data(), entry.path.size());
+
+    const StringView<char8_t> child_path = {child, length};
+    if (entry.flags.has(EntryFlag::Directory) && !entry.symlink) {
+      inotify_watch_directory(alloc, watcher, child_path, true);
+    }
+    if (fn) {
+      fn(child_path, WalkChange::Added, user_data);
+    }
+  });
+  walk(alloc, path, {}, callback);
+  callback.destroy(alloc);
+}
+
+static void inotify_unwatch_tree(const NotNull<const Allocator *> alloc,
+                                 InotifyWatcher *watcher,
+                                 const StringView<char8_t> path) {
+  // NOTE: Collected first, removal shifts the table.
+  Array<i32> stale = {};
+  for (const auto &entry : watcher->directories) {
+    const StringView<char8_t> watched = {entry.value.path, entry.value.length};
+    if (watched.starts_with(path) &&
+        (watched.size() == path.size() || watched[path.size()] == u8'/')) {
+      stale.push_back(alloc, entry.key);
+    }
+  }
+  for (const i32 wd : stale) {
+    InotifyDirectory directory = {};
+    if (watcher->directories.remove(alloc, wd, &directory)) {
+      inotify_rm_watch(watcher->fd, wd);
+      alloc->free(directory.path);
+    }
+  }
+  stale.destroy(alloc);
+}
+
+void *watch_native_create(const NotNull<const Allocator *> alloc) {
+  InotifyWatcher *watcher = alloc->allocate<InotifyWatcher>();
+  if (!watcher) {
+    return nullptr;
+  }
+  watcher->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (watcher->fd < 0 || !watcher->directories.create(alloc)) {
+    if (watcher->fd >= 0) {
+      close(watcher->fd);
+    }
+    alloc->deallocate(watcher);
+    return nullptr;
+  }
+  return watcher;
+}
+
+void watch_native_destroy(const NotNull<const Allocator *> alloc,
+                          void *native) {
+  auto *watcher = static_cast<InotifyWatcher *>(native);
+  for (const auto &entry : watcher->directories) {
+    alloc->free(entry.value.path);
+  }
+  watcher->directories.destroy(alloc);
+  close(watcher->fd);
+  alloc->deallocate(watcher);
+}
+
+bool watch_native_add(const NotNull<const Allocator *> alloc, void *native,
+                      const StringView<char8_t> directory,
+                      const bool recursive) {
+  auto *watcher = static_cast<InotifyWatcher *>(native);
+  StringView<char8_t> path = directory;
+  while (path.size() > 1 && is_separator(path.back())) {
+    path.remove_suffix(1);
+  }
+  if (!inotify_watch_directory(alloc, watcher, path, recursive)) {
+    return false;
+  }
+  if (recursive) {
+    inotify_watch_tree(alloc, watcher, path, nullptr, nullptr);
+  }
+  return true;
+}
+
+bool watch_native_read(const NotNull<const Allocator *> alloc, void *native,
+                       void (*fn)(StringView<char8_t>, WalkChange, void *),
+                       void *user_data) {
+  auto *watcher = static_cast<InotifyWatcher *>(native);
+  bool complete = true;
+
+  for (;;) {
+    const ssize_t count =
+        read(watcher->fd, watcher->buffer, sizeof(watcher->buffer));
+    if (count <= 0) {
+      break;
+    }
+
+    for (ssize_t position = 0; position < count;) {
+      const auto *event =
+          reinterpret_cast<const inotify_event *>(watcher->buffer + position);
+      position += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        complete = false;
+        continue;
+      }
+      if (event->mask & IN_IGNORED) {
+        InotifyDirectory directory = {};
+        if (watcher->directories.remove(alloc, event->wd, &directory)) {
+          alloc->free(directory.path);
+        }
+        continue;
+      }
+
+      const auto found = watcher->directories.find(event->wd);
+      if (found == watcher->directories.end() || event->len == 0) {
+        continue;
+      }
+
+      // NOTE: Copied out, watching a new subtree may grow the table.
+      const InotifyDirectory directory = found->value;
+      char8_t path[NATIVE_PATH_CAPACITY];
+      const usize name_length = strlen(event->name);
+      const usize length = directory.length + 1 + name_length;
+      if (length >= sizeof(path)) {
+        continue;
+      }
+      memcpy(path, directory.path, directory.length);
+      path[directory.length] = u8'/';
+      memcpy(path + directory.length + 1, event->name, name_length);
+      path[length] = u8'\0';
+      const StringView<char8_t> changed = {path, length};
+
+      if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+        fn(changed, WalkChange::Added, user_data);
+        if ((event->mask & IN_ISDIR) && directory.recursive &&
+            inotify_watch_directory(alloc, watcher, changed, true)) {
+          inotify_watch_tree(alloc, watcher, changed, fn, user_data);
+        }
+      } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        fn(changed, WalkChange::Removed, user_data);
+        if (event->mask & IN_ISDIR) {
+          inotify_unwatch_tree(alloc, watcher, changed);
+        }
+      } else if (!(event->mask & IN_ISDIR)) {
+        fn(changed, WalkChange::Modified, user_data);
+      }
+    }
+  }
+
+  return complete;
+}
+#else
+// NOTE: No kqueue or FSEvents backend yet, watchers fail to create.
+void *watch_native_create(const NotNull<const Allocator *> alloc) {
+  (void)alloc;
+  return nullptr;
+}
+
+void watch_native_destroy(const NotNull<const Allocator *> alloc,
+                          void *native) {
+  (void)alloc;
+  (void)native;
+}
+
+bool watch_native_add(const NotNull<const Allocator *> alloc, void *native,
+                      const StringView<char8_t> directory,
+                      const bool recursive) {
+  (void)alloc;
+  (void)native;
+  (void)directory;
+  (void)recursive;
+  return false;
+}
+
+bool watch_native_read(const NotNull<const Allocator *> alloc, void *native,
+                       void (*fn)(StringView<char8_t>, WalkChange, void *),
+                       void *user_data) {
+  (void)alloc;
+  (void)native;
+  (void)fn;
+  (void)user_data;
+  return true;
+}
+#endif
+
+IFile *open_native_file(const NotNull<const Allocator *> alloc,
+                        const StringView<char8_t> path,
+                        const AccessModeFlags flags) {
+  NativeFile *file = alloc->allocate<NativeFile>();
+  if (!file) {
+    return nullptr;
+  }
+  if (!file->open(path, flags)) {
+    alloc->deallocate(file);
+    return nullptr;
+  }
+  return file;
+}
+
+IFilesystem *create_native_filesystem(const NotNull<const Allocator *> alloc,
+                                      const StringView<char8_t> root) {
+  String root_copy = {};
+  if (!root_copy.from_utf8(alloc, root.data(), root.size())) {
+    return nullptr;
+  }
+
+  NativeFilesystem *filesystem = alloc->allocate<NativeFilesystem>(root_copy);
+  if (!filesystem) {
+    root_copy.destroy(alloc);
+    return nullptr;
+  }
+  if (!filesystem->create(alloc)) {
+    filesystem->destroy(alloc);
+    alloc->deallocate(filesystem);
+    return nullptr;
+  }
+  return filesystem;
+}
+
+bool file_exists(const StringView<char8_t> path) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return false;
+  }
+  return native_entry_flags(native_path).has(EntryFlag::File);
+}
+
+bool directory_exists(const StringView<char8_t> path) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return false;
+  }
+  return native_entry_flags(native_path).has(EntryFlag::Directory);
+}
+
+i64 file_size(const StringView<char8_t> path) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return -1;
+  }
+  struct stat st;
+  if (stat(native_path, &st) != 0) {
+    return -1;
+  }
+  return static_cast<i64>(st.st_size);
+}
+
+bool create_directory(const StringView<char8_t> path) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return false;
+  }
+  return mkdir(native_path, 0755) == 0 || errno == EEXIST;
+}
+
+bool create_directories(const StringView<char8_t> path) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return false;
+  }
+
+  // Walk the path from root to leaf, creating each component.
+  const usize length = path.size();
+  for (usize i = 1; i <= length; ++i) {
+    if (i != length && native_path[i] != '/') {
+      continue;
+    }
+    if (native_path[i - 1] == '/') {
+      continue;
+    }
+
+    const char saved = native_path[i];
+    native_path[i] = '\0';
+    const bool created = mkdir(native_path, 0755) == 0 || errno == EEXIST;
+    native_path[i] = saved;
+    if (!created) {
+      return false;
+    }
+  }
+
+  return native_entry_flags(native_path).has(EntryFlag::Directory);
+}
+
+bool remove_file(const StringView<char8_t> path) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return false;
+  }
+  return unlink(native_path) == 0;
+}
+
+bool remove_directory(const StringView<char8_t> path) {
+  char native_path[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(path, native_path, sizeof(native_path))) {
+    return false;
+  }
+  return rmdir(native_path) == 0;
+}
+
+bool rename_path(const StringView<char8_t> from, const StringView<char8_t> to) {
+  char native_from[NATIVE_PATH_CAPACITY], native_to[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(from, native_from, sizeof(native_from)) ||
+      !to_native_path(to, native_to, sizeof(native_to))) {
+    return false;
+  }
+  return rename(native_from, native_to) == 0;
+}
+
+bool copy_file(const StringView<char8_t> from, const StringView<char8_t> to) {
+  char native_from[NATIVE_PATH_CAPACITY], native_to[NATIVE_PATH_CAPACITY];
+  if (!to_native_path(from, native_from, sizeof(native_from)) ||
+      !to_native_path(to, native_to, sizeof(native_to))) {
+    return false;
+  }
+
+  const int source = ::open(native_from, O_RDONLY | O_CLOEXEC);
+  if (source < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(source, &st) != 0) {
+    ::close(source);
+    return false;
+  }
+
+  const int target = ::open(native_to, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                            st.st_mode & 0777);
+  if (target < 0) {
+    ::close(source);
+    return false;
+  }
+
+  u64 copied = 0;
+  const u64 total = static_cast<u64>(st.st_size);
+#if EDGE_PLATFORM_LINUX || EDGE_PLATFORM_ANDROID
+  // NOTE: In kernel copy, no round trip through user space buffers.
+  while (copied < total) {
+    const ssize_t bytes = sendfile(target, source, nullptr, total - copied);
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      break;
+    }
+    copied += static_cast<u64>(bytes);
+  }
+#endif
+
+  char buffer[64 * 1024];
+  while (copied < total) {
+    const ssize_t bytes = pread(source, buffer, sizeof(buffer),
+                                static_cast<off_t>(copied));
+    if (bytes < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes <= 0) {
+      break;
+    }
+    ssize_t written = 0;
+    while (written < bytes) {
+      const ssize_t result = pwrite(target, buffer + written,
+                                    static_cast<usize>(bytes - written),
+                                    static_cast<off_t>(copied + written));
+      if (result < 0 && errno == EINTR) {
+        continue;
+      }
+      if (result <= 0) {
+        break;
+      }
+      written += result;
+    }
+    if (written != bytes) {
+      break;
+    }
+    copied += static_cast<u64>(bytes);
+  }
+
+  ::close(source);
+  const bool closed = ::close(target) == 0;
+  return closed && copied == total;
+}
+} // namespace edge::filesystem
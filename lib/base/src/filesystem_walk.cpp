@@ -0,0 +1,458 @@
+#include "filesystem.hpp"
+
+#include "allocator.hpp"
+#include "scheduler.hpp"
+#include "threads.hpp"
+
+#include <cstring>
+
+namespace edge::filesystem {
+bool read_directory(StringView<char8_t> root, StringView<char8_t> directory,
+                    bool metadata, u8 *buffer, usize buffer_size,
+                    void (*fn)(const WalkEntry &, void *), void *user_data);
+
+constexpr usize WALK_LISTING_BUFFER_SIZE = 64 * 1024;
+constexpr usize WALK_PATH_CAPACITY = 4096;
+
+constexpr u32 WALK_SNAPSHOT_MAGIC = 0x4E535745; // "EWSN"
+constexpr u32 WALK_SNAPSHOT_VERSION = 1;
+constexpr usize WALK_SNAPSHOT_HEADER_SIZE = 16;
+constexpr usize WALK_SNAPSHOT_RECORD_SIZE = 24;
+
+struct WalkState {
+  const Allocator *alloc = nullptr;
+  StringView<char8_t> root = {};
+  const WalkFilter *filter = nullptr;
+  const WalkCallback *callback = nullptr;
+  WalkFlags flags = {};
+
+  // NOTE: Pending relative directory paths, null terminated. The counter
+  // covers queued and in flight directories, workers leave once it drains.
+  RwLock lock = {};
+  Array<char8_t *> directories = {};
+  std::atomic<usize> pending = 0;
+  std::atomic<bool> root_listed = false;
+};
+
+struct WalkWorker {
+  WalkState *state = nullptr;
+  StringView<char8_t> directory = {};
+  Array<char8_t *> found = {};
+  char8_t path[WALK_PATH_CAPACITY];
+};
+
+static void walk_visit(const WalkEntry &listed, void *user_data) {
+  auto *worker = static_cast<WalkWorker *>(user_data);
+  const WalkState *state = worker->state;
+
+  // NOTE: The listed directory is already at the front of the path buffer.
+  const usize prefix = worker->directory.size();
+  const usize length = prefix + (prefix != 0 ? 1 : 0) + listed.path.size();
+  if (length >= WALK_PATH_CAPACITY) {
+    return;
+  }
+  char8_t *cursor = worker->path + prefix;
+  if (prefix != 0) {
+    *cursor++ = u8'/';
+  }
+  memcpy(cursor, listed.path.data(), listed.path.size());
+  worker->path[length] = u8'\0';
+
+  WalkEntry entry = listed;
+  entry.path = StringView<char8_t>{worker->path, length};
+  if (state->filter->is_valid() && !state->filter->invoke(entry)) {
+    return;
+  }
+  if (state->callback->is_valid()) {
+    state->callback->invoke(entry);
+  }
+
+  if (!entry.flags.has(EntryFlag::Directory) || entry.symlink ||
+      !state->flags.has(WalkFlag::Recursive)) {
+    return;
+  }
+
+  auto *copy = static_cast<char8_t *>(state->alloc->malloc(length + 1, 1));
+  if (!copy) {
+    return;
+  }
+  memcpy(copy, worker->path, length + 1);
+  if (!worker->found.push_back(state->alloc, copy)) {
+    state->alloc->free(copy);
+  }
+}
+
+static void walk_worker_run(WalkState *state) {
+  const NotNull<const Allocator *> alloc = state->alloc;
+  u8 *buffer = static_cast<u8 *>(alloc->malloc(WALK_LISTING_BUFFER_SIZE, 16));
+  if (!buffer) {
+    return;
+  }
+
+  WalkWorker worker = {};
+  worker.state = state;
+
+  for (;;) {
+    char8_t *directory = nullptr;
+    rwlock_lock(&state->lock);
+    if (!state->directories.empty()) {
+      state->directories.pop_back(&directory);
+    }
+    rwlock_unlock(&state->lock);
+
+    if (!directory) {
+      if (state->pending.load(std::memory_order_acquire) == 0) {
+        break;
+      }
+      if (job_current() && is_running_in_job()) {
+        job_yield();
+      } else {
+        thread_yield();
+      }
+      continue;
+    }
+
+    usize length = 0;
+    while (directory[length] != u8'\0') {
+      ++length;
+    }
+    memcpy(worker.path, directory, length);
+    worker.directory = StringView<char8_t>{directory, length};
+
+    const bool listed = read_directory(
+        state->root, worker.directory, state->flags.has(WalkFlag::Metadata),
+        buffer, WALK_LISTING_BUFFER_SIZE, walk_visit, &worker);
+    if (listed && length == 0) {
+      state->root_listed.store(true, std::memory_order_relaxed);
+    }
+
+    // NOTE: New work is published before the finished directory is counted
+    // off, so the counter never drains while subtrees remain.
+    if (!worker.found.empty()) {
+      usize queued = 0;
+      rwlock_lock(&state->lock);
+      for (char8_t *found : worker.found) {
+        if (state->directories.push_back(alloc, found)) {
+          ++queued;
+        } else {
+          alloc->free(found);
+        }
+      }
+      state->pending.fetch_add(queued, std::memory_order_relaxed);
+      rwlock_unlock(&state->lock);
+      worker.found.clear();
+    }
+
+    alloc->free(directory);
+    state->pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  worker.found.destroy(alloc);
+  alloc->free(buffer);
+}
+
+bool walk(const NotNull<const Allocator *> alloc,
+          const StringView<char8_t> root, const WalkFilter &filter,
+          const WalkCallback &callback, const WalkFlags flags,
+          Scheduler *sched) {
+  WalkState state = {};
+  state.alloc = alloc.m_ptr;
+  state.root = root.empty() ? StringView<char8_t>{u8"."} : root;
+  state.filter = &filter;
+  state.callback = &callback;
+  state.flags = flags;
+
+  auto *top = static_cast<char8_t *>(alloc->malloc(1, 1));
+  if (!top) {
+    return false;
+  }
+  top[0] = u8'\0';
+  if (!state.directories.push_back(alloc, top)) {
+    alloc->free(top);
+    return false;
+  }
+  state.pending.store(1, std::memory_order_relaxed);
+
+  u32 task_count = 1;
+  if (sched && flags.has(WalkFlag::Recursive)) {
+    const usize workers = sched->background_threads.size() + 1;
+    task_count = static_cast<u32>(workers < JOB_PARALLEL_FOR_MAX_TASKS
+                                      ? workers
+                                      : JOB_PARALLEL_FOR_MAX_TASKS);
+  }
+  if (task_count > 1) {
+    job_parallel_for(alloc, sched, task_count,
+                     [&state](u32) { walk_worker_run(&state); });
+  } else {
+    walk_worker_run(&state);
+  }
+
+  // NOTE: Only left over when no worker could get a listing buffer.
+  for (char8_t *directory : state.directories) {
+    alloc->free(directory);
+  }
+  state.directories.destroy(alloc);
+
+  return state.root_listed.load(std::memory_order_relaxed);
+}
+
+struct SnapshotCollector {
+  WalkSnapshot *snapshot = nullptr;
+  const Allocator *alloc = nullptr;
+  RwLock lock = {};
+  bool failed = false;
+};
+
+static bool snapshot_insert(WalkSnapshot *snapshot,
+                            const NotNull<const Allocator *> alloc,
+                            const StringView<char8_t> path,
+                            const WalkSnapshotEntry &value) {
+  auto *name = static_cast<char8_t *>(snapshot->m_names.alloc_ex(
+      path.size() > 0 ? path.size() : 1, 1));
+  if (!name) {
+    return false;
+  }
+  memcpy(name, path.data(), path.size());
+  const auto [it, inserted] = snapshot->m_entries.try_emplace(
+      alloc, StringView<char8_t>{name, path.size()}, value);
+  return it != snapshot->m_entries.end();
+}
+
+static bool snapshot_collect(WalkSnapshot *snapshot,
+                             const NotNull<const Allocator *> alloc,
+                             const StringView<char8_t> root,
+                             const WalkFilter &filter, Scheduler *sched) {
+  SnapshotCollector collector = {};
+  collector.snapshot = snapshot;
+  collector.alloc = alloc.m_ptr;
+
+  WalkCallback callback =
+      WalkCallback::create(alloc, [&collector](const WalkEntry &entry) {
+        const WalkSnapshotEntry value = {
+            .size = entry.size, .mtime = entry.mtime, .flags = entry.flags};
+        rwlock_lock(&collector.lock);
+        if (!snapshot_insert(collector.snapshot, collector.alloc, entry.path,
+                             value)) {
+          collector.failed = true;
+        }
+        rwlock_unlock(&collector.lock);
+      });
+
+  const bool walked =
+      walk(alloc, root, filter, callback,
+           WalkFlags{WalkFlag::Recursive} | WalkFlag::Metadata, sched);
+  callback.destroy(alloc);
+  return walked && !collector.failed;
+}
+
+static WalkEntry snapshot_walk_entry(const StringView<char8_t> path,
+                                     const WalkSnapshotEntry &value) {
+  WalkEntry entry = {};
+  entry.path = path;
+  entry.flags = value.flags;
+  entry.size = value.size;
+  entry.mtime = value.mtime;
+  return entry;
+}
+
+bool WalkSnapshot::create(const NotNull<const Allocator *> alloc) {
+  if (!m_entries.create(alloc)) {
+    return false;
+  }
+  if (!m_names.create()) {
+    m_entries.destroy(alloc);
+    return false;
+  }
+  return true;
+}
+
+void WalkSnapshot::destroy(const NotNull<const Allocator *> alloc) {
+  m_entries.destroy(alloc);
+  m_names.destroy();
+}
+
+bool WalkSnapshot::capture(const NotNull<const Allocator *> alloc,
+                           const StringView<char8_t> root,
+                           const WalkFilter &filter, Scheduler *sched) {
+  WalkSnapshot next = {};
+  if (!next.create(alloc)) {
+    return false;
+  }
+  if (!snapshot_collect(&next, alloc, root, filter, sched)) {
+    next.destroy(alloc);
+    return false;
+  }
+
+  destroy(alloc);
+  *this = next;
+  return true;
+}
+
+bool WalkSnapshot::rescan(const NotNull<const Allocator *> alloc,
+                          const StringView<char8_t> root,
+                          const WalkChangeCallback &callback,
+                          const WalkFilter &filter, Scheduler *sched) {
+  // NOTE: Trees rarely change much between scans, the previous size is a
+  // good estimate that saves the rehashes while collecting.
+  WalkSnapshot next = {};
+  if (!next.create(alloc) || !next.m_entries.reserve(alloc, size())) {
+    next.destroy(alloc);
+    return false;
+  }
+  if (!snapshot_collect(&next, alloc, root, filter, sched)) {
+    next.destroy(alloc);
+    return false;
+  }
+
+  // NOTE: Changes are reported from the calling thread once the walk is
+  // done, in no particular order.
+  if (callback.is_valid()) {
+    for (const auto &entry : next.m_entries) {
+      const WalkSnapshotEntry &value = entry.value;
+      const WalkSnapshotEntry *previous = find(entry.key);
+      if (!previous) {
+        callback.invoke(WalkChange::Added,
+                        snapshot_walk_entry(entry.key, value));
+      } else if (value.flags.value() != previous->flags.value() ||
+                 (value.flags.has(EntryFlag::File) &&
+                  (value.size != previous->size ||
+                   value.mtime != previous->mtime))) {
+        callback.invoke(WalkChange::Modified,
+                        snapshot_walk_entry(entry.key, value));
+      }
+    }
+    for (const auto &entry : m_entries) {
+      if (!next.find(entry.key)) {
+        callback.invoke(WalkChange::Removed,
+                        snapshot_walk_entry(entry.key, entry.value));
+      }
+    }
+  }
+
+  destroy(alloc);
+  *this = next;
+  return true;
+}
+
+// NOTE: Native byte order, a header followed by fixed records each trailed by
+// its path bytes.
+bool WalkSnapshot::save(const NotNull<const Allocator *> alloc,
+                        const StringView<char8_t> path) const {
+  usize total_size = WALK_SNAPSHOT_HEADER_SIZE;
+  for (const auto &entry : m_entries) {
+    total_size += WALK_SNAPSHOT_RECORD_SIZE + entry.key.size();
+  }
+
+  u8 *data = static_cast<u8 *>(alloc->malloc(total_size, 16));
+  if (!data) {
+    return false;
+  }
+
+  const u64 count = m_entries.size();
+  memcpy(data, &WALK_SNAPSHOT_MAGIC, 4);
+  memcpy(data + 4, &WALK_SNAPSHOT_VERSION, 4);
+  memcpy(data + 8, &count, 8);
+
+  u8 *cursor = data + WALK_SNAPSHOT_HEADER_SIZE;
+  for (const auto &entry : m_entries) {
+    const StringView<char8_t> name = entry.key;
+    const WalkSnapshotEntry &value = entry.value;
+    const u32 flags = value.flags.value();
+    const u32 length = static_cast<u32>(name.size());
+    memcpy(cursor, &value.size, 8);
+    memcpy(cursor + 8, &value.mtime, 8);
+    memcpy(cursor + 16, &flags, 4);
+    memcpy(cursor + 20, &length, 4);
+    memcpy(cursor + WALK_SNAPSHOT_RECORD_SIZE, name.data(), name.size());
+    cursor += WALK_SNAPSHOT_RECORD_SIZE + name.size();
+  }
+
+  bool saved = false;
+  if (IFile *file = open_native_file(alloc, path,
+                                     AccessModeFlags{AccessMode::Write} |
+                                         AccessMode::Create |
+                                         AccessMode::Truncate)) {
+    saved = file->write_at(0, data, total_size) == total_size;
+    alloc->deallocate(file);
+  }
+  alloc->free(data);
+  return saved;
+}
+
+bool WalkSnapshot::load(const NotNull<const Allocator *> alloc,
+                        const StringView<char8_t> path) {
+  IFile *file =
+      open_native_file(alloc, path, AccessModeFlags{AccessMode::Read});
+  if (!file) {
+    return false;
+  }
+
+  const usize total_size = static_cast<usize>(file->size());
+  u8 *data = total_size >= WALK_SNAPSHOT_HEADER_SIZE
+                 ? static_cast<u8 *>(alloc->malloc(total_size, 16))
+                 : nullptr;
+  const bool read =
+      data && file->read_at(0, data, total_size) == total_size;
+  alloc->deallocate(file);
+  if (!read) {
+    alloc->free(data);
+    return false;
+  }
+
+  WalkSnapshot next = {};
+  bool valid = next.create(alloc);
+
+  u32 magic = 0;
+  u32 version = 0;
+  u64 count = 0;
+  memcpy(&magic, data, 4);
+  memcpy(&version, data + 4, 4);
+  memcpy(&count, data + 8, 8);
+  valid = valid && magic == WALK_SNAPSHOT_MAGIC &&
+          version == WALK_SNAPSHOT_VERSION;
+
+  usize offset = WALK_SNAPSHOT_HEADER_SIZE;
+  for (u64 i = 0; valid && i < count; ++i) {
+    if (total_size - offset < WALK_SNAPSHOT_RECORD_SIZE) {
+      valid = false;
+      break;
+    }
+    WalkSnapshotEntry value = {};
+    u32 flags = 0;
+    u32 length = 0;
+    memcpy(&value.size, data + offset, 8);
+    memcpy(&value.mtime, data + offset + 8, 8);
+    memcpy(&flags, data + offset + 16, 4);
+    memcpy(&length, data + offset + 20, 4);
+    value.flags = EntryFlags{flags};
+    offset += WALK_SNAPSHOT_RECORD_SIZE;
+
+    if (total_size - offset < length) {
+      valid = false;
+      break;
+    }
+    valid = snapshot_insert(
+        &next, alloc,
+        StringView<char8_t>{reinterpret_cast<const char8_t *>(data + offset),
+                            length},
+        value);
+    offset += length;
+  }
+  alloc->free(data);
+
+  if (!valid) {
+    next.destroy(alloc);
+    return false;
+  }
+
+  destroy(alloc);
+  *this = next;
+  return true;
+}
+
+const WalkSnapshotEntry *
+WalkSnapshot::find(const StringView<char8_t> path) const {
+  const auto it = m_entries.find(path);
+  return it == m_entries.end() ? nullptr : &it->value;
+}
+} // namespace edge::filesystem
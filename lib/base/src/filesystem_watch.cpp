@@ -0,0 +1,150 @@
+#include "filesystem.hpp"
+
+#include "allocator.hpp"
+
+#include <chrono>
+#include <cstring>
+
+namespace edge::filesystem {
+void *watch_native_create(NotNull<const Allocator *> alloc);
+void watch_native_destroy(NotNull<const Allocator *> alloc, void *native);
+bool watch_native_add(NotNull<const Allocator *> alloc, void *native,
+                      StringView<char8_t> directory, bool recursive);
+bool watch_native_read(NotNull<const Allocator *> alloc, void *native,
+                       void (*fn)(StringView<char8_t>, WalkChange, void *),
+                       void *user_data);
+
+struct WatchCollector {
+  Watcher *watcher = nullptr;
+  const Allocator *alloc = nullptr;
+  i64 now = 0;
+};
+
+static i64 watch_now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void watch_erase(Watcher *watcher, const NotNull<const Allocator *> alloc,
+                        const StringView<char8_t> path) {
+  const auto it = watcher->m_pending.find(path);
+  if (it == watcher->m_pending.end()) {
+    return;
+  }
+  char8_t *name = const_cast<char8_t *>(it->key.data());
+  watcher->m_pending.remove(alloc, path);
+  alloc->free(name);
+}
+
+// NOTE: Folds a new event into what is already pending for the path. A file
+// that appears and disappears within one window never surfaces, one that is
+// replaced surfaces as modified.
+static void watch_collect(const StringView<char8_t> path,
+                          const WalkChange change, void *user_data) {
+  auto *collector = static_cast<WatchCollector *>(user_data);
+  Watcher *watcher = collector->watcher;
+  const NotNull<const Allocator *> alloc = collector->alloc;
+
+  const auto it = watcher->m_pending.find(path);
+  if (it != watcher->m_pending.end()) {
+    WatchPending &pending = it->value;
+    pending.last_event = collector->now;
+    if (pending.change == WalkChange::Added && change == WalkChange::Removed) {
+      watch_erase(watcher, alloc, path);
+    } else if (pending.change == WalkChange::Removed &&
+               change == WalkChange::Added) {
+      pending.change = WalkChange::Modified;
+    } else if (pending.change != WalkChange::Added) {
+      pending.change = change;
+    }
+    return;
+  }
+
+  auto *name =
+      static_cast<char8_t *>(alloc->malloc(path.size() > 0 ? path.size() : 1, 1));
+  if (!name) {
+    return;
+  }
+  memcpy(name, path.data(), path.size());
+  const WatchPending pending = {.change = change,
+                                .last_event = collector->now};
+  const auto [inserted, created] = watcher->m_pending.try_emplace(
+      alloc, StringView<char8_t>{name, path.size()}, pending);
+  if (inserted == watcher->m_pending.end()) {
+    alloc->free(name);
+  }
+}
+
+static void watch_release_batch(Watcher *watcher,
+                                const NotNull<const Allocator *> alloc) {
+  for (const WatchEvent &event : watcher->m_batch) {
+    alloc->free(const_cast<char8_t *>(event.path.data()));
+  }
+  watcher->m_batch.clear();
+}
+
+bool Watcher::create(const NotNull<const Allocator *> alloc,
+                     const u32 settle_ms) {
+  m_settle_time = static_cast<i64>(settle_ms) * 1000000ll;
+  if (!m_pending.create(alloc)) {
+    return false;
+  }
+  m_native = watch_native_create(alloc);
+  if (!m_native) {
+    m_pending.destroy(alloc);
+    return false;
+  }
+  return true;
+}
+
+void Watcher::destroy(const NotNull<const Allocator *> alloc) {
+  if (m_native) {
+    watch_native_destroy(alloc, m_native);
+    m_native = nullptr;
+  }
+
+  watch_release_batch(this, alloc);
+  m_batch.destroy(alloc);
+  for (const auto &entry : m_pending) {
+    alloc->free(const_cast<char8_t *>(entry.key.data()));
+  }
+  m_pending.destroy(alloc);
+}
+
+bool Watcher::add(const NotNull<const Allocator *> alloc,
+                  const StringView<char8_t> directory, const bool recursive) {
+  return m_native && watch_native_add(alloc, m_native, directory, recursive);
+}
+
+Span<const WatchEvent> Watcher::poll(const NotNull<const Allocator *> alloc) {
+  watch_release_batch(this, alloc);
+  if (!m_native) {
+    return {};
+  }
+
+  WatchCollector collector = {};
+  collector.watcher = this;
+  collector.alloc = alloc.m_ptr;
+  collector.now = watch_now();
+  m_overflowed =
+      !watch_native_read(alloc, m_native, watch_collect, &collector);
+
+  // NOTE: Settled entries move into the batch together with their names,
+  // removal shifts the table so they are taken out afterwards.
+  for (const auto &entry : m_pending) {
+    if (collector.now - entry.value.last_event >= m_settle_time) {
+      const WatchEvent event = {.path = entry.key,
+                                .change = entry.value.change};
+      if (!m_batch.push_back(alloc, event)) {
+        break;
+      }
+    }
+  }
+  for (const WatchEvent &event : m_batch) {
+    m_pending.remove(alloc, event.path);
+  }
+
+  return Span<const WatchEvent>{m_batch.data(), m_batch.size()};
+}
+} // namespace edge::filesystem
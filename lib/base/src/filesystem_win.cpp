@@ -1,6 +1,8 @@
 #include "filesystem.hpp"
 
 #include "allocator.hpp"
+#include "arena.hpp"
+#include "sort.hpp"
 
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
@@ -77,8 +79,63 @@ String get_system_cached_path(const NotNull<const Allocator *> alloc) {
   return String{alloc, utf8_buffer, utf_len};
 }
 
+static bool join_wide_path(const StringView<char8_t> root,
+                           const StringView<char8_t> path, wchar_t *out,
+                           const usize out_cap) {
+  if (root.empty() || is_absolute(path)) {
+    return utf8_to_wide(path, out, out_cap) != 0;
+  }
+
+  const usize root_length = utf8_to_wide(root, out, out_cap);
+  if (root_length == 0 || path.empty()) {
+    return root_length != 0;
+  }
+
+  usize length = root_length;
+  if (out[length - 1] != L'/' && out[length - 1] != L'\\') {
+    if (length + 1 >= out_cap) {
+      return false;
+    }
+    out[length++] = L'\\';
+  }
+  return utf8_to_wide(path, out + length, out_cap - length) != 0;
+}
+
+static EntryFlags wide_entry_flags(const wchar_t *path) {
+  const DWORD attr = GetFileAttributesW(path);
+  if (attr == INVALID_FILE_ATTRIBUTES) {
+    return EntryFlags{};
+  }
+  return (attr & FILE_ATTRIBUTE_DIRECTORY) ? EntryFlags{EntryFlag::Directory}
+                                           : EntryFlags{EntryFlag::File};
+}
+
+static usize read_handle_at(const HANDLE handle, const u64 offset,
+                            void *buffer_out, const usize size) {
+  u8 *cursor = static_cast<u8 *>(buffer_out);
+  usize total = 0;
+  while (total < size) {
+    const u64 position = offset + total;
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(position);
+    overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+    const DWORD chunk = static_cast<DWORD>(
+        size - total > 0x40000000u ? 0x40000000u : size - total);
+    DWORD bytes_read = 0;
+    if (!ReadFile(handle, cursor + total, chunk, &bytes_read, &overlapped) ||
+        bytes_read == 0) {
+      break;
+    }
+    total += bytes_read;
+  }
+  return total;
+}
+
 class NativeFile final : public IFile {
 public:
+  ~NativeFile() override { close(); }
+
   bool open(const StringView<char8_t> path,
             const AccessModeFlags flags) override {
     if (is_open()) {
@@ -89,6 +146,13 @@ public:
     if (!utf8_to_wide(path, wpath, 1024)) {
       return false;
     }
+    return open_wide(wpath, flags);
+  }
+
+  bool open_wide(const wchar_t *wpath, const AccessModeFlags flags) {
+    if (is_open()) {
+      return false;
+    }
 
     DWORD desired_access = 0;
     DWORD creation = OPEN_EXISTING;
@@ -111,9 +175,30 @@ public:
       creation = TRUNCATE_EXISTING;
     }
 
+    DWORD attributes = FILE_ATTRIBUTE_NORMAL;
+    if (flags.has(AccessMode::SequentialScan)) {
+      attributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+    } else if (flags.has(AccessMode::RandomAccess)) {
+      attributes |= FILE_FLAG_RANDOM_ACCESS;
+    }
+    if (flags.has(AccessMode::Unbuffered)) {
+      attributes |= FILE_FLAG_NO_BUFFERING;
+    }
+
     m_handle = CreateFileW(wpath, desired_access, share, nullptr, creation,
-                           FILE_ATTRIBUTE_NORMAL, nullptr);
-    if (!m_handle) {
+                           attributes, nullptr);
+    // NOTE: Some network and virtual filesystems reject FILE_FLAG_NO_BUFFERING,
+    // the request is a hint so it degrades to buffered IO.
+    if (m_handle == INVALID_HANDLE_VALUE &&
+        flags.has(AccessMode::Unbuffered)) {
+      const DWORD error = GetLastError();
+      if (error == ERROR_INVALID_PARAMETER || error == ERROR_NOT_SUPPORTED) {
+        m_handle =
+            CreateFileW(wpath, desired_access, share, nullptr, creation,
+                        attributes & ~FILE_FLAG_NO_BUFFERING, nullptr);
+      }
+    }
+    if (m_handle == INVALID_HANDLE_VALUE) {
       return false;
     }
 
@@ -135,7 +220,7 @@ public:
 
   usize seek(const isize offset, const StreamOrigin origin) override {
     if (!is_open()) {
-      return false;
+      return SIZE_MAX;
     }
 
     DWORD method = FILE_BEGIN;
@@ -150,10 +235,13 @@ public:
       break;
     }
 
-    LARGE_INTEGER li;
-    li.QuadPart = offset;
-    li.LowPart = SetFilePointer(m_handle, li.LowPart, &li.HighPart, method);
-    return li.LowPart != INVALID_SET_FILE_POINTER || GetLastError() == NO_ERROR;
+    LARGE_INTEGER distance;
+    distance.QuadPart = offset;
+    LARGE_INTEGER position;
+    if (!SetFilePointerEx(m_handle, distance, &position, method)) {
+      return SIZE_MAX;
+    }
+    return static_cast<usize>(position.QuadPart);
   }
 
   usize tell() override {
@@ -170,6 +258,14 @@ public:
     return pos.QuadPart;
   }
 
+  u64 size() const override {
+    LARGE_INTEGER size;
+    if (!is_open() || !GetFileSizeEx(m_handle, &size)) {
+      return 0;
+    }
+    return static_cast<u64>(size.QuadPart);
+  }
+
   usize read(void *buffer_out, const usize element_size,
              const usize element_count) const override {
     if (!is_open() || !buffer_out || element_size == 0 || element_count == 0) {
@@ -200,6 +296,43 @@ public:
     return bytes_written;
   }
 
+  // NOTE: Synchronous handles still move the file pointer after an
+  // OVERLAPPED offset read, only the stream position is affected.
+  usize read_at(const u64 offset, void *buffer_out,
+                const usize size) const override {
+    if (!is_open() || !buffer_out || size == 0) {
+      return 0;
+    }
+    return read_handle_at(m_handle, offset, buffer_out, size);
+  }
+
+  usize write_at(const u64 offset, const void *buffer_in,
+                 const usize size) const override {
+    if (!is_open() || !buffer_in || size == 0) {
+      return 0;
+    }
+
+    const u8 *cursor = static_cast<const u8 *>(buffer_in);
+    usize total = 0;
+    while (total < size) {
+      const u64 position = offset + total;
+      OVERLAPPED overlapped = {};
+      overlapped.Offset = static_cast<DWORD>(position);
+      overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+      const DWORD chunk = static_cast<DWORD>(
+          size - total > 0x40000000u ? 0x40000000u : size - total);
+      DWORD bytes_written = 0;
+      if (!WriteFile(m_handle, cursor + total, chunk, &bytes_written,
+                     &overlapped) ||
+          bytes_written == 0) {
+        break;
+      }
+      total += bytes_written;
+    }
+    return total;
+  }
+
   bool flush() override {
     if (!is_open()) {
       return false;
@@ -211,6 +344,574 @@ private:
   HANDLE m_handle = INVALID_HANDLE_VALUE;
 };
 
+class NativeFilesystem final : public IFilesystem {
+public:
+  explicit NativeFilesystem(const String &root) : m_root(root) {}
+
+  bool create(NotNull<const Allocator *>) override { return true; }
+
+  void destroy(const NotNull<const Allocator *> alloc) override {
+    m_root.destroy(alloc);
+  }
+
+  bool create_directory(const StringView<char8_t> path) override {
+    wchar_t wpath[1024];
+    if (!join_wide_path(m_root, path, wpath, 1024)) {
+      return false;
+    }
+    return CreateDirectoryW(wpath, nullptr) != 0 ||
+           (GetLastError() == ERROR_ALREADY_EXISTS &&
+            wide_entry_flags(wpath).has(EntryFlag::Directory));
+  }
+
+  bool remove(const StringView<char8_t> path) override {
+    wchar_t wpath[1024];
+    if (!join_wide_path(m_root, path, wpath, 1024)) {
+      return false;
+    }
+    return wide_entry_flags(wpath).has(EntryFlag::Directory)
+               ? RemoveDirectoryW(wpath) != 0
+               : DeleteFileW(wpath) != 0;
+  }
+
+  EntryFlags get_entry_flags(const StringView<char8_t> path) override {
+    wchar_t wpath[1024];
+    if (!join_wide_path(m_root, path, wpath, 1024)) {
+      return EntryFlags{};
+    }
+    return wide_entry_flags(wpath);
+  }
+
+  IFile *open_file(const NotNull<const Allocator *> alloc,
+                   const StringView<char8_t> path,
+                   const AccessModeFlags flags) override {
+    wchar_t wpath[1024];
+    if (!join_wide_path(m_root, path, wpath, 1024)) {
+      return nullptr;
+    }
+
+    NativeFile *file = alloc->allocate<NativeFile>();
+    if (!file) {
+      return nullptr;
+    }
+    if (!file->open_wide(wpath, flags)) {
+      alloc->deallocate(file);
+      return nullptr;
+    }
+    return file;
+  }
+
+private:
+  String m_root;
+};
+
+bool MappedFile::map(const StringView<char8_t> path, const u64 offset,
+                     usize size, const MapFlags flags) {
+  unmap();
+
+  wchar_t wpath[1024];
+  if (!utf8_to_wide(path, wpath, 1024)) {
+    return false;
+  }
+
+  const DWORD attributes = flags.has(MapFlag::Sequential)
+                               ? FILE_FLAG_SEQUENTIAL_SCAN
+                           : flags.has(MapFlag::RandomAccess)
+                               ? FILE_FLAG_RANDOM_ACCESS
+                               : FILE_ATTRIBUTE_NORMAL;
+  const HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, attributes, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) ||
+      offset >= static_cast<u64>(file_size.QuadPart)) {
+    CloseHandle(file);
+    return false;
+  }
+
+  const u64 available = static_cast<u64>(file_size.QuadPart) - offset;
+  if (size == 0 || size > available) {
+    size = static_cast<usize>(available);
+  }
+
+  const HANDLE mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping) {
+    return false;
+  }
+
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  const u64 granularity = info.dwAllocationGranularity;
+  const u64 aligned_offset = offset & ~(granularity - 1);
+  const usize delta = static_cast<usize>(offset - aligned_offset);
+
+  // NOTE: The view keeps the section alive, both handles can go now.
+  void *base = MapViewOfFile(mapping, FILE_MAP_READ,
+                             static_cast<DWORD>(aligned_offset >> 32),
+                             static_cast<DWORD>(aligned_offset & 0xFFFFFFFFu),
+                             size + delta);
+  CloseHandle(mapping);
+  if (!base) {
+    return false;
+  }
+
+  m_base = base;
+  m_mapped_size = size + delta;
+  m_data = static_cast<const u8 *>(base) + delta;
+  m_size = size;
+
+  advise(0, size, flags);
+  return true;
+}
+
+void MappedFile::unmap() {
+  if (m_base) {
+    UnmapViewOfFile(m_base);
+  }
+  *this = {};
+}
+
+void MappedFile::advise(const usize offset, usize size,
+                        const MapFlags flags) const {
+  if (!m_base || offset >= m_size) {
+    return;
+  }
+  if (size > m_size - offset) {
+    size = m_size - offset;
+  }
+
+  // NOTE: Access pattern hints are fixed at CreateFileW time and large pages
+  // are not available for file backed sections, only prefetch applies here.
+  if (flags.has(MapFlag::WillNeed) || flags.has(MapFlag::Populate)) {
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<u8 *>(m_data + offset);
+    range.NumberOfBytes = size;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+  }
+}
+
+struct ReadBatchEntry {
+  u64 device;
+  u64 index;
+  u64 offset;
+  u32 request;
+  HANDLE handle;
+};
+
+// NOTE: Bounds the handles a batch keeps open, matching the POSIX side.
+constexpr usize READ_BATCH_MAX_OPEN = 256;
+
+// NOTE: ReadFileScatter only takes page sized, unbuffered segments, so
+// batches are read range by range in physical order instead of being merged.
+usize read_batch(const NotNull<const Allocator *> alloc,
+                 Span<ReadRequest> requests, Arena *arena) {
+  const usize count = requests.size();
+  if (count == 0) {
+    return 0;
+  }
+
+  const usize handle_capacity =
+      count < READ_BATCH_MAX_OPEN ? count : READ_BATCH_MAX_OPEN;
+  auto *entries = static_cast<ReadBatchEntry *>(
+      alloc->malloc(sizeof(ReadBatchEntry) * count, alignof(ReadBatchEntry)));
+  auto *handles = static_cast<HANDLE *>(
+      alloc->malloc(sizeof(HANDLE) * handle_capacity, alignof(HANDLE)));
+  if (!entries || !handles) {
+    alloc->free(entries);
+    alloc->free(handles);
+    return 0;
+  }
+
+  for (usize i = 0; i < count; ++i) {
+    requests[i].bytes_read = 0;
+    requests[i].status = ReadStatus::Pending;
+    entries[i] = {0, 0, requests[i].offset, static_cast<u32>(i),
+                  INVALID_HANDLE_VALUE};
+  }
+
+  sort_merge(alloc, Span<ReadBatchEntry>{entries, count},
+             [requests](const ReadBatchEntry &a, const ReadBatchEntry &b) {
+               return requests[a.request].path.compare(
+                          requests[b.request].path) < 0;
+             });
+
+  for (usize window = 0; window < count;) {
+    usize handle_count = 0;
+    usize entry_count = 0;
+    u64 file_size = 0;
+    ReadBatchEntry file = {0, 0, 0, 0, INVALID_HANDLE_VALUE};
+    usize i = window;
+    for (; i < count; ++i) {
+      ReadBatchEntry entry = entries[i];
+      ReadRequest &request = requests[entry.request];
+
+      if (i == window || request.path != requests[file.request].path) {
+        if (handle_count == handle_capacity) {
+          break;
+        }
+        file = {0, 0, 0, entry.request, INVALID_HANDLE_VALUE};
+
+        wchar_t wpath[1024];
+        if (utf8_to_wide(request.path, wpath, 1024)) {
+          file.handle =
+              CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        }
+
+        BY_HANDLE_FILE_INFORMATION info;
+        if (file.handle != INVALID_HANDLE_VALUE &&
+            !GetFileInformationByHandle(file.handle, &info)) {
+          CloseHandle(file.handle);
+          file.handle = INVALID_HANDLE_VALUE;
+        }
+        if (file.handle != INVALID_HANDLE_VALUE) {
+          handles[handle_count++] = file.handle;
+          file.device = info.dwVolumeSerialNumber;
+          file.index = (static_cast<u64>(info.nFileIndexHigh) << 32) |
+                       info.nFileIndexLow;
+          file_size = (static_cast<u64>(info.nFileSizeHigh) << 32) |
+                      info.nFileSizeLow;
+        }
+      }
+
+      if (file.handle == INVALID_HANDLE_VALUE) {
+        request.status = ReadStatus::OpenFailed;
+        continue;
+      }
+      if (request.offset >= file_size) {
+        request.status = ReadStatus::OutOfRange;
+        continue;
+      }
+      if (request.size == 0) {
+        request.size = static_cast<usize>(file_size - request.offset);
+      }
+      if (!request.buffer && arena) {
+        request.buffer = arena->alloc(request.size);
+      }
+      if (!request.buffer) {
+        request.status = ReadStatus::NoBuffer;
+        continue;
+      }
+
+      entry.device = file.device;
+      entry.index = file.index;
+      entry.handle = file.handle;
+      entries[window + entry_count++] = entry;
+    }
+
+    ReadBatchEntry *batch = entries + window;
+    window = i;
+
+    sort_merge(alloc, Span<ReadBatchEntry>{batch, entry_count},
+               [](const ReadBatchEntry &a, const ReadBatchEntry &b) {
+                 if (a.device != b.device) {
+                   return a.device < b.device;
+                 }
+                 if (a.index != b.index) {
+                   return a.index < b.index;
+                 }
+                 return a.offset < b.offset;
+               });
+
+    for (usize j = 0; j < entry_count; ++j) {
+      const ReadBatchEntry &entry = batch[j];
+      ReadRequest &request = requests[entry.request];
+      request.bytes_read = read_handle_at(entry.handle, entry.offset,
+                                          request.buffer, request.size);
+      request.status = request.bytes_read == request.size
+                           ? ReadStatus::Completed
+                           : ReadStatus::ShortRead;
+    }
+
+    for (usize j = 0; j < handle_count; ++j) {
+      CloseHandle(handles[j]);
+    }
+  }
+
+  alloc->free(entries);
+  alloc->free(handles);
+
+  usize completed = 0;
+  for (const ReadRequest &request : requests) {
+    completed += request.completed() ? 1 : 0;
+  }
+  return completed;
+}
+
+// NOTE: FILETIME counts 100ns ticks from 1601.
+static i64 filetime_to_unix_ns(const FILETIME &time) {
+  const u64 ticks = (static_cast<u64>(time.dwHighDateTime) << 32) |
+                    time.dwLowDateTime;
+  return (static_cast<i64>(ticks) - 116444736000000000ll) * 100;
+}
+
+bool read_directory(const StringView<char8_t> root,
+                    const StringView<char8_t> directory, const bool metadata,
+                    u8 *buffer, const usize buffer_size,
+                    void (*fn)(const WalkEntry &, void *), void *user_data) {
+  (void)metadata;
+  (void)buffer;
+  (void)buffer_size;
+
+  wchar_t wpath[1024];
+  if (!join_wide_path(root, directory, wpath, 1024)) {
+    return false;
+  }
+  usize length = wcslen(wpath);
+  if (length + 3 > 1024) {
+    return false;
+  }
+  if (wpath[length - 1] != L'/' && wpath[length - 1] != L'\\') {
+    wpath[length++] = L'\\';
+  }
+  wpath[length++] = L'*';
+  wpath[length] = L'\0';
+
+  // NOTE: The basic info level skips short names and the large fetch asks
+  // for bigger listing batches. Size and times come with every record.
+  WIN32_FIND_DATAW data;
+  const HANDLE find =
+      FindFirstFileExW(wpath, FindExInfoBasic, &data, FindExSearchNameMatch,
+                       nullptr, FIND_FIRST_EX_LARGE_FETCH);
+  if (find == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  do {
+    const wchar_t *name = data.cFileName;
+    if (name[0] == L'.' &&
+        (name[1] == L'\0' || (name[1] == L'.' && name[2] == L'\0'))) {
+      continue;
+    }
+
+    char8_t utf8_name[1024];
+    const usize name_length = wide_to_utf8(name, utf8_name, 1024);
+    if (name_length == 0) {
+      continue;
+    }
+
+    WalkEntry entry = {};
+    entry.path = StringView<char8_t>{utf8_name, name_length};
+    entry.symlink = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      entry.flags = EntryFlags{EntryFlag::Directory};
+    } else {
+      entry.flags = EntryFlags{EntryFlag::File};
+      entry.size = (static_cast<u64>(data.nFileSizeHigh) << 32) |
+                   data.nFileSizeLow;
+    }
+    entry.mtime = filetime_to_unix_ns(data.ftLastWriteTime);
+    fn(entry, user_data);
+  } while (FindNextFileW(find, &data));
+
+  FindClose(find);
+  return true;
+}
+
+constexpr usize WATCH_BUFFER_SIZE = 64 * 1024;
+constexpr DWORD WATCH_NOTIFY_FILTER =
+    FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+    FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE |
+    FILE_NOTIFY_CHANGE_CREATION;
+
+struct WinWatch {
+  HANDLE directory = INVALID_HANDLE_VALUE;
+  OVERLAPPED overlapped = {};
+  String root = {};
+  bool recursive = false;
+  alignas(DWORD) u8 buffer[WATCH_BUFFER_SIZE];
+};
+
+struct WinWatcher {
+  Array<WinWatch *> watches = {};
+};
+
+static bool win_watch_issue(WinWatch *watch) {
+  return ReadDirectoryChangesW(watch->directory, watch->buffer,
+                               sizeof(watch->buffer), watch->recursive,
+                               WATCH_NOTIFY_FILTER, nullptr,
+                               &watch->overlapped, nullptr) != 0;
+}
+
+static void win_watch_close(const NotNull<const Allocator *> alloc,
+                            WinWatch *watch) {
+  if (watch->directory != INVALID_HANDLE_VALUE) {
+    // NOTE: The kernel owns the buffer until the cancelled read completes.
+    DWORD transferred = 0;
+    CancelIoEx(watch->directory, &watch->overlapped);
+    GetOverlappedResult(watch->directory, &watch->overlapped, &transferred,
+                        TRUE);
+    CloseHandle(watch->directory);
+  }
+  if (watch->overlapped.hEvent) {
+    CloseHandle(watch->overlapped.hEvent);
+  }
+  watch->root.destroy(alloc);
+  alloc->deallocate(watch);
+}
+
+void *watch_native_create(const NotNull<const Allocator *> alloc) {
+  return alloc->allocate<WinWatcher>();
+}
+
+void watch_native_destroy(const NotNull<const Allocator *> alloc,
+                          void *native) {
+  auto *watcher = static_cast<WinWatcher *>(native);
+  for (WinWatch *watch : watcher->watches) {
+    win_watch_close(alloc, watch);
+  }
+  watcher->watches.destroy(alloc);
+  alloc->deallocate(watcher);
+}
+
+bool watch_native_add(const NotNull<const Allocator *> alloc, void *native,
+                      const StringView<char8_t> directory,
+                      const bool recursive) {
+  auto *watcher = static_cast<WinWatcher *>(native);
+
+  StringView<char8_t> path = directory;
+  while (path.size() > 1 && is_separator(path.back())) {
+    path.remove_suffix(1);
+  }
+  wchar_t wpath[1024];
+  if (!utf8_to_wide(path, wpath, 1024)) {
+    return false;
+  }
+
+  WinWatch *watch = alloc->allocate<WinWatch>();
+  if (!watch) {
+    return false;
+  }
+  watch->recursive = recursive;
+  watch->directory = CreateFileW(
+      wpath, FILE_LIST_DIRECTORY,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+      OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+      nullptr);
+  watch->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+  if (watch->directory == INVALID_HANDLE_VALUE || !watch->overlapped.hEvent ||
+      !watch->root.from_utf8(alloc, path.data(), path.size()) ||
+      !win_watch_issue(watch) || !watcher->watches.push_back(alloc, watch)) {
+    win_watch_close(alloc, watch);
+    return false;
+  }
+  return true;
+}
+
+bool watch_native_read(const NotNull<const Allocator *> alloc, void *native,
+                       void (*fn)(StringView<char8_t>, WalkChange, void *),
+                       void *user_data) {
+  (void)alloc;
+  auto *watcher = static_cast<WinWatcher *>(native);
+  bool complete = true;
+
+  for (WinWatch *watch : watcher->watches) {
+    DWORD transferred = 0;
+    if (!GetOverlappedResult(watch->directory, &watch->overlapped,
+                             &transferred, FALSE)) {
+      continue;
+    }
+
+    // NOTE: An empty completion means the change buffer overflowed.
+    if (transferred == 0) {
+      complete = false;
+    }
+
+    const StringView<char8_t> root = watch->root;
+    for (usize offset = 0; transferred != 0;) {
+      const auto *info = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(
+          watch->buffer + offset);
+
+      wchar_t name[1024];
+      const usize name_length = info->FileNameLength / sizeof(wchar_t);
+      char8_t path[2048];
+      if (name_length < 1024 && root.size() + 1 < sizeof(path)) {
+        memcpy(name, info->FileName, name_length * sizeof(wchar_t));
+        name[name_length] = L'\0';
+
+        // NOTE: FileName is relative to the watched root with '\\'
+        // separators, the published path uses '/' throughout, root included.
+        usize prefix = root.size();
+        memcpy(path, root.data(), prefix);
+        if (prefix > 0 && !is_separator(path[prefix - 1])) {
+          path[prefix++] = u8'/';
+        }
+        const usize length =
+            wide_to_utf8(name, path + prefix, sizeof(path) - prefix);
+        for (usize i = 0; i < prefix + length; ++i) {
+          if (is_separator(path[i])) {
+            path[i] = u8'/';
+          }
+        }
+        const StringView<char8_t> changed = {path, prefix + length};
+
+        switch (info->Action) {
+        case FILE_ACTION_ADDED:
+        case FILE_ACTION_RENAMED_NEW_NAME:
+          fn(changed, WalkChange::Added, user_data);
+          break;
+        case FILE_ACTION_REMOVED:
+        case FILE_ACTION_RENAMED_OLD_NAME:
+          fn(changed, WalkChange::Removed, user_data);
+          break;
+        default:
+          fn(changed, WalkChange::Modified, user_data);
+          break;
+        }
+      }
+
+      if (info->NextEntryOffset == 0) {
+        break;
+      }
+      offset += info->NextEntryOffset;
+    }
+
+    ResetEvent(watch->overlapped.hEvent);
+    win_watch_issue(watch);
+  }
+
+  return complete;
+}
+
+IFile *open_native_file(const NotNull<const Allocator *> alloc,
+                        const StringView<char8_t> path,
+                        const AccessModeFlags flags) {
+  NativeFile *file = alloc->allocate<NativeFile>();
+  if (!file) {
+    return nullptr;
+  }
+  if (!file->open(path, flags)) {
+    alloc->deallocate(file);
+    return nullptr;
+  }
+  return file;
+}
+
+IFilesystem *create_native_filesystem(const NotNull<const Allocator *> alloc,
+                                      const StringView<char8_t> root) {
+  String root_copy = {};
+  if (!root_copy.from_utf8(alloc, root.data(), root.size())) {
+    return nullptr;
+  }
+
+  NativeFilesystem *filesystem = alloc->allocate<NativeFilesystem>(root_copy);
+  if (!filesystem) {
+    root_copy.destroy(alloc);
+    return nullptr;
+  }
+  if (!filesystem->create(alloc)) {
+    filesystem->destroy(alloc);
+    alloc->deallocate(filesystem);
+    return nullptr;
+  }
+  return filesystem;
+}
+
 bool file_exists(const StringView<char8_t> path) {
   wchar_t wpath[1024];
   if (!utf8_to_wide(path, wpath, 1024)) {
@@ -267,29 +968,31 @@ bool create_directories(const StringView<char8_t> path) {
   }
 
   // Normalize separators to backslash for Windows.
-  for (usize i = 0; i < buf.m_length; ++i) {
-    if (buf.m_data[i] == u8'/') {
-      buf.m_data[i] = u8'\\';
+  char8_t *buf_data = buf.data();
+  const usize buf_length = buf.length();
+  for (usize i = 0; i < buf_length; ++i) {
+    if (buf_data[i] == u8'/') {
+      buf_data[i] = u8'\\';
     }
   }
 
   usize start = 0;
   // Skip drive letter or UNC prefix.
-  if (buf.m_length >= 3 && is_alpha(buf.m_data[0]) && buf.m_data[1] == u8':' &&
-      buf.m_data[2] == u8'\\') {
+  if (buf_length >= 3 && is_alpha(buf_data[0]) && buf_data[1] == u8':' &&
+      buf_data[2] == u8'\\') {
     start = 3;
   }
 
-  for (usize i = start; i <= buf.m_length; ++i) {
-    if (i == buf.m_length || buf.m_data[i] == u8'\\') {
-      const char8_t saved = buf.m_data[i];
-      buf.m_data[i] = 0;
-      if (!create_directory(StringView{buf.m_data, i})) {
-        buf.m_data[i] = saved;
+  for (usize i = start; i <= buf_length; ++i) {
+    if (i == buf_length || buf_data[i] == u8'\\') {
+      const char8_t saved = buf_data[i];
+      buf_data[i] = 0;
+      if (!create_directory(StringView{buf_data, i})) {
+        buf_data[i] = saved;
         buf.destroy(&scratch_alloc);
         return false;
       }
-      buf.m_data[i] = saved;
+      buf_data[i] = saved;
     }
   }
 
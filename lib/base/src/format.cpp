@@ -0,0 +1,421 @@
+#include "format.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+
+namespace edge {
+namespace detail {
+static constexpr char g_digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static constexpr char g_hex_lower[] = "0123456789abcdef";
+static constexpr char g_hex_upper[] = "0123456789ABCDEF";
+
+// NOTE: g_pow10[0] is 0 so that zero still counts as one digit.
+static constexpr u64 g_pow10[20] = {0ull,
+                                    10ull,
+                                    100ull,
+                                    1000ull,
+                                    10000ull,
+                                    100000ull,
+                                    1000000ull,
+                                    10000000ull,
+                                    100000000ull,
+                                    1000000000ull,
+                                    10000000000ull,
+                                    100000000000ull,
+                                    1000000000000ull,
+                                    10000000000000ull,
+                                    100000000000000ull,
+                                    1000000000000000ull,
+                                    10000000000000000ull,
+                                    100000000000000000ull,
+                                    1000000000000000000ull,
+                                    10000000000000000000ull};
+
+// NOTE: bit_width * log10(2) guesses the digit count, one compare against
+// the power table corrects the guess. No loop and no data dependent branch.
+static EDGE_FORCE_INLINE u32 count_digits(const u64 value) {
+  const u32 guess = (static_cast<u32>(std::bit_width(value | 1)) * 1233) >> 12;
+  return guess + 1 - static_cast<u32>(value < g_pow10[guess]);
+}
+
+static EDGE_FORCE_INLINE char *write_digits32(char *it, u32 value) {
+  while (value >= 100) {
+    const u32 pair = (value % 100) * 2;
+    value /= 100;
+    it -= 2;
+    memcpy(it, g_digit_pairs + pair, 2);
+  }
+
+  if (value >= 10) {
+    it -= 2;
+    memcpy(it, g_digit_pairs + value * 2, 2);
+  } else {
+    *--it = static_cast<char>('0' + value);
+  }
+  return it;
+}
+
+// NOTE: Writes two digits per step from the back, length comes from
+// count_digits so the caller knows where the number starts. Values past 32
+// bits are cut into 8 digit chunks so the pair loop stays on 32-bit math.
+static EDGE_FORCE_INLINE void write_decimal(char *out, const u32 length,
+                                            u64 value) {
+  char *it = out + length;
+  while (value > 0xFFFFFFFFull) {
+    u32 chunk = static_cast<u32>(value % 100000000ull);
+    value /= 100000000ull;
+    for (i32 i = 0; i < 4; ++i) {
+      it -= 2;
+      memcpy(it, g_digit_pairs + (chunk % 100) * 2, 2);
+      chunk /= 100;
+    }
+  }
+  write_digits32(it, static_cast<u32>(value));
+}
+
+static u32 write_radix(char *out, u64 value, const i32 shift,
+                       const bool upper) {
+  const char *digits = upper ? g_hex_upper : g_hex_lower;
+  const u32 bits = static_cast<u32>(std::bit_width(value | 1));
+  const u32 length = (bits + static_cast<u32>(shift) - 1) / static_cast<u32>(shift);
+  const u64 mask = (1ull << shift) - 1;
+
+  for (u32 i = length; i > 0; --i) {
+    out[i - 1] = digits[value & mask];
+    value >>= shift;
+  }
+  return length;
+}
+
+static void write_padded(FormatBuffer &out, const FormatSpec &spec,
+                         const char *prefix, const usize prefix_length,
+                         const char *body, const usize body_length,
+                         const char default_align) {
+  const usize length = prefix_length + body_length;
+  if (spec.m_width <= length) {
+    out.write(prefix, prefix_length);
+    out.write(body, body_length);
+    return;
+  }
+
+  const usize padding = spec.m_width - length;
+  if (spec.m_zero_pad && spec.m_align == '\0') {
+    out.write(prefix, prefix_length);
+    out.fill('0', padding);
+    out.write(body, body_length);
+    return;
+  }
+
+  const char align = spec.m_align != '\0' ? spec.m_align : default_align;
+  const usize left = align == '>' ? padding : align == '^' ? padding / 2 : 0;
+  out.fill(spec.m_fill, left);
+  out.write(prefix, prefix_length);
+  out.write(body, body_length);
+  out.fill(spec.m_fill, padding - left);
+}
+
+static usize sign_prefix(char *prefix, const bool negative,
+                         const FormatSpec &spec) {
+  if (negative) {
+    prefix[0] = '-';
+    return 1;
+  }
+  if (spec.m_sign == '+' || spec.m_sign == ' ') {
+    prefix[0] = spec.m_sign;
+    return 1;
+  }
+  return 0;
+}
+
+static void format_integer(FormatBuffer &out, const FormatSpec &spec,
+                           const u64 magnitude, const bool negative) {
+  if (spec.m_type == 'c') {
+    const char c = static_cast<char>(magnitude);
+    write_padded(out, spec, nullptr, 0, &c, 1, '<');
+    return;
+  }
+
+  char prefix[4];
+  usize prefix_length = sign_prefix(prefix, negative, spec);
+  char digits[64];
+  u32 length = 0;
+
+  switch (spec.m_type) {
+  case 'x':
+  case 'X':
+    if (spec.m_alternate) {
+      prefix[prefix_length++] = '0';
+      prefix[prefix_length++] = spec.m_type;
+    }
+    length = write_radix(digits, magnitude, 4, spec.m_type == 'X');
+    break;
+  case 'b':
+    if (spec.m_alternate) {
+      prefix[prefix_length++] = '0';
+      prefix[prefix_length++] = 'b';
+    }
+    length = write_radix(digits, magnitude, 1, false);
+    break;
+  case 'o':
+    if (spec.m_alternate && magnitude != 0) {
+      prefix[prefix_length++] = '0';
+    }
+    length = write_radix(digits, magnitude, 3, false);
+    break;
+  default:
+    length = count_digits(magnitude);
+    write_decimal(digits, length, magnitude);
+    break;
+  }
+
+  write_padded(out, spec, prefix, prefix_length, digits, length, '>');
+}
+
+static void format_float(FormatBuffer &out, const FormatSpec &spec,
+                         const f64 value, const bool single) {
+  const bool negative = std::signbit(value);
+  const f64 magnitude = std::fabs(value);
+
+  // NOTE: Fixed notation of DBL_MAX needs 309 digits, precision is capped so
+  // the worst case still fits.
+  char digits[512];
+  const i32 precision = spec.m_precision < 128 ? spec.m_precision : 128;
+  char *const end = digits + sizeof(digits);
+  std::to_chars_result result = {};
+
+  switch (spec.m_type) {
+  case 'f':
+  case 'F':
+    result = std::to_chars(digits, end, magnitude, std::chars_format::fixed,
+                           precision < 0 ? 6 : precision);
+    break;
+  case 'e':
+  case 'E':
+    result = std::to_chars(digits, end, magnitude,
+                           std::chars_format::scientific,
+                           precision < 0 ? 6 : precision);
+    break;
+  case 'g':
+  case 'G':
+    result = std::to_chars(digits, end, magnitude, std::chars_format::general,
+                           precision < 0 ? 6 : precision);
+    break;
+  default:
+    // NOTE: Shortest representation that parses back to the same value.
+    if (precision >= 0) {
+      result = std::to_chars(digits, end, magnitude,
+                             std::chars_format::general, precision);
+    } else if (single) {
+      result = std::to_chars(digits, end, static_cast<f32>(magnitude));
+    } else {
+      result = std::to_chars(digits, end, magnitude);
+    }
+    break;
+  }
+
+  const usize length = static_cast<usize>(result.ptr - digits);
+  if (spec.m_type == 'F' || spec.m_type == 'E' || spec.m_type == 'G') {
+    for (usize i = 0; i < length; ++i) {
+      if (digits[i] >= 'a' && digits[i] <= 'z') {
+        digits[i] = static_cast<char>(digits[i] - 'a' + 'A');
+      }
+    }
+  }
+
+  char prefix[1];
+  const usize prefix_length = sign_prefix(prefix, negative, spec);
+  if (!std::isfinite(value) && spec.m_zero_pad) {
+    FormatSpec padded = spec;
+    padded.m_zero_pad = false;
+    write_padded(out, padded, prefix, prefix_length, digits, length, '>');
+    return;
+  }
+  write_padded(out, spec, prefix, prefix_length, digits, length, '>');
+}
+
+static void format_string(FormatBuffer &out, const FormatSpec &spec,
+                          const char *data, usize length) {
+  if (spec.m_precision >= 0 && static_cast<usize>(spec.m_precision) < length) {
+    length = static_cast<usize>(spec.m_precision);
+  }
+  write_padded(out, spec, nullptr, 0, data, length, '<');
+}
+
+static void format_signed(FormatBuffer &out, const FormatSpec &spec,
+                          const i64 value) {
+  const u64 magnitude =
+      value < 0 ? 0ull - static_cast<u64>(value) : static_cast<u64>(value);
+  format_integer(out, spec, magnitude, value < 0);
+}
+
+static void format_scalar(FormatBuffer &out, const FormatSpec &spec,
+                          const FormatArgType type, const void *value,
+                          const u8 size) {
+  switch (type) {
+  case FormatArgType::Bool: {
+    const bool b = *static_cast<const bool *>(value);
+    if (spec.m_type == '\0' || spec.m_type == 's') {
+      format_string(out, spec, b ? "true" : "false", b ? 4 : 5);
+    } else {
+      format_integer(out, spec, b ? 1 : 0, false);
+    }
+    break;
+  }
+  case FormatArgType::Char: {
+    const char c = *static_cast<const char *>(value);
+    if (spec.m_type == '\0' || spec.m_type == 'c') {
+      write_padded(out, spec, nullptr, 0, &c, 1, '<');
+    } else {
+      format_integer(out, spec, static_cast<u8>(c), false);
+    }
+    break;
+  }
+  case FormatArgType::Signed:
+    switch (size) {
+    case 1:
+      format_signed(out, spec, *static_cast<const i8 *>(value));
+      break;
+    case 2:
+      format_signed(out, spec, *static_cast<const i16 *>(value));
+      break;
+    case 4:
+      format_signed(out, spec, *static_cast<const i32 *>(value));
+      break;
+    default:
+      format_signed(out, spec, *static_cast<const i64 *>(value));
+      break;
+    }
+    break;
+  case FormatArgType::Unsigned:
+    switch (size) {
+    case 1:
+      format_integer(out, spec, *static_cast<const u8 *>(value), false);
+      break;
+    case 2:
+      format_integer(out, spec, *static_cast<const u16 *>(value), false);
+      break;
+    case 4:
+      format_integer(out, spec, *static_cast<const u32 *>(value), false);
+      break;
+    default:
+      format_integer(out, spec, *static_cast<const u64 *>(value), false);
+      break;
+    }
+    break;
+  case FormatArgType::Float:
+    format_float(out, spec, *static_cast<const f32 *>(value), true);
+    break;
+  case FormatArgType::Double:
+    format_float(out, spec, *static_cast<const f64 *>(value), false);
+    break;
+  default:
+    break;
+  }
+}
+
+static void format_arg(FormatBuffer &out, const FormatSpec &spec,
+                       const FormatArg &arg) {
+  switch (arg.m_type) {
+  case FormatArgType::CString: {
+    const char *str = arg.m_cstring ? arg.m_cstring : "(null)";
+    format_string(out, spec, str, strlen(str));
+    break;
+  }
+  case FormatArgType::String:
+    format_string(out, spec, arg.m_string.m_data, arg.m_string.m_length);
+    break;
+  case FormatArgType::Pointer: {
+    char digits[16];
+    const u32 length = write_radix(
+        digits, static_cast<u64>(reinterpret_cast<uintptr_t>(arg.m_pointer)), 4,
+        false);
+    write_padded(out, spec, "0x", 2, digits, length, '>');
+    break;
+  }
+  case FormatArgType::Span: {
+    const auto *bytes = static_cast<const u8 *>(arg.m_span.m_data);
+    out.put('[');
+    for (usize i = 0; i < arg.m_span.m_count; ++i) {
+      if (i > 0) {
+        out.write(", ", 2);
+      }
+      format_scalar(out, spec, arg.m_span.m_type, bytes + i * arg.m_span.m_size,
+                    arg.m_span.m_size);
+    }
+    out.put(']');
+    break;
+  }
+  case FormatArgType::Signed:
+    format_signed(out, spec, arg.m_signed);
+    break;
+  case FormatArgType::Unsigned:
+    format_integer(out, spec, arg.m_unsigned, false);
+    break;
+  case FormatArgType::Bool:
+    format_scalar(out, spec, arg.m_type, &arg.m_bool, sizeof(bool));
+    break;
+  case FormatArgType::Char:
+    format_scalar(out, spec, arg.m_type, &arg.m_char, sizeof(char));
+    break;
+  case FormatArgType::Float:
+    format_float(out, spec, arg.m_float, true);
+    break;
+  case FormatArgType::Double:
+    format_float(out, spec, arg.m_double, false);
+    break;
+  default:
+    break;
+  }
+}
+
+usize vformat(FormatBuffer &out, const char *format, const usize format_length,
+              const FormatArg *args, const usize arg_count) {
+  const char *it = format;
+  const char *const end = format + format_length;
+  usize next_arg = 0;
+
+  while (it < end) {
+    // NOTE: Literal text between fields is copied in one piece.
+    const char *literal = it;
+    while (it < end && *it != '{' && *it != '}') {
+      it++;
+    }
+    out.write(literal, static_cast<usize>(it - literal));
+    if (it >= end) {
+      break;
+    }
+
+    const char brace = *it++;
+    if (brace == '}' || (it < end && *it == '{')) {
+      // NOTE: Escaped brace, the checked format string guarantees the pair.
+      out.put(brace);
+      it += it < end && *it == brace;
+      continue;
+    }
+
+    FormatSpec spec = {};
+    if (it < end && *it == ':') {
+      it++;
+      if (!parse_format_spec(it, end, spec)) {
+        break;
+      }
+    } else {
+      it++;
+    }
+
+    if (next_arg < arg_count) {
+      format_arg(out, spec, args[next_arg++]);
+    }
+  }
+
+  return out.m_length;
+}
+} // namespace detail
+} // namespace edge
@@ -2,18 +2,13 @@
 
 #include <bit>
 
-#if defined(EDGE_ARCH_X64)
-#define EDGE_HASH_X86
-#if defined(EDGE_HAS_SSE4_2)
-#define EDGE_HASH_HAS_CRC32
-#include <nmmintrin.h>
+#if EDGE_HAS_PCLMUL
+#include <wmmintrin.h>
 #endif
-#elif defined(EDGE_ARCH_AARCH64)
-#if defined(__ARM_FEATURE_CRC32)
-#define EDGE_HASH_HAS_CRC32
+
+#if EDGE_HAS_ARM_CRC32
 #include <arm_acle.h>
 #endif
-#endif
 
 namespace edge {
 namespace detail {
@@ -29,66 +24,735 @@ static u64 read64(const void *ptr) {
   return result;
 }
 
-static u32 g_crc32_table[256];
-static bool g_crc32_table_initialized = false;
+constexpr u32 XXH_PRIME32_1 = 0x9E3779B1u;
+constexpr u32 XXH_PRIME32_2 = 0x85EBCA77u;
+constexpr u32 XXH_PRIME32_3 = 0xC2B2AE3Du;
+constexpr u64 XXH_PRIME64_1 = 0x9E3779B185EBCA87ull;
+constexpr u64 XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr u64 XXH_PRIME64_3 = 0x165667B19E3779F9ull;
+constexpr u64 XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr u64 XXH_PRIME64_5 = 0x27D4EB2F165667C5ull;
+constexpr u64 XXH_PRIME_MX1 = 0x165667919E3779F9ull;
+constexpr u64 XXH_PRIME_MX2 = 0x9FB21C651E98DF25ull;
+
+constexpr usize XXH3_STRIPE_SIZE = 64;
+constexpr usize XXH3_SECRET_CONSUME = 8;
+constexpr usize XXH3_SECRET_SIZE_MIN = 136;
+constexpr usize XXH3_MIDSIZE_MAX = 240;
+constexpr usize XXH3_STRIPES_PER_BLOCK =
+    (XXH3_SECRET_SIZE - XXH3_STRIPE_SIZE) / XXH3_SECRET_CONSUME;
+constexpr usize XXH3_SECRET_LIMIT = XXH3_SECRET_SIZE - XXH3_STRIPE_SIZE;
+
+alignas(64) static constexpr u8 g_xxh3_secret[XXH3_SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c,
+    0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+    0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e,
+    0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6,
+    0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+    0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97,
+    0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7,
+    0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+    0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83,
+    0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26,
+    0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+    0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f,
+    0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static EDGE_FORCE_INLINE u32 bswap32(const u32 value) {
+#if defined(EDGE_COMPILER_MSVC)
+  return _byteswap_ulong(value);
+#else
+  return __builtin_bswap32(value);
+#endif
+}
+
+static EDGE_FORCE_INLINE u64 bswap64(const u64 value) {
+#if defined(EDGE_COMPILER_MSVC)
+  return _byteswap_uint64(value);
+#else
+  return __builtin_bswap64(value);
+#endif
+}
+
+static EDGE_FORCE_INLINE Hash128 mul64to128(const u64 lhs, const u64 rhs) {
+#if defined(__SIZEOF_INT128__)
+  const __uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+  return {static_cast<u64>(product), static_cast<u64>(product >> 64)};
+#elif defined(EDGE_COMPILER_MSVC) && defined(EDGE_ARCH_X64)
+  u64 high;
+  const u64 low = _umul128(lhs, rhs, &high);
+  return {low, high};
+#else
+  const u64 lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+  const u64 hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+  const u64 lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+  const u64 hi_hi = (lhs >> 32) * (rhs >> 32);
+  const u64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  return {(cross << 32) | (lo_lo & 0xFFFFFFFF),
+          (hi_lo >> 32) + (cross >> 32) + hi_hi};
+#endif
+}
+
+static EDGE_FORCE_INLINE u64 mul128_fold64(const u64 lhs, const u64 rhs) {
+  const Hash128 product = mul64to128(lhs, rhs);
+  return product.low ^ product.high;
+}
+
+static EDGE_FORCE_INLINE u64 xorshift64(const u64 value, const i32 shift) {
+  return value ^ (value >> shift);
+}
+
+static u64 xxh64_avalanche(u64 hash) {
+  hash ^= hash >> 33;
+  hash *= XXH_PRIME64_2;
+  hash ^= hash >> 29;
+  hash *= XXH_PRIME64_3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+static u64 xxh3_avalanche(u64 hash) {
+  hash = xorshift64(hash, 37);
+  hash *= XXH_PRIME_MX1;
+  return xorshift64(hash, 32);
+}
+
+static u64 xxh3_rrmxmx(u64 hash, const u64 size) {
+  hash ^= std::rotl(hash, 49) ^ std::rotl(hash, 24);
+  hash *= XXH_PRIME_MX2;
+  hash ^= (hash >> 35) + size;
+  hash *= XXH_PRIME_MX2;
+  return xorshift64(hash, 28);
+}
+
+static EDGE_FORCE_INLINE u64 xxh3_mix16(const u8 *input, const u8 *secret,
+                                        const u64 seed) {
+  return mul128_fold64(read64(input) ^ (read64(secret) + seed),
+                       read64(input + 8) ^ (read64(secret + 8) - seed));
+}
+
+static u64 xxh3_64_short(const u8 *input, const usize size, const u8 *secret,
+                         u64 seed) {
+  if (size > 8) {
+    const u64 bitflip1 = (read64(secret + 24) ^ read64(secret + 32)) + seed;
+    const u64 bitflip2 = (read64(secret + 40) ^ read64(secret + 48)) - seed;
+    const u64 input_lo = read64(input) ^ bitflip1;
+    const u64 input_hi = read64(input + size - 8) ^ bitflip2;
+    return xxh3_avalanche(size + bswap64(input_lo) + input_hi +
+                          mul128_fold64(input_lo, input_hi));
+  }
+
+  if (size >= 4) {
+    seed ^= static_cast<u64>(bswap32(static_cast<u32>(seed))) << 32;
+    const u64 bitflip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+    const u64 input64 =
+        read32(input + size - 4) + (static_cast<u64>(read32(input)) << 32);
+    return xxh3_rrmxmx(input64 ^ bitflip, size);
+  }
+
+  if (size > 0) {
+    const u32 combined = (static_cast<u32>(input[0]) << 16) |
+                         (static_cast<u32>(input[size >> 1]) << 24) |
+                         static_cast<u32>(input[size - 1]) |
+                         (static_cast<u32>(size) << 8);
+    const u64 bitflip = (read32(secret) ^ read32(secret + 4)) + seed;
+    return xxh64_avalanche(combined ^ bitflip);
+  }
+
+  return xxh64_avalanche(seed ^ read64(secret + 56) ^ read64(secret + 64));
+}
+
+static u64 xxh3_64_medium(const u8 *input, const usize size, const u8 *secret,
+                          const u64 seed) {
+  u64 acc = size * XXH_PRIME64_1;
+
+  if (size <= 128) {
+    if (size > 32) {
+      if (size > 64) {
+        if (size > 96) {
+          acc += xxh3_mix16(input + 48, secret + 96, seed);
+          acc += xxh3_mix16(input + size - 64, secret + 112, seed);
+        }
+        acc += xxh3_mix16(input + 32, secret + 64, seed);
+        acc += xxh3_mix16(input + size - 48, secret + 80, seed);
+      }
+      acc += xxh3_mix16(input + 16, secret + 32, seed);
+      acc += xxh3_mix16(input + size - 32, secret + 48, seed);
+    }
+    acc += xxh3_mix16(input, secret, seed);
+    acc += xxh3_mix16(input + size - 16, secret + 16, seed);
+    return xxh3_avalanche(acc);
+  }
+
+  for (usize i = 0; i < 8; ++i) {
+    acc += xxh3_mix16(input + 16 * i, secret + 16 * i, seed);
+  }
+  acc = xxh3_avalanche(acc);
+
+  u64 acc_end =
+      xxh3_mix16(input + size - 16, secret + XXH3_SECRET_SIZE_MIN - 17, seed);
+  const usize rounds = size / 16;
+  for (usize i = 8; i < rounds; ++i) {
+    acc_end += xxh3_mix16(input + 16 * i, secret + 16 * (i - 8) + 3, seed);
+  }
+  return xxh3_avalanche(acc + acc_end);
+}
+
+static Hash128 xxh3_128_short(const u8 *input, const usize size,
+                              const u8 *secret, u64 seed) {
+  if (size > 8) {
+    const u64 bitflip_lo = (read64(secret + 32) ^ read64(secret + 40)) - seed;
+    const u64 bitflip_hi = (read64(secret + 48) ^ read64(secret + 56)) + seed;
+    const u64 input_lo = read64(input);
+    u64 input_hi = read64(input + size - 8);
+
+    Hash128 m128 =
+        mul64to128(input_lo ^ input_hi ^ bitflip_lo, XXH_PRIME64_1);
+    m128.low += static_cast<u64>(size - 1) << 54;
+    input_hi ^= bitflip_hi;
+    m128.high +=
+        input_hi + static_cast<u64>(static_cast<u32>(input_hi)) *
+                       static_cast<u64>(XXH_PRIME32_2 - 1);
+    m128.low ^= bswap64(m128.high);
+
+    Hash128 h128 = mul64to128(m128.low, XXH_PRIME64_2);
+    h128.high += m128.high * XXH_PRIME64_2;
+    return {xxh3_avalanche(h128.low), xxh3_avalanche(h128.high)};
+  }
+
+  if (size >= 4) {
+    seed ^= static_cast<u64>(bswap32(static_cast<u32>(seed))) << 32;
+    const u64 input64 =
+        read32(input) + (static_cast<u64>(read32(input + size - 4)) << 32);
+    const u64 bitflip = (read64(secret + 16) ^ read64(secret + 24)) + seed;
+
+    Hash128 m128 = mul64to128(input64 ^ bitflip, XXH_PRIME64_1 + (size << 2));
+    m128.high += m128.low << 1;
+    m128.low ^= m128.high >> 3;
+    m128.low = xorshift64(m128.low, 35);
+    m128.low *= XXH_PRIME_MX2;
+    m128.low = xorshift64(m128.low, 28);
+    m128.high = xxh3_avalanche(m128.high);
+    return m128;
+  }
+
+  if (size > 0) {
+    const u32 combined_lo = (static_cast<u32>(input[0]) << 16) |
+                            (static_cast<u32>(input[size >> 1]) << 24) |
+                            static_cast<u32>(input[size - 1]) |
+                            (static_cast<u32>(size) << 8);
+    const u32 combined_hi = std::rotl(bswap32(combined_lo), 13);
+    const u64 bitflip_lo = (read32(secret) ^ read32(secret + 4)) + seed;
+    const u64 bitflip_hi = (read32(secret + 8) ^ read32(secret + 12)) - seed;
+    return {xxh64_avalanche(combined_lo ^ bitflip_lo),
+            xxh64_avalanche(combined_hi ^ bitflip_hi)};
+  }
+
+  return {xxh64_avalanche(seed ^ read64(secret + 64) ^ read64(secret + 72)),
+          xxh64_avalanche(seed ^ read64(secret + 80) ^ read64(secret + 88))};
+}
+
+static EDGE_FORCE_INLINE Hash128 xxh3_mix32(Hash128 acc, const u8 *input1,
+                                            const u8 *input2, const u8 *secret,
+                                            const u64 seed) {
+  acc.low += xxh3_mix16(input1, secret, seed);
+  acc.low ^= read64(input2) + read64(input2 + 8);
+  acc.high += xxh3_mix16(input2, secret + 16, seed);
+  acc.high ^= read64(input1) + read64(input1 + 8);
+  return acc;
+}
+
+static Hash128 xxh3_128_medium(const u8 *input, const usize size,
+                               const u8 *secret, const u64 seed) {
+  Hash128 acc = {size * XXH_PRIME64_1, 0ull};
+
+  if (size <= 128) {
+    if (size > 32) {
+      if (size > 64) {
+        if (size > 96) {
+          acc = xxh3_mix32(acc, input + 48, input + size - 64, secret + 96,
+                           seed);
+        }
+        acc = xxh3_mix32(acc, input + 32, input + size - 48, secret + 64, seed);
+      }
+      acc = xxh3_mix32(acc, input + 16, input + size - 32, secret + 32, seed);
+    }
+    acc = xxh3_mix32(acc, input, input + size - 16, secret, seed);
+  } else {
+    for (usize i = 32; i < 160; i += 32) {
+      acc = xxh3_mix32(acc, input + i - 32, input + i - 16, secret + i - 32,
+                       seed);
+    }
+    acc.low = xxh3_avalanche(acc.low);
+    acc.high = xxh3_avalanche(acc.high);
+    for (usize i = 160; i <= size; i += 32) {
+      acc = xxh3_mix32(acc, input + i - 32, input + i - 16,
+                       secret + 3 + i - 160, seed);
+    }
+    acc = xxh3_mix32(acc, input + size - 16, input + size - 32,
+                     secret + XXH3_SECRET_SIZE_MIN - 17 - 16, 0ull - seed);
+  }
+
+  const u64 low = acc.low + acc.high;
+  const u64 high = acc.low * XXH_PRIME64_1 + acc.high * XXH_PRIME64_4 +
+                   (size - seed) * XXH_PRIME64_2;
+  return {xxh3_avalanche(low), 0ull - xxh3_avalanche(high)};
+}
+
+static EDGE_FORCE_INLINE void xxh3_accumulate_512(u64 *acc, const u8 *input,
+                                                  const u8 *secret) {
+#if EDGE_HAS_AVX2
+  auto *vacc = reinterpret_cast<__m256i *>(acc);
+  for (usize i = 0; i < 2; ++i) {
+    const __m256i value = _mm256_loadu_si256(vacc + i);
+    const __m256i data =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input) + i);
+    const __m256i key =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(secret) + i);
+    const __m256i data_key = _mm256_xor_si256(data, key);
+    const __m256i product =
+        _mm256_mul_epu32(data_key, _mm256_srli_epi64(data_key, 32));
+    const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    _mm256_storeu_si256(
+        vacc + i, _mm256_add_epi64(value, _mm256_add_epi64(product, swapped)));
+  }
+#elif EDGE_HAS_SSE2
+  auto *vacc = reinterpret_cast<__m128i *>(acc);
+  for (usize i = 0; i < 4; ++i) {
+    const __m128i value = _mm_loadu_si128(vacc + i);
+    const __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(input) + i);
+    const __m128i key =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i);
+    const __m128i data_key = _mm_xor_si128(data, key);
+    const __m128i product =
+        _mm_mul_epu32(data_key, _mm_srli_epi64(data_key, 32));
+    const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    _mm_storeu_si128(vacc + i,
+                     _mm_add_epi64(value, _mm_add_epi64(product, swapped)));
+  }
+#elif EDGE_HAS_NEON
+  for (usize i = 0; i < 4; ++i) {
+    const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(input + 16 * i));
+    const uint64x2_t key = vreinterpretq_u64_u8(vld1q_u8(secret + 16 * i));
+    const uint64x2_t data_key = veorq_u64(data, key);
+    const uint64x2_t product =
+        vmull_u32(vmovn_u64(data_key), vshrn_n_u64(data_key, 32));
+    const uint64x2_t swapped = vextq_u64(data, data, 1);
+    vst1q_u64(acc + 2 * i, vaddq_u64(vld1q_u64(acc + 2 * i),
+                                     vaddq_u64(product, swapped)));
+  }
+#else
+  for (usize lane = 0; lane < 8; ++lane) {
+    const u64 data = read64(input + 8 * lane);
+    const u64 data_key = data ^ read64(secret + 8 * lane);
+    acc[lane ^ 1] += data;
+    acc[lane] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+  }
+#endif
+}
+
+static EDGE_FORCE_INLINE void xxh3_scramble(u64 *acc, const u8 *secret) {
+#if EDGE_HAS_AVX2
+  auto *vacc = reinterpret_cast<__m256i *>(acc);
+  const __m256i prime = _mm256_set1_epi32(static_cast<i32>(XXH_PRIME32_1));
+  for (usize i = 0; i < 2; ++i) {
+    const __m256i accumulator = _mm256_loadu_si256(vacc + i);
+    const __m256i value = _mm256_xor_si256(
+        accumulator, _mm256_srli_epi64(accumulator, 47));
+    const __m256i data_key = _mm256_xor_si256(
+        value,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(secret) + i));
+    const __m256i product_lo = _mm256_mul_epu32(data_key, prime);
+    const __m256i product_hi =
+        _mm256_mul_epu32(_mm256_srli_epi64(data_key, 32), prime);
+    _mm256_storeu_si256(
+        vacc + i,
+        _mm256_add_epi64(product_lo, _mm256_slli_epi64(product_hi, 32)));
+  }
+#elif EDGE_HAS_SSE2
+  auto *vacc = reinterpret_cast<__m128i *>(acc);
+  const __m128i prime = _mm_set1_epi32(static_cast<i32>(XXH_PRIME32_1));
+  for (usize i = 0; i < 4; ++i) {
+    const __m128i accumulator = _mm_loadu_si128(vacc + i);
+    const __m128i value =
+        _mm_xor_si128(accumulator, _mm_srli_epi64(accumulator, 47));
+    const __m128i data_key = _mm_xor_si128(
+        value, _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + i));
+    const __m128i product_lo = _mm_mul_epu32(data_key, prime);
+    const __m128i product_hi =
+        _mm_mul_epu32(_mm_srli_epi64(data_key, 32), prime);
+    _mm_storeu_si128(vacc + i,
+                     _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32)));
+  }
+#elif EDGE_HAS_NEON
+  const uint32x2_t prime = vdup_n_u32(XXH_PRIME32_1);
+  for (usize i = 0; i < 4; ++i) {
+    uint64x2_t value = vld1q_u64(acc + 2 * i);
+    value = veorq_u64(value, vshrq_n_u64(value, 47));
+    const uint64x2_t data_key =
+        veorq_u64(value, vreinterpretq_u64_u8(vld1q_u8(secret + 16 * i)));
+    const uint64x2_t product_hi =
+        vshlq_n_u64(vmull_u32(vshrn_n_u64(data_key, 32), prime), 32);
+    vst1q_u64(acc + 2 * i,
+              vmlal_u32(product_hi, vmovn_u64(data_key), prime));
+  }
+#else
+  for (usize lane = 0; lane < 8; ++lane) {
+    u64 value = xorshift64(acc[lane], 47);
+    value ^= read64(secret + 8 * lane);
+    acc[lane] = value * XXH_PRIME32_1;
+  }
+#endif
+}
+
+static void xxh3_accumulate(u64 *acc, const u8 *input, const u8 *secret,
+                            const usize stripes) {
+  for (usize n = 0; n < stripes; ++n) {
+    xxh3_accumulate_512(acc, input + n * XXH3_STRIPE_SIZE,
+                        secret + n * XXH3_SECRET_CONSUME);
+  }
+}
+
+static void xxh3_init_acc(u64 *acc) {
+  acc[0] = XXH_PRIME32_3;
+  acc[1] = XXH_PRIME64_1;
+  acc[2] = XXH_PRIME64_2;
+  acc[3] = XXH_PRIME64_3;
+  acc[4] = XXH_PRIME64_4;
+  acc[5] = XXH_PRIME32_2;
+  acc[6] = XXH_PRIME64_5;
+  acc[7] = XXH_PRIME32_1;
+}
+
+static void xxh3_init_secret(u8 *secret, const u64 seed) {
+  for (usize i = 0; i < XXH3_SECRET_SIZE; i += 16) {
+    const u64 lo = read64(g_xxh3_secret + i) + seed;
+    const u64 hi = read64(g_xxh3_secret + i + 8) - seed;
+    memcpy(secret + i, &lo, sizeof(u64));
+    memcpy(secret + i + 8, &hi, sizeof(u64));
+  }
+}
+
+// NOTE: Blocks of 16 stripes walk the secret 8 bytes at a time and are then
+// scrambled. The last stripe is always taken from the final 64 input bytes,
+// overlapping the previous stripe when the size is not a multiple of 64.
+static void xxh3_hash_long(u64 *acc, const u8 *input, const usize size,
+                           const u8 *secret) {
+  constexpr usize block_size = XXH3_STRIPE_SIZE * XXH3_STRIPES_PER_BLOCK;
+  const usize blocks = (size - 1) / block_size;
+
+  for (usize n = 0; n < blocks; ++n) {
+    xxh3_accumulate(acc, input + n * block_size, secret,
+                    XXH3_STRIPES_PER_BLOCK);
+    xxh3_scramble(acc, secret + XXH3_SECRET_LIMIT);
+  }
+
+  const usize stripes = ((size - 1) - block_size * blocks) / XXH3_STRIPE_SIZE;
+  xxh3_accumulate(acc, input + blocks * block_size, secret, stripes);
+  xxh3_accumulate_512(acc, input + size - XXH3_STRIPE_SIZE,
+                      secret + XXH3_SECRET_LIMIT - 7);
+}
+
+static u64 xxh3_merge_accs(const u64 *acc, const u8 *secret, const u64 start) {
+  u64 result = start;
+  for (usize i = 0; i < 4; ++i) {
+    result += mul128_fold64(acc[2 * i] ^ read64(secret + 16 * i),
+                            acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+  }
+  return xxh3_avalanche(result);
+}
+
+static u64 xxh3_64_digest_long(const u64 *acc, const u8 *secret,
+                               const u64 size) {
+  return xxh3_merge_accs(acc, secret + 11, size * XXH_PRIME64_1);
+}
+
+static Hash128 xxh3_128_digest_long(const u64 *acc, const u8 *secret,
+                                    const u64 size) {
+  return {xxh3_merge_accs(acc, secret + 11, size * XXH_PRIME64_1),
+          xxh3_merge_accs(acc, secret + XXH3_SECRET_SIZE - 64 - 11,
+                          ~(size * XXH_PRIME64_2))};
+}
+
+// NOTE: Feeds stripes into the accumulators, scrambling whenever a block of
+// the secret is used up. Returns the input past the consumed stripes.
+static const u8 *xxh3_consume_stripes(u64 *acc, usize *stripes_in_block,
+                                      const u8 *input, usize stripes,
+                                      const u8 *secret) {
+  const u8 *block_secret = secret + *stripes_in_block * XXH3_SECRET_CONSUME;
+  if (stripes >= XXH3_STRIPES_PER_BLOCK - *stripes_in_block) {
+    usize block_stripes = XXH3_STRIPES_PER_BLOCK - *stripes_in_block;
+    do {
+      xxh3_accumulate(acc, input, block_secret, block_stripes);
+      xxh3_scramble(acc, secret + XXH3_SECRET_LIMIT);
+      input += block_stripes * XXH3_STRIPE_SIZE;
+      stripes -= block_stripes;
+      block_stripes = XXH3_STRIPES_PER_BLOCK;
+      block_secret = secret;
+    } while (stripes >= XXH3_STRIPES_PER_BLOCK);
+    *stripes_in_block = 0;
+  }
+
+  if (stripes > 0) {
+    xxh3_accumulate(acc, input, block_secret, stripes);
+    input += stripes * XXH3_STRIPE_SIZE;
+    *stripes_in_block += stripes;
+  }
+  return input;
+}
+
+struct CrcTables {
+  u32 table[8][256];
+};
 
-static void crc32_init_table() {
+// NOTE: Slicing-by-8 tables for a reflected polynomial, built at compile time
+// so there is no lazy initialization to race on.
+constexpr CrcTables crc_make_tables(const u32 poly) {
+  CrcTables tables = {};
   for (u32 i = 0; i < 256; i++) {
     u32 crc = i;
     for (u32 j = 0; j < 8; j++) {
-      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+      crc = (crc >> 1) ^ (poly & (0u - (crc & 1)));
     }
-    g_crc32_table[i] = crc;
+    tables.table[0][i] = crc;
   }
-  g_crc32_table_initialized = true;
+
+  for (u32 i = 0; i < 256; i++) {
+    for (u32 slice = 1; slice < 8; slice++) {
+      const u32 prev = tables.table[slice - 1][i];
+      tables.table[slice][i] = (prev >> 8) ^ tables.table[0][prev & 0xFF];
+    }
+  }
+  return tables;
 }
-} // namespace detail
 
-u32 hash_crc32(const void *data, usize size) {
-  if (!detail::g_crc32_table_initialized) {
-    detail::crc32_init_table();
+constexpr u32 CRC32_POLY = 0xEDB88320u;
+constexpr u32 CRC32C_POLY = 0x82F63B78u;
+
+static constexpr CrcTables g_crc32_tables = crc_make_tables(CRC32_POLY);
+static constexpr CrcTables g_crc32c_tables = crc_make_tables(CRC32C_POLY);
+
+// NOTE: All update functions work on the raw register, the public functions
+// apply the pre and post inversion.
+static u32 crc_update_table(const CrcTables &tables, u32 crc, const u8 *bytes,
+                            usize size) {
+  while (size >= 8) {
+    const u32 lo = read32(bytes) ^ crc;
+    const u32 hi = read32(bytes + 4);
+    crc = tables.table[7][lo & 0xFF] ^ tables.table[6][(lo >> 8) & 0xFF] ^
+          tables.table[5][(lo >> 16) & 0xFF] ^ tables.table[4][lo >> 24] ^
+          tables.table[3][hi & 0xFF] ^ tables.table[2][(hi >> 8) & 0xFF] ^
+          tables.table[1][(hi >> 16) & 0xFF] ^ tables.table[0][hi >> 24];
+    bytes += 8;
+    size -= 8;
   }
 
-  auto bytes = static_cast<const u8 *>(data);
-  u32 crc = 0xFFFFFFFF;
+  while (size > 0) {
+    crc = (crc >> 8) ^ tables.table[0][(crc ^ *bytes++) & 0xFF];
+    size--;
+  }
+  return crc;
+}
 
-#if defined(EDGE_HASH_HAS_CRC32) && defined(EDGE_HASH_X86)
+static u32 crc32_update(u32 crc, const u8 *bytes, usize size) {
+#if EDGE_HAS_ARM_CRC32
   while (size >= 8) {
-    crc = static_cast<u32>(_mm_crc32_u64(crc, detail::read64(bytes)));
+    crc = __crc32d(crc, read64(bytes));
     bytes += 8;
     size -= 8;
   }
-  if (size >= 4) {
-    crc = _mm_crc32_u32(crc, detail::read32(bytes));
-    bytes += 4;
-    size -= 4;
+  while (size > 0) {
+    crc = __crc32b(crc, *bytes++);
+    size--;
+  }
+  return crc;
+#else
+  return crc_update_table(g_crc32_tables, crc, bytes, size);
+#endif
+}
+
+static u32 crc32c_update(u32 crc, const u8 *bytes, usize size) {
+#if EDGE_HAS_SSE4_2 && defined(EDGE_ARCH_X64)
+  while (size >= 8) {
+    crc = static_cast<u32>(_mm_crc32_u64(crc, read64(bytes)));
+    bytes += 8;
+    size -= 8;
   }
   while (size > 0) {
     crc = _mm_crc32_u8(crc, *bytes++);
     size--;
   }
-#elif defined(EDGE_HASH_HAS_CRC32) && defined(EDGE_HASH_AARCH64)
+  return crc;
+#elif EDGE_HAS_ARM_CRC32
   while (size >= 8) {
-    crc = __crc32d(crc, detail::read64(bytes));
+    crc = __crc32cd(crc, read64(bytes));
     bytes += 8;
     size -= 8;
   }
-  if (size >= 4) {
-    crc = __crc32w(crc, detail::read32(bytes));
-    bytes += 4;
-    size -= 4;
-  }
   while (size > 0) {
-    crc = __crc32b(crc, *bytes++);
+    crc = __crc32cb(crc, *bytes++);
     size--;
   }
+  return crc;
 #else
-  for (usize i = 0; i < size; i++) {
-    crc = (crc >> 8) ^ detail::g_crc32_table[(crc ^ bytes[i]) & 0xFF];
+  return crc_update_table(g_crc32c_tables, crc, bytes, size);
+#endif
+}
+
+#if EDGE_HAS_PCLMUL
+constexpr usize CRC_FOLD_MIN_SIZE = 128;
+
+// NOTE: x^(n) mod P for the fold distances, bit reflected and shifted left by
+// one to match the reflected carry-less products.
+struct CrcFoldConstants {
+  u64 k1, k2;
+  u64 k3, k4;
+};
+
+static constexpr CrcFoldConstants g_crc32_fold = {0x154442bd4ull, 0x1c6e41596ull,
+                                                  0x1751997d0ull, 0x0ccaa009eull};
+static constexpr CrcFoldConstants g_crc32c_fold = {0x0740eef02ull, 0x09e4addf8ull,
+                                                   0x0f20c0dfeull, 0x14cd00bd6ull};
+
+static EDGE_FORCE_INLINE __m128i crc_fold_128(const __m128i value,
+                                              const __m128i k) {
+  return _mm_xor_si128(_mm_clmulepi64_si128(value, k, 0x00),
+                       _mm_clmulepi64_si128(value, k, 0x11));
+}
+
+// NOTE: Four independent 128 bit lanes are folded forward 512 bits at a time,
+// so throughput is bound by the multiplier instead of the dependency chain of
+// a byte or word loop. The lanes are then folded into one and the remaining
+// 16 byte value is reduced with the scalar update, which avoids a separate
+// Barrett step.
+template <u32 (*Update)(u32, const u8 *, usize)>
+static u32 crc_fold(const CrcFoldConstants &constants, const u32 crc,
+                    const u8 *bytes, usize size) {
+  const auto *blocks = reinterpret_cast<const __m128i *>(bytes);
+  __m128i x0 = _mm_xor_si128(_mm_loadu_si128(blocks + 0),
+                             _mm_cvtsi32_si128(static_cast<i32>(crc)));
+  __m128i x1 = _mm_loadu_si128(blocks + 1);
+  __m128i x2 = _mm_loadu_si128(blocks + 2);
+  __m128i x3 = _mm_loadu_si128(blocks + 3);
+  bytes += 64;
+  size -= 64;
+
+  const __m128i k1k2 = _mm_set_epi64x(static_cast<i64>(constants.k2),
+                                      static_cast<i64>(constants.k1));
+  while (size >= 64) {
+    blocks = reinterpret_cast<const __m128i *>(bytes);
+    x0 = _mm_xor_si128(crc_fold_128(x0, k1k2), _mm_loadu_si128(blocks + 0));
+    x1 = _mm_xor_si128(crc_fold_128(x1, k1k2), _mm_loadu_si128(blocks + 1));
+    x2 = _mm_xor_si128(crc_fold_128(x2, k1k2), _mm_loadu_si128(blocks + 2));
+    x3 = _mm_xor_si128(crc_fold_128(x3, k1k2), _mm_loadu_si128(blocks + 3));
+    bytes += 64;
+    size -= 64;
   }
+
+  const __m128i k3k4 = _mm_set_epi64x(static_cast<i64>(constants.k4),
+                                      static_cast<i64>(constants.k3));
+  x0 = _mm_xor_si128(crc_fold_128(x0, k3k4), x1);
+  x0 = _mm_xor_si128(crc_fold_128(x0, k3k4), x2);
+  x0 = _mm_xor_si128(crc_fold_128(x0, k3k4), x3);
+  while (size >= 16) {
+    x0 = _mm_xor_si128(crc_fold_128(x0, k3k4),
+                       _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes)));
+    bytes += 16;
+    size -= 16;
+  }
+
+  alignas(16) u8 folded[16];
+  _mm_store_si128(reinterpret_cast<__m128i *>(folded), x0);
+  return Update(Update(0, folded, 16), bytes, size);
+}
 #endif
 
-  return ~crc;
+// NOTE: zlib's combine, crc1 is advanced over size2 zero bytes by multiplying
+// with x^(8 * size2) mod P, built from the table of x^(2^n) powers.
+static constexpr u32 crc_multiply_mod(u32 a, u32 b, const u32 poly) {
+  u32 mask = 1u << 31;
+  u32 product = 0;
+  for (;;) {
+    if (a & mask) {
+      product ^= b;
+      if ((a & (mask - 1)) == 0) {
+        break;
+      }
+    }
+    mask >>= 1;
+    b = (b & 1) ? (b >> 1) ^ poly : b >> 1;
+  }
+  return product;
+}
+
+struct CrcPowers {
+  u32 x2n[32];
+};
+
+static constexpr CrcPowers crc_make_powers(const u32 poly) {
+  CrcPowers powers = {};
+  u32 p = 1u << 30;
+  powers.x2n[0] = p;
+  for (u32 n = 1; n < 32; n++) {
+    p = crc_multiply_mod(p, p, poly);
+    powers.x2n[n] = p;
+  }
+  return powers;
+}
+
+static constexpr CrcPowers g_crc32_powers = crc_make_powers(CRC32_POLY);
+static constexpr CrcPowers g_crc32c_powers = crc_make_powers(CRC32C_POLY);
+
+static u32 crc_combine(const CrcPowers &powers, const u32 poly,
+                       const u32 crc1, const u32 crc2, u64 size2) {
+  u32 shift = 1u << 31;
+  u32 k = 3;
+  while (size2) {
+    if (size2 & 1) {
+      shift = crc_multiply_mod(powers.x2n[k & 31], shift, poly);
+    }
+    size2 >>= 1;
+    k++;
+  }
+  return crc_multiply_mod(shift, crc1, poly) ^ crc2;
+}
+} // namespace detail
+
+u32 hash_crc32(const void *data, const usize size, const u32 crc) {
+  const auto bytes = static_cast<const u8 *>(data);
+#if EDGE_HAS_PCLMUL
+  if (size >= detail::CRC_FOLD_MIN_SIZE) {
+    return ~detail::crc_fold<detail::crc32_update>(detail::g_crc32_fold, ~crc,
+                                                   bytes, size);
+  }
+#endif
+  return ~detail::crc32_update(~crc, bytes, size);
+}
+
+u32 hash_crc32c(const void *data, const usize size, const u32 crc) {
+  const auto bytes = static_cast<const u8 *>(data);
+#if EDGE_HAS_PCLMUL
+  if (size >= detail::CRC_FOLD_MIN_SIZE) {
+    return ~detail::crc_fold<detail::crc32c_update>(detail::g_crc32c_fold,
+                                                    ~crc, bytes, size);
+  }
+#endif
+  return ~detail::crc32c_update(~crc, bytes, size);
+}
+
+u32 hash_crc32_combine(const u32 crc1, const u32 crc2, const u64 size2) {
+  return detail::crc_combine(detail::g_crc32_powers, detail::CRC32_POLY, crc1,
+                             crc2, size2);
+}
+
+u32 hash_crc32c_combine(const u32 crc1, const u32 crc2, const u64 size2) {
+  return detail::crc_combine(detail::g_crc32c_powers, detail::CRC32C_POLY,
+                             crc1, crc2, size2);
 }
 
 usize hash_pointer(const void *ptr) {
@@ -98,4 +762,147 @@ usize hash_pointer(const void *ptr) {
     return Hash<u32>{}(static_cast<u32>(reinterpret_cast<uintptr_t>(ptr)));
   }
 }
+
+u64 hash_xxh3_64(const void *data, const usize size, const u64 seed) {
+  const auto input = static_cast<const u8 *>(data);
+  if (size <= 16) {
+    return detail::xxh3_64_short(input, size, detail::g_xxh3_secret, seed);
+  }
+  if (size <= detail::XXH3_MIDSIZE_MAX) {
+    return detail::xxh3_64_medium(input, size, detail::g_xxh3_secret, seed);
+  }
+
+  alignas(64) u8 custom_secret[detail::XXH3_SECRET_SIZE];
+  const u8 *secret = detail::g_xxh3_secret;
+  if (seed != 0) {
+    detail::xxh3_init_secret(custom_secret, seed);
+    secret = custom_secret;
+  }
+
+  alignas(64) u64 acc[8];
+  detail::xxh3_init_acc(acc);
+  detail::xxh3_hash_long(acc, input, size, secret);
+  return detail::xxh3_64_digest_long(acc, secret, size);
+}
+
+Hash128 hash_xxh3_128(const void *data, const usize size, const u64 seed) {
+  const auto input = static_cast<const u8 *>(data);
+  if (size <= 16) {
+    return detail::xxh3_128_short(input, size, detail::g_xxh3_secret, seed);
+  }
+  if (size <= detail::XXH3_MIDSIZE_MAX) {
+    return detail::xxh3_128_medium(input, size, detail::g_xxh3_secret, seed);
+  }
+
+  alignas(64) u8 custom_secret[detail::XXH3_SECRET_SIZE];
+  const u8 *secret = detail::g_xxh3_secret;
+  if (seed != 0) {
+    detail::xxh3_init_secret(custom_secret, seed);
+    secret = custom_secret;
+  }
+
+  alignas(64) u64 acc[8];
+  detail::xxh3_init_acc(acc);
+  detail::xxh3_hash_long(acc, input, size, secret);
+  return detail::xxh3_128_digest_long(acc, secret, size);
+}
+
+void HashStream::reset(const u64 seed) {
+  detail::xxh3_init_acc(m_acc);
+  if (seed != 0) {
+    detail::xxh3_init_secret(m_secret, seed);
+  } else {
+    memcpy(m_secret, detail::g_xxh3_secret, detail::XXH3_SECRET_SIZE);
+  }
+  m_seed = seed;
+  m_total_size = 0;
+  m_buffered = 0;
+  m_stripes_in_block = 0;
+}
+
+void HashStream::update(const void *data, const usize size) {
+  if (size == 0) {
+    return;
+  }
+
+  auto input = static_cast<const u8 *>(data);
+  const u8 *const end = input + size;
+  m_total_size += size;
+
+  if (size <= detail::XXH3_BUFFER_SIZE - m_buffered) {
+    memcpy(m_buffer + m_buffered, input, size);
+    m_buffered += size;
+    return;
+  }
+
+  // NOTE: Input is only consumed while more of it follows, the final stripe
+  // has to stay buffered for the digest.
+  constexpr usize buffer_stripes =
+      detail::XXH3_BUFFER_SIZE / detail::XXH3_STRIPE_SIZE;
+  if (m_buffered > 0) {
+    const usize fill = detail::XXH3_BUFFER_SIZE - m_buffered;
+    memcpy(m_buffer + m_buffered, input, fill);
+    input += fill;
+    detail::xxh3_consume_stripes(m_acc, &m_stripes_in_block, m_buffer,
+                                 buffer_stripes, m_secret);
+    m_buffered = 0;
+  }
+
+  if (static_cast<usize>(end - input) > detail::XXH3_BUFFER_SIZE) {
+    const usize stripes =
+        static_cast<usize>(end - 1 - input) / detail::XXH3_STRIPE_SIZE;
+    input = detail::xxh3_consume_stripes(m_acc, &m_stripes_in_block, input,
+                                         stripes, m_secret);
+    // NOTE: The digest may need the previous stripe to build the last one.
+    memcpy(m_buffer + detail::XXH3_BUFFER_SIZE - detail::XXH3_STRIPE_SIZE,
+           input - detail::XXH3_STRIPE_SIZE, detail::XXH3_STRIPE_SIZE);
+  }
+
+  m_buffered = static_cast<usize>(end - input);
+  memcpy(m_buffer, input, m_buffered);
+}
+
+namespace detail {
+static void hash_stream_digest_acc(const HashStream &stream, u64 *acc) {
+  memcpy(acc, stream.m_acc, sizeof(stream.m_acc));
+
+  u8 last_stripe[XXH3_STRIPE_SIZE];
+  const u8 *last_stripe_ptr;
+  if (stream.m_buffered >= XXH3_STRIPE_SIZE) {
+    const usize stripes = (stream.m_buffered - 1) / XXH3_STRIPE_SIZE;
+    usize stripes_in_block = stream.m_stripes_in_block;
+    xxh3_consume_stripes(acc, &stripes_in_block, stream.m_buffer, stripes,
+                         stream.m_secret);
+    last_stripe_ptr = stream.m_buffer + stream.m_buffered - XXH3_STRIPE_SIZE;
+  } else {
+    const usize catchup = XXH3_STRIPE_SIZE - stream.m_buffered;
+    memcpy(last_stripe, stream.m_buffer + XXH3_BUFFER_SIZE - catchup, catchup);
+    memcpy(last_stripe + catchup, stream.m_buffer, stream.m_buffered);
+    last_stripe_ptr = last_stripe;
+  }
+
+  xxh3_accumulate_512(acc, last_stripe_ptr,
+                      stream.m_secret + XXH3_SECRET_LIMIT - 7);
+}
+} // namespace detail
+
+u64 HashStream::digest64() const {
+  if (m_total_size <= detail::XXH3_MIDSIZE_MAX) {
+    return hash_xxh3_64(m_buffer, static_cast<usize>(m_total_size), m_seed);
+  }
+
+  alignas(64) u64 acc[8];
+  detail::hash_stream_digest_acc(*this, acc);
+  return detail::xxh3_64_digest_long(acc, m_secret, m_total_size);
+}
+
+Hash128 HashStream::digest128() const {
+  if (m_total_size <= detail::XXH3_MIDSIZE_MAX) {
+    return hash_xxh3_128(m_buffer, static_cast<usize>(m_total_size), m_seed);
+  }
+
+  alignas(64) u64 acc[8];
+  detail::hash_stream_digest_acc(*this, acc);
+  return detail::xxh3_128_digest_long(acc, m_secret, m_total_size);
+}
 } // namespace edge
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "random.hpp"
 
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
+#include <utility>
 
 #if EDGE_HAS_WINDOWS_API
 #include <windows.h>
@@ -53,6 +57,233 @@ namespace detail {
   c = c ^ (a << 5) ^ (b >> 23);
   return a ^ b ^ c;
 }
+
+#if EDGE_HAS_AVX2
+struct RngLanes {
+  using Type = __m256i;
+  static constexpr usize WIDTH = 4;
+
+  static Type load(const u64 *data) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(data));
+  }
+  static void store(u64 *data, const Type value) {
+    _mm256_store_si256(reinterpret_cast<__m256i *>(data), value);
+  }
+  static void store_bytes(void *data, const Type value) {
+    _mm256_storeu_si256(static_cast<__m256i *>(data), value);
+  }
+  static void store_unit_f32(f32 *data, const Type value) {
+    const __m256 unit = _mm256_cvtepi32_ps(_mm256_srli_epi32(value, 8));
+    _mm256_storeu_ps(data, _mm256_mul_ps(unit, _mm256_set1_ps(0x1.0p-24f)));
+  }
+  static Type add(const Type a, const Type b) { return _mm256_add_epi64(a, b); }
+  static Type op_or(const Type a, const Type b) { return _mm256_or_si256(a, b); }
+  static Type op_xor(const Type a, const Type b) {
+    return _mm256_xor_si256(a, b);
+  }
+  template <i32 N> static Type shl(const Type a) {
+    return _mm256_slli_epi64(a, N);
+  }
+  template <i32 N> static Type shr(const Type a) {
+    return _mm256_srli_epi64(a, N);
+  }
+};
+#elif EDGE_HAS_SSE2
+struct RngLanes {
+  using Type = __m128i;
+  static constexpr usize WIDTH = 2;
+
+  static Type load(const u64 *data) {
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(data));
+  }
+  static void store(u64 *data, const Type value) {
+    _mm_store_si128(reinterpret_cast<__m128i *>(data), value);
+  }
+  static void store_bytes(void *data, const Type value) {
+    _mm_storeu_si128(static_cast<__m128i *>(data), value);
+  }
+  static void store_unit_f32(f32 *data, const Type value) {
+    const __m128 unit = _mm_cvtepi32_ps(_mm_srli_epi32(value, 8));
+    _mm_storeu_ps(data, _mm_mul_ps(unit, _mm_set1_ps(0x1.0p-24f)));
+  }
+  static Type add(const Type a, const Type b) { return _mm_add_epi64(a, b); }
+  static Type op_or(const Type a, const Type b) { return _mm_or_si128(a, b); }
+  static Type op_xor(const Type a, const Type b) { return _mm_xor_si128(a, b); }
+  template <i32 N> static Type shl(const Type a) { return _mm_slli_epi64(a, N); }
+  template <i32 N> static Type shr(const Type a) { return _mm_srli_epi64(a, N); }
+};
+#elif EDGE_HAS_NEON
+struct RngLanes {
+  using Type = uint64x2_t;
+  static constexpr usize WIDTH = 2;
+
+  static Type load(const u64 *data) { return vld1q_u64(data); }
+  static void store(u64 *data, const Type value) { vst1q_u64(data, value); }
+  static void store_bytes(void *data, const Type value) {
+    vst1q_u8(static_cast<u8 *>(data), vreinterpretq_u8_u64(value));
+  }
+  static void store_unit_f32(f32 *data, const Type value) {
+    const float32x4_t unit =
+        vcvtq_f32_u32(vshrq_n_u32(vreinterpretq_u32_u64(value), 8));
+    vst1q_f32(data, vmulq_n_f32(unit, 0x1.0p-24f));
+  }
+  static Type add(const Type a, const Type b) { return vaddq_u64(a, b); }
+  static Type op_or(const Type a, const Type b) { return vorrq_u64(a, b); }
+  static Type op_xor(const Type a, const Type b) { return veorq_u64(a, b); }
+  template <i32 N> static Type shl(const Type a) { return vshlq_n_u64(a, N); }
+  template <i32 N> static Type shr(const Type a) { return vshrq_n_u64(a, N); }
+};
+#else
+struct RngLanes {
+  using Type = u64;
+  static constexpr usize WIDTH = 1;
+
+  static Type load(const u64 *data) { return *data; }
+  static void store(u64 *data, const Type value) { *data = value; }
+  static void store_bytes(void *data, const Type value) {
+    memcpy(data, &value, sizeof(value));
+  }
+  static void store_unit_f32(f32 *data, const Type value) {
+    data[0] = static_cast<f32>(static_cast<u32>(value) >> 8) * 0x1.0p-24f;
+    data[1] = static_cast<f32>(static_cast<u32>(value >> 32) >> 8) * 0x1.0p-24f;
+  }
+  static Type add(const Type a, const Type b) { return a + b; }
+  static Type op_or(const Type a, const Type b) { return a | b; }
+  static Type op_xor(const Type a, const Type b) { return a ^ b; }
+  template <i32 N> static Type shl(const Type a) { return a << N; }
+  template <i32 N> static Type shr(const Type a) { return a >> N; }
+};
+#endif
+
+constexpr usize RNG_LANE_REGS = RNG_BATCH_LANES / RngLanes::WIDTH;
+
+// NOTE: Register loops are unrolled with compile time indices, a plain loop
+// is left rolled at -O2 and the state arrays get spilled to the stack.
+template <typename Fn, usize... I>
+static EDGE_FORCE_INLINE void for_each_lane_reg(Fn &&fn,
+                                                std::index_sequence<I...>) {
+  (fn(std::integral_constant<usize, I>{}), ...);
+}
+
+template <typename Fn> static EDGE_FORCE_INLINE void for_each_lane_reg(Fn &&fn) {
+  for_each_lane_reg(fn, std::make_index_sequence<RNG_LANE_REGS>{});
+}
+
+// NOTE: One xoshiro256** step for every lane. The multiplies by 5 and 9 are
+// shift and add since AVX2 and NEON have no 64-bit lane multiply.
+template <typename Emit>
+static void xoshiro_batch_run(u64 (&state)[4][RNG_BATCH_LANES],
+                              const usize steps, Emit &&emit) {
+  using V = RngLanes;
+  V::Type s0[RNG_LANE_REGS], s1[RNG_LANE_REGS], s2[RNG_LANE_REGS],
+      s3[RNG_LANE_REGS];
+  for_each_lane_reg([&](const auto r) {
+    s0[r] = V::load(state[0] + r * V::WIDTH);
+    s1[r] = V::load(state[1] + r * V::WIDTH);
+    s2[r] = V::load(state[2] + r * V::WIDTH);
+    s3[r] = V::load(state[3] + r * V::WIDTH);
+  });
+
+  for (usize step = 0; step < steps; ++step) {
+    V::Type result[RNG_LANE_REGS];
+    for_each_lane_reg([&](const auto r) {
+      const V::Type times5 = V::add(s1[r], V::shl<2>(s1[r]));
+      const V::Type rotated = V::op_or(V::shl<7>(times5), V::shr<57>(times5));
+      result[r] = V::add(rotated, V::shl<3>(rotated));
+
+      const V::Type t = V::shl<17>(s1[r]);
+      s2[r] = V::op_xor(s2[r], s0[r]);
+      s3[r] = V::op_xor(s3[r], s1[r]);
+      s1[r] = V::op_xor(s1[r], s2[r]);
+      s0[r] = V::op_xor(s0[r], s3[r]);
+      s2[r] = V::op_xor(s2[r], t);
+      s3[r] = V::op_or(V::shl<45>(s3[r]), V::shr<19>(s3[r]));
+    });
+    emit(step, result);
+  }
+
+  for_each_lane_reg([&](const auto r) {
+    V::store(state[0] + r * V::WIDTH, s0[r]);
+    V::store(state[1] + r * V::WIDTH, s1[r]);
+    V::store(state[2] + r * V::WIDTH, s2[r]);
+    V::store(state[3] + r * V::WIDTH, s3[r]);
+  });
+}
+
+constexpr usize ZIGGURAT_LAYERS = 256;
+constexpr f64 ZIGGURAT_R = 3.6541528853610088;
+constexpr f64 ZIGGURAT_AREA = 4.928673233974658e-3;
+
+struct ZigguratTables {
+  u32 k[ZIGGURAT_LAYERS];
+  f32 w[ZIGGURAT_LAYERS];
+  f32 f[ZIGGURAT_LAYERS];
+};
+
+static ZigguratTables ziggurat_make_tables() {
+  constexpr f64 scale = 2147483648.0;
+  ZigguratTables tables = {};
+
+  f64 dn = ZIGGURAT_R;
+  f64 tn = dn;
+  const f64 q = ZIGGURAT_AREA / std::exp(-0.5 * dn * dn);
+  tables.k[0] = static_cast<u32>((dn / q) * scale);
+  tables.k[1] = 0;
+  tables.w[0] = static_cast<f32>(q / scale);
+  tables.w[ZIGGURAT_LAYERS - 1] = static_cast<f32>(dn / scale);
+  tables.f[0] = 1.0f;
+  tables.f[ZIGGURAT_LAYERS - 1] = static_cast<f32>(std::exp(-0.5 * dn * dn));
+
+  for (usize i = ZIGGURAT_LAYERS - 2; i >= 1; --i) {
+    dn = std::sqrt(-2.0 * std::log(ZIGGURAT_AREA / dn + std::exp(-0.5 * dn * dn)));
+    tables.k[i + 1] = static_cast<u32>((dn / tn) * scale);
+    tn = dn;
+    tables.f[i] = static_cast<f32>(std::exp(-0.5 * dn * dn));
+    tables.w[i] = static_cast<f32>(dn / scale);
+  }
+  return tables;
+}
+
+static const ZigguratTables &ziggurat_tables() {
+  static const ZigguratTables tables = ziggurat_make_tables();
+  return tables;
+}
+
+static f32 unit_open_f32(const u64 bits) {
+  return static_cast<f32>((bits >> 40) + 1) * 0x1.0p-24f;
+}
+
+// NOTE: The layer index and the signed abscissa come from different halves
+// of one output, avoiding the layer/value correlation of the 32-bit original.
+template <typename NextBits>
+static f32 ziggurat_slow(const ZigguratTables &zig, u64 bits,
+                         NextBits &&next_bits) {
+  for (;;) {
+    const i32 hz = static_cast<i32>(bits >> 32);
+    const u32 iz = static_cast<u32>(bits) & (ZIGGURAT_LAYERS - 1);
+    const u32 magnitude = hz < 0 ? 0u - static_cast<u32>(hz) : static_cast<u32>(hz);
+    const f32 x = static_cast<f32>(hz) * zig.w[iz];
+    if (magnitude < zig.k[iz]) {
+      return x;
+    }
+
+    if (iz == 0) {
+      constexpr f32 r = static_cast<f32>(ZIGGURAT_R);
+      f32 tx, ty;
+      do {
+        tx = -std::log(unit_open_f32(next_bits())) * (1.0f / r);
+        ty = -std::log(unit_open_f32(next_bits()));
+      } while (ty + ty < tx * tx);
+      return hz > 0 ? r + tx : -r - tx;
+    }
+
+    const f32 y = zig.f[iz] + unit_open_f32(next_bits()) * (zig.f[iz - 1] - zig.f[iz]);
+    if (y < std::exp(-0.5f * x * x)) {
+      return x;
+    }
+    bits = next_bits();
+  }
+}
 } // namespace detail
 
 template <RngAlgorithm Algorithm> void rng_seed_entropy(Algorithm &state) {
@@ -73,4 +304,166 @@ void rng_seed_entropy_secure(Algorithm &state) {
     rng_seed_entropy(state);
   }
 }
-} // namespace edge
\ No newline at end of file
+
+void RngXoshiro256Batch::seed_stream(const u64 seed_val, u32 stream) noexcept {
+  RngXoshiro256 base = {};
+  base.seed(seed_val);
+  while (stream-- > 0) {
+    base.long_jump();
+  }
+  seed_lanes(base);
+}
+
+void RngXoshiro256Batch::seed_lanes(RngXoshiro256 base) noexcept {
+  for (usize lane = 0; lane < RNG_BATCH_LANES; ++lane) {
+    for (usize i = 0; i < 4; ++i) {
+      m_state[i][lane] = base.s[i];
+    }
+    base.jump();
+  }
+  m_buffer_pos = RNG_BATCH_BUFFER;
+}
+
+void RngXoshiro256Batch::fill_u64(u64 *out, const usize count) noexcept {
+  using V = detail::RngLanes;
+  const usize steps = count / RNG_BATCH_LANES;
+  detail::xoshiro_batch_run(m_state, steps, [out](const usize step, const V::Type *result) {
+    detail::for_each_lane_reg([&](const auto r) {
+      V::store_bytes(out + step * RNG_BATCH_LANES + r * V::WIDTH, result[r]);
+    });
+  });
+
+  const usize rest = count - steps * RNG_BATCH_LANES;
+  if (rest > 0) {
+    u64 tail[RNG_BATCH_LANES];
+    fill_u64(tail, RNG_BATCH_LANES);
+    memcpy(out + steps * RNG_BATCH_LANES, tail, rest * sizeof(u64));
+  }
+}
+
+void RngXoshiro256Batch::fill_u32(u32 *out, const usize count) noexcept {
+  constexpr usize STEP = RNG_BATCH_LANES * 2;
+  using V = detail::RngLanes;
+  const usize steps = count / STEP;
+  detail::xoshiro_batch_run(m_state, steps, [out](const usize step, const V::Type *result) {
+    detail::for_each_lane_reg([&](const auto r) {
+      V::store_bytes(out + step * STEP + r * V::WIDTH * 2, result[r]);
+    });
+  });
+
+  const usize rest = count - steps * STEP;
+  if (rest > 0) {
+    u32 tail[STEP];
+    fill_u32(tail, STEP);
+    memcpy(out + steps * STEP, tail, rest * sizeof(u32));
+  }
+}
+
+void RngXoshiro256Batch::fill_f32(f32 *out, const usize count) noexcept {
+  constexpr usize STEP = RNG_BATCH_LANES * 2;
+  using V = detail::RngLanes;
+  const usize steps = count / STEP;
+  detail::xoshiro_batch_run(m_state, steps, [out](const usize step, const V::Type *result) {
+    detail::for_each_lane_reg([&](const auto r) {
+      V::store_unit_f32(out + step * STEP + r * V::WIDTH * 2, result[r]);
+    });
+  });
+
+  const usize rest = count - steps * STEP;
+  if (rest > 0) {
+    f32 tail[STEP];
+    fill_f32(tail, STEP);
+    memcpy(out + steps * STEP, tail, rest * sizeof(f32));
+  }
+}
+
+void RngXoshiro256Batch::fill_f32_range(f32 *out, const usize count,
+                                        const f32 min_val,
+                                        const f32 max_val) noexcept {
+  fill_f32(out, count);
+  const f32 range = max_val - min_val;
+  for (usize i = 0; i < count; ++i) {
+    out[i] = min_val + out[i] * range;
+  }
+}
+
+void RngXoshiro256Batch::fill_normal_f32(f32 *out, const usize count,
+                                         const f32 mean,
+                                         const f32 stddev) noexcept {
+  constexpr usize BLOCK = 256;
+  constexpr usize GROUP = 8;
+  const detail::ZigguratTables &zig = detail::ziggurat_tables();
+
+  u64 bits[BLOCK];
+  usize pos = BLOCK;
+  auto next_bits = [&]() {
+    if (pos == BLOCK) {
+      fill_u64(bits, BLOCK);
+      pos = 0;
+    }
+    return bits[pos++];
+  };
+
+  // NOTE: Draws are taken eight at a time and rejected lanes are redrawn
+  // after the group, so every instruction set yields the same sequence.
+  for (usize i = 0; i < count; i += GROUP) {
+    if (pos > BLOCK - GROUP) {
+      fill_u64(bits, BLOCK);
+      pos = 0;
+    }
+    const u64 *draws = bits + pos;
+    pos += GROUP;
+
+    f32 values[GROUP];
+    u32 accepted = 0;
+#if EDGE_HAS_AVX2
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(draws));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(draws + 4));
+    const __m256i lo = _mm256_permute4x64_epi64(
+        _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b),
+                                              _MM_SHUFFLE(2, 0, 2, 0))),
+        _MM_SHUFFLE(3, 1, 2, 0));
+    const __m256i hz = _mm256_permute4x64_epi64(
+        _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b),
+                                              _MM_SHUFFLE(3, 1, 3, 1))),
+        _MM_SHUFFLE(3, 1, 2, 0));
+    const __m256i iz = _mm256_and_si256(lo, _mm256_set1_epi32(detail::ZIGGURAT_LAYERS - 1));
+    const __m256i k = _mm256_i32gather_epi32(reinterpret_cast<const int *>(zig.k), iz, 4);
+    const __m256 w = _mm256_i32gather_ps(zig.w, iz, 4);
+    const __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(hz), w);
+
+    // NOTE: Unsigned compare through the sign flip, |INT_MIN| must reject.
+    const __m256i flip = _mm256_set1_epi32(static_cast<i32>(0x80000000u));
+    const __m256i inside = _mm256_cmpgt_epi32(_mm256_xor_si256(k, flip),
+                                              _mm256_xor_si256(_mm256_abs_epi32(hz), flip));
+    accepted = static_cast<u32>(_mm256_movemask_ps(_mm256_castsi256_ps(inside)));
+    if (accepted == 0xFF && count - i >= GROUP) {
+      _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_set1_ps(mean),
+                                              _mm256_mul_ps(_mm256_set1_ps(stddev), x)));
+      continue;
+    }
+    _mm256_storeu_ps(values, x);
+#else
+    for (usize lane = 0; lane < GROUP; ++lane) {
+      const i32 hz = static_cast<i32>(draws[lane] >> 32);
+      const u32 iz = static_cast<u32>(draws[lane]) & (detail::ZIGGURAT_LAYERS - 1);
+      const u32 magnitude = hz < 0 ? 0u - static_cast<u32>(hz) : static_cast<u32>(hz);
+      values[lane] = static_cast<f32>(hz) * zig.w[iz];
+      accepted |= static_cast<u32>(magnitude < zig.k[iz]) << lane;
+    }
+#endif
+
+    // NOTE: Redraws may refill the block, keep the group's own draws aside.
+    u64 group[GROUP];
+    memcpy(group, draws, sizeof(group));
+    const usize used = count - i < GROUP ? count - i : GROUP;
+    for (usize lane = 0; lane < used; ++lane) {
+      // NOTE: Roughly 99% of draws land inside a layer rectangle.
+      if (!(accepted & (1u << lane))) [[unlikely]] {
+        values[lane] = detail::ziggurat_slow(zig, group[lane], next_bits);
+      }
+      out[i + lane] = mean + stddev * values[lane];
+    }
+  }
+}
+} // namespace edge
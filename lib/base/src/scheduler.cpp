@@ -1,9 +1,9 @@
 #include "scheduler.hpp"
 
+#include <format.hpp>
 #include <vmem.hpp>
 
 #include <cassert>
-#include <cstdio>
 #include <ctime>
 
 namespace edge {
@@ -125,7 +125,8 @@ struct Scheduler::Worker {
   usize thread_id = 0;
   std::atomic<bool> should_exit = false;
 
-  static Worker *create(NotNull<const Allocator *> alloc);
+  static Worker *create(NotNull<const Allocator *> alloc, Scheduler *sched,
+                        Workgroup wg, usize thread_id);
   static void destroy(NotNull<const Allocator *> alloc, Worker *self);
 
   static i32 entry(void *arg) {
@@ -165,13 +166,20 @@ struct SchedulerThreadContext {
 
 static thread_local SchedulerThreadContext thread_context = {};
 
-Scheduler::Worker *Scheduler::Worker::create(const NotNull<const Allocator *> alloc) {
+Scheduler::Worker *Scheduler::Worker::create(const NotNull<const Allocator *> alloc,
+                                             Scheduler *sched,
+                                             const Workgroup wg,
+                                             const usize thread_id) {
   auto *worker = alloc->allocate<Worker>();
   if (!worker) {
     return nullptr;
   }
 
+  // NOTE: Everything the thread reads has to be set before it starts.
   worker->allocator = alloc.m_ptr;
+  worker->wg = wg;
+  worker->scheduler = sched;
+  worker->thread_id = thread_id;
   worker->should_exit.store(false, std::memory_order_relaxed);
 
   if (thread_create(&worker->thread_handle, entry, worker) !=
@@ -475,16 +483,12 @@ Scheduler *Scheduler::create(const NotNull<const Allocator *> alloc) {
     char buffer[32] = {};
 
     {
-      Worker *worker = Worker::create(alloc);
+      Worker *worker = Worker::create(alloc, sched, IO, i);
       if (!worker) {
         destroy(alloc, sched);
         return nullptr;
       }
 
-      worker->wg = IO;
-      worker->scheduler = sched;
-      worker->thread_id = i;
-
       if (!sched->io_threads.push_back(alloc, worker)) {
         destroy(alloc, sched);
         return nullptr;
@@ -493,21 +497,17 @@ Scheduler *Scheduler::create(const NotNull<const Allocator *> alloc) {
       thread_set_affinity_ex(worker->thread_handle, cpu_info, cpu_count, i,
                              false);
 
-      snprintf(buffer, sizeof(buffer), "io-%d", i);
+      format_to(buffer, "io-{}", i);
       thread_set_name(worker->thread_handle, buffer);
     }
 
     {
-      Worker *worker = Worker::create(alloc);
+      Worker *worker = Worker::create(alloc, sched, Background, i);
       if (!worker) {
         destroy(alloc, sched);
         return nullptr;
       }
 
-      worker->wg = Background;
-      worker->scheduler = sched;
-      worker->thread_id = i;
-
       if (!sched->background_threads.push_back(alloc, worker)) {
         destroy(alloc, sched);
         return nullptr;
@@ -516,7 +516,7 @@ Scheduler *Scheduler::create(const NotNull<const Allocator *> alloc) {
       thread_set_affinity_ex(worker->thread_handle, cpu_info, cpu_count, i,
                              false);
 
-      snprintf(buffer, sizeof(buffer), "background-%d", i);
+      format_to(buffer, "background-{}", i);
       thread_set_name(worker->thread_handle, buffer);
     }
   }
@@ -0,0 +1,513 @@
+#include "simd_math.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace edge {
+namespace detail {
+struct MathLanesScalar {
+  using Type = f32;
+  static constexpr usize WIDTH = 1;
+
+  static Type load(const f32 *data) { return *data; }
+  static void store(f32 *data, const Type value) { *data = value; }
+  static Type splat(const f32 value) { return value; }
+  static Type add(const Type a, const Type b) { return a + b; }
+  static Type sub(const Type a, const Type b) { return a - b; }
+  static Type mul(const Type a, const Type b) { return a * b; }
+  static Type div(const Type a, const Type b) { return a / b; }
+  static Type madd(const Type a, const Type b, const Type c) { return a * b + c; }
+  static Type min(const Type a, const Type b) { return b < a ? b : a; }
+  static Type max(const Type a, const Type b) { return a < b ? b : a; }
+
+  static void load_column(const Mat4 *m, const i32 column, Type (&rows)[4]) {
+    const Vec4 &value = m->m_columns[column];
+    rows[0] = value.x;
+    rows[1] = value.y;
+    rows[2] = value.z;
+    rows[3] = value.w;
+  }
+  static void store_column(Mat4 *m, const i32 column, const Type (&rows)[4]) {
+    m->m_columns[column] = {rows[0], rows[1], rows[2], rows[3]};
+  }
+};
+
+// NOTE: Column load and store transpose one column of WIDTH matrices so that
+// lane i always belongs to matrix i, same as the SoA inputs.
+#if EDGE_HAS_AVX2
+struct MathLanes {
+  using Type = __m256;
+  static constexpr usize WIDTH = 8;
+
+  static Type load(const f32 *data) { return _mm256_loadu_ps(data); }
+  static void store(f32 *data, const Type value) { _mm256_storeu_ps(data, value); }
+  static Type splat(const f32 value) { return _mm256_set1_ps(value); }
+  static Type add(const Type a, const Type b) { return _mm256_add_ps(a, b); }
+  static Type sub(const Type a, const Type b) { return _mm256_sub_ps(a, b); }
+  static Type mul(const Type a, const Type b) { return _mm256_mul_ps(a, b); }
+  static Type div(const Type a, const Type b) { return _mm256_div_ps(a, b); }
+  static Type madd(const Type a, const Type b, const Type c) {
+#if EDGE_HAS_FMA
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+  }
+  static Type min(const Type a, const Type b) { return _mm256_min_ps(a, b); }
+  static Type max(const Type a, const Type b) { return _mm256_max_ps(a, b); }
+
+  static void transpose(Type (&v)[4]) {
+    const __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(v[0], v[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(v[2], v[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(v[2], v[3]);
+    v[0] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    v[1] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    v[2] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    v[3] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  }
+  static void load_column(const Mat4 *m, const i32 column, Type (&rows)[4]) {
+    for (i32 i = 0; i < 4; ++i) {
+      const __m128 low = _mm_load_ps(&m[i].m_columns[column].x);
+      const __m128 high = _mm_load_ps(&m[i + 4].m_columns[column].x);
+      rows[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+    }
+    transpose(rows);
+  }
+  static void store_column(Mat4 *m, const i32 column, const Type (&rows)[4]) {
+    Type values[4] = {rows[0], rows[1], rows[2], rows[3]};
+    transpose(values);
+    for (i32 i = 0; i < 4; ++i) {
+      _mm_store_ps(&m[i].m_columns[column].x, _mm256_castps256_ps128(values[i]));
+      _mm_store_ps(&m[i + 4].m_columns[column].x,
+                   _mm256_extractf128_ps(values[i], 1));
+    }
+  }
+};
+#elif EDGE_HAS_SSE2
+struct MathLanes {
+  using Type = __m128;
+  static constexpr usize WIDTH = 4;
+
+  static Type load(const f32 *data) { return _mm_loadu_ps(data); }
+  static void store(f32 *data, const Type value) { _mm_storeu_ps(data, value); }
+  static Type splat(const f32 value) { return _mm_set1_ps(value); }
+  static Type add(const Type a, const Type b) { return _mm_add_ps(a, b); }
+  static Type sub(const Type a, const Type b) { return _mm_sub_ps(a, b); }
+  static Type mul(const Type a, const Type b) { return _mm_mul_ps(a, b); }
+  static Type div(const Type a, const Type b) { return _mm_div_ps(a, b); }
+  static Type madd(const Type a, const Type b, const Type c) {
+    return f32x4_madd(a, b, c);
+  }
+  static Type min(const Type a, const Type b) { return _mm_min_ps(a, b); }
+  static Type max(const Type a, const Type b) { return _mm_max_ps(a, b); }
+
+  static void load_column(const Mat4 *m, const i32 column, Type (&rows)[4]) {
+    for (i32 i = 0; i < 4; ++i) {
+      rows[i] = _mm_load_ps(&m[i].m_columns[column].x);
+    }
+    _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+  }
+  static void store_column(Mat4 *m, const i32 column, const Type (&rows)[4]) {
+    Type r0 = rows[0], r1 = rows[1], r2 = rows[2], r3 = rows[3];
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_store_ps(&m[0].m_columns[column].x, r0);
+    _mm_store_ps(&m[1].m_columns[column].x, r1);
+    _mm_store_ps(&m[2].m_columns[column].x, r2);
+    _mm_store_ps(&m[3].m_columns[column].x, r3);
+  }
+};
+#elif EDGE_HAS_NEON
+struct MathLanes {
+  using Type = float32x4_t;
+  static constexpr usize WIDTH = 4;
+
+  static Type load(const f32 *data) { return vld1q_f32(data); }
+  static void store(f32 *data, const Type value) { vst1q_f32(data, value); }
+  static Type splat(const f32 value) { return vdupq_n_f32(value); }
+  static Type add(const Type a, const Type b) { return vaddq_f32(a, b); }
+  static Type sub(const Type a, const Type b) { return vsubq_f32(a, b); }
+  static Type mul(const Type a, const Type b) { return vmulq_f32(a, b); }
+  static Type div(const Type a, const Type b) { return f32x4_div(a, b); }
+  static Type madd(const Type a, const Type b, const Type c) {
+    return f32x4_madd(a, b, c);
+  }
+  static Type min(const Type a, const Type b) { return vminq_f32(a, b); }
+  static Type max(const Type a, const Type b) { return vmaxq_f32(a, b); }
+
+  static void transpose(Type (&v)[4]) {
+    const float32x4x2_t t01 = vtrnq_f32(v[0], v[1]);
+    const float32x4x2_t t23 = vtrnq_f32(v[2], v[3]);
+    v[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    v[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    v[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    v[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+  }
+  static void load_column(const Mat4 *m, const i32 column, Type (&rows)[4]) {
+    for (i32 i = 0; i < 4; ++i) {
+      rows[i] = vld1q_f32(&m[i].m_columns[column].x);
+    }
+    transpose(rows);
+  }
+  static void store_column(Mat4 *m, const i32 column, const Type (&rows)[4]) {
+    Type values[4] = {rows[0], rows[1], rows[2], rows[3]};
+    transpose(values);
+    for (i32 i = 0; i < 4; ++i) {
+      vst1q_f32(&m[i].m_columns[column].x, values[i]);
+    }
+  }
+};
+#else
+using MathLanes = MathLanesScalar;
+#endif
+
+template <typename L>
+static usize transform_points_run(const Mat4 &m, const Vec3Soa &in,
+                                  const Vec3Soa &out, usize i, const usize count) {
+  using V = typename L::Type;
+  const V m00 = L::splat(m.m_columns[0].x), m01 = L::splat(m.m_columns[0].y),
+          m02 = L::splat(m.m_columns[0].z);
+  const V m10 = L::splat(m.m_columns[1].x), m11 = L::splat(m.m_columns[1].y),
+          m12 = L::splat(m.m_columns[1].z);
+  const V m20 = L::splat(m.m_columns[2].x), m21 = L::splat(m.m_columns[2].y),
+          m22 = L::splat(m.m_columns[2].z);
+  const V m30 = L::splat(m.m_columns[3].x), m31 = L::splat(m.m_columns[3].y),
+          m32 = L::splat(m.m_columns[3].z);
+
+  for (; i + L::WIDTH <= count; i += L::WIDTH) {
+    const V x = L::load(in.m_x + i);
+    const V y = L::load(in.m_y + i);
+    const V z = L::load(in.m_z + i);
+    L::store(out.m_x + i, L::madd(m20, z, L::madd(m10, y, L::madd(m00, x, m30))));
+    L::store(out.m_y + i, L::madd(m21, z, L::madd(m11, y, L::madd(m01, x, m31))));
+    L::store(out.m_z + i, L::madd(m22, z, L::madd(m12, y, L::madd(m02, x, m32))));
+  }
+  return i;
+}
+
+// NOTE: Cofactor expansion through 2x2 minors of the top and bottom row
+// pairs. Returns the reciprocal determinant lanes, inf or nan when singular.
+template <typename L>
+static typename L::Type mat4_inverse_lanes(const Mat4 *in, Mat4 *out) {
+  using V = typename L::Type;
+  V a[4][4];
+  for (i32 c = 0; c < 4; ++c) {
+    L::load_column(in, c, a[c]);
+  }
+
+  const V s0 = L::sub(L::mul(a[0][0], a[1][1]), L::mul(a[1][0], a[0][1]));
+  const V s1 = L::sub(L::mul(a[0][0], a[1][2]), L::mul(a[1][0], a[0][2]));
+  const V s2 = L::sub(L::mul(a[0][0], a[1][3]), L::mul(a[1][0], a[0][3]));
+  const V s3 = L::sub(L::mul(a[0][1], a[1][2]), L::mul(a[1][1], a[0][2]));
+  const V s4 = L::sub(L::mul(a[0][1], a[1][3]), L::mul(a[1][1], a[0][3]));
+  const V s5 = L::sub(L::mul(a[0][2], a[1][3]), L::mul(a[1][2], a[0][3]));
+  const V c5 = L::sub(L::mul(a[2][2], a[3][3]), L::mul(a[3][2], a[2][3]));
+  const V c4 = L::sub(L::mul(a[2][1], a[3][3]), L::mul(a[3][1], a[2][3]));
+  const V c3 = L::sub(L::mul(a[2][1], a[3][2]), L::mul(a[3][1], a[2][2]));
+  const V c2 = L::sub(L::mul(a[2][0], a[3][3]), L::mul(a[3][0], a[2][3]));
+  const V c1 = L::sub(L::mul(a[2][0], a[3][2]), L::mul(a[3][0], a[2][2]));
+  const V c0 = L::sub(L::mul(a[2][0], a[3][1]), L::mul(a[3][0], a[2][1]));
+
+  V det = L::sub(L::mul(s0, c5), L::mul(s1, c4));
+  det = L::madd(s2, c3, det);
+  det = L::madd(s3, c2, det);
+  det = L::sub(det, L::mul(s4, c1));
+  det = L::madd(s5, c0, det);
+  const V inv_det = L::div(L::splat(1.0f), det);
+  const V neg_inv_det = L::sub(L::splat(0.0f), inv_det);
+
+  // NOTE: r = (x*p - y*q + z*r) * scale, scale carries the cofactor sign.
+  const auto cofactor = [](const V x, const V p, const V y, const V q, const V z,
+                           const V r, const V scale) {
+    return L::mul(L::madd(z, r, L::sub(L::mul(x, p), L::mul(y, q))), scale);
+  };
+
+  V b[4][4];
+  b[0][0] = cofactor(a[1][1], c5, a[1][2], c4, a[1][3], c3, inv_det);
+  b[0][1] = cofactor(a[0][1], c5, a[0][2], c4, a[0][3], c3, neg_inv_det);
+  b[0][2] = cofactor(a[3][1], s5, a[3][2], s4, a[3][3], s3, inv_det);
+  b[0][3] = cofactor(a[2][1], s5, a[2][2], s4, a[2][3], s3, neg_inv_det);
+  b[1][0] = cofactor(a[1][0], c5, a[1][2], c2, a[1][3], c1, neg_inv_det);
+  b[1][1] = cofactor(a[0][0], c5, a[0][2], c2, a[0][3], c1, inv_det);
+  b[1][2] = cofactor(a[3][0], s5, a[3][2], s2, a[3][3], s1, neg_inv_det);
+  b[1][3] = cofactor(a[2][0], s5, a[2][2], s2, a[2][3], s1, inv_det);
+  b[2][0] = cofactor(a[1][0], c4, a[1][1], c2, a[1][3], c0, inv_det);
+  b[2][1] = cofactor(a[0][0], c4, a[0][1], c2, a[0][3], c0, neg_inv_det);
+  b[2][2] = cofactor(a[3][0], s4, a[3][1], s2, a[3][3], s0, inv_det);
+  b[2][3] = cofactor(a[2][0], s4, a[2][1], s2, a[2][3], s0, neg_inv_det);
+  b[3][0] = cofactor(a[1][0], c3, a[1][1], c1, a[1][2], c0, neg_inv_det);
+  b[3][1] = cofactor(a[0][0], c3, a[0][1], c1, a[0][2], c0, inv_det);
+  b[3][2] = cofactor(a[3][0], s3, a[3][1], s1, a[3][2], s0, neg_inv_det);
+  b[3][3] = cofactor(a[2][0], s3, a[2][1], s1, a[2][2], s0, inv_det);
+
+  for (i32 c = 0; c < 4; ++c) {
+    L::store_column(out, c, b[c]);
+  }
+  return inv_det;
+}
+
+template <typename L>
+static usize mat4_inverse_run(const Mat4 *in, Mat4 *out, usize i, const usize count,
+                              u8 *invertible) {
+  for (; i + L::WIDTH <= count; i += L::WIDTH) {
+    alignas(32) f32 inv_det[L::WIDTH];
+    L::store(inv_det, mat4_inverse_lanes<L>(in + i, out + i));
+
+    for (usize lane = 0; lane < L::WIDTH; ++lane) {
+      const usize index = i + lane;
+      const bool ok = std::isfinite(inv_det[lane]);
+      if (!ok) {
+        out[index] = {{Vec4{}, Vec4{}, Vec4{}, Vec4{}}};
+      }
+      if (invertible) {
+        const u8 bit = static_cast<u8>(1u << (index & 7));
+        invertible[index >> 3] =
+            ok ? static_cast<u8>(invertible[index >> 3] | bit)
+               : static_cast<u8>(invertible[index >> 3] & ~bit);
+      }
+    }
+  }
+  return i;
+}
+
+template <typename L>
+static usize mat4_from_trs_run(const Vec3Soa &t, const QuatSoa &r, const Vec3Soa &s,
+                               Mat4 *out, usize i, const usize count) {
+  using V = typename L::Type;
+  const V one = L::splat(1.0f);
+  const V two = L::splat(2.0f);
+  const V zero = L::splat(0.0f);
+
+  for (; i + L::WIDTH <= count; i += L::WIDTH) {
+    const V x = L::load(r.m_x + i);
+    const V y = L::load(r.m_y + i);
+    const V z = L::load(r.m_z + i);
+    const V w = L::load(r.m_w + i);
+    const V x2 = L::mul(x, two), y2 = L::mul(y, two), z2 = L::mul(z, two);
+    const V xx = L::mul(x, x2), yy = L::mul(y, y2), zz = L::mul(z, z2);
+    const V xy = L::mul(x, y2), xz = L::mul(x, z2), yz = L::mul(y, z2);
+    const V wx = L::mul(w, x2), wy = L::mul(w, y2), wz = L::mul(w, z2);
+
+    const V sx = L::load(s.m_x + i);
+    const V sy = L::load(s.m_y + i);
+    const V sz = L::load(s.m_z + i);
+
+    V column[4];
+    column[0] = L::mul(L::sub(one, L::add(yy, zz)), sx);
+    column[1] = L::mul(L::add(xy, wz), sx);
+    column[2] = L::mul(L::sub(xz, wy), sx);
+    column[3] = zero;
+    L::store_column(out + i, 0, column);
+
+    column[0] = L::mul(L::sub(xy, wz), sy);
+    column[1] = L::mul(L::sub(one, L::add(xx, zz)), sy);
+    column[2] = L::mul(L::add(yz, wx), sy);
+    L::store_column(out + i, 1, column);
+
+    column[0] = L::mul(L::add(xz, wy), sz);
+    column[1] = L::mul(L::sub(yz, wx), sz);
+    column[2] = L::mul(L::sub(one, L::add(xx, yy)), sz);
+    L::store_column(out + i, 2, column);
+
+    column[0] = L::load(t.m_x + i);
+    column[1] = L::load(t.m_y + i);
+    column[2] = L::load(t.m_z + i);
+    column[3] = one;
+    L::store_column(out + i, 3, column);
+  }
+  return i;
+}
+
+template <typename L>
+static usize aabb_from_points_run(const Vec3Soa &points, usize i, const usize count,
+                                  Aabb &result) {
+  using V = typename L::Type;
+  if (i + L::WIDTH > count) {
+    return i;
+  }
+
+  V min_x = L::load(points.m_x + i), max_x = min_x;
+  V min_y = L::load(points.m_y + i), max_y = min_y;
+  V min_z = L::load(points.m_z + i), max_z = min_z;
+  for (i += L::WIDTH; i + L::WIDTH <= count; i += L::WIDTH) {
+    const V x = L::load(points.m_x + i);
+    const V y = L::load(points.m_y + i);
+    const V z = L::load(points.m_z + i);
+    min_x = L::min(min_x, x);
+    max_x = L::max(max_x, x);
+    min_y = L::min(min_y, y);
+    max_y = L::max(max_y, y);
+    min_z = L::min(min_z, z);
+    max_z = L::max(max_z, z);
+  }
+
+  alignas(32) f32 lanes[6][L::WIDTH];
+  L::store(lanes[0], min_x);
+  L::store(lanes[1], min_y);
+  L::store(lanes[2], min_z);
+  L::store(lanes[3], max_x);
+  L::store(lanes[4], max_y);
+  L::store(lanes[5], max_z);
+  for (usize lane = 0; lane < L::WIDTH; ++lane) {
+    result.m_min.x = edge::min(result.m_min.x, lanes[0][lane]);
+    result.m_min.y = edge::min(result.m_min.y, lanes[1][lane]);
+    result.m_min.z = edge::min(result.m_min.z, lanes[2][lane]);
+    result.m_max.x = edge::max(result.m_max.x, lanes[3][lane]);
+    result.m_max.y = edge::max(result.m_max.y, lanes[4][lane]);
+    result.m_max.z = edge::max(result.m_max.z, lanes[5][lane]);
+  }
+  return i;
+}
+} // namespace detail
+
+Mat4 mat4_transpose(const Mat4 &m) {
+  f32 values[16];
+  memcpy(values, &m, sizeof(values));
+  for (i32 c = 0; c < 4; ++c) {
+    for (i32 r = c + 1; r < 4; ++r) {
+      swap(values[c * 4 + r], values[r * 4 + c]);
+    }
+  }
+  Mat4 result;
+  memcpy(&result, values, sizeof(values));
+  return result;
+}
+
+bool mat4_inverse(const Mat4 &m, Mat4 &out) {
+  Mat4 result;
+  if (!std::isfinite(detail::mat4_inverse_lanes<detail::MathLanesScalar>(&m, &result))) {
+    return false;
+  }
+  out = result;
+  return true;
+}
+
+Mat4 mat4_from_trs(Vec3 translation, Quat rotation, Vec3 scale) {
+  const Vec3Soa t = {&translation.x, &translation.y, &translation.z};
+  const QuatSoa r = {&rotation.x, &rotation.y, &rotation.z, &rotation.w};
+  const Vec3Soa s = {&scale.x, &scale.y, &scale.z};
+  Mat4 result;
+  detail::mat4_from_trs_run<detail::MathLanesScalar>(t, r, s, &result, 0, 1);
+  return result;
+}
+
+Mat4 quat_to_mat4(const Quat &q) {
+  return mat4_from_trs({0.0f, 0.0f, 0.0f}, q, {1.0f, 1.0f, 1.0f});
+}
+
+Quat quat_slerp(const Quat &a, const Quat &b, const f32 t) {
+  Quat target = b;
+  f32 cos_theta = quat_dot(a, b);
+  if (cos_theta < 0.0f) {
+    target = {-b.x, -b.y, -b.z, -b.w};
+    cos_theta = -cos_theta;
+  }
+
+  f32 wa = 1.0f - t;
+  f32 wb = t;
+  // NOTE: Nearly parallel quaternions fall back to nlerp, sin(theta) is too
+  // small to divide by.
+  if (cos_theta < 1.0f - 1e-4f) {
+    const f32 theta = std::acos(cos_theta);
+    const f32 inv_sin = 1.0f / std::sin(theta);
+    wa = std::sin(wa * theta) * inv_sin;
+    wb = std::sin(wb * theta) * inv_sin;
+  }
+
+  return quat_normalize({a.x * wa + target.x * wb, a.y * wa + target.y * wb,
+                         a.z * wa + target.z * wb, a.w * wa + target.w * wb});
+}
+
+void transform_points(const Mat4 &m, const Vec3Soa &in, const Vec3Soa &out,
+                      const usize count) {
+  usize i = detail::transform_points_run<detail::MathLanes>(m, in, out, 0, count);
+  detail::transform_points_run<detail::MathLanesScalar>(m, in, out, i, count);
+}
+
+void mat4_mul_batch(const Mat4 *a, const Mat4 *b, Mat4 *out, const usize count) {
+  for (usize i = 0; i < count; ++i) {
+#if EDGE_HAS_AVX2
+    // NOTE: Two output columns per register, the columns of a are broadcast
+    // to both halves and b is splatted within each half.
+    const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&a[i].m_columns[0]));
+    const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&a[i].m_columns[1]));
+    const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&a[i].m_columns[2]));
+    const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(&a[i].m_columns[3]));
+    const __m256 b01 = _mm256_loadu_ps(&b[i].m_columns[0].x);
+    const __m256 b23 = _mm256_loadu_ps(&b[i].m_columns[2].x);
+
+    const auto column_pair = [&](const __m256 columns) {
+      __m256 value = _mm256_mul_ps(a0, _mm256_shuffle_ps(columns, columns, 0x00));
+      value = detail::MathLanes::madd(a1, _mm256_shuffle_ps(columns, columns, 0x55), value);
+      value = detail::MathLanes::madd(a2, _mm256_shuffle_ps(columns, columns, 0xAA), value);
+      return detail::MathLanes::madd(a3, _mm256_shuffle_ps(columns, columns, 0xFF), value);
+    };
+    const __m256 r01 = column_pair(b01);
+    const __m256 r23 = column_pair(b23);
+    _mm256_storeu_ps(&out[i].m_columns[0].x, r01);
+    _mm256_storeu_ps(&out[i].m_columns[2].x, r23);
+#else
+    out[i] = mat4_mul(a[i], b[i]);
+#endif
+  }
+}
+
+void mat4_inverse_batch(const Mat4 *in, Mat4 *out, const usize count, u8 *invertible) {
+  usize i = detail::mat4_inverse_run<detail::MathLanes>(in, out, 0, count, invertible);
+  detail::mat4_inverse_run<detail::MathLanesScalar>(in, out, i, count, invertible);
+}
+
+void mat4_from_trs_batch(const Vec3Soa &translations, const QuatSoa &rotations,
+                         const Vec3Soa &scales, Mat4 *out, const usize count) {
+  usize i = detail::mat4_from_trs_run<detail::MathLanes>(translations, rotations,
+                                                         scales, out, 0, count);
+  detail::mat4_from_trs_run<detail::MathLanesScalar>(translations, rotations, scales,
+                                                     out, i, count);
+}
+
+void aabb_transform_batch(const Aabb *local, const Mat4 *transforms, Aabb *out,
+                          const usize count) {
+  const F32x4 half = f32x4_splat(0.5f);
+  for (usize i = 0; i < count; ++i) {
+    // NOTE: The max corner is loaded from m_min.z so the last element never
+    // reads past the end of the array.
+    const F32x4 box_min = f32x4_load(&local[i].m_min.x);
+    const F32x4 box_max = f32x4_swizzle<1, 2, 3, 3>(f32x4_load(&local[i].m_min.z));
+    const F32x4 center = f32x4_mul(f32x4_add(box_min, box_max), half);
+    const F32x4 extent = f32x4_mul(f32x4_sub(box_max, box_min), half);
+
+    const Mat4 &m = transforms[i];
+    const F32x4 c0 = f32x4_load(m.m_columns[0]);
+    const F32x4 c1 = f32x4_load(m.m_columns[1]);
+    const F32x4 c2 = f32x4_load(m.m_columns[2]);
+
+    F32x4 new_center = f32x4_madd(c0, f32x4_splat_lane<0>(center),
+                                  f32x4_load(m.m_columns[3]));
+    new_center = f32x4_madd(c1, f32x4_splat_lane<1>(center), new_center);
+    new_center = f32x4_madd(c2, f32x4_splat_lane<2>(center), new_center);
+
+    F32x4 new_extent = f32x4_mul(f32x4_abs(c0), f32x4_splat_lane<0>(extent));
+    new_extent = f32x4_madd(f32x4_abs(c1), f32x4_splat_lane<1>(extent), new_extent);
+    new_extent = f32x4_madd(f32x4_abs(c2), f32x4_splat_lane<2>(extent), new_extent);
+
+    alignas(16) f32 corners[8];
+    f32x4_store(corners, f32x4_sub(new_center, new_extent));
+    f32x4_store(corners + 4, f32x4_add(new_center, new_extent));
+    out[i].m_min = {corners[0], corners[1], corners[2]};
+    out[i].m_max = {corners[4], corners[5], corners[6]};
+  }
+}
+
+Aabb aabb_from_points(const Vec3Soa &points, const usize count) {
+  if (count == 0) {
+    return {};
+  }
+
+  Aabb result;
+  result.m_min = {points.m_x[0], points.m_y[0], points.m_z[0]};
+  result.m_max = result.m_min;
+  usize i = detail::aabb_from_points_run<detail::MathLanes>(points, 0, count, result);
+  detail::aabb_from_points_run<detail::MathLanesScalar>(points, i, count, result);
+  return result;
+}
+} // namespace edge
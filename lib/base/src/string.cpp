@@ -0,0 +1,1078 @@
+#include "string_view.hpp"
+
+namespace edge {
+namespace detail {
+namespace utf8 {
+[[maybe_unused]] static u64 read64(const void *ptr) {
+  u64 result;
+  memcpy(&result, ptr, sizeof(u64));
+  return result;
+}
+
+constexpr u64 ASCII_MASK64 = 0x8080808080808080ull;
+
+// NOTE: Length of the well formed sequence at data, or 0 when it is truncated,
+// overlong, a surrogate or above U+10FFFF.
+static usize sequence_length_checked(const u8 *data, const usize remaining) {
+  const u8 b0 = data[0];
+  if (b0 < 0x80) {
+    return 1;
+  }
+
+  if (b0 < 0xC2) {
+    return 0;
+  }
+
+  if (b0 < 0xE0) {
+    return remaining >= 2 && (data[1] & 0xC0) == 0x80 ? 2 : 0;
+  }
+
+  if (b0 < 0xF0) {
+    if (remaining < 3) {
+      return 0;
+    }
+
+    const u8 b1 = data[1];
+    if ((b1 & 0xC0) != 0x80 || (data[2] & 0xC0) != 0x80) {
+      return 0;
+    }
+    if ((b0 == 0xE0 && b1 < 0xA0) || (b0 == 0xED && b1 > 0x9F)) {
+      return 0;
+    }
+    return 3;
+  }
+
+  if (b0 < 0xF5) {
+    if (remaining < 4) {
+      return 0;
+    }
+
+    const u8 b1 = data[1];
+    if ((b1 & 0xC0) != 0x80 || (data[2] & 0xC0) != 0x80 ||
+        (data[3] & 0xC0) != 0x80) {
+      return 0;
+    }
+    if ((b0 == 0xF0 && b1 < 0x90) || (b0 == 0xF4 && b1 > 0x8F)) {
+      return 0;
+    }
+    return 4;
+  }
+
+  return 0;
+}
+
+[[maybe_unused]] static bool validate_scalar(const u8 *data, const usize length) {
+  usize pos = 0;
+  while (pos < length) {
+    if (pos + 8 <= length && (read64(data + pos) & ASCII_MASK64) == 0) {
+      pos += 8;
+      continue;
+    }
+
+    const usize count = sequence_length_checked(data + pos, length - pos);
+    if (count == 0) {
+      return false;
+    }
+    pos += count;
+  }
+  return true;
+}
+
+// NOTE: Decodes a sequence that is known to be well formed.
+static EDGE_FORCE_INLINE char32_t decode_trusted(const u8 *data, usize &count) {
+  const u8 b0 = data[0];
+  if (b0 < 0x80) {
+    count = 1;
+    return b0;
+  }
+  if (b0 < 0xE0) {
+    count = 2;
+    return (static_cast<char32_t>(b0 & 0x1F) << 6) | (data[1] & 0x3F);
+  }
+  if (b0 < 0xF0) {
+    count = 3;
+    return (static_cast<char32_t>(b0 & 0x0F) << 12) |
+           (static_cast<char32_t>(data[1] & 0x3F) << 6) | (data[2] & 0x3F);
+  }
+  count = 4;
+  return (static_cast<char32_t>(b0 & 0x07) << 18) |
+         (static_cast<char32_t>(data[1] & 0x3F) << 12) |
+         (static_cast<char32_t>(data[2] & 0x3F) << 6) | (data[3] & 0x3F);
+}
+
+#if EDGE_HAS_AVX2 || EDGE_HAS_SSSE3 ||                                        \
+    (EDGE_HAS_NEON && defined(EDGE_ARCH_AARCH64))
+#define EDGE_UTF8_SIMD_VALIDATE 1
+
+// NOTE: Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction
+// Per Byte". Three nibble lookups classify every byte pair, a separate check
+// makes sure the third and fourth bytes of long sequences are continuations.
+constexpr u8 TOO_SHORT = 1 << 0;
+constexpr u8 TOO_LONG = 1 << 1;
+constexpr u8 OVERLONG_3 = 1 << 2;
+constexpr u8 TOO_LARGE = 1 << 3;
+constexpr u8 SURROGATE = 1 << 4;
+constexpr u8 OVERLONG_2 = 1 << 5;
+constexpr u8 TOO_LARGE_1000 = 1 << 6;
+constexpr u8 OVERLONG_4 = 1 << 6;
+constexpr u8 TWO_CONTS = 1 << 7;
+constexpr u8 CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+alignas(16) static constexpr u8 g_byte1_high[16] = {
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TWO_CONTS,
+    TWO_CONTS,
+    TWO_CONTS,
+    TWO_CONTS,
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+};
+
+alignas(16) static constexpr u8 g_byte1_low[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    CARRY | OVERLONG_2,
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+alignas(16) static constexpr u8 g_byte2_high[16] = {
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 |
+        OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+};
+
+// NOTE: A block ending in one of these still expects continuation bytes.
+alignas(16) static constexpr u8 g_incomplete_max[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
+#if EDGE_HAS_AVX2
+struct Utf8Vector {
+  using Type = __m256i;
+  static constexpr usize SIZE = 32;
+
+  static Type load(const u8 *data) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  }
+  static Type zero() { return _mm256_setzero_si256(); }
+  static Type splat(const u8 value) {
+    return _mm256_set1_epi8(static_cast<char>(value));
+  }
+  static Type table(const u8 *values) {
+    return _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(values)));
+  }
+  static Type incomplete_max() {
+    return _mm256_inserti128_si256(
+        splat(0xFF),
+        _mm_load_si128(reinterpret_cast<const __m128i *>(g_incomplete_max)),
+        1);
+  }
+  static Type lookup(const Type table, const Type index) {
+    return _mm256_shuffle_epi8(table, index);
+  }
+  static Type high_nibble(const Type value) {
+    return _mm256_and_si256(_mm256_srli_epi16(value, 4), splat(0x0F));
+  }
+  static Type low_nibble(const Type value) {
+    return _mm256_and_si256(value, splat(0x0F));
+  }
+  template <i32 N> static Type prev(const Type input, const Type prev_input) {
+    return _mm256_alignr_epi8(
+        input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+  }
+  static Type op_and(const Type a, const Type b) {
+    return _mm256_and_si256(a, b);
+  }
+  static Type op_or(const Type a, const Type b) {
+    return _mm256_or_si256(a, b);
+  }
+  static Type op_xor(const Type a, const Type b) {
+    return _mm256_xor_si256(a, b);
+  }
+  static Type subs(const Type a, const Type b) {
+    return _mm256_subs_epu8(a, b);
+  }
+  static bool is_ascii(const Type value) {
+    return _mm256_movemask_epi8(value) == 0;
+  }
+  static bool any(const Type value) { return !_mm256_testz_si256(value, value); }
+};
+#elif EDGE_HAS_SSSE3
+struct Utf8Vector {
+  using Type = __m128i;
+  static constexpr usize SIZE = 16;
+
+  static Type load(const u8 *data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  }
+  static Type zero() { return _mm_setzero_si128(); }
+  static Type splat(const u8 value) {
+    return _mm_set1_epi8(static_cast<char>(value));
+  }
+  static Type table(const u8 *values) {
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(values));
+  }
+  static Type incomplete_max() { return table(g_incomplete_max); }
+  static Type lookup(const Type table, const Type index) {
+    return _mm_shuffle_epi8(table, index);
+  }
+  static Type high_nibble(const Type value) {
+    return _mm_and_si128(_mm_srli_epi16(value, 4), splat(0x0F));
+  }
+  static Type low_nibble(const Type value) {
+    return _mm_and_si128(value, splat(0x0F));
+  }
+  template <i32 N> static Type prev(const Type input, const Type prev_input) {
+    return _mm_alignr_epi8(input, prev_input, 16 - N);
+  }
+  static Type op_and(const Type a, const Type b) { return _mm_and_si128(a, b); }
+  static Type op_or(const Type a, const Type b) { return _mm_or_si128(a, b); }
+  static Type op_xor(const Type a, const Type b) { return _mm_xor_si128(a, b); }
+  static Type subs(const Type a, const Type b) { return _mm_subs_epu8(a, b); }
+  static bool is_ascii(const Type value) { return _mm_movemask_epi8(value) == 0; }
+  static bool any(const Type value) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(value, zero())) != 0xFFFF;
+  }
+};
+#else
+struct Utf8Vector {
+  using Type = uint8x16_t;
+  static constexpr usize SIZE = 16;
+
+  static Type load(const u8 *data) { return vld1q_u8(data); }
+  static Type zero() { return vdupq_n_u8(0); }
+  static Type splat(const u8 value) { return vdupq_n_u8(value); }
+  static Type table(const u8 *values) { return vld1q_u8(values); }
+  static Type incomplete_max() { return table(g_incomplete_max); }
+  static Type lookup(const Type table, const Type index) {
+    return vqtbl1q_u8(table, index);
+  }
+  static Type high_nibble(const Type value) { return vshrq_n_u8(value, 4); }
+  static Type low_nibble(const Type value) {
+    return vandq_u8(value, splat(0x0F));
+  }
+  template <i32 N> static Type prev(const Type input, const Type prev_input) {
+    return vextq_u8(prev_input, input, 16 - N);
+  }
+  static Type op_and(const Type a, const Type b) { return vandq_u8(a, b); }
+  static Type op_or(const Type a, const Type b) { return vorrq_u8(a, b); }
+  static Type op_xor(const Type a, const Type b) { return veorq_u8(a, b); }
+  static Type subs(const Type a, const Type b) { return vqsubq_u8(a, b); }
+  static bool is_ascii(const Type value) { return vmaxvq_u8(value) < 0x80; }
+  static bool any(const Type value) { return vmaxvq_u8(value) != 0; }
+};
+#endif
+
+static bool validate_simd(const u8 *data, const usize length) {
+  using V = Utf8Vector;
+  using Type = V::Type;
+
+  const Type byte1_high = V::table(g_byte1_high);
+  const Type byte1_low = V::table(g_byte1_low);
+  const Type byte2_high = V::table(g_byte2_high);
+  const Type incomplete_max = V::incomplete_max();
+  const Type third_byte = V::splat(0xE0 - 0x80);
+  const Type fourth_byte = V::splat(0xF0 - 0x80);
+  const Type high_bit = V::splat(0x80);
+
+  Type error = V::zero();
+  Type prev_input = V::zero();
+  Type prev_incomplete = V::zero();
+
+  auto check_block = [&](const Type input) {
+    if (V::is_ascii(input)) {
+      error = V::op_or(error, prev_incomplete);
+      return;
+    }
+
+    const Type prev1 = V::prev<1>(input, prev_input);
+    const Type special = V::op_and(
+        V::op_and(V::lookup(byte1_high, V::high_nibble(prev1)),
+                  V::lookup(byte1_low, V::low_nibble(prev1))),
+        V::lookup(byte2_high, V::high_nibble(input)));
+
+    const Type must_continue =
+        V::op_or(V::subs(V::prev<2>(input, prev_input), third_byte),
+                 V::subs(V::prev<3>(input, prev_input), fourth_byte));
+    error = V::op_or(
+        error, V::op_xor(V::op_and(must_continue, high_bit), special));
+
+    prev_incomplete = V::subs(input, incomplete_max);
+    prev_input = input;
+  };
+
+  usize pos = 0;
+  for (; pos + V::SIZE <= length; pos += V::SIZE) {
+    check_block(V::load(data + pos));
+  }
+
+  if (pos < length) {
+    alignas(32) u8 tail[V::SIZE] = {};
+    memcpy(tail, data + pos, length - pos);
+    check_block(V::load(tail));
+  }
+
+  return !V::any(V::op_or(error, prev_incomplete));
+}
+#endif
+
+// NOTE: Widens a run of ASCII bytes straight into the output. Returns the
+// number of bytes consumed, 0 when the next block holds a multi byte
+// sequence.
+template <typename CharT>
+static EDGE_FORCE_INLINE usize widen_ascii(const u8 *data, const usize remaining,
+                                           CharT *out) {
+#if EDGE_HAS_AVX2
+  if (remaining < 32) {
+    return 0;
+  }
+  const __m256i input =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  if (_mm256_movemask_epi8(input) != 0) {
+    return 0;
+  }
+
+  auto *dst = reinterpret_cast<__m256i *>(out);
+  if constexpr (sizeof(CharT) == 2) {
+    _mm256_storeu_si256(dst, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input)));
+    _mm256_storeu_si256(dst + 1,
+                        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input, 1)));
+  } else {
+    for (i32 i = 0; i < 4; ++i) {
+      _mm256_storeu_si256(
+          dst + i, _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                       reinterpret_cast<const __m128i *>(data + 8 * i))));
+    }
+  }
+  return 32;
+#elif EDGE_HAS_SSE2
+  if (remaining < 16) {
+    return 0;
+  }
+  const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  if (_mm_movemask_epi8(input) != 0) {
+    return 0;
+  }
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i lo = _mm_unpacklo_epi8(input, zero);
+  const __m128i hi = _mm_unpackhi_epi8(input, zero);
+  auto *dst = reinterpret_cast<__m128i *>(out);
+  if constexpr (sizeof(CharT) == 2) {
+    _mm_storeu_si128(dst, lo);
+    _mm_storeu_si128(dst + 1, hi);
+  } else {
+    _mm_storeu_si128(dst, _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(hi, zero));
+  }
+  return 16;
+#elif EDGE_HAS_NEON && defined(EDGE_ARCH_AARCH64)
+  if (remaining < 16) {
+    return 0;
+  }
+  const uint8x16_t input = vld1q_u8(data);
+  if (vmaxvq_u8(input) >= 0x80) {
+    return 0;
+  }
+
+  const uint16x8_t lo = vmovl_u8(vget_low_u8(input));
+  const uint16x8_t hi = vmovl_high_u8(input);
+  if constexpr (sizeof(CharT) == 2) {
+    vst1q_u16(reinterpret_cast<u16 *>(out), lo);
+    vst1q_u16(reinterpret_cast<u16 *>(out) + 8, hi);
+  } else {
+    auto *dst = reinterpret_cast<u32 *>(out);
+    vst1q_u32(dst, vmovl_u16(vget_low_u16(lo)));
+    vst1q_u32(dst + 4, vmovl_high_u16(lo));
+    vst1q_u32(dst + 8, vmovl_u16(vget_low_u16(hi)));
+    vst1q_u32(dst + 12, vmovl_high_u16(hi));
+  }
+  return 16;
+#else
+  if (remaining < 8 || (read64(data) & ASCII_MASK64) != 0) {
+    return 0;
+  }
+  for (usize i = 0; i < 8; ++i) {
+    out[i] = static_cast<CharT>(data[i]);
+  }
+  return 8;
+#endif
+}
+
+// NOTE: Packs a run of ASCII code units into bytes, returns the number of
+// units consumed or 0.
+template <typename CharT>
+static EDGE_FORCE_INLINE usize narrow_ascii(const CharT *data,
+                                            const usize remaining, u8 *out) {
+#if EDGE_HAS_SSE2
+  if (remaining < 16) {
+    return 0;
+  }
+
+  const auto *src = reinterpret_cast<const __m128i *>(data);
+  if constexpr (sizeof(CharT) == 2) {
+    const __m128i a = _mm_loadu_si128(src);
+    const __m128i b = _mm_loadu_si128(src + 1);
+    const __m128i any_high =
+        _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<i16>(0xFF80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(any_high, _mm_setzero_si128())) !=
+        0xFFFF) {
+      return 0;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(a, b));
+  } else {
+    const __m128i a = _mm_loadu_si128(src);
+    const __m128i b = _mm_loadu_si128(src + 1);
+    const __m128i c = _mm_loadu_si128(src + 2);
+    const __m128i d = _mm_loadu_si128(src + 3);
+    const __m128i any_high =
+        _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)),
+                      _mm_set1_epi32(static_cast<i32>(0xFFFFFF80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(any_high, _mm_setzero_si128())) !=
+        0xFFFF) {
+      return 0;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                     _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                      _mm_packs_epi32(c, d)));
+  }
+  return 16;
+#elif EDGE_HAS_NEON && defined(EDGE_ARCH_AARCH64)
+  if (remaining < 16) {
+    return 0;
+  }
+
+  if constexpr (sizeof(CharT) == 2) {
+    const auto *src = reinterpret_cast<const u16 *>(data);
+    const uint16x8_t a = vld1q_u16(src);
+    const uint16x8_t b = vld1q_u16(src + 8);
+    if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+      return 0;
+    }
+    vst1q_u8(out, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+  } else {
+    const auto *src = reinterpret_cast<const u32 *>(data);
+    const uint32x4_t a = vld1q_u32(src);
+    const uint32x4_t b = vld1q_u32(src + 4);
+    const uint32x4_t c = vld1q_u32(src + 8);
+    const uint32x4_t d = vld1q_u32(src + 12);
+    if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) {
+      return 0;
+    }
+    const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+    const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+    vst1q_u8(out, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+  }
+  return 16;
+#else
+  if (remaining < 8) {
+    return 0;
+  }
+  CharT any = 0;
+  for (usize i = 0; i < 8; ++i) {
+    any |= data[i];
+  }
+  if (any >= 0x80) {
+    return 0;
+  }
+  for (usize i = 0; i < 8; ++i) {
+    out[i] = static_cast<u8>(data[i]);
+  }
+  return 8;
+#endif
+}
+
+// NOTE: Counts lead bytes, plus the 4 byte leads again when each of those
+// needs two output units.
+static usize count_units(const u8 *data, const usize length,
+                         const bool count_four_byte) {
+  usize count = 0;
+  usize pos = 0;
+
+#if EDGE_HAS_SSE2
+  const __m128i continuation_max = _mm_set1_epi8(-65);
+  const __m128i four_byte_min = _mm_set1_epi8(static_cast<char>(0xF0));
+  for (; pos + 16 <= length; pos += 16) {
+    const __m128i input =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    count += static_cast<usize>(std::popcount(static_cast<u32>(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(input, continuation_max)))));
+    if (count_four_byte) {
+      count += static_cast<usize>(std::popcount(static_cast<u32>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(
+              _mm_max_epu8(input, four_byte_min), input)))));
+    }
+  }
+#elif EDGE_HAS_NEON && defined(EDGE_ARCH_AARCH64)
+  const int8x16_t continuation_max = vdupq_n_s8(-65);
+  const uint8x16_t four_byte_min = vdupq_n_u8(0xF0);
+  const uint8x16_t one = vdupq_n_u8(1);
+  for (; pos + 16 <= length; pos += 16) {
+    const uint8x16_t input = vld1q_u8(data + pos);
+    count += vaddvq_u8(
+        vandq_u8(vcgtq_s8(vreinterpretq_s8_u8(input), continuation_max), one));
+    if (count_four_byte) {
+      count += vaddvq_u8(vandq_u8(vcgeq_u8(input, four_byte_min), one));
+    }
+  }
+#endif
+
+  for (; pos < length; ++pos) {
+    count += static_cast<i8>(data[pos]) > -65;
+    count += count_four_byte && data[pos] >= 0xF0;
+  }
+  return count;
+}
+
+template <typename CharT>
+static usize convert_from_utf8(const u8 *data, const usize length, CharT *out) {
+  usize pos = 0;
+  usize out_pos = 0;
+
+  while (pos < length) {
+    if (const usize widened = widen_ascii(data + pos, length - pos, out + out_pos);
+        widened > 0) {
+      pos += widened;
+      out_pos += widened;
+      continue;
+    }
+
+    // NOTE: Decode until the next 16 byte block could be ASCII again.
+    const usize stop = length - pos > 16 ? pos + 16 : length;
+    while (pos < stop) {
+      usize count = 0;
+      char32_t cp = decode_trusted(data + pos, count);
+      pos += count;
+
+      if constexpr (sizeof(CharT) == 2) {
+        if (cp > 0xFFFF) {
+          cp -= 0x10000;
+          out[out_pos++] = static_cast<CharT>(0xD800 + (cp >> 10));
+          out[out_pos++] = static_cast<CharT>(0xDC00 + (cp & 0x3FF));
+          continue;
+        }
+      }
+      out[out_pos++] = static_cast<CharT>(cp);
+    }
+  }
+
+  return out_pos;
+}
+} // namespace utf8
+} // namespace detail
+
+bool detail::utf8::validate_utf8(const char8_t *data, const usize length) {
+  const auto bytes = reinterpret_cast<const u8 *>(data);
+#if defined(EDGE_UTF8_SIMD_VALIDATE)
+  return validate_simd(bytes, length);
+#else
+  return validate_scalar(bytes, length);
+#endif
+}
+
+usize detail::utf8::utf16_length(const char8_t *data, const usize length) {
+  return count_units(reinterpret_cast<const u8 *>(data), length, true);
+}
+
+usize detail::utf8::utf32_length(const char8_t *data, const usize length) {
+  return count_units(reinterpret_cast<const u8 *>(data), length, false);
+}
+
+usize detail::utf8::convert_to_utf16(const char8_t *data, const usize length,
+                                     char16_t *out) {
+  return convert_from_utf8(reinterpret_cast<const u8 *>(data), length, out);
+}
+
+usize detail::utf8::convert_to_utf32(const char8_t *data, const usize length,
+                                     char32_t *out) {
+  return convert_from_utf8(reinterpret_cast<const u8 *>(data), length, out);
+}
+
+bool detail::utf8::convert_from_utf16(const char16_t *data, const usize length,
+                                      char8_t *out, usize &out_length) {
+  auto *bytes = reinterpret_cast<u8 *>(out);
+  usize pos = 0;
+  usize out_pos = 0;
+
+  while (pos < length) {
+    if (const usize narrowed =
+            narrow_ascii(data + pos, length - pos, bytes + out_pos);
+        narrowed > 0) {
+      pos += narrowed;
+      out_pos += narrowed;
+      continue;
+    }
+
+    usize count = 0;
+    if (const char16_t c = data[pos]; is_high_surrogate(c)) {
+      if (pos + 1 >= length || !encode_char(c, data[pos + 1], out + out_pos, count)) {
+        return false;
+      }
+      pos += 2;
+    } else {
+      if (!encode_char(c, out + out_pos, count)) {
+        return false;
+      }
+      pos++;
+    }
+    out_pos += count;
+  }
+
+  out_length = out_pos;
+  return true;
+}
+
+bool detail::utf8::convert_from_utf32(const char32_t *data, const usize length,
+                                      char8_t *out, usize &out_length) {
+  auto *bytes = reinterpret_cast<u8 *>(out);
+  usize pos = 0;
+  usize out_pos = 0;
+
+  while (pos < length) {
+    if (const usize narrowed =
+            narrow_ascii(data + pos, length - pos, bytes + out_pos);
+        narrowed > 0) {
+      pos += narrowed;
+      out_pos += narrowed;
+      continue;
+    }
+
+    usize count = 0;
+    if (!encode_char(data[pos], out + out_pos, count)) {
+      return false;
+    }
+    pos++;
+    out_pos += count;
+  }
+
+  out_length = out_pos;
+  return true;
+}
+
+namespace detail {
+#if EDGE_HAS_AVX2 || EDGE_HAS_SSE2 || EDGE_HAS_NEON
+#define EDGE_BYTE_SCAN_SIMD 1
+#endif
+
+#if EDGE_HAS_AVX2
+struct ByteScan {
+  using Type = __m256i;
+  static constexpr usize SIZE = 32;
+  // NOTE: Bits per byte in the match mask is 1 << MASK_SHIFT.
+  static constexpr i32 MASK_SHIFT = 0;
+
+  static Type load(const u8 *data) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  }
+  static Type splat(const u8 value) {
+    return _mm256_set1_epi8(static_cast<char>(value));
+  }
+  static Type eq(const Type a, const Type b) { return _mm256_cmpeq_epi8(a, b); }
+  static Type op_or(const Type a, const Type b) { return _mm256_or_si256(a, b); }
+  static Type op_and(const Type a, const Type b) {
+    return _mm256_and_si256(a, b);
+  }
+  static u64 mask(const Type value) {
+    return static_cast<u32>(_mm256_movemask_epi8(value));
+  }
+};
+#elif EDGE_HAS_SSE2
+struct ByteScan {
+  using Type = __m128i;
+  static constexpr usize SIZE = 16;
+  static constexpr i32 MASK_SHIFT = 0;
+
+  static Type load(const u8 *data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+  }
+  static Type splat(const u8 value) {
+    return _mm_set1_epi8(static_cast<char>(value));
+  }
+  static Type eq(const Type a, const Type b) { return _mm_cmpeq_epi8(a, b); }
+  static Type op_or(const Type a, const Type b) { return _mm_or_si128(a, b); }
+  static Type op_and(const Type a, const Type b) { return _mm_and_si128(a, b); }
+  static u64 mask(const Type value) {
+    return static_cast<u32>(_mm_movemask_epi8(value));
+  }
+};
+#elif EDGE_HAS_NEON
+struct ByteScan {
+  using Type = uint8x16_t;
+  static constexpr usize SIZE = 16;
+  static constexpr i32 MASK_SHIFT = 2;
+
+  static Type load(const u8 *data) { return vld1q_u8(data); }
+  static Type splat(const u8 value) { return vdupq_n_u8(value); }
+  static Type eq(const Type a, const Type b) { return vceqq_u8(a, b); }
+  static Type op_or(const Type a, const Type b) { return vorrq_u8(a, b); }
+  static Type op_and(const Type a, const Type b) { return vandq_u8(a, b); }
+  // NOTE: Narrowing shift keeps a nibble per byte, one bit of it is enough.
+  static u64 mask(const Type value) {
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(value), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) &
+           0x8888888888888888ull;
+  }
+};
+#endif
+
+static EDGE_FORCE_INLINE bool in_set(const u8 value, const u8 *set,
+                                     const usize set_length) {
+  for (usize i = 0; i < set_length; ++i) {
+    if (set[i] == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// NOTE: Larger sets are matched through a lookup table, comparing every
+// block against each set byte stops paying off.
+constexpr usize BYTE_SET_SIMD_MAX = 8;
+} // namespace detail
+
+usize detail::find_byte(const void *data, const usize length, const u8 value) {
+  const auto *bytes = static_cast<const u8 *>(data);
+  usize pos = 0;
+
+#if defined(EDGE_BYTE_SCAN_SIMD)
+  const ByteScan::Type needle = ByteScan::splat(value);
+  // NOTE: Short distances are common (tokens, lines), so one block is tried
+  // before four blocks per step start sharing one branch.
+  if (ByteScan::SIZE <= length) {
+    if (const u64 mask =
+            ByteScan::mask(ByteScan::eq(ByteScan::load(bytes), needle));
+        mask != 0) {
+      return std::countr_zero(mask) >> ByteScan::MASK_SHIFT;
+    }
+    pos = ByteScan::SIZE;
+  }
+
+  for (; pos + 4 * ByteScan::SIZE <= length; pos += 4 * ByteScan::SIZE) {
+    const u8 *block = bytes + pos;
+    const ByteScan::Type m0 = ByteScan::eq(ByteScan::load(block), needle);
+    const ByteScan::Type m1 =
+        ByteScan::eq(ByteScan::load(block + ByteScan::SIZE), needle);
+    const ByteScan::Type m2 =
+        ByteScan::eq(ByteScan::load(block + 2 * ByteScan::SIZE), needle);
+    const ByteScan::Type m3 =
+        ByteScan::eq(ByteScan::load(block + 3 * ByteScan::SIZE), needle);
+    if (ByteScan::mask(ByteScan::op_or(ByteScan::op_or(m0, m1),
+                                       ByteScan::op_or(m2, m3))) == 0) {
+      continue;
+    }
+
+    const u64 masks[4] = {ByteScan::mask(m0), ByteScan::mask(m1),
+                          ByteScan::mask(m2), ByteScan::mask(m3)};
+    for (usize i = 0; i < 4; ++i) {
+      if (masks[i] != 0) {
+        return pos + i * ByteScan::SIZE +
+               (std::countr_zero(masks[i]) >> ByteScan::MASK_SHIFT);
+      }
+    }
+  }
+
+  for (; pos + ByteScan::SIZE <= length; pos += ByteScan::SIZE) {
+    if (const u64 mask =
+            ByteScan::mask(ByteScan::eq(ByteScan::load(bytes + pos), needle));
+        mask != 0) {
+      return pos + (std::countr_zero(mask) >> ByteScan::MASK_SHIFT);
+    }
+  }
+#endif
+
+  for (; pos < length; ++pos) {
+    if (bytes[pos] == value) {
+      return pos;
+    }
+  }
+  return SIZE_MAX;
+}
+
+usize detail::rfind_byte(const void *data, const usize length, const u8 value) {
+  const auto *bytes = static_cast<const u8 *>(data);
+  usize end = length;
+
+#if defined(EDGE_BYTE_SCAN_SIMD)
+  const ByteScan::Type needle = ByteScan::splat(value);
+  if (end >= ByteScan::SIZE) {
+    end -= ByteScan::SIZE;
+    if (const u64 mask =
+            ByteScan::mask(ByteScan::eq(ByteScan::load(bytes + end), needle));
+        mask != 0) {
+      return end + ((63 - std::countl_zero(mask)) >> ByteScan::MASK_SHIFT);
+    }
+  }
+
+  for (; end >= 4 * ByteScan::SIZE; end -= 4 * ByteScan::SIZE) {
+    const usize pos = end - 4 * ByteScan::SIZE;
+    const u8 *block = bytes + pos;
+    const ByteScan::Type m0 = ByteScan::eq(ByteScan::load(block), needle);
+    const ByteScan::Type m1 =
+        ByteScan::eq(ByteScan::load(block + ByteScan::SIZE), needle);
+    const ByteScan::Type m2 =
+        ByteScan::eq(ByteScan::load(block + 2 * ByteScan::SIZE), needle);
+    const ByteScan::Type m3 =
+        ByteScan::eq(ByteScan::load(block + 3 * ByteScan::SIZE), needle);
+    if (ByteScan::mask(ByteScan::op_or(ByteScan::op_or(m0, m1),
+                                       ByteScan::op_or(m2, m3))) == 0) {
+      continue;
+    }
+
+    const u64 masks[4] = {ByteScan::mask(m0), ByteScan::mask(m1),
+                          ByteScan::mask(m2), ByteScan::mask(m3)};
+    for (usize i = 4; i > 0; --i) {
+      if (masks[i - 1] != 0) {
+        return pos + (i - 1) * ByteScan::SIZE +
+               ((63 - std::countl_zero(masks[i - 1])) >> ByteScan::MASK_SHIFT);
+      }
+    }
+  }
+
+  for (; end >= ByteScan::SIZE; end -= ByteScan::SIZE) {
+    const usize pos = end - ByteScan::SIZE;
+    if (const u64 mask =
+            ByteScan::mask(ByteScan::eq(ByteScan::load(bytes + pos), needle));
+        mask != 0) {
+      return pos + ((63 - std::countl_zero(mask)) >> ByteScan::MASK_SHIFT);
+    }
+  }
+#endif
+
+  for (; end > 0; --end) {
+    if (bytes[end - 1] == value) {
+      return end - 1;
+    }
+  }
+  return SIZE_MAX;
+}
+
+usize detail::find_byte_of(const void *data, const usize length,
+                           const void *set, const usize set_length) {
+  const auto *bytes = static_cast<const u8 *>(data);
+  const auto *set_bytes = static_cast<const u8 *>(set);
+  if (set_length == 1) {
+    return find_byte(data, length, set_bytes[0]);
+  }
+
+  if (set_length > BYTE_SET_SIMD_MAX) {
+    bool table[256] = {};
+    for (usize i = 0; i < set_length; ++i) {
+      table[set_bytes[i]] = true;
+    }
+    for (usize pos = 0; pos < length; ++pos) {
+      if (table[bytes[pos]]) {
+        return pos;
+      }
+    }
+    return SIZE_MAX;
+  }
+
+  usize pos = 0;
+#if defined(EDGE_BYTE_SCAN_SIMD)
+  ByteScan::Type needles[BYTE_SET_SIMD_MAX];
+  for (usize i = 0; i < set_length; ++i) {
+    needles[i] = ByteScan::splat(set_bytes[i]);
+  }
+
+  for (; pos + ByteScan::SIZE <= length; pos += ByteScan::SIZE) {
+    const ByteScan::Type block = ByteScan::load(bytes + pos);
+    ByteScan::Type matches = ByteScan::eq(block, needles[0]);
+    for (usize i = 1; i < set_length; ++i) {
+      matches = ByteScan::op_or(matches, ByteScan::eq(block, needles[i]));
+    }
+    if (const u64 mask = ByteScan::mask(matches); mask != 0) {
+      return pos + (std::countr_zero(mask) >> ByteScan::MASK_SHIFT);
+    }
+  }
+#endif
+
+  for (; pos < length; ++pos) {
+    if (in_set(bytes[pos], set_bytes, set_length)) {
+      return pos;
+    }
+  }
+  return SIZE_MAX;
+}
+
+usize detail::rfind_byte_of(const void *data, const usize length,
+                            const void *set, const usize set_length) {
+  const auto *bytes = static_cast<const u8 *>(data);
+  const auto *set_bytes = static_cast<const u8 *>(set);
+  if (set_length == 1) {
+    return rfind_byte(data, length, set_bytes[0]);
+  }
+
+  if (set_length > BYTE_SET_SIMD_MAX) {
+    bool table[256] = {};
+    for (usize i = 0; i < set_length; ++i) {
+      table[set_bytes[i]] = true;
+    }
+    for (usize end = length; end > 0; --end) {
+      if (table[bytes[end - 1]]) {
+        return end - 1;
+      }
+    }
+    return SIZE_MAX;
+  }
+
+  usize end = length;
+#if defined(EDGE_BYTE_SCAN_SIMD)
+  ByteScan::Type needles[BYTE_SET_SIMD_MAX];
+  for (usize i = 0; i < set_length; ++i) {
+    needles[i] = ByteScan::splat(set_bytes[i]);
+  }
+
+  for (; end >= ByteScan::SIZE; end -= ByteScan::SIZE) {
+    const usize pos = end - ByteScan::SIZE;
+    const ByteScan::Type block = ByteScan::load(bytes + pos);
+    ByteScan::Type matches = ByteScan::eq(block, needles[0]);
+    for (usize i = 1; i < set_length; ++i) {
+      matches = ByteScan::op_or(matches, ByteScan::eq(block, needles[i]));
+    }
+    if (const u64 mask = ByteScan::mask(matches); mask != 0) {
+      return pos + ((63 - std::countl_zero(mask)) >> ByteScan::MASK_SHIFT);
+    }
+  }
+#endif
+
+  for (; end > 0; --end) {
+    if (in_set(bytes[end - 1], set_bytes, set_length)) {
+      return end - 1;
+    }
+  }
+  return SIZE_MAX;
+}
+
+// NOTE: Candidates are positions where both the first and the last needle
+// byte match, only those are compared in full. Mula, "SIMD-friendly
+// algorithms for substring searching".
+usize detail::find_bytes(const void *data, const usize length,
+                         const void *needle, const usize needle_length) {
+  const auto *bytes = static_cast<const u8 *>(data);
+  const auto *needle_bytes = static_cast<const u8 *>(needle);
+  if (needle_length == 0) {
+    return 0;
+  }
+  if (needle_length > length) {
+    return SIZE_MAX;
+  }
+  if (needle_length == 1) {
+    return find_byte(data, length, needle_bytes[0]);
+  }
+
+  const usize last = needle_length - 1;
+  const usize candidates = length - last;
+  usize pos = 0;
+
+#if defined(EDGE_BYTE_SCAN_SIMD)
+  const ByteScan::Type first_byte = ByteScan::splat(needle_bytes[0]);
+  const ByteScan::Type last_byte = ByteScan::splat(needle_bytes[last]);
+  for (; pos + ByteScan::SIZE <= candidates; pos += ByteScan::SIZE) {
+    u64 mask = ByteScan::mask(ByteScan::op_and(
+        ByteScan::eq(ByteScan::load(bytes + pos), first_byte),
+        ByteScan::eq(ByteScan::load(bytes + pos + last), last_byte)));
+    while (mask != 0) {
+      const usize candidate =
+          pos + (std::countr_zero(mask) >> ByteScan::MASK_SHIFT);
+      if (memcmp(bytes + candidate + 1, needle_bytes + 1, last - 1) == 0) {
+        return candidate;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  for (; pos < candidates; ++pos) {
+    if (bytes[pos] == needle_bytes[0] && bytes[pos + last] == needle_bytes[last] &&
+        memcmp(bytes + pos + 1, needle_bytes + 1, last - 1) == 0) {
+      return pos;
+    }
+  }
+  return SIZE_MAX;
+}
+
+usize detail::rfind_bytes(const void *data, const usize length,
+                          const void *needle, const usize needle_length) {
+  const auto *bytes = static_cast<const u8 *>(data);
+  const auto *needle_bytes = static_cast<const u8 *>(needle);
+  if (needle_length == 0) {
+    return length;
+  }
+  if (needle_length > length) {
+    return SIZE_MAX;
+  }
+  if (needle_length == 1) {
+    return rfind_byte(data, length, needle_bytes[0]);
+  }
+
+  const usize last = needle_length - 1;
+  usize end = length - last;
+
+#if defined(EDGE_BYTE_SCAN_SIMD)
+  const ByteScan::Type first_byte = ByteScan::splat(needle_bytes[0]);
+  const ByteScan::Type last_byte = ByteScan::splat(needle_bytes[last]);
+  for (; end >= ByteScan::SIZE; end -= ByteScan::SIZE) {
+    const usize pos = end - ByteScan::SIZE;
+    u64 mask = ByteScan::mask(ByteScan::op_and(
+        ByteScan::eq(ByteScan::load(bytes + pos), first_byte),
+        ByteScan::eq(ByteScan::load(bytes + pos + last), last_byte)));
+    while (mask != 0) {
+      const i32 bit = 63 - std::countl_zero(mask);
+      const usize candidate = pos + (bit >> ByteScan::MASK_SHIFT);
+      if (memcmp(bytes + candidate + 1, needle_bytes + 1, last - 1) == 0) {
+        return candidate;
+      }
+      mask ^= 1ull << bit;
+    }
+  }
+#endif
+
+  for (; end > 0; --end) {
+    const usize pos = end - 1;
+    if (bytes[pos] == needle_bytes[0] && bytes[pos + last] == needle_bytes[last] &&
+        memcmp(bytes + pos + 1, needle_bytes + 1, last - 1) == 0) {
+      return pos;
+    }
+  }
+  return SIZE_MAX;
+}
+} // namespace edge
@@ -0,0 +1,69 @@
+#include "string_id.hpp"
+
+#include "arena.hpp"
+#include "concurrent_hashmap.hpp"
+
+namespace edge {
+namespace detail {
+struct StringIdTable {
+  Allocator alloc = Allocator::create_default();
+  ConcurrentHashMap<u64, StringView<char8_t>> names = {};
+  Arena arena = {};
+  RwLock arena_lock = {};
+
+  StringIdTable() {
+    [[maybe_unused]] const bool created =
+        names.create(&alloc) && arena.create(STRING_ID_ARENA_SIZE);
+    assert(created && "StringId: failed to create the intern table");
+  }
+};
+
+// NOTE: Never destroyed, names stay valid during static destruction.
+static StringIdTable &string_id_table() {
+  static StringIdTable *table = new StringIdTable{};
+  return *table;
+}
+} // namespace detail
+
+StringId string_id_intern(const StringView<char8_t> str) {
+  const StringId id{str};
+  if (!id.valid()) {
+    return id;
+  }
+
+  detail::StringIdTable &table = detail::string_id_table();
+  const EpochGuard guard = table.names.pin();
+
+  const StringView<char8_t> *name = table.names.get_or_insert_with(
+      &table.alloc, guard, id.m_hash, [&table, str]() {
+        rwlock_lock(&table.arena_lock);
+        auto *text = table.arena.alloc<char8_t>(str.length() + 1);
+        if (text) {
+          memcpy(text, str.data(), str.length());
+          text[str.length()] = u8'\0';
+        }
+        rwlock_unlock(&table.arena_lock);
+
+        assert(text && "StringId: intern arena is full");
+        return text ? StringView<char8_t>{text, str.length()}
+                    : StringView<char8_t>{};
+      });
+
+  assert(name && *name == str && "StringId: hash collision");
+  (void)name;
+
+  return id;
+}
+
+StringView<char8_t> string_id_name(const StringId id) {
+  if (!id.valid()) {
+    return {};
+  }
+
+  detail::StringIdTable &table = detail::string_id_table();
+  const EpochGuard guard = table.names.pin();
+
+  const StringView<char8_t> *name = table.names.find(guard, id.m_hash);
+  return name ? *name : StringView<char8_t>{};
+}
+} // namespace edge
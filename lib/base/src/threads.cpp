@@ -912,4 +912,108 @@ ThreadResult thread_set_affinity(const Thread &thr, const i32 core_id,
   return thread_set_affinity_ex(thr, cpu_info, cpu_count, core_id,
                                 prefer_physical);
 }
+namespace detail {
+constexpr u32 RWLOCK_WRITER = 1u << 31;
+constexpr u32 RWLOCK_WRITER_WAITING = 1u << 30;
+constexpr u32 RWLOCK_SLEEPERS = 1u << 29;
+constexpr u32 RWLOCK_READER_MASK = RWLOCK_SLEEPERS - 1;
+constexpr u32 RWLOCK_SPIN_COUNT = 64;
+
+// NOTE: Marks the lock as having sleepers before waiting so unlock knows it has
+// to wake, returns false if the state changed under us.
+static bool rwlock_sleep(RwLock *lock, u32 state) {
+  if (!(state & RWLOCK_SLEEPERS)) {
+    if (!lock->state.compare_exchange_weak(state, state | RWLOCK_SLEEPERS,
+                                           std::memory_order_relaxed)) {
+      return false;
+    }
+    state |= RWLOCK_SLEEPERS;
+  }
+
+  futex_wait(&lock->state, state, std::chrono::nanoseconds::zero());
+  return true;
+}
+} // namespace detail
+
+bool rwlock_try_lock_shared(RwLock *lock) {
+  u32 state = lock->state.load(std::memory_order_relaxed);
+  while (!(state & (detail::RWLOCK_WRITER | detail::RWLOCK_WRITER_WAITING))) {
+    if (lock->state.compare_exchange_weak(state, state + 1,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void rwlock_lock_shared(RwLock *lock) {
+  for (u32 spin = 0;; ++spin) {
+    if (rwlock_try_lock_shared(lock)) {
+      return;
+    }
+
+    if (spin < detail::RWLOCK_SPIN_COUNT) {
+      thread_yield();
+      continue;
+    }
+
+    const u32 state = lock->state.load(std::memory_order_relaxed);
+    if (state & (detail::RWLOCK_WRITER | detail::RWLOCK_WRITER_WAITING)) {
+      detail::rwlock_sleep(lock, state);
+    }
+  }
+}
+
+void rwlock_unlock_shared(RwLock *lock) {
+  const u32 prev = lock->state.fetch_sub(1, std::memory_order_release);
+  if ((prev & detail::RWLOCK_READER_MASK) == 1 &&
+      (prev & detail::RWLOCK_SLEEPERS)) {
+    futex_wake_all(&lock->state);
+  }
+}
+
+bool rwlock_try_lock(RwLock *lock) {
+  u32 state = lock->state.load(std::memory_order_relaxed);
+  while (!(state & (detail::RWLOCK_WRITER | detail::RWLOCK_READER_MASK))) {
+    // NOTE: Keep the sleepers bit, waiters must still be woken on unlock.
+    if (lock->state.compare_exchange_weak(
+            state, detail::RWLOCK_WRITER | (state & detail::RWLOCK_SLEEPERS),
+            std::memory_order_acquire, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void rwlock_lock(RwLock *lock) {
+  for (u32 spin = 0;; ++spin) {
+    if (rwlock_try_lock(lock)) {
+      return;
+    }
+
+    u32 state = lock->state.load(std::memory_order_relaxed);
+    if (!(state & detail::RWLOCK_WRITER_WAITING)) {
+      // NOTE: Stop new readers from entering so the writer can not starve.
+      lock->state.compare_exchange_weak(state,
+                                        state | detail::RWLOCK_WRITER_WAITING,
+                                        std::memory_order_relaxed);
+      continue;
+    }
+
+    if (spin < detail::RWLOCK_SPIN_COUNT) {
+      thread_yield();
+      continue;
+    }
+
+    detail::rwlock_sleep(lock, state);
+  }
+}
+
+void rwlock_unlock(RwLock *lock) {
+  const u32 prev = lock->state.exchange(0, std::memory_order_release);
+  if (prev & detail::RWLOCK_SLEEPERS) {
+    futex_wake_all(&lock->state);
+  }
+}
 } // namespace edge
\ No newline at end of file
@@ -0,0 +1,472 @@
+#include "tlsf.hpp"
+#include "math.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace edge {
+namespace detail {
+static u32 tlsf_fls(const usize x) {
+  return static_cast<u32>(63 - std::countl_zero(static_cast<u64>(x)));
+}
+
+static u32 tlsf_ffs(const u32 x) {
+  return static_cast<u32>(std::countr_zero(x));
+}
+
+static void tlsf_mapping_insert(const usize size, u32 *fl, u32 *sl) {
+  if (size < TLSF_SMALL_BLOCK_SIZE) {
+    *fl = 0;
+    *sl = static_cast<u32>(size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT));
+  } else {
+    const u32 f = tlsf_fls(size);
+    *sl = static_cast<u32>(size >> (f - TLSF_SL_INDEX_COUNT_LOG2)) ^
+          TLSF_SL_INDEX_COUNT;
+    *fl = f - (TLSF_FL_INDEX_SHIFT - 1);
+  }
+}
+
+// NOTE: Rounds the request up to the next list boundary so that any block found
+// in the resulting list is large enough, no list walking required.
+static usize tlsf_round_search_size(const usize size) {
+  if (size < TLSF_SMALL_BLOCK_SIZE) {
+    return size;
+  }
+  return size + (1ull << (tlsf_fls(size) - TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+}
+
+static usize tlsf_adjust_request_size(const usize size) {
+  if (size == 0 || size >= (1ull << TLSF_FL_INDEX_MAX)) {
+    return 0;
+  }
+
+  const usize aligned = align_up(size, TLSF_ALIGN_SIZE);
+  return aligned < TlsfBlock::min_size() ? TlsfBlock::min_size() : aligned;
+}
+} // namespace detail
+
+bool Tlsf::create(usize reserve_size, usize commit_size) {
+  if (reserve_size == 0) {
+    reserve_size = TLSF_MAX_SIZE;
+  }
+
+  if (commit_size == 0) {
+    commit_size = TLSF_COMMIT_CHUNK_SIZE;
+  }
+
+  const usize page_size = vmem_page_size();
+  reserve_size = align_up(reserve_size, page_size);
+  commit_size = align_up(commit_size, page_size);
+  if (commit_size > reserve_size) {
+    commit_size = reserve_size;
+  }
+
+  void *base = nullptr;
+  if (!vmem_reserve(&base, reserve_size)) {
+    return false;
+  }
+
+  if (!vmem_commit(base, commit_size)) {
+    vmem_release(base, reserve_size);
+    return false;
+  }
+
+  m_base = base;
+  m_reserved = reserve_size;
+  m_committed = commit_size;
+  m_page_size = page_size;
+
+  m_fl_bitmap = 0;
+  memset(m_sl_bitmap, 0, sizeof(m_sl_bitmap));
+  memset(m_blocks, 0, sizeof(m_blocks));
+
+  // NOTE: One free block spanning the committed range, followed by a zero sized
+  // used sentinel that stops coalescing and marks the end of the pool.
+  m_first_block = static_cast<TlsfBlock *>(base);
+  m_first_block->prev_phys = nullptr;
+  m_first_block->size_and_flags =
+      commit_size - 2 * TlsfBlock::header_size();
+  m_first_block->set_free(true);
+
+  m_sentinel = m_first_block->next_phys();
+  m_sentinel->prev_phys = m_first_block;
+  m_sentinel->size_and_flags = 0;
+
+  insert_free_block(m_first_block);
+  return true;
+}
+
+void Tlsf::destroy() {
+  if (m_base) {
+    vmem_release(m_base, m_reserved);
+  }
+
+  m_base = nullptr;
+  m_reserved = 0;
+  m_committed = 0;
+  m_first_block = nullptr;
+  m_sentinel = nullptr;
+  m_fl_bitmap = 0;
+}
+
+void *Tlsf::alloc_ex(const usize size, usize alignment) {
+  if (!m_base) {
+    return nullptr;
+  }
+
+  if (alignment < TLSF_ALIGN_SIZE) {
+    alignment = TLSF_ALIGN_SIZE;
+  }
+
+  if ((alignment & (alignment - 1)) != 0) {
+    return nullptr;
+  }
+
+  const usize adjusted = detail::tlsf_adjust_request_size(size);
+  if (adjusted == 0) {
+    return nullptr;
+  }
+
+  if (alignment == TLSF_ALIGN_SIZE) {
+    TlsfBlock *block = find_free_block(adjusted);
+    if (!block) {
+      return nullptr;
+    }
+
+    trim_free(block, adjusted);
+    block->set_free(false);
+    return block->payload();
+  }
+
+  // NOTE: Over-allocate so a leading gap large enough to be a free block of its
+  // own can always be split off in front of the aligned payload.
+  constexpr usize gap_minimum = sizeof(TlsfBlock);
+  const usize size_with_gap =
+      detail::tlsf_adjust_request_size(adjusted + alignment + gap_minimum);
+  if (size_with_gap == 0) {
+    return nullptr;
+  }
+
+  TlsfBlock *block = find_free_block(size_with_gap);
+  if (!block) {
+    return nullptr;
+  }
+
+  const auto ptr = reinterpret_cast<uintptr_t>(block->payload());
+  uintptr_t aligned = align_up(ptr, static_cast<uintptr_t>(alignment));
+  usize gap = aligned - ptr;
+
+  if (gap != 0 && gap < gap_minimum) {
+    const usize gap_remain = gap_minimum - gap;
+    const usize offset = gap_remain > alignment ? gap_remain : alignment;
+    aligned = align_up(ptr + offset, static_cast<uintptr_t>(alignment));
+    gap = aligned - ptr;
+  }
+
+  if (gap != 0) {
+    block = trim_free_leading(block, gap);
+  }
+
+  trim_free(block, adjusted);
+  block->set_free(false);
+  return block->payload();
+}
+
+void *Tlsf::realloc_ex(void *ptr, const usize size, usize alignment) {
+  if (!ptr) {
+    return alloc_ex(size, alignment);
+  }
+
+  if (size == 0) {
+    free(ptr);
+    return nullptr;
+  }
+
+  if (alignment < TLSF_ALIGN_SIZE) {
+    alignment = TLSF_ALIGN_SIZE;
+  }
+
+  const usize adjusted = detail::tlsf_adjust_request_size(size);
+  if (adjusted == 0) {
+    return nullptr;
+  }
+
+  TlsfBlock *block = TlsfBlock::from_payload(ptr);
+  assert(!block->is_free() && "Tlsf::realloc_ex: block already freed");
+
+  const usize current_size = block->size();
+  const TlsfBlock *next = block->next_phys();
+  const usize combined_size =
+      current_size +
+      (next->is_free() ? next->size() + TlsfBlock::header_size() : 0);
+
+  const bool misaligned =
+      (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) != 0;
+
+  if (misaligned || (adjusted > current_size && combined_size < adjusted)) {
+    void *new_ptr = alloc_ex(size, alignment);
+    if (!new_ptr) {
+      return nullptr;
+    }
+
+    memcpy(new_ptr, ptr, current_size < size ? current_size : size);
+    free(ptr);
+    return new_ptr;
+  }
+
+  // NOTE: Grow in place by absorbing the following free block.
+  if (adjusted > current_size) {
+    merge_next(block);
+  }
+
+  trim_used(block, adjusted);
+  return ptr;
+}
+
+void Tlsf::free(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+
+  TlsfBlock *block = TlsfBlock::from_payload(ptr);
+  assert(!block->is_free() && "Tlsf::free: block already freed");
+
+  block->set_free(true);
+  block = merge_prev(block);
+  block = merge_next(block);
+  insert_free_block(block);
+}
+
+usize Tlsf::block_size(const void *ptr) {
+  if (!ptr) {
+    return 0;
+  }
+  return TlsfBlock::from_payload(ptr)->size();
+}
+
+TlsfStats Tlsf::stats() const {
+  TlsfStats result = {};
+  result.committed_bytes = m_committed;
+
+  walk([&result](void *, const usize size, const bool used) {
+    if (used) {
+      result.used_bytes += size;
+      result.used_block_count++;
+    } else {
+      result.free_bytes += size;
+      result.free_block_count++;
+      if (size > result.largest_free_block) {
+        result.largest_free_block = size;
+      }
+    }
+    result.overhead_bytes += TlsfBlock::header_size();
+  });
+
+  if (m_sentinel) {
+    result.overhead_bytes += TlsfBlock::header_size();
+  }
+
+  return result;
+}
+
+Allocator Tlsf::to_allocator() {
+  return Allocator::create(
+      [](const usize size, const usize alignment, void *user_data) {
+        return static_cast<Tlsf *>(user_data)->alloc_ex(size, alignment);
+      },
+      [](void *ptr, void *user_data) {
+        static_cast<Tlsf *>(user_data)->free(ptr);
+      },
+      [](void *ptr, const usize size, const usize alignment, void *user_data) {
+        return static_cast<Tlsf *>(user_data)->realloc_ex(ptr, size,
+                                                          alignment);
+      },
+      this);
+}
+
+bool Tlsf::grow(const usize required_size) {
+  const usize needed =
+      align_up(required_size + TlsfBlock::header_size(), m_page_size);
+
+  usize commit_size = needed > TLSF_COMMIT_CHUNK_SIZE
+                          ? needed
+                          : align_up(TLSF_COMMIT_CHUNK_SIZE, m_page_size);
+  if (m_committed + commit_size > m_reserved) {
+    commit_size = m_reserved - m_committed;
+  }
+
+  if (commit_size < needed) {
+    return false;
+  }
+
+  if (void *commit_addr = static_cast<u8 *>(m_base) + m_committed;
+      !vmem_commit(commit_addr, commit_size)) {
+    return false;
+  }
+
+  m_committed += commit_size;
+
+  // NOTE: The old sentinel becomes the header of the newly committed range.
+  TlsfBlock *block = m_sentinel;
+  block->size_and_flags = commit_size - TlsfBlock::header_size();
+  block->set_free(true);
+
+  m_sentinel = block->next_phys();
+  m_sentinel->prev_phys = block;
+  m_sentinel->size_and_flags = 0;
+
+  block = merge_prev(block);
+  insert_free_block(block);
+  return true;
+}
+
+void Tlsf::insert_free_block(TlsfBlock *block) {
+  u32 fl, sl;
+  detail::tlsf_mapping_insert(block->size(), &fl, &sl);
+
+  TlsfBlock *head = m_blocks[fl][sl];
+  block->next_free = head;
+  block->prev_free = nullptr;
+  if (head) {
+    head->prev_free = block;
+  }
+
+  m_blocks[fl][sl] = block;
+  m_fl_bitmap |= 1u << fl;
+  m_sl_bitmap[fl] |= 1u << sl;
+}
+
+void Tlsf::remove_free_block(TlsfBlock *block) {
+  u32 fl, sl;
+  detail::tlsf_mapping_insert(block->size(), &fl, &sl);
+
+  TlsfBlock *prev = block->prev_free;
+  TlsfBlock *next = block->next_free;
+  if (next) {
+    next->prev_free = prev;
+  }
+  if (prev) {
+    prev->next_free = next;
+  }
+
+  if (m_blocks[fl][sl] == block) {
+    m_blocks[fl][sl] = next;
+    if (!next) {
+      m_sl_bitmap[fl] &= ~(1u << sl);
+      if (m_sl_bitmap[fl] == 0) {
+        m_fl_bitmap &= ~(1u << fl);
+      }
+    }
+  }
+}
+
+TlsfBlock *Tlsf::find_free_block(const usize size) {
+  const usize search_size = detail::tlsf_round_search_size(size);
+
+  u32 fl, sl;
+  detail::tlsf_mapping_insert(search_size, &fl, &sl);
+  if (fl >= TLSF_FL_INDEX_COUNT) {
+    return nullptr;
+  }
+
+  const auto search = [this](u32 fli, u32 sli) -> TlsfBlock * {
+    u32 sl_map = m_sl_bitmap[fli] & (~0u << sli);
+    if (!sl_map) {
+      const u32 fl_map =
+          fli + 1 < 32 ? m_fl_bitmap & (~0u << (fli + 1)) : 0u;
+      if (!fl_map) {
+        return nullptr;
+      }
+
+      fli = detail::tlsf_ffs(fl_map);
+      sl_map = m_sl_bitmap[fli];
+    }
+
+    return m_blocks[fli][detail::tlsf_ffs(sl_map)];
+  };
+
+  TlsfBlock *block = search(fl, sl);
+  if (!block) {
+    if (!grow(search_size)) {
+      return nullptr;
+    }
+    block = search(fl, sl);
+  }
+
+  if (block) {
+    remove_free_block(block);
+  }
+  return block;
+}
+
+TlsfBlock *Tlsf::merge_prev(TlsfBlock *block) {
+  TlsfBlock *prev = block->prev_phys;
+  if (!prev || !prev->is_free()) {
+    return block;
+  }
+
+  remove_free_block(prev);
+  prev->set_size(prev->size() + TlsfBlock::header_size() + block->size());
+  prev->next_phys()->prev_phys = prev;
+  return prev;
+}
+
+TlsfBlock *Tlsf::merge_next(TlsfBlock *block) {
+  TlsfBlock *next = block->next_phys();
+  if (!next->is_free()) {
+    return block;
+  }
+
+  remove_free_block(next);
+  block->set_size(block->size() + TlsfBlock::header_size() + next->size());
+  block->next_phys()->prev_phys = block;
+  return block;
+}
+
+void Tlsf::trim_free(TlsfBlock *block, const usize size) {
+  if (block->size() < size + sizeof(TlsfBlock)) {
+    return;
+  }
+
+  auto *remaining = reinterpret_cast<TlsfBlock *>(
+      static_cast<u8 *>(block->payload()) + size);
+  remaining->prev_phys = block;
+  remaining->size_and_flags =
+      block->size() - size - TlsfBlock::header_size();
+  remaining->set_free(true);
+  remaining->next_phys()->prev_phys = remaining;
+
+  block->set_size(size);
+  insert_free_block(remaining);
+}
+
+TlsfBlock *Tlsf::trim_free_leading(TlsfBlock *block, const usize gap) {
+  auto *aligned = reinterpret_cast<TlsfBlock *>(
+      static_cast<u8 *>(block->payload()) + gap - TlsfBlock::header_size());
+  aligned->prev_phys = block;
+  aligned->size_and_flags = block->size() - gap;
+  aligned->set_free(true);
+  aligned->next_phys()->prev_phys = aligned;
+
+  block->set_size(gap - TlsfBlock::header_size());
+  insert_free_block(block);
+  return aligned;
+}
+
+void Tlsf::trim_used(TlsfBlock *block, const usize size) {
+  if (block->size() < size + sizeof(TlsfBlock)) {
+    return;
+  }
+
+  auto *remaining = reinterpret_cast<TlsfBlock *>(
+      static_cast<u8 *>(block->payload()) + size);
+  remaining->prev_phys = block;
+  remaining->size_and_flags =
+      block->size() - size - TlsfBlock::header_size();
+  remaining->set_free(true);
+  remaining->next_phys()->prev_phys = remaining;
+
+  block->set_size(size);
+  insert_free_block(merge_next(remaining));
+}
+} // namespace edge
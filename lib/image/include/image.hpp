@@ -4,6 +4,7 @@
 #include <cstdio>
 
 #include <callable.hpp>
+#include <span.hpp>
 
 namespace edge {
 using ImageReadFn = Callable<bool(u32 mip_level, u32 layer, u32 layer_count)>;
@@ -109,6 +110,9 @@ struct IImageWriter {
 
 Result<IImageReader *, IImageReader::Result>
 open_image_reader(NotNull<const Allocator *> alloc, NotNull<FILE *> stream);
+// NOTE: Reads straight from the bytes, which must outlive the reader.
+Result<IImageReader *, IImageReader::Result>
+open_image_reader(NotNull<const Allocator *> alloc, Span<const u8> bytes);
 Result<IImageWriter *, IImageWriter::Result>
 open_image_writer(NotNull<const Allocator *> alloc, NotNull<FILE *> stream,
                   ImageContainerType type);
@@ -3,6 +3,7 @@
 
 #include "image.hpp"
 #include "image_format.hpp"
+#include "image_source.hpp"
 
 #include <math.hpp>
 
@@ -256,13 +257,14 @@ static constexpr usize header_dxt10_size = sizeof(HeaderDXT10);
 } // namespace detail::dds
 
 struct DDSReader final : IImageReader {
-  FILE *stream = nullptr;
+  detail::ImageSource source = {};
   ImageInfo info = {};
 
   usize current_layer = 0;
   usize current_mip = 0;
 
-  DDSReader(const NotNull<FILE *> fstream) : stream{fstream.m_ptr} {}
+  DDSReader(const NotNull<FILE *> fstream) : source{fstream.m_ptr} {}
+  DDSReader(const detail::ImageSource &image_source) : source{image_source} {}
 
   Result create(NotNull<const Allocator *> alloc) override {
     using namespace detail::dds;
@@ -335,7 +337,7 @@ struct DDSReader final : IImageReader {
                                 block_info.block_depth) *
                             block_info.layer_count;
     const usize bytes_readed =
-        fread(static_cast<u8 *>(dst_memory) + dst_offset, 1, copy_size, stream);
+        read_bytes(static_cast<u8 *>(dst_memory) + dst_offset, copy_size);
     if (bytes_readed != copy_size) {
       return Result::EndOfStream;
     }
@@ -357,8 +359,8 @@ struct DDSReader final : IImageReader {
   }
 
 private:
-  usize read_bytes(void *buffer, const usize count) const {
-    return fread(buffer, 1, count, stream);
+  usize read_bytes(void *buffer, const usize count) {
+    return source.read(buffer, count);
   }
 };
 
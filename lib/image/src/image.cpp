@@ -64,6 +64,29 @@ open_image_reader(const NotNull<const Allocator *> alloc, NotNull<FILE *> stream
   return reader;
 }
 
+Result<IImageReader *, IImageReader::Result>
+open_image_reader(const NotNull<const Allocator *> alloc,
+                  const Span<const u8> bytes) {
+  if (bytes.size() < detail::max_ident_size) {
+    return IImageReader::Result::InvalidHeader;
+  }
+
+  IImageReader *reader = nullptr;
+  if (memcmp(bytes.data(), detail::dds::IDENTIFIER, detail::dds::ident_size) ==
+      0) {
+    reader = alloc->allocate<DDSReader>(
+        detail::ImageSource{bytes, detail::dds::ident_size});
+  } else if (memcmp(bytes.data(), detail::ktx1::IDENTIFIER,
+                    detail::ktx1::ident_size) == 0) {
+    reader = alloc->allocate<KTX10Reader>(
+        detail::ImageSource{bytes, detail::ktx1::ident_size});
+  } else {
+    return IImageReader::Result::InvalidHeader;
+  }
+
+  return reader;
+}
+
 Result<IImageWriter *, IImageWriter::Result>
 open_image_writer(const NotNull<const Allocator *> alloc, NotNull<FILE *> stream, const ImageContainerType type) {
   IImageWriter *writer = nullptr;
@@ -0,0 +1,58 @@
+#ifndef EDGE_IMAGE_SOURCE_H
+#define EDGE_IMAGE_SOURCE_H
+
+#include <cstdio>
+#include <cstring>
+
+#include <span.hpp>
+
+namespace edge::detail {
+// NOTE: Readers pull either from a FILE stream or straight from a memory view,
+// mapped files skip the stdio copy entirely.
+struct ImageSource {
+  FILE *m_file = nullptr;
+  const u8 *m_data = nullptr;
+  usize m_size = 0;
+  usize m_offset = 0;
+
+  ImageSource() = default;
+  ImageSource(FILE *file) : m_file{file} {}
+  ImageSource(const Span<const u8> bytes, const usize offset)
+      : m_data{bytes.data()}, m_size{bytes.size()}, m_offset{offset} {}
+
+  usize read(void *buffer, const usize count) {
+    if (m_file) {
+      return fread(buffer, 1, count, m_file);
+    }
+
+    const usize available = m_offset < m_size ? m_size - m_offset : 0;
+    const usize copy_size = count < available ? count : available;
+    memcpy(buffer, m_data + m_offset, copy_size);
+    m_offset += copy_size;
+    return copy_size;
+  }
+
+  bool seek(const usize offset) {
+    if (m_file) {
+      return fseek(m_file, static_cast<long>(offset), SEEK_SET) == 0;
+    }
+    if (offset > m_size) {
+      return false;
+    }
+    m_offset = offset;
+    return true;
+  }
+
+  bool skip(const usize count) { return seek(tell() + count); }
+
+  [[nodiscard]] usize tell() const {
+    if (m_file) {
+      const long position = ftell(m_file);
+      return position < 0 ? 0 : static_cast<usize>(position);
+    }
+    return m_offset;
+  }
+};
+} // namespace edge::detail
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "image.hpp"
 #include "image_format.hpp"
+#include "image_source.hpp"
 
 namespace edge {
 namespace detail::ktx1 {
@@ -69,13 +70,15 @@ static u32 gl_type_size_from_gl_type(u32 gl_type) {
 } // namespace detail::ktx1
 
 struct KTX10Reader final : IImageReader {
-  FILE *stream = nullptr;
+  detail::ImageSource source = {};
   ImageInfo info = {};
   u32 endianness = 0;
 
   usize current_mip = 0;
 
-  KTX10Reader(NotNull<FILE *> fstream) : stream{fstream.m_ptr} {}
+  KTX10Reader(NotNull<FILE *> fstream) : source{fstream.m_ptr} {}
+  KTX10Reader(const detail::ImageSource &image_source)
+      : source{image_source} {}
 
   Result create(NotNull<const Allocator *> alloc) override {
     using namespace detail::ktx1;
@@ -114,7 +117,9 @@ struct KTX10Reader final : IImageReader {
               header.number_of_array_elements, header.number_of_faces);
 
     // Skip metadata
-    fseek(stream, static_cast<long>(header.bytes_of_key_value_data), SEEK_CUR);
+    if (!source.skip(header.bytes_of_key_value_data)) {
+      return Result::InvalidHeader;
+    }
 
     return Result::Success;
   }
@@ -167,8 +172,7 @@ struct KTX10Reader final : IImageReader {
 
     dst_offset += calculated_block_size;
 
-    const usize current_stream_offset = ftell(stream);
-    fseek(stream, (current_stream_offset + 3) & ~3, SEEK_SET);
+    source.seek((source.tell() + 3) & ~static_cast<usize>(3));
 
     return Result::Success;
   }
@@ -180,8 +184,8 @@ struct KTX10Reader final : IImageReader {
   }
 
 private:
-  usize read_bytes(void *buffer, const usize count) const {
-    return fread(buffer, 1, count, stream);
+  usize read_bytes(void *buffer, const usize count) {
+    return source.read(buffer, count);
   }
 };
 
@@ -1,5 +1,7 @@
 #include "logger.hpp"
 
+#include <format.hpp>
+
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
@@ -39,46 +41,48 @@ i32 logger_format_entry(char *buffer, usize buffer_size, const LogEntry *entry,
     return 0;
   }
 
-  i32 pos = 0;
+  FormatBuffer out = {buffer, buffer_size - 1, 0};
 
   const char *color =
       (format_flags & LogFormat_Color) ? logger_level_color(entry->level) : "";
   const char *reset = (format_flags & LogFormat_Color) ? ANSI_COLOR_RESET : "";
 
   if (format_flags & LogFormat_Timestamp) {
-    pos += snprintf(buffer + pos, buffer_size - pos, "[%s] ", entry->timestamp);
+    format_append(out, "[{}] ", entry->timestamp);
   }
 
   // TODO: Need to do it after fix issuer with fibers and threading
   // if (format_flags & LogFormat_ThreadId) {
-  //	pos += snprintf(buffer + pos, buffer_size - pos, "[%u] ",
-  //entry->thread_id);
+  //	format_append(out, "[{}] ", entry->thread_id);
   //}
 
   if (format_flags & LogFormat_Level) {
-    pos += snprintf(buffer + pos, buffer_size - pos, "%s[%s]%s ", color,
-                    logger_level_string(entry->level), reset);
+    format_append(out, "{}[{}]{} ", color, logger_level_string(entry->level),
+                  reset);
   }
 
   if ((format_flags & LogFormat_File) && entry->file) {
     const char *filename = get_filename(entry->file);
     if (format_flags & LogFormat_Line) {
-      pos += snprintf(buffer + pos, buffer_size - pos, "[%s:%d] ", filename,
-                      entry->line);
+      format_append(out, "[{}:{}] ", filename, entry->line);
     } else {
-      pos += snprintf(buffer + pos, buffer_size - pos, "[%s] ", filename);
+      format_append(out, "[{}] ", filename);
     }
   }
 
   if ((format_flags & LogFormat_Function) && entry->func) {
-    pos += snprintf(buffer + pos, buffer_size - pos, "<%s> ", entry->func);
+    format_append(out, "<{}> ", entry->func);
   }
 
   if (entry->message) {
-    pos += snprintf(buffer + pos, buffer_size - pos, "%s", entry->message);
+    format_append(out, "{}", entry->message);
   }
 
-  return pos;
+  // NOTE: Returns what was actually written, the line is cut at the buffer.
+  const usize written = out.m_length < out.m_capacity ? out.m_length
+                                                      : out.m_capacity;
+  buffer[written] = '\0';
+  return static_cast<i32>(written);
 }
 
 bool Logger::create(NotNull<const Allocator *> alloc, LogLevel min_level) {
@@ -133,10 +137,11 @@ void logger_vlog(Logger *logger, LogLevel level, const char *file, i32 line,
   struct tm *tm_info = localtime(&now);
 
   if (tm_info) {
-    strftime(entry.timestamp, sizeof(entry.timestamp), "%Y-%m-%d %H:%M:%S",
-             tm_info);
+    format_to(entry.timestamp, "{:04}-{:02}-{:02} {:02}:{:02}:{:02}",
+              tm_info->tm_year + 1900, tm_info->tm_mon + 1, tm_info->tm_mday,
+              tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec);
   } else {
-    snprintf(entry.timestamp, sizeof(entry.timestamp), "UNKNOWN");
+    format_to(entry.timestamp, "UNKNOWN");
   }
 
   for (ILoggerOutput *output : logger->outputs) {
@@ -14,10 +14,11 @@ struct LoggerOutputFile final : ILoggerOutput {
   void write(const LogEntry *entry) override {
     char buffer[EDGE_LOGGER_BUFFER_SIZE];
     /* Strip color codes for file output */
-    logger_format_entry(buffer, sizeof(buffer), entry,
-                        format_flags & ~LogFormat_Color);
+    const i32 length = logger_format_entry(buffer, sizeof(buffer) - 1, entry,
+                                           format_flags & ~LogFormat_Color);
+    buffer[length] = '\n';
 
-    fprintf(file, "%s\n", buffer);
+    fwrite(buffer, 1, static_cast<usize>(length) + 1, file);
 
     if (auto_flush) {
       fflush(file);
@@ -10,8 +10,10 @@ struct LoggerOutputStdout final : ILoggerOutput {
 
   void write(const LogEntry *entry) override {
     char buffer[EDGE_LOGGER_BUFFER_SIZE];
-    logger_format_entry(buffer, sizeof(buffer), entry, format_flags);
-    printf("%s\n", buffer);
+    const i32 length = logger_format_entry(buffer, sizeof(buffer) - 1, entry,
+                                           format_flags);
+    buffer[length] = '\n';
+    fwrite(buffer, 1, static_cast<usize>(length) + 1, stdout);
   }
 
   void flush() override { fflush(stdout); }
@@ -3,10 +3,19 @@
 
 #include <array.hpp>
 #include <callable.hpp>
+#include <filesystem.hpp>
 
 namespace edge {
 struct Allocator;
 
+enum EventCategory : u64 {
+  EVENT_CATEGORY_FILESYSTEM = 1ull << 0,
+};
+
+enum EventType : u64 {
+  EVENT_TYPE_FILE_CHANGED = 1,
+};
+
 struct EventHeader {
   u64 categories = 0;
   u64 type = 0;
@@ -17,6 +26,13 @@ struct EventHeader {
   }
 };
 
+// NOTE: One per settled path of a watcher batch, the path is only valid during
+// dispatch.
+struct FileChangedEvent : EventHeader {
+  StringView<char8_t> path = {};
+  filesystem::WalkChange change = filesystem::WalkChange::Modified;
+};
+
 using EventListenerFn = Callable<void(EventHeader *evt)>;
 
 struct EventListener {
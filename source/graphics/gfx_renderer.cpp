@@ -355,8 +355,12 @@ bool Renderer::create(const NotNull<const Allocator *> alloc,
     swapchain_images[i].set_name("backbuffer[%" PRIu64 "]", i);
     img_res.srv.set_name("backbuffer_view[%" PRIu64 "]", i);
 
-    backbuffer_handles[i] = create_empty();
+    backbuffer_handles[i] = create_empty(alloc);
     RenderResource *res = resource_pool.get(backbuffer_handles[i]);
+    if (!res) {
+      destroy(alloc);
+      return false;
+    }
 
     if (!srv_index_allocator.allocate(&res->srv_index)) {
       destroy(alloc);
@@ -408,20 +412,23 @@ void Renderer::destroy(const NotNull<const Allocator *> alloc) {
   cmd_pool.destroy();
 }
 
-Handle Renderer::create_empty() {
-  if (resource_pool.is_full()) {
-    return HANDLE_INVALID;
-  }
-  return resource_pool.allocate();
+Handle Renderer::create_empty(const NotNull<const Allocator *> alloc) {
+  return resource_pool.allocate(alloc);
 }
 
-Handle Renderer::create_image(const ImageCreateInfo &create_info) {
+Handle Renderer::create_image(const NotNull<const Allocator *> alloc,
+                              const ImageCreateInfo &create_info) {
   Image image;
   if (!image.create(create_info)) {
     return HANDLE_INVALID;
   }
 
-  const Handle h = resource_pool.allocate();
+  const Handle h = resource_pool.allocate(alloc);
+  if (h.is_invalid()) {
+    image.destroy();
+    return HANDLE_INVALID;
+  }
+
   if (!attach_image(h, image)) {
     image.destroy();
     return HANDLE_INVALID;
@@ -527,13 +534,19 @@ bool Renderer::update_image(const NotNull<const Allocator *> alloc,
   return true;
 }
 
-Handle Renderer::create_buffer(const BufferCreateInfo &create_info) {
+Handle Renderer::create_buffer(const NotNull<const Allocator *> alloc,
+                               const BufferCreateInfo &create_info) {
   Buffer buffer;
   if (!buffer.create(create_info)) {
     return HANDLE_INVALID;
   }
 
-  const Handle h = resource_pool.allocate();
+  const Handle h = resource_pool.allocate(alloc);
+  if (h.is_invalid()) {
+    buffer.destroy();
+    return HANDLE_INVALID;
+  }
+
   if (!attach_buffer(h, buffer)) {
     buffer.destroy();
     return HANDLE_INVALID;
@@ -572,13 +585,19 @@ bool Renderer::update_buffer(const NotNull<const Allocator *> alloc,
   return true;
 }
 
-Handle Renderer::create_sampler(const VkSamplerCreateInfo &create_info) {
+Handle Renderer::create_sampler(const NotNull<const Allocator *> alloc,
+                                const VkSamplerCreateInfo &create_info) {
   Sampler sampler;
   if (!sampler.create(create_info)) {
     return HANDLE_INVALID;
   }
 
-  const Handle h = resource_pool.allocate();
+  const Handle h = resource_pool.allocate(alloc);
+  if (h.is_invalid()) {
+    sampler.destroy();
+    return HANDLE_INVALID;
+  }
+
   if (!attach_sampler(h, sampler)) {
     sampler.destroy();
     return HANDLE_INVALID;
@@ -209,19 +209,22 @@ struct Renderer {
   bool create(NotNull<const Allocator *> alloc, RendererCreateInfo create_info);
   void destroy(NotNull<const Allocator *> alloc);
 
-  Handle create_empty();
+  Handle create_empty(NotNull<const Allocator *> alloc);
 
-  Handle create_image(const ImageCreateInfo &create_info);
+  Handle create_image(NotNull<const Allocator *> alloc,
+                      const ImageCreateInfo &create_info);
   bool attach_image(Handle h, const Image &image);
   bool update_image(NotNull<const Allocator *> alloc, Handle h,
                     const Image &img);
 
-  Handle create_buffer(const BufferCreateInfo &create_info);
+  Handle create_buffer(NotNull<const Allocator *> alloc,
+                       const BufferCreateInfo &create_info);
   bool attach_buffer(Handle h, const Buffer &buf);
   bool update_buffer(NotNull<const Allocator *> alloc, Handle h,
                      const Buffer &buf);
 
-  Handle create_sampler(const VkSamplerCreateInfo &create_info);
+  Handle create_sampler(NotNull<const Allocator *> alloc,
+                        const VkSamplerCreateInfo &create_info);
   bool attach_sampler(Handle handle, const Sampler& smp);
   bool update_sampler(NotNull<const Allocator *> alloc, Handle h, const Sampler& smp);
 
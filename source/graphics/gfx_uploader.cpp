@@ -2,6 +2,7 @@
 
 #include "gfx_context.h"
 
+#include <filesystem.hpp>
 #include <image.hpp>
 #include <logger.hpp>
 #include <math.hpp>
@@ -186,15 +187,19 @@ ResourceSet &Uploader::get_resource_set() {
 
 void Uploader::load_image_job(const NotNull<const Allocator *> alloc,
                               const char *path) {
-  FILE *stream = fopen(path, "rb");
-  if (!stream) {
+  filesystem::MappedFile mapped_file = {};
+  if (!mapped_file.map(reinterpret_cast<const char8_t *>(path), 0, 0,
+                       filesystem::MapFlag::Sequential |
+                           filesystem::MapFlag::WillNeed)) {
     job_failed(ImageLoadingError::OpenImageError);
     return;
   }
 
   // TODO: Write error descriptions and converters
-  const auto reader_open_result = open_image_reader(alloc, stream);
+  const auto reader_open_result = open_image_reader(
+      alloc, Span<const u8>{mapped_file.data(), mapped_file.size()});
   if (!reader_open_result) {
+    mapped_file.unmap();
     job_failed(ImageLoadingError::HeaderReadingError);
     return;
   }
@@ -202,6 +207,8 @@ void Uploader::load_image_job(const NotNull<const Allocator *> alloc,
   IImageReader *reader = reader_open_result.value();
   if (const auto reader_result = reader->create(alloc);
       reader_result != IImageReader::Result::Success) {
+    alloc->deallocate(reader);
+    mapped_file.unmap();
     job_failed(ImageLoadingError::HeaderReadingError);
     return;
   }
@@ -221,6 +228,9 @@ void Uploader::load_image_job(const NotNull<const Allocator *> alloc,
   Image image = {};
   if (!image.create(create_info)) {
     EDGE_LOG_ERROR("Image loading failed. Can't create image handle.");
+    reader->destroy(alloc);
+    alloc->deallocate(reader);
+    mapped_file.unmap();
     job_failed(ImageLoadingError::FailedToCreateImage);
     return;
   }
@@ -247,6 +257,9 @@ void Uploader::load_image_job(const NotNull<const Allocator *> alloc,
   if (!buffer_view) {
     EDGE_LOG_ERROR(
         "Image loading failed. Failed to allocate uploading memory.");
+    reader->destroy(alloc);
+    alloc->deallocate(reader);
+    mapped_file.unmap();
     job_failed(ImageLoadingError::FailedToAllocateStagingMemory);
     return;
   }
@@ -277,7 +290,7 @@ void Uploader::load_image_job(const NotNull<const Allocator *> alloc,
   reader->destroy(alloc);
   alloc->deallocate(reader);
 
-  fclose(stream);
+  mapped_file.unmap();
 
   const VkCopyBufferToImageInfo2KHR copy_image_info = {
       .sType = VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2_KHR,
@@ -138,10 +138,10 @@ bool ImGuiRenderer::create(NotNull<const Allocator *> alloc,
     return false;
   }
 
-  vertex_buffer = renderer->create_empty();
+  vertex_buffer = renderer->create_empty(alloc);
   vertex_buffer_capacity = k_initial_vertex_count;
 
-  index_buffer = renderer->create_empty();
+  index_buffer = renderer->create_empty(alloc);
   index_buffer_capacity = k_initial_index_count;
 
   update_buffers(alloc);
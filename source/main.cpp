@@ -108,6 +108,13 @@ bool EngineContext::create(const NotNull<const Allocator *> alloc,
   }
   EDGE_LOG_INFO("InputSystem initialized.");
 
+  // NOTE: Hot reload only, running without it is fine.
+  if (asset_watcher.create(alloc) && asset_watcher.add(alloc, u8"assets")) {
+    EDGE_LOG_INFO("Asset watcher initialized.");
+  } else {
+    EDGE_LOG_WARN("Asset changes will not be picked up.");
+  }
+
   const RuntimeInitInfo runtime_info = {.alloc = &allocator,
                                   .layout = runtime_layout.m_ptr,
                                   .input_system = &input_system,
@@ -209,7 +216,7 @@ bool EngineContext::create(const NotNull<const Allocator *> alloc,
       .anisotropyEnable = VK_TRUE,
       .maxAnisotropy = 4.0f};
 
-  default_sampler_handle = renderer.create_sampler(sampler_create_info);
+  default_sampler_handle = renderer.create_sampler(&allocator, sampler_create_info);
 
   return true;
 }
@@ -253,6 +260,7 @@ void EngineContext::destroy(const NotNull<const Allocator *> alloc) {
   }
 
   input_system.destroy(&allocator);
+  asset_watcher.destroy(alloc);
   event_dispatcher.destroy(alloc);
 }
 
@@ -266,9 +274,35 @@ bool EngineContext::run() {
   return true;
 }
 
+void EngineContext::dispatch_file_changes() {
+  const Span<const filesystem::WatchEvent> changes =
+      asset_watcher.poll(&allocator);
+  if (changes.empty() && !asset_watcher.overflowed()) {
+    return;
+  }
+
+  // NOTE: Cached entry flags may describe files that are gone or new.
+  if (filesystem::Filesystem *fs = filesystem::Filesystem::get_instance()) {
+    fs->invalidate_cache();
+  }
+  if (asset_watcher.overflowed()) {
+    EDGE_LOG_WARN("Asset watcher dropped events, some changes were missed.");
+  }
+
+  for (const filesystem::WatchEvent &change : changes) {
+    FileChangedEvent event = {};
+    event.categories = EVENT_CATEGORY_FILESYSTEM;
+    event.type = EVENT_TYPE_FILE_CHANGED;
+    event.path = change.path;
+    event.change = change.change;
+    event_dispatcher.dispatch(&event);
+  }
+}
+
 void EngineContext::tick(const f32 delta_time) {
   runtime->process_events();
   input_system.update();
+  dispatch_file_changes();
 
   imgui_layer.on_frame_begin(delta_time);
 
@@ -93,6 +93,7 @@ private:
 struct EngineContext {
   EventDispatcher event_dispatcher = {};
   InputSystem input_system = {};
+  filesystem::Watcher asset_watcher = {};
 
   IRuntime *runtime = nullptr;
 
@@ -119,6 +120,7 @@ struct EngineContext {
 
 private:
   void tick(f32 delta_time);
+  void dispatch_file_changes();
 };
 } // namespace edge
 
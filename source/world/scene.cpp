@@ -1,6 +1,7 @@
 #include "scene.h"
 
 #include <cgltf.h>
+#include <filesystem.hpp>
 #include <ranges>
 
 namespace edge::world {
@@ -20,35 +21,20 @@ create_cgltf_memory_options(const NotNull<const Allocator *> alloc) {
           .user_data = (void *)alloc.m_ptr};
 }
 
+// NOTE: cgltf only reads the file contents, so glTF and bin buffers are
+// served straight from a read-only mapping instead of a heap copy.
 cgltf_result cgltf_fread(const cgltf_memory_options *mopt,
                          const cgltf_file_options *fopt, const char *path,
                          cgltf_size *size, void **data) {
-  FILE *stream = fopen(path, "rb");
-  if (!stream) {
+  filesystem::MappedFile mapped_file = {};
+  if (!mapped_file.map(reinterpret_cast<const char8_t *>(path), 0, 0,
+                       filesystem::MapFlag::Sequential |
+                           filesystem::MapFlag::WillNeed)) {
     return cgltf_result_io_error;
   }
 
-  fseek(stream, 0, SEEK_END);
-  cgltf_size stream_size = ftell(stream);
-  fseek(stream, 0, SEEK_SET);
-
-  *data = mopt->alloc_func(mopt->user_data, stream_size);
-  if (!*data) {
-    return cgltf_result_out_of_memory;
-  }
-
-  *size = stream_size;
-
-  const usize readed_bytes = fread(*data, 1, stream_size, stream);
-  if (readed_bytes != stream_size) {
-    mopt->free_func(mopt->user_data, *data);
-    *data = nullptr;
-    *size = 0;
-    fclose(stream);
-    return cgltf_result_io_error;
-  }
-
-  fclose(stream);
+  *data = const_cast<u8 *>(mapped_file.data());
+  *size = mapped_file.size();
   return cgltf_result_success;
 }
 
@@ -56,7 +42,10 @@ void cgltf_frelease(const cgltf_memory_options *mopt,
                     const cgltf_file_options *fopt, void *data,
                     cgltf_size size) {
   if (data) {
-    mopt->free_func(mopt->user_data, data);
+    // NOTE: Whole file views start at offset 0, the base is the data.
+    filesystem::MappedFile mapped_file = {
+        static_cast<const u8 *>(data), size, data, size};
+    mapped_file.unmap();
   }
 }
 
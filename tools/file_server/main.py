@@ -56,6 +56,39 @@ def get_mtime(path: Path) -> int:
         return 0
 
 
+def scan_entries(directory: Path, recursive: bool) -> List[FilesystemEntry]:
+    """List a directory with os.scandir, one stat per entry at most.
+
+    The entry type comes straight from the listing, symlinked directories are
+    reported but not descended into.
+    """
+    entries = []
+    pending = [directory]
+    while pending:
+        current = pending.pop()
+        try:
+            scanner = os.scandir(current)
+        except OSError:
+            continue
+        with scanner:
+            for item in scanner:
+                try:
+                    is_directory = item.is_dir()
+                    info = item.stat()
+                except OSError:
+                    continue
+                rel_path = os.path.relpath(item.path, ROOT_DIR)
+                entries.append(FilesystemEntry(
+                    path=rel_path.replace("\\", "/"),
+                    is_directory=is_directory,
+                    size=info.st_size if not is_directory else 0,
+                    mtime=int(info.st_mtime)
+                ))
+                if recursive and is_directory and not item.is_symlink():
+                    pending.append(item.path)
+    return entries
+
+
 @app.get("/", response_model=dict)
 async def root():
     """API information"""
@@ -215,32 +248,7 @@ async def filesystem_tree(path: str = "", recursive: bool = False):
         if not full_path.is_dir():
             raise HTTPException(status_code=400, detail="Path is not a directory")
         
-        entries = []
-        
-        if recursive:
-            for item in full_path.rglob("*"):
-                try:
-                    rel_path = item.relative_to(ROOT_DIR)
-                    entries.append(FilesystemEntry(
-                        path=str(rel_path).replace("\\", "/"),
-                        is_directory=item.is_dir(),
-                        size=item.stat().st_size if item.is_file() else 0,
-                        mtime=get_mtime(item)
-                    ))
-                except:
-                    continue
-        else:
-            for item in full_path.iterdir():
-                try:
-                    rel_path = item.relative_to(ROOT_DIR)
-                    entries.append(FilesystemEntry(
-                        path=str(rel_path).replace("\\", "/"),
-                        is_directory=item.is_dir(),
-                        size=item.stat().st_size if item.is_file() else 0,
-                        mtime=get_mtime(item)
-                    ))
-                except:
-                    continue
+        entries = scan_entries(full_path, recursive)
         
         return FilesystemTree(entries=entries)
     